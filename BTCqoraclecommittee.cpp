@@ -9,6 +9,9 @@
 #include <array>
 #include <string>
 #include <cstring>
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qprobe.hpp"
 
 // Constants
 constexpr size_t ORACLE_COMMITTEE_SIZE = 5;
@@ -36,6 +39,7 @@ struct Signature {
 
 // Quantum-proof multi-sig validator stub (replace with actual scheme)
 bool verify_quantum_multisig(const std::string& message, const std::array<Signature, ORACLE_THRESHOLD>& sigs) {
+    QPROBE(probe, "btcq.verify_multisig");
     size_t valid_count = 0;
     bool used[ORACLE_COMMITTEE_SIZE] = {false, false, false, false, false};
 
@@ -51,28 +55,44 @@ bool verify_quantum_multisig(const std::string& message, const std::array<Signat
             }
         }
     }
-    return valid_count >= ORACLE_THRESHOLD;
+    if (valid_count < ORACLE_THRESHOLD) return QPROBE_REJECT(probe, false);
+    return true;
 }
 
 // Price update function (callable only with threshold signatures)
 bool update_price(uint64_t new_price, uint64_t timestamp, const std::array<Signature, ORACLE_THRESHOLD>& sigs) {
+    QPROBE(probe, "btcq.update_price");
     // Enforce monotonic timestamp
-    if (timestamp <= latest_feed.timestamp) return false;
+    if (timestamp <= latest_feed.timestamp) return QPROBE_REJECT(probe, false);
 
     // Construct message to sign (e.g., "price|timestamp")
     std::string message = std::to_string(new_price) + "|" + std::to_string(timestamp);
 
     // Verify signatures
-    if (!verify_quantum_multisig(message, sigs)) return false;
+    if (!verify_quantum_multisig(message, sigs)) return QPROBE_REJECT(probe, false);
 
     // All checks pass, update price
     latest_feed.price = new_price;
     latest_feed.timestamp = timestamp;
+    journal().record(EventContract::BTCQ_COMMITTEE, JournalRecord::Price, 0, [](std::ostream& out) {
+        out.write(reinterpret_cast<const char*>(&latest_feed), sizeof(latest_feed));
+    });
+    emitEvent(EventContract::BTCQ_COMMITTEE, EventType::PriceUpdate, EventKeyRef(), EventKeyRef(),
+              new_price, timestamp);
+    return true;
+}
+
+// Journal replay (qjournal.hpp): the feed after an accepted update
+bool replay_journal(std::istream& in) {
+    PriceFeed f;
+    if (!in.read(reinterpret_cast<char*>(&f), sizeof(f))) return false;
+    if (f.timestamp > latest_feed.timestamp) latest_feed = f;
     return true;
 }
 
 // Read function to get latest price
 PriceFeed get_latest_price() {
+    QPROBE(probe, "btcq.get_latest_price");
     return latest_feed;
 }
 
@@ -5,43 +5,641 @@
  */
 
 #include <vector>
-#include <unordered_map>
+#include <array>
 #include <string>
+#include <string_view>
 #include <set>
+#include <map>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <memory>
+#include <atomic>
+#include <stdexcept>
+#include "qsnapshot.hpp"
+#include "qstatedelta.hpp"
+#include "qjournal.hpp"
+#include "qevents.hpp"
+#include "qstatetree.hpp"
+#include "qsignerset.hpp"
+#include "qproposalstore.hpp"
+#include "qcall.hpp"
+#include "qworkers.hpp"
+#include "qprobe.hpp"
+
+// ====== Quantum Signature (Dilithium) - must use side-channel-resistant code ======
+extern bool dilithium_verify(
+    const uint8_t* pubkey,
+    const uint8_t* msg, size_t msg_len,
+    const uint8_t* sig, size_t sig_len
+);
 
 class Qnosis {
 public:
+    // Proposal actions, parsed once at propose time; the value indexes the dispatch table
+    enum class ActionKind : uint8_t {
+        Transfer = 0,
+        AddOwner,
+        RemoveOwner,
+        ChangeThreshold,
+        Multicall, // `data` holds encoded sub-actions (see encodeMulticall)
+        Count
+    };
+    static constexpr const char* ACTION_NAMES[size_t(ActionKind::Count)] = {
+        "transfer", "add-owner", "remove-owner", "change-threshold", "multicall"};
+    static constexpr uint32_t MAX_MULTICALL_CALLS = 4096;
+
+    // Tokens a "transfer" can move, named by its param; an empty param is a native
+    // QUBIC transfer. Token transfers go out through the call bus (qcall.hpp) from
+    // the vault's account, which is its domain.
+    struct TokenName {
+        const char* name;
+        EventContract contract;
+    };
+    static constexpr TokenName TOKENS[] = {
+        {"qusd", EventContract::QUSD}, {"bkpy", EventContract::BKPY}, {"qbtc", EventContract::QBTC}};
+
+    // Off-chain approvals: an owner that signs with Dilithium3 is identified by its
+    // raw public key (the owner string is the key bytes)
+    static constexpr size_t OWNER_PUBKEY_SIZE = 1472;
+    static constexpr size_t OWNER_SIG_SIZE = 2701;
+
     // Represents a transaction proposal
     struct Proposal {
         std::string to;            // destination address (or contract)
         uint64_t value;            // amount (for transfers, in qBTC or QUBIC units)
-        std::string data;          // payload (for contract call)
+        std::string data;          // payload (for contract call, or multicall sub-actions)
         uint64_t nonce;            // unique identifier
         bool executed;             // has the proposal been executed?
-        std::set<std::string> sigs; // set of owner addresses that have signed
-        std::string action;        // "transfer", "add-owner", "remove-owner", etc.
+        SignerMask approvals;      // owner slots that have signed
+        ActionKind action;         // what execute() does
         std::string param;         // parameter for action (e.g., owner address for add/remove)
+        uint64_t amount;           // numeric parameter, pre-parsed (change-threshold; token id for transfer)
+    };
+
+    // One action ready to apply; strings view into the owning proposal
+    struct Call {
+        ActionKind action;
+        std::string_view to;
+        uint64_t value;
+        std::string_view param;
+        uint64_t amount;
+        std::string_view data;
+    };
+
+    // One multicall sub-action as written by the proposer
+    struct CallInput {
+        std::string action;
+        std::string to;
+        uint64_t value;
+        std::string param;
     };
 
-    std::vector<std::string> owners;                   // Current owners
+    // Read-only view of a proposal, pending or archived. Valid until the next
+    // mutating call: execution moves proposals out of the slab and may remap the archive.
+    struct ProposalView {
+        std::string_view to;
+        uint64_t value;
+        std::string_view data;
+        uint64_t nonce;
+        bool executed;
+        SignerMask approvals;
+        std::string_view action;
+        std::string_view param;
+    };
+
+    // One owner's signature over proposalHash(), collected off-chain
+    struct OwnerSignature {
+        uint32_t slot;                   // signer's owner slot (see getOwners order / SignerSet)
+        std::vector<uint8_t> signature;  // OWNER_SIG_SIZE bytes
+    };
+
+    // One page of nonces in ascending order; pass nextCursor back for the next
+    // page (0 when there are no more)
+    struct ProposalPage {
+        std::vector<uint64_t> nonces;
+        uint64_t nextCursor;
+    };
+
+    SignerSet owners;                                  // Current owners (up to 64 slots)
     uint32_t threshold;                                // Signatures required
     uint64_t proposalNonce;                            // For replay protection
-    std::unordered_map<uint64_t, Proposal> proposals;  // Map nonce => proposal
+    NonceSlab<Proposal> proposals;                     // Pending proposals by nonce (executed ones are archived)
+    Hash256 domain{};                                  // Binds off-chain signatures to this vault (e.g. its contract id)
+
+    // ==== Snapshot Tables (see qsnapshot.hpp) ====
+    static constexpr uint32_t SNAPSHOT_TABLE_OWNERS = 0;     // StringRow, by slot (empty key = free slot)
+    static constexpr uint32_t SNAPSHOT_TABLE_PROPOSALS = 1;  // ProposalRow, hot proposals sorted by nonce
+    static constexpr size_t SNAPSHOT_SCALAR_THRESHOLD = 0;
+    static constexpr size_t SNAPSHOT_SCALAR_NONCE = 1;
+    static constexpr size_t SNAPSHOT_SCALAR_ARCHIVE_END = 2; // archive length at snapshot time
+
+    // ==== Delta Tables (see qstatedelta.hpp) ====
+    // One section of touched proposals, then the governance flag, owners by slot
+    // (when changed in range), threshold and the next nonce
+    static constexpr uint16_t DELTA_TABLE_PROPOSALS = 0;
+
+    // A touched proposal as carried by a delta: hot (every field), archived (the
+    // archive record) or gone (a signed submission that failed)
+    struct ProposalRecord {
+        enum : uint8_t { ABSENT = 0, HOT = 1, ARCHIVED = 2 };
+        uint8_t state = ABSENT;
+        std::string to, data, param;
+        uint64_t value = 0, approvals = 0;
+        uint8_t action = 0;
+        bool executed = false;
+        std::vector<uint8_t> archived;
+
+        friend void writeField(std::ostream& out, const ProposalRecord& r) {
+            out.put(char(r.state));
+            if (r.state == HOT) {
+                writeField(out, r.to);
+                writeField(out, r.data);
+                writeField(out, r.param);
+                writeU64(out, r.value);
+                writeU64(out, r.approvals);
+                out.put(char(r.action));
+                writeField(out, r.executed);
+            } else if (r.state == ARCHIVED) {
+                writeField(out, r.archived);
+            }
+        }
+        friend bool readField(std::istream& in, ProposalRecord& r) {
+            int state = in.get();
+            if (state < ABSENT || state > ARCHIVED) return false;
+            r = ProposalRecord();
+            r.state = uint8_t(state);
+            if (r.state == HOT) {
+                int action;
+                if (!readField(in, r.to) || !readField(in, r.data) || !readField(in, r.param) ||
+                    !readU64(in, r.value) || !readU64(in, r.approvals) || (action = in.get()) < 0 ||
+                    !readField(in, r.executed))
+                    return false;
+                r.action = uint8_t(action);
+            } else if (r.state == ARCHIVED) {
+                return readField(in, r.archived);
+            }
+            return true;
+        }
+    };
+
+    struct StringRow {
+        SnapshotStringRef key;
+    };
+    struct ProposalRow {
+        uint64_t nonce;
+        uint64_t value;
+        SnapshotStringRef to, data, action, param;
+        uint64_t approvals;  // owner slot bitmap
+        uint8_t executed;
+        uint8_t reserved[7];
+    };
+
+private:
+    // Executed proposals, append-only and mapped; shared between copies
+    std::shared_ptr<NonceArchive> archive = std::make_shared<NonceArchive>();
+
+    // Journal and catch-up: proposals touched per tick, and the last tick owners or
+    // threshold changed (construction counts, so the first record carries them)
+    DirtyLog<uint64_t> dirtyProposals;
+    uint64_t governanceTick = 0;
+
+    // Secondary indexes over pending proposals: O(owners) per propose/sign/execute,
+    // rebuilt on owner or threshold changes
+    NonceBitset readyQueue;                                // approvals >= threshold
+    std::array<NonceBitset, SIGNER_SET_CAPACITY> awaiting; // per owner slot: not yet approved by that owner
+
+    void indexProposal(uint64_t nonce, const Proposal& p) {
+        for (SignerMask m = owners.mask() & ~p.approvals; m; m &= m - 1)
+            awaiting[popcount64((m & -m) - 1)].set(nonce);
+        if (approvalCount(p) >= threshold) readyQueue.set(nonce);
+        else readyQueue.reset(nonce);
+    }
+
+    void unindexProposal(uint64_t nonce) {
+        readyQueue.reset(nonce);
+        for (SignerMask m = owners.mask(); m; m &= m - 1)
+            awaiting[popcount64((m & -m) - 1)].reset(nonce);
+    }
+
+    void rebuildIndexes() {
+        readyQueue.clear();
+        for (auto& a : awaiting) a.clear();
+        proposals.forEach([this](uint64_t nonce, const Proposal& p) {
+            if (!p.executed) indexProposal(nonce, p);
+        });
+    }
+
+    template <typename Next>
+    static ProposalPage collectPage(uint64_t cursor, size_t limit, Next next) {
+        ProposalPage page{{}, 0};
+        for (uint64_t n = next(std::max<uint64_t>(cursor, 1)); n != UINT64_MAX; n = next(n + 1)) {
+            if (page.nonces.size() >= limit) {
+                page.nextCursor = n;
+                break;
+            }
+            page.nonces.push_back(n);
+        }
+        return page;
+    }
+
+    // Archive record: value, approvals, four string lengths, then the strings
+    bool archiveProposal(const Proposal& p) {
+        std::string_view fields[4] = {p.to, p.data, ACTION_NAMES[size_t(p.action)], p.param};
+        std::vector<uint8_t> rec(32);
+        memcpy(rec.data(), &p.value, 8);
+        memcpy(rec.data() + 8, &p.approvals, 8);
+        for (int i = 0; i < 4; ++i) {
+            uint32_t len = uint32_t(fields[i].size());
+            memcpy(rec.data() + 16 + 4 * i, &len, 4);
+            rec.insert(rec.end(), fields[i].begin(), fields[i].end());
+        }
+        return archive->append(p.nonce, rec.data(), rec.size());
+    }
+
+    bool view(uint64_t nonce, ProposalView& v) const {
+        if (const Proposal* p = proposals.find(nonce)) {
+            v = ProposalView{p->to, p->value, p->data, p->nonce, p->executed, p->approvals,
+                             ACTION_NAMES[size_t(p->action)], p->param};
+            return true;
+        }
+        size_t len;
+        const uint8_t* rec = archive->find(nonce, len);
+        if (!rec || len < 32) return false;
+        uint32_t lens[4];
+        memcpy(&v.value, rec, 8);
+        memcpy(&v.approvals, rec + 8, 8);
+        memcpy(lens, rec + 16, 16);
+        std::string_view* fields[4] = {&v.to, &v.data, &v.action, &v.param};
+        const char* at = reinterpret_cast<const char*>(rec + 32);
+        size_t left = len - 32;
+        for (int i = 0; i < 4; ++i) {
+            if (lens[i] > left) return false;
+            *fields[i] = std::string_view(at, lens[i]);
+            at += lens[i];
+            left -= lens[i];
+        }
+        v.nonce = nonce;
+        v.executed = true;
+        return true;
+    }
+
+    // A removed owner's slot may be reused: drop its approvals from every pending proposal
+    void clearApprovals(uint32_t slot) {
+        SignerMask bit = signerBit(slot);
+        proposals.forEach([this, bit](uint64_t nonce, const Proposal& p) {
+            if (!p.executed && (p.approvals & bit)) {
+                proposals.find(nonce)->approvals &= ~bit;
+                dirtyProposals.markDirty(nonce);
+            }
+        });
+    }
+
+    uint32_t approvalCount(const Proposal& p) const {
+        return popcount64(p.approvals & owners.mask());
+    }
+
+    // ==== Action Parsing ====
+    static bool parseAction(std::string_view name, ActionKind& kind) {
+        for (size_t i = 0; i < size_t(ActionKind::Count); ++i)
+            if (name == ACTION_NAMES[i]) { kind = ActionKind(i); return true; }
+        return false;
+    }
+
+    // Validate the parameter for an action and pre-parse numeric ones
+    static bool parseParam(ActionKind kind, std::string_view param, uint64_t& amount) {
+        amount = 0;
+        switch (kind) {
+        case ActionKind::AddOwner:
+        case ActionKind::RemoveOwner:
+            return !param.empty();
+        case ActionKind::ChangeThreshold: {
+            auto r = std::from_chars(param.data(), param.data() + param.size(), amount);
+            return r.ec == std::errc() && r.ptr == param.data() + param.size();
+        }
+        case ActionKind::Transfer:
+            if (param.empty()) return true;
+            for (const TokenName& t : TOKENS)
+                if (param == t.name) { amount = uint64_t(t.contract); return true; }
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    // Walk an encoded multicall payload; false if malformed, empty, oversized, nested or
+    // if a sub-call's param does not parse. Layout per call: action u8, value u64,
+    // to (u32 len + bytes), param (u32 len + bytes). A sub-call's pre-parsed amount
+    // (threshold, token id) comes from its param, as for a top-level proposal.
+    template <typename Visit>
+    static bool decodeMulticall(std::string_view data, Visit visit) {
+        size_t at = 0;
+        auto take = [&](void* out, size_t n) {
+            if (data.size() - at < n) return false;
+            memcpy(out, data.data() + at, n);
+            at += n;
+            return true;
+        };
+        auto takeString = [&](std::string_view& out) {
+            uint32_t len;
+            if (!take(&len, 4) || data.size() - at < len) return false;
+            out = data.substr(at, len);
+            at += len;
+            return true;
+        };
+        uint32_t count;
+        if (!take(&count, 4) || count == 0 || count > MAX_MULTICALL_CALLS) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint8_t kind;
+            Call c{};
+            if (!take(&kind, 1) || kind >= uint8_t(ActionKind::Multicall)) return false;
+            if (!take(&c.value, 8) || !takeString(c.to) || !takeString(c.param)) return false;
+            c.action = ActionKind(kind);
+            if (!parseParam(c.action, c.param, c.amount)) return false;
+            visit(c);
+        }
+        return at == data.size();
+    }
+
+    static Call callOf(const Proposal& p) {
+        return Call{p.action, p.to, p.value, p.param, p.amount, p.data};
+    }
+
+    // ==== Action Handlers ====
+    // Undo record for one execute/executeBatch: governance state is copied on first change
+    struct Undo {
+        bool saved;
+        SignerSet owners;
+        uint32_t threshold;
+        SignerMask freedSlots; // approvals for these slots are cleared on commit
+    };
+    Undo undo{};
+
+    // Token transfers of the executing batch, in the order applied; buffers for the call bus
+    struct TokenTransfer {
+        EventContract token;
+        CallTransferInput input;
+        CallTransferOutput output;
+    };
+    std::vector<TokenTransfer> transfers;
+    std::vector<CrossCall> crossCalls;
+
+    void beginGovernanceChange() {
+        if (undo.saved) return;
+        undo.owners = owners;
+        undo.threshold = threshold;
+        undo.saved = true;
+    }
+
+    // Token transfers are queued and sent by settleTransfers() once every action of
+    // the batch has applied
+    void applyTransfer(const Call& c) {
+        if (c.amount == 0) {
+            // Native QUBIC transfer: chain API, e.g. QUBIC::transfer(c.to, c.value)
+            return;
+        }
+        EventContract token = EventContract(c.amount);
+        require(callBus().bound(token, CallProcedure::Transfer) && callBus().bound(token, CallProcedure::BalanceOf),
+                "Token not available");
+        require(c.to.size() == 32 && c.value > 0, "Invalid token transfer");
+        require(memcmp(c.to.data(), domain.data(), 32) != 0, "Transfer to the vault itself");
+        TokenTransfer& t = transfers.emplace_back();
+        t.token = token;
+        memcpy(t.input.to, c.to.data(), 32);
+        t.input.amount = c.value;
+        t.output.ok = 0;
+    }
+
+    CallBalanceOutput tokenBalance(EventContract token, const uint8_t account[32]) const {
+        CallBalanceInput in;
+        CallBalanceOutput out{0, 0};
+        memcpy(in.account, account, 32);
+        require(callBus().call(token, CallProcedure::BalanceOf, domain.data(), in, out), "Token not available");
+        require(out.addressable, "Account not addressable by token");
+        return out;
+    }
+
+    // Send the batch's token transfers as one bus batch under the vault's account.
+    // Every refusal a token can make is ruled out first, over the batch's totals:
+    // each account must be addressable by the token, the vault's balance must cover
+    // what it sends, and no recipient's balance may overflow with what it receives.
+    // A transfer refused anyway fails the execution after the ones that went through
+    // are reversed, so no token moves.
+    void settleTransfers() {
+        if (transfers.empty()) return;
+        std::map<std::pair<EventContract, Hash256>, uint64_t> due; // per token: vault outflow, recipient inflow
+        for (const TokenTransfer& t : transfers) {
+            Hash256 to;
+            memcpy(to.data(), t.input.to, 32);
+            for (uint64_t* d : {&due[{t.token, domain}], &due[{t.token, to}]}) {
+                require(*d + t.input.amount >= *d, "Transfer total overflows");
+                *d += t.input.amount;
+            }
+        }
+        for (const auto& [key, amount] : due) {
+            uint64_t balance = tokenBalance(key.first, key.second.data()).balance;
+            if (key.second == domain) require(balance >= amount, "Vault balance too low");
+            else require(balance + amount >= balance, "Recipient balance overflows");
+        }
+        crossCalls.clear();
+        for (TokenTransfer& t : transfers)
+            crossCalls.push_back({t.token, CallProcedure::Transfer, &t.input, &t.output});
+        require(callBus().callBatch(domain.data(), crossCalls.data(), crossCalls.size()) == crossCalls.size(),
+                "Token not available");
+        for (const TokenTransfer& t : transfers) {
+            if (t.output.ok) continue;
+            reverseTransfers();
+            require(false, "Token transfer refused");
+        }
+    }
+
+    // Compensate the transfers of the batch that went through, newest first, by
+    // sending each amount back from its recipient. Recipients only received in the
+    // batch and the vault only sent, so each reversal is covered by what its
+    // recipient was just credited and brings the vault back to at most its old balance.
+    void reverseTransfers() {
+        for (size_t i = transfers.size(); i--;) {
+            const TokenTransfer& t = transfers[i];
+            if (!t.output.ok) continue;
+            CallTransferInput back;
+            CallTransferOutput out{0};
+            memcpy(back.to, domain.data(), 32);
+            back.amount = t.input.amount;
+            require(callBus().call(t.token, CallProcedure::Transfer, t.input.to, back, out) && out.ok,
+                    "Token transfer reversal refused");
+        }
+    }
+
+    void applyAddOwner(const Call& c) {
+        std::string owner(c.param);
+        require(!isOwner(owner), "Already an owner");
+        beginGovernanceChange();
+        require(owners.add(owner) >= 0, "Owner table full");
+    }
+
+    void applyRemoveOwner(const Call& c) {
+        std::string owner(c.param);
+        require(isOwner(owner), "Not an owner");
+        require(owners.size() > 1, "At least 1 owner required");
+        beginGovernanceChange();
+        undo.freedSlots |= signerBit(uint32_t(owners.remove(owner)));
+        if (threshold > owners.size()) threshold = owners.size(); // Adjust threshold if needed
+    }
+
+    void applyChangeThreshold(const Call& c) {
+        require(c.amount > 0 && c.amount <= owners.size(), "Invalid threshold");
+        beginGovernanceChange();
+        threshold = uint32_t(c.amount);
+    }
+
+    void applyMulticall(const Call& c) {
+        // Validated at propose time; a payload failing here throws and the batch is undone
+        require(decodeMulticall(c.data, [this](const Call& sub) { apply(sub); }), "Malformed multicall");
+    }
+
+    // Dispatch through a table indexed by ActionKind
+    void apply(const Call& c) {
+        using Handler = void (Qnosis::*)(const Call&);
+        static constexpr Handler handlers[] = {
+            &Qnosis::applyTransfer,
+            &Qnosis::applyAddOwner,
+            &Qnosis::applyRemoveOwner,
+            &Qnosis::applyChangeThreshold,
+            &Qnosis::applyMulticall,
+        };
+        static_assert(sizeof(handlers) / sizeof(handlers[0]) == size_t(ActionKind::Count), "one handler per action");
+        (this->*handlers[size_t(c.action)])(c);
+    }
+
+    // Verify signatures in parallel on the shared worker pool and return the mask of
+    // the lowest-slot `threshold` owners whose signatures check out (fewer if the
+    // quorum is not met). The mask is stored and snapshotted, so it must not depend
+    // on scheduling: candidates are taken in slot order, and a worker skips one only
+    // once `threshold` lower-slot signatures are already known valid, so at most about
+    // one verification per worker is wasted past the quorum.
+    SignerMask verifySignatures(const Hash256& hash, const std::vector<OwnerSignature>& sigs) const {
+        std::vector<size_t> todo;
+        SignerMask claimed = 0;
+        for (size_t i = 0; i < sigs.size(); ++i) {
+            const OwnerSignature& s = sigs[i];
+            if (s.slot >= SIGNER_SET_CAPACITY || !(owners.mask() & signerBit(s.slot))) continue;
+            if ((claimed & signerBit(s.slot)) || s.signature.size() != OWNER_SIG_SIZE) continue;
+            if (owners.at(s.slot).size() != OWNER_PUBKEY_SIZE) continue;
+            claimed |= signerBit(s.slot);
+            todo.push_back(i);
+        }
+        if (popcount64(claimed) < threshold) return 0; // cannot reach quorum: verify nothing
+        std::sort(todo.begin(), todo.end(), [&sigs](size_t a, size_t b) { return sigs[a].slot < sigs[b].slot; });
+
+        enum : uint8_t { PENDING, VALID, INVALID };
+        std::unique_ptr<std::atomic<uint8_t>[]> result(new std::atomic<uint8_t>[todo.size()]);
+        for (size_t i = 0; i < todo.size(); ++i) result[i].store(PENDING, std::memory_order_relaxed);
+        sharedWorkers().parallelFor(todo.size(), [&](size_t i) {
+            uint32_t validBelow = 0;
+            for (size_t j = 0; j < i && validBelow < threshold; ++j)
+                validBelow += result[j].load(std::memory_order_acquire) == VALID;
+            if (validBelow >= threshold) return; // cannot be among the lowest `threshold`
+            const OwnerSignature& s = sigs[todo[i]];
+            const auto* key = reinterpret_cast<const uint8_t*>(owners.at(s.slot).data());
+            QPROBE(probe, "qgnosis.dilithium_verify");
+            bool ok = dilithium_verify(key, hash.data(), hash.size(), s.signature.data(), s.signature.size());
+            result[i].store(ok ? VALID : INVALID, std::memory_order_release);
+            if (!ok) QPROBE_REJECT_VOID(probe);
+        });
+
+        SignerMask verified = 0;
+        uint32_t count = 0;
+        for (size_t i = 0; i < todo.size() && count < threshold; ++i) {
+            if (result[i].load(std::memory_order_relaxed) != VALID) continue;
+            verified |= signerBit(sigs[todo[i]].slot);
+            ++count;
+        }
+        return verified;
+    }
+
+    // Execute proposals all-or-nothing. Authorization is checked once for the whole
+    // batch, before any effect; token transfers are sent after every action applied.
+    // If anything throws, owners and threshold are restored, no token moves (transfers
+    // already sent are reversed) and no proposal is marked executed.
+    void executeAll(const uint64_t* nonces, size_t count) {
+        size_t marked = 0;
+        undo.saved = false;
+        undo.freedSlots = 0;
+        transfers.clear();
+        try {
+            for (; marked < count; ++marked) {
+                Proposal* p = proposals.find(nonces[marked]);
+                require(p != nullptr, "No such proposal");
+                require(!p->executed, "Already executed"); // also rejects duplicates in the batch
+                require(approvalCount(*p) >= threshold, "Not enough signatures");
+                p->executed = true;
+            }
+            for (size_t i = 0; i < count; ++i) apply(callOf(*proposals.find(nonces[i])));
+            settleTransfers();
+        } catch (...) {
+            if (undo.saved) {
+                owners = undo.owners;
+                threshold = undo.threshold;
+            }
+            for (size_t i = 0; i < marked; ++i) proposals.find(nonces[i])->executed = false;
+            throw;
+        }
+
+        // Commit: a removed owner's slot may be reused, so its approvals go now
+        for (SignerMask m = undo.freedSlots; m; m &= m - 1) clearApprovals(popcount64((m & -m) - 1));
+        for (size_t i = 0; i < count; ++i) {
+            unindexProposal(nonces[i]);
+            dirtyProposals.markDirty(nonces[i]);
+        }
+        if (undo.saved) {
+            rebuildIndexes();
+            governanceTick = dirtyProposals.currentTick();
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const Proposal& p = *proposals.find(nonces[i]);
+            emitEvent(EventContract::QNOSIS, EventType::ProposalExecuted, p.to, EventKeyRef(), p.value, p.nonce);
+            // Move to the cold archive; if it cannot be written the proposal just stays hot
+            if (archiveProposal(p)) proposals.erase(nonces[i]);
+        }
+    }
+
+    // Delta record for a touched nonce: hot, archived or gone
+    void recordOf(uint64_t nonce, ProposalRecord& r) const {
+        r = ProposalRecord();
+        if (const Proposal* p = proposals.find(nonce)) {
+            r.state = ProposalRecord::HOT;
+            r.to = p->to;
+            r.data = p->data;
+            r.param = p->param;
+            r.value = p->value;
+            r.approvals = p->approvals;
+            r.action = uint8_t(p->action);
+            r.executed = p->executed;
+            return;
+        }
+        size_t len;
+        if (const uint8_t* rec = archive->find(nonce, len)) {
+            r.state = ProposalRecord::ARCHIVED;
+            r.archived.assign(rec, rec + len);
+        }
+    }
+
+public:
 
     // ==== Constructor ====
     Qnosis(const std::vector<std::string>& initialOwners, uint32_t thresh) {
         require(initialOwners.size() > 0, "Owners required");
+        require(initialOwners.size() <= SIGNER_SET_CAPACITY, "Too many owners");
         require(thresh > 0 && thresh <= initialOwners.size(), "Invalid threshold");
-        owners = initialOwners;
+        for (const auto& o : initialOwners) require(owners.add(o) >= 0, "Duplicate or empty owner");
         threshold = thresh;
         proposalNonce = 1;
     }
 
     // ==== Utility: Checks ====
     bool isOwner(const std::string& addr) const {
-        return std::find(owners.begin(), owners.end(), addr) != owners.end();
+        return owners.contains(addr);
     }
 
     void require(bool cond, const std::string& msg) const {
@@ -50,70 +648,376 @@ public:
 
     // ==== Proposal Management ====
 
-    // Propose new transaction (transfer or contract call)
+    // Propose new transaction (transfer, contract call, owner change or multicall)
     uint64_t propose(const std::string& proposer, const std::string& to, uint64_t value, const std::string& data, const std::string& action = "transfer", const std::string& param = "") {
+        QPROBE_THROWING(probe, "qgnosis.propose");
         require(isOwner(proposer), "Not an owner");
-        Proposal p{to, value, data, proposalNonce, false, {}, action, param};
-        proposals[proposalNonce] = p;
+        ActionKind kind = ActionKind::Transfer;
+        uint64_t amount;
+        require(parseAction(action, kind), "Unknown action");
+        require(parseParam(kind, param, amount), "Invalid action parameter");
+        if (kind == ActionKind::Multicall) require(decodeMulticall(data, [](const Call&) {}), "Malformed multicall");
+        Proposal p{to, value, data, proposalNonce, false, 0, kind, param, amount};
+        indexProposal(proposalNonce, proposals.insert(proposalNonce, std::move(p)));
+        dirtyProposals.markDirty(proposalNonce);
         proposalNonce++;
         return proposalNonce - 1;
     }
 
     // Sign a proposal (no double signing)
     void sign(uint64_t nonce, const std::string& signer) {
-        require(isOwner(signer), "Not an owner");
-        require(proposals.count(nonce), "No such proposal");
-        Proposal& p = proposals[nonce];
+        QPROBE_THROWING(probe, "qgnosis.sign");
+        int slot = owners.indexOf(signer);
+        require(slot >= 0, "Not an owner");
+        Proposal* found = proposals.find(nonce);
+        require(found != nullptr, "No such proposal");
+        Proposal& p = *found;
         require(!p.executed, "Already executed");
-        p.sigs.insert(signer);
+        if (p.approvals & signerBit(uint32_t(slot))) return;
+        p.approvals |= signerBit(uint32_t(slot));
+        dirtyProposals.markDirty(nonce);
+        awaiting[slot].reset(nonce);
+        if (approvalCount(p) >= threshold) readyQueue.set(nonce);
     }
 
     // Can this proposal be executed?
     bool canExecute(uint64_t nonce) const {
-        auto it = proposals.find(nonce);
-        if (it == proposals.end()) return false;
-        const Proposal& p = it->second;
-        return !p.executed && p.sigs.size() >= threshold;
+        QPROBE(probe, "qgnosis.canExecute");
+        const Proposal* found = proposals.find(nonce);
+        if (!found) return false;
+        const Proposal& p = *found;
+        return !p.executed && approvalCount(p) >= threshold;
     }
 
     // Execute proposal (must be signed by threshold)
+    // Quantum signature logic: can be plugged in here (or when validating signatures)
     void execute(uint64_t nonce) {
-        require(proposals.count(nonce), "No such proposal");
-        Proposal& p = proposals[nonce];
-        require(!p.executed, "Already executed");
-        require(p.sigs.size() >= threshold, "Not enough signatures");
+        QPROBE_THROWING(probe, "qgnosis.execute");
+        executeAll(&nonce, 1);
+    }
 
-        if (p.action == "transfer") {
-            // [Insert logic for Qubic-native transfer/call, e.g.]:
-            // Token::transfer(address(this), p.to, p.value);
-            // Or: QUBIC::transfer(p.to, p.value);
-            // Or: Contract::call(p.to, p.data);
-            // (In real Qubic, must integrate with chain/call API)
-        }
-        else if (p.action == "add-owner") {
-            require(!isOwner(p.param), "Already an owner");
-            owners.push_back(p.param);
-        }
-        else if (p.action == "remove-owner") {
-            require(isOwner(p.param), "Not an owner");
-            require(owners.size() > 1, "At least 1 owner required");
-            owners.erase(std::remove(owners.begin(), owners.end(), p.param), owners.end());
-            if (threshold > owners.size()) threshold = owners.size(); // Adjust threshold if needed
+    // Execute several ready proposals atomically: all succeed or none take effect
+    void executeBatch(const std::vector<uint64_t>& nonces) {
+        QPROBE_THROWING(probe, "qgnosis.executeBatch");
+        require(!nonces.empty(), "Empty batch");
+        executeAll(nonces.data(), nonces.size());
+    }
+
+    // ==== Off-chain Approvals ====
+
+    // Bind signatures to one vault instance; set once at deployment
+    void setDomain(const Hash256& d) { domain = d; }
+
+    // Message owners sign for the proposal that would get `nonce`: K12 over the
+    // vault domain, nonce, action, value, to, param and data (lengths prefixed)
+    Hash256 proposalHash(uint64_t nonce, const std::string& to, uint64_t value, const std::string& data,
+                         const std::string& action = "transfer", const std::string& param = "") const {
+        static constexpr char TAG[] = "QNOSIS/PROPOSAL/1";
+        std::vector<uint8_t> buf(TAG, TAG + sizeof(TAG) - 1);
+        auto put = [&buf](const void* p, size_t n) {
+            const uint8_t* b = static_cast<const uint8_t*>(p);
+            buf.insert(buf.end(), b, b + n);
+        };
+        auto putString = [&put](const std::string& str) {
+            uint64_t len = str.size();
+            put(&len, 8);
+            put(str.data(), str.size());
+        };
+        put(domain.data(), domain.size());
+        put(&nonce, 8);
+        put(&value, 8);
+        putString(action);
+        putString(to);
+        putString(param);
+        putString(data);
+        Hash256 out;
+        KangarooTwelve(buf.data(), unsigned(buf.size()), out.data(), 32);
+        return out;
+    }
+
+    // Create, approve and execute a proposal in one call from signatures collected
+    // off-chain over proposalHash(nextNonce(), ...). `hash` must match that message.
+    // Signatures are verified in parallel and verification stops once the threshold
+    // is met. All-or-nothing: if the quorum is missing or execution throws, no
+    // proposal is left behind and the nonce is not consumed.
+    uint64_t submitSigned(const Hash256& hash, const std::vector<OwnerSignature>& sigs, const std::string& to, uint64_t value,
+                          const std::string& data, const std::string& action = "transfer", const std::string& param = "") {
+        QPROBE_THROWING(probe, "qgnosis.submitSigned");
+        ActionKind kind = ActionKind::Transfer;
+        uint64_t amount;
+        require(parseAction(action, kind), "Unknown action");
+        require(parseParam(kind, param, amount), "Invalid action parameter");
+        if (kind == ActionKind::Multicall) require(decodeMulticall(data, [](const Call&) {}), "Malformed multicall");
+        require(hash == proposalHash(proposalNonce, to, value, data, action, param), "Proposal hash mismatch");
+        SignerMask approvals = verifySignatures(hash, sigs);
+        require(popcount64(approvals) >= threshold, "Not enough valid signatures");
+
+        uint64_t nonce = proposalNonce;
+        indexProposal(nonce, proposals.insert(nonce, Proposal{to, value, data, nonce, false, approvals, kind, param, amount}));
+        dirtyProposals.markDirty(nonce);
+        proposalNonce++;
+        try {
+            executeAll(&nonce, 1);
+        } catch (...) {
+            unindexProposal(nonce);
+            proposals.erase(nonce);
+            proposalNonce--;
+            throw;
         }
-        else if (p.action == "change-threshold") {
-            uint32_t newThresh = std::stoul(p.param);
-            require(newThresh > 0 && newThresh <= owners.size(), "Invalid threshold");
-            threshold = newThresh;
+        return nonce;
+    }
+
+    // Nonce the next proposal will get (what off-chain signers sign over)
+    uint64_t nextNonce() const { return proposalNonce; }
+
+    // Encode sub-actions as the `data` of a "multicall" proposal; one approval
+    // round then applies them all atomically
+    std::string encodeMulticall(const std::vector<CallInput>& calls) const {
+        require(!calls.empty() && calls.size() <= MAX_MULTICALL_CALLS, "Invalid multicall size");
+        std::string out(4, '\0');
+        uint32_t count = uint32_t(calls.size());
+        memcpy(&out[0], &count, 4);
+        auto put = [&out](const void* p, size_t n) { out.append(static_cast<const char*>(p), n); };
+        for (const auto& c : calls) {
+            ActionKind kind;
+            uint64_t amount;
+            require(parseAction(c.action, kind) && kind != ActionKind::Multicall, "Unknown action");
+            require(parseParam(kind, c.param, amount), "Invalid action parameter");
+            uint8_t k = uint8_t(kind);
+            uint32_t toLen = uint32_t(c.to.size()), paramLen = uint32_t(c.param.size());
+            put(&k, 1);
+            put(&c.value, 8);
+            put(&toLen, 4);
+            put(c.to.data(), toLen);
+            put(&paramLen, 4);
+            put(c.param.data(), paramLen);
         }
-        // Quantum signature logic: can be plugged in here (or when validating signatures)
-        p.executed = true;
+        return out;
     }
 
     // ==== View/Info ====
-    std::vector<std::string> getOwners() const { return owners; }
+    std::vector<std::string> getOwners() const {
+        std::vector<std::string> out;
+        owners.forEach([&out](uint32_t, const std::string& o) { out.push_back(o); });
+        return out;
+    }
     uint32_t getThreshold() const { return threshold; }
-    bool isExecuted(uint64_t nonce) const { return proposals.count(nonce) ? proposals.at(nonce).executed : false; }
-    std::set<std::string> getSignatures(uint64_t nonce) const { return proposals.count(nonce) ? proposals.at(nonce).sigs : std::set<std::string>{}; }
-    Proposal getProposal(uint64_t nonce) const { require(proposals.count(nonce), "No such proposal"); return proposals.at(nonce); }
+    bool isExecuted(uint64_t nonce) const { ProposalView v; return view(nonce, v) && v.executed; }
+    SignerMask getApprovals(uint64_t nonce) const { ProposalView v; return view(nonce, v) ? v.approvals : 0; }
+    std::set<std::string> getSignatures(uint64_t nonce) const {
+        SignerMask approvals = getApprovals(nonce);
+        std::set<std::string> out;
+        owners.forEach([&](uint32_t slot, const std::string& o) { if (approvals & signerBit(slot)) out.insert(o); });
+        return out;
+    }
+    ProposalView getProposal(uint64_t nonce) const { ProposalView v; require(view(nonce, v), "No such proposal"); return v; }
+    size_t pendingProposals() const { return proposals.size(); }
+
+    // ==== Paginated Queries (cursor = first nonce to return, 0 = from the start) ====
+    ProposalPage getReadyToExecute(uint64_t cursor = 0, size_t limit = 100) const {
+        return collectPage(cursor, limit, [this](uint64_t n) { return readyQueue.next(n); });
+    }
+    ProposalPage getAwaitingSignature(const std::string& owner, uint64_t cursor = 0, size_t limit = 100) const {
+        int slot = owners.indexOf(owner);
+        if (slot < 0) return ProposalPage{{}, 0};
+        const NonceBitset& set = awaiting[slot];
+        return collectPage(cursor, limit, [&set](uint64_t n) { return set.next(n); });
+    }
+    ProposalPage getPendingProposals(uint64_t cursor = 0, size_t limit = 100) const {
+        return collectPage(cursor, limit, [this](uint64_t n) {
+            for (n = proposals.next(n); n != UINT64_MAX && proposals.find(n)->executed; n = proposals.next(n + 1)) {}
+            return n;
+        });
+    }
+    ProposalPage getExecutedProposals(uint64_t cursor = 0, size_t limit = 100) const {
+        return collectPage(cursor, limit, [this](uint64_t n) {
+            for (; n < proposalNonce; ++n) {
+                const Proposal* p = proposals.find(n);
+                if (!p || p->executed) return n;
+            }
+            return UINT64_MAX;
+        });
+    }
+
+    // ==== Cold Archive ====
+
+    // Back the archive with a file (resumed if present); before any proposal executes
+    bool openArchive(const std::string& path) {
+        if (archive->end() != 0) return false;
+        auto a = std::make_shared<NonceArchive>();
+        if (!a->open(path)) return false;
+        archive = a;
+        return true;
+    }
+
+    // ==== Snapshot ====
+
+    // Write owners, threshold, nonce and hot proposals; archived ones are referenced
+    // by the archive length, which a restore rolls the archive back to, so the
+    // archive is synced first
+    bool saveSnapshot(const std::string& path, uint64_t tick) const {
+        if (!archive->sync()) return false;
+        SnapshotWriter w(path);
+        w.beginTable(SNAPSHOT_TABLE_OWNERS, sizeof(StringRow));
+        for (uint32_t slot = 0; slot < owners.slotSpan(); ++slot) w.appendRow(StringRow{w.addString(owners.at(slot))});
+        w.endTable();
+
+        w.beginTable(SNAPSHOT_TABLE_PROPOSALS, sizeof(ProposalRow));
+        proposals.forEach([&w](uint64_t, const Proposal& p) {
+            ProposalRow row = {};
+            row.nonce = p.nonce;
+            row.value = p.value;
+            row.to = w.addString(p.to);
+            row.data = w.addString(p.data);
+            row.action = w.addString(ACTION_NAMES[size_t(p.action)]);
+            row.param = w.addString(p.param);
+            row.approvals = p.approvals;
+            row.executed = p.executed;
+            w.appendRow(row);
+        });
+        w.endTable();
+
+        w.setScalar(SNAPSHOT_SCALAR_THRESHOLD, threshold);
+        w.setScalar(SNAPSHOT_SCALAR_NONCE, proposalNonce);
+        w.setScalar(SNAPSHOT_SCALAR_ARCHIVE_END, archive->end());
+        return w.finish(tick);
+    }
+
+    // Restore from a snapshot: hot proposals are copied in (O(pending)) and the
+    // archive is rolled back to its length at snapshot time
+    bool loadSnapshot(const std::string& path) {
+        SnapshotView snapshot;
+        if (!snapshot.open(path) || !snapshot.verify()) return false;
+        size_t n, rowCount;
+        const StringRow* ownerRows = snapshot.table<StringRow>(SNAPSHOT_TABLE_OWNERS, n);
+        const ProposalRow* rows = snapshot.table<ProposalRow>(SNAPSHOT_TABLE_PROPOSALS, rowCount);
+        if (n == 0 || n > SIGNER_SET_CAPACITY) return false;
+        NonceSlab<Proposal> restored;
+        for (size_t i = 0; i < rowCount; ++i) {
+            const ProposalRow& r = rows[i];
+            Proposal p{snapshot.string(r.to), r.value, snapshot.string(r.data), r.nonce, r.executed != 0,
+                       r.approvals, ActionKind::Transfer, snapshot.string(r.param), 0};
+            if (!parseAction(snapshot.string(r.action), p.action) || !parseParam(p.action, p.param, p.amount))
+                return false;
+            restored.insert(r.nonce, std::move(p));
+        }
+        if (!archive->truncate(snapshot.scalar(SNAPSHOT_SCALAR_ARCHIVE_END))) return false; // archive is behind
+        owners.clear();
+        for (size_t i = 0; i < n; ++i) {
+            std::string key = snapshot.string(ownerRows[i].key);
+            if (!key.empty()) owners.assign(uint32_t(i), key);
+        }
+        proposals = std::move(restored);
+        threshold = uint32_t(snapshot.scalar(SNAPSHOT_SCALAR_THRESHOLD));
+        proposalNonce = snapshot.scalar(SNAPSHOT_SCALAR_NONCE);
+        rebuildIndexes();
+        dirtyProposals.restart(snapshot.tick());
+        governanceTick = snapshot.tick();
+        return true;
+    }
+
+    // ==== Journal (see qjournal.hpp) ====
+    // One vault per process is journaled: records are keyed by EventContract::QNOSIS
+
+    // Tick boundary: sync the tick's archived proposals, journal the tick, then
+    // close the dirty set. An archive that cannot sync is caught up from the journal,
+    // whose deltas carry archived records.
+    void endTick() {
+        QPROBE(probe, "qgnosis.endTick");
+        archive->sync();
+        uint64_t tick = dirtyProposals.currentTick();
+        journal().record(EventContract::QNOSIS, JournalRecord::Delta, tick,
+                         [this, tick](std::ostream& out) { exportDelta(tick, out); });
+        dirtyProposals.endTick();
+    }
+
+    // Proposals touched in [fromTick, current], then governance and counters.
+    // False if fromTick is outside the retained window (use a full snapshot instead)
+    bool exportDelta(uint64_t fromTick, std::ostream& out) const {
+        bool ok = dirtyProposals.exportDelta<ProposalRecord>(fromTick, DELTA_TABLE_PROPOSALS, out,
+            [this](uint64_t nonce, ProposalRecord& r) { recordOf(nonce, r); });
+        if (!ok) return false;
+        bool governance = governanceTick >= fromTick;
+        writeField(out, governance);
+        if (governance) {
+            writeU64(out, owners.slotSpan());
+            for (uint32_t slot = 0; slot < owners.slotSpan(); ++slot) writeField(out, owners.at(slot));
+        }
+        writeU64(out, threshold);
+        writeU64(out, proposalNonce);
+        return bool(out);
+    }
+
+    // Peer catch-up and journal replay. The delta must start at the open tick; it is
+    // read and checked whole before any state changes. Archived proposals missing
+    // from this node's archive are appended to it.
+    bool applyDelta(std::istream& in) {
+        DeltaHeader header;
+        std::vector<std::pair<uint64_t, ProposalRecord>> records;
+        bool governance;
+        uint64_t span = 0, newThreshold, newNonce;
+        std::vector<std::string> slots;
+        if (!readDelta(in, DELTA_TABLE_PROPOSALS, header, records) || !readField(in, governance)) return false;
+        if (governance) {
+            if (!readU64(in, span) || span == 0 || span > SIGNER_SET_CAPACITY) return false;
+            slots.resize(size_t(span));
+            for (auto& key : slots)
+                if (!readField(in, key)) return false;
+        }
+        if (!readU64(in, newThreshold) || !readU64(in, newNonce)) return false;
+        if (header.fromTick != dirtyProposals.currentTick()) return false;
+
+        size_t ownerCount = governance ? 0 : owners.size();
+        for (const auto& key : slots) ownerCount += !key.empty();
+        if (newThreshold == 0 || newThreshold > ownerCount || newNonce == 0) return false;
+        std::vector<Proposal> hot;
+        for (const auto& [nonce, r] : records) {
+            if (nonce == 0 || nonce >= newNonce) return false;
+            if (r.state == ProposalRecord::ARCHIVED && r.archived.size() < 32) return false;
+            if (r.state != ProposalRecord::HOT) continue;
+            Proposal p{r.to, r.value, r.data, nonce, r.executed, r.approvals, ActionKind(r.action), r.param, 0};
+            if (r.action >= uint8_t(ActionKind::Count) || !parseParam(p.action, p.param, p.amount)) return false;
+            if (p.action == ActionKind::Multicall && !decodeMulticall(p.data, [](const Call&) {})) return false;
+            hot.push_back(std::move(p));
+        }
+
+        SignerSet restored;
+        for (size_t slot = 0; slot < slots.size(); ++slot)
+            if (!slots[slot].empty() && !restored.assign(uint32_t(slot), slots[slot])) return false;
+
+        // The archive first: if it cannot be written, nothing in memory has changed
+        for (const auto& [nonce, r] : records) {
+            size_t len;
+            if (r.state == ProposalRecord::ARCHIVED && !archive->find(nonce, len) &&
+                !archive->append(nonce, r.archived.data(), r.archived.size()))
+                return false;
+        }
+        if (governance) owners = restored;
+        size_t next = 0;
+        for (const auto& [nonce, r] : records) {
+            if (proposals.find(nonce)) {
+                unindexProposal(nonce);
+                proposals.erase(nonce);
+            }
+            if (r.state != ProposalRecord::HOT) continue;
+            const Proposal& p = proposals.insert(nonce, std::move(hot[next++]));
+            if (!governance && !p.executed) indexProposal(nonce, p);
+        }
+        threshold = uint32_t(newThreshold);
+        proposalNonce = newNonce;
+        if (governance) {
+            rebuildIndexes();
+            governanceTick = header.toTick;
+        }
+        dirtyProposals.restart(header.toTick + 1);
+        return true;
+    }
+
+    // Journal replay: a tick recorded by endTick(), on top of the restored snapshot.
+    // Ticks the snapshot already holds are skipped.
+    bool replayJournal(uint64_t tick, std::istream& in) {
+        if (tick < dirtyProposals.currentTick()) return true;
+        return applyDelta(in);
+    }
 };
 
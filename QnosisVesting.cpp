@@ -6,16 +6,29 @@
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <cassert>
+#include <istream>
+#include <ostream>
+#include "qstatedelta.hpp"
+#include "qsnapshot.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qsignerset.hpp"
+#include "qvestingstore.hpp"
+#include "qschedule.hpp"
+#include "qfixed.hpp"
+#include "qprobe.hpp"
+#include "qtick.hpp"
 
 // ---- Config ----
 static constexpr uint8_t MAX_SIGNERS = 10;
 static constexpr uint8_t THRESHOLD = 3; // Min signatures needed
 
 // ---- Qubic Qnosis Multisig State ----
-std::vector<std::string> signers;      // Public keys (or addresses) of multisig
-std::unordered_map<std::string, bool> isSigner; // Quick lookup
+SignerSet signers; // Public keys (or addresses) of multisig, one bitmap slot each
 
 // ---- ERC20-style token state ----
 std::unordered_map<std::string, uint64_t> balances;
@@ -30,60 +43,344 @@ struct Vesting {
     uint64_t claimedAmount;
     bool paused;
     bool cancelled;
+    VestingSchedule schedule;  // cliff/step/piecewise breakpoints; empty: linear from startTime over duration
+    bool autoClaim;            // unlocks are credited by the timer wheel without a claim call
+    uint64_t unlockedThrough;  // last unlock time handled by the timer wheel
 };
 
 std::unordered_map<std::string, Vesting> vestings;
 
-// ---- Events (pseudo, replace with real Qubic events/syscalls) ----
-void emitEvent(const std::string &event, const std::string &data) {
-    // Qubic: log or trigger event in your system.
+// Beneficiary -> ids of live (not cancelled) grants created since the snapshot;
+// grants already in the snapshot are listed by its GrantRow table
+std::unordered_map<std::string, std::vector<std::string>> grantsByBeneficiary;
+
+// ---- Dirty tracking (node catch-up via exportDelta/applyDelta) ----
+DirtyLog<std::string> dirtyBalances;
+DirtyLog<std::string> dirtyVestings;
+constexpr uint16_t DELTA_TABLE_BALANCES = 0;
+constexpr uint16_t DELTA_TABLE_VESTINGS = 1;
+
+void writeField(std::ostream &out, const Vesting &v) {
+    writeField(out, v.beneficiary);
+    writeField(out, v.totalAmount);
+    writeField(out, v.startTime);
+    writeField(out, v.duration);
+    writeField(out, v.claimedAmount);
+    writeField(out, v.paused);
+    writeField(out, v.cancelled);
+    const auto &points = v.schedule.breakpoints();
+    writeU64(out, points.size());
+    for (const auto &p : points) {
+        writeU64(out, p.time);
+        writeU64(out, p.amount);
+    }
+    writeField(out, v.autoClaim);
+    writeField(out, v.unlockedThrough);
+}
+bool readField(std::istream &in, Vesting &v) {
+    uint64_t n;
+    bool ok = readField(in, v.beneficiary) && readField(in, v.totalAmount) && readField(in, v.startTime)
+        && readField(in, v.duration) && readField(in, v.claimedAmount) && readField(in, v.paused)
+        && readField(in, v.cancelled) && readU64(in, n) && n <= (1u << 16);
+    if (!ok) return false;
+    std::vector<ScheduleBreakpoint> points(n);
+    for (auto &p : points)
+        if (!readU64(in, p.time) || !readU64(in, p.amount)) return false;
+    if (n && !VestingSchedule::valid(points)) return false;
+    v.schedule = VestingSchedule(std::move(points));
+    return readField(in, v.autoClaim) && readField(in, v.unlockedThrough);
+}
+
+// ---- Snapshot (mapped in place; rows fault into the maps on first access) ----
+constexpr uint32_t SNAPSHOT_TABLE_BALANCES = 0; // BalanceRow, sorted by address
+constexpr uint32_t SNAPSHOT_TABLE_VESTINGS = 1; // VestingRow, sorted by id
+constexpr uint32_t SNAPSHOT_TABLE_SIGNERS = 2;  // SignerRow, by slot (empty key = free slot)
+constexpr uint32_t SNAPSHOT_TABLE_GRANTS = 3;   // GrantRow, live grants sorted by (beneficiary, id)
+constexpr uint32_t SNAPSHOT_TABLE_SCHEDULES = 4; // ScheduleRow, one per VestingRow, same order
+constexpr uint32_t SNAPSHOT_TABLE_UNLOCKS = 5;  // UnlockRow, pending timer wheel entries
+constexpr size_t SNAPSHOT_SCALAR_TOTAL_SUPPLY = 0;
+constexpr size_t SNAPSHOT_SCALAR_UNLOCK_TIME = 1; // timer wheel time
+
+struct BalanceRow {
+    SnapshotStringRef key;
+    uint64_t balance;
+};
+struct VestingRow {
+    SnapshotStringRef key;
+    SnapshotStringRef beneficiary;
+    uint64_t totalAmount;
+    uint64_t startTime;
+    uint64_t duration;
+    uint64_t claimedAmount;
+    uint8_t paused;
+    uint8_t cancelled;
+    uint8_t reserved[6];
+};
+struct SignerRow {
+    SnapshotStringRef key;
+};
+struct GrantRow {
+    SnapshotStringRef key; // beneficiary
+    SnapshotStringRef id;
+};
+struct ScheduleRow {
+    SnapshotStringRef points; // raw ScheduleBreakpoint array, empty for linear grants
+    uint64_t unlockedThrough;
+    uint8_t autoClaim;
+    uint8_t reserved[7];
+};
+struct UnlockRow {
+    SnapshotStringRef key; // vesting id
+    uint64_t deadline;
+};
+
+SnapshotView snapshot;
+const BalanceRow *snapshotBalances = nullptr;
+size_t snapshotBalanceCount = 0;
+const VestingRow *snapshotVestings = nullptr;
+size_t snapshotVestingCount = 0;
+const GrantRow *snapshotGrants = nullptr;
+size_t snapshotGrantCount = 0;
+const ScheduleRow *snapshotSchedules = nullptr;
+size_t snapshotScheduleCount = 0; // 0 for snapshots taken before schedules existed
+
+VestingSchedule scheduleFromRow(const ScheduleRow &r) {
+    const char *p = snapshot.stringData(r.points);
+    std::vector<ScheduleBreakpoint> points(p ? size_t(r.points.length) / sizeof(ScheduleBreakpoint) : 0);
+    if (!points.empty()) memcpy(points.data(), p, points.size() * sizeof(ScheduleBreakpoint));
+    return VestingSchedule(std::move(points));
+}
+
+Vesting vestingFromRow(const VestingRow &r) {
+    Vesting v{snapshot.string(r.beneficiary), r.totalAmount, r.startTime, r.duration, r.claimedAmount,
+              r.paused != 0, r.cancelled != 0, VestingSchedule(), false, 0};
+    size_t i = size_t(&r - snapshotVestings);
+    if (i < snapshotScheduleCount) {
+        v.schedule = scheduleFromRow(snapshotSchedules[i]);
+        v.autoClaim = snapshotSchedules[i].autoClaim != 0;
+        v.unlockedThrough = snapshotSchedules[i].unlockedThrough;
+    }
+    return v;
+}
+
+// Read-only balance: overlay, else snapshot, else 0
+uint64_t readBalance(const std::string &addr) {
+    auto it = balances.find(addr);
+    if (it != balances.end()) return it->second;
+    const BalanceRow *row = snapshot.findByKey(snapshotBalances, snapshotBalanceCount, addr);
+    return row ? row->balance : 0;
+}
+
+// Mutable balance, faulted in from the snapshot on first touch
+uint64_t &balanceRef(const std::string &addr) {
+    auto it = balances.find(addr);
+    if (it != balances.end()) return it->second;
+    return balances.emplace(addr, readBalance(addr)).first->second;
+}
+
+// Vesting by id, faulted in from the snapshot on first touch; nullptr if none
+Vesting *findVesting(const std::string &id) {
+    auto it = vestings.find(id);
+    if (it != vestings.end()) return &it->second;
+    const VestingRow *row = snapshot.findByKey(snapshotVestings, snapshotVestingCount, id);
+    if (!row) return nullptr;
+    return &vestings.emplace(id, vestingFromRow(*row)).first->second;
+}
+
+// ---- Beneficiary index ----
+void indexGrant(const std::string &beneficiary, const std::string &id) {
+    grantsByBeneficiary[beneficiary].push_back(id);
+}
+
+// Drop a cancelled grant; snapshot-listed grants are filtered by their flag instead
+void unindexGrant(const std::string &beneficiary, const std::string &id) {
+    auto it = grantsByBeneficiary.find(beneficiary);
+    if (it == grantsByBeneficiary.end()) return;
+    auto &ids = it->second;
+    auto pos = std::find(ids.begin(), ids.end(), id);
+    if (pos == ids.end()) return;
+    *pos = ids.back();
+    ids.pop_back();
+    if (ids.empty()) grantsByBeneficiary.erase(it);
+}
+
+// Visit (id, vesting) for each live grant of a beneficiary: O(grants + log n)
+template <typename Visit>
+void forEachGrant(const std::string &beneficiary, Visit visit) {
+    size_t first, last;
+    snapshot.rangeByKey(snapshotGrants, snapshotGrantCount, beneficiary, first, last);
+    for (size_t i = first; i < last; ++i) {
+        std::string id = snapshot.string(snapshotGrants[i].id);
+        Vesting *v = findVesting(id);
+        if (v && !v->cancelled) visit(id, *v);
+    }
+    auto it = grantsByBeneficiary.find(beneficiary);
+    if (it == grantsByBeneficiary.end()) return;
+    for (const auto &id : it->second) visit(id, *findVesting(id));
+}
+
+// Ids of a beneficiary's live grants
+std::vector<std::string> vestingsOf(const std::string &beneficiary) {
+    std::vector<std::string> ids;
+    forEachGrant(beneficiary, [&ids](const std::string &id, const Vesting &) { ids.push_back(id); });
+    return ids;
+}
+
+// Amount vested by `now` under the grant's schedule (128-bit products, no overflow)
+uint64_t vestedAmount(const Vesting &v, uint64_t now) {
+    if (!v.schedule.empty()) return v.schedule.amountAt(now);
+    return linearVested(v.totalAmount, v.startTime, v.duration, now);
+}
+
+// Next unlock moment after t (a breakpoint where the vested amount grows), or UINT64_MAX
+uint64_t nextUnlock(const Vesting &v, uint64_t t) {
+    if (!v.schedule.empty()) return v.schedule.nextUnlockAfter(t);
+    uint64_t end = v.startTime + v.duration;
+    return (t < end && v.totalAmount > 0) ? end : UINT64_MAX;
+}
+
+// ---- Column store for reports (optional, see enableVestingColumns) ----
+VestingStore vestingColumns;
+std::unordered_map<std::string, uint32_t> vestingColumnRow; // id -> row
+bool vestingColumnsEnabled = false;
+
+uint8_t vestingFlags(bool paused, bool cancelled) {
+    return uint8_t((paused ? VESTING_PAUSED : 0) | (cancelled ? VESTING_CANCELLED : 0));
+}
+
+void syncVestingColumns(const std::string &id, const Vesting &v) {
+    auto it = vestingColumnRow.find(id);
+    uint8_t flags = vestingFlags(v.paused, v.cancelled);
+    if (it == vestingColumnRow.end())
+        vestingColumnRow.emplace(id, vestingColumns.append(v.startTime, v.duration, v.totalAmount, v.claimedAmount, flags, &v.schedule));
+    else
+        vestingColumns.set(it->second, v.startTime, v.duration, v.totalAmount, v.claimedAmount, flags, &v.schedule);
+}
+
+// Single write path for vesting records: dirty log, then the columns if enabled
+void vestingChanged(const std::string &id, const Vesting &v) {
+    dirtyVestings.markDirty(id);
+    if (vestingColumnsEnabled) syncVestingColumns(id, v);
+}
+
+// Build the column store from the snapshot and overlay (O(n)); kept in step afterwards
+void enableVestingColumns() {
+    vestingColumns.clear();
+    vestingColumnRow.clear();
+    vestingColumns.reserve(snapshotVestingCount + vestings.size());
+    vestingColumnRow.reserve(snapshotVestingCount + vestings.size());
+    for (size_t i = 0; i < snapshotVestingCount; ++i) {
+        const VestingRow &r = snapshotVestings[i];
+        std::string id = snapshot.string(r.key);
+        if (vestings.count(id)) continue; // overlay copy is newer
+        VestingSchedule schedule;
+        if (i < snapshotScheduleCount && snapshotSchedules[i].points.length) schedule = scheduleFromRow(snapshotSchedules[i]);
+        vestingColumnRow.emplace(std::move(id), vestingColumns.append(r.startTime, r.duration, r.totalAmount,
+            r.claimedAmount, vestingFlags(r.paused != 0, r.cancelled != 0), &schedule));
+    }
+    for (const auto &e : vestings) syncVestingColumns(e.first, e.second);
+    vestingColumnsEnabled = true;
+}
+
+void disableVestingColumns() {
+    vestingColumnsEnabled = false;
+    vestingColumns.clear();
+    vestingColumnRow.clear();
+}
+
+// Treasury report at time t over every grant (requires enableVestingColumns)
+VestingTotals vestingTotalsAt(uint64_t t) {
+    assert(vestingColumnsEnabled);
+    return vestingColumns.totalsAt(t);
+}
+
+// ---- Unlock timers: each live grant has one pending timer, at its next unlock ----
+TimerWheel<std::string> unlockWheel;
+
+void scheduleUnlock(const std::string &id, const Vesting &v) {
+    if (v.cancelled) return;
+    uint64_t at = nextUnlock(v, v.unlockedThrough);
+    if (at != UINT64_MAX) unlockWheel.schedule(at, id);
+}
+
+// Timer callback: announce what is claimable at `now` (crediting it for autoClaim
+// grants), then arm the grant's next unlock. Stale and duplicate timers are no-ops.
+// A paused grant's timer stops without handling its unlock; unpauseVesting re-arms
+// it, and the first fire after that covers every unlock passed in between.
+void fireUnlock(uint64_t at, const std::string &id, uint64_t now) {
+    Vesting *found = findVesting(id);
+    if (!found || found->cancelled || found->paused || at <= found->unlockedThrough) return;
+    Vesting &v = *found;
+    v.unlockedThrough = at;
+    for (uint64_t next = nextUnlock(v, at); next <= now; next = nextUnlock(v, next)) v.unlockedThrough = next;
+    uint64_t claimable = vestedAmount(v, now) - v.claimedAmount;
+    if (claimable > 0) {
+        emitEvent(EventContract::QNOSIS_VESTING, EventType::VestingUnlocked, id, v.beneficiary, claimable, at);
+        if (v.autoClaim) {
+            v.claimedAmount += claimable;
+            balanceRef(v.beneficiary) += claimable;
+            dirtyBalances.markDirty(v.beneficiary);
+            emitEvent(EventContract::QNOSIS_VESTING, EventType::ClaimVesting, id, v.beneficiary, claimable);
+        }
+    }
+    vestingChanged(id, v);
+    scheduleUnlock(id, v);
+}
+
+// ---- Qnosis: Check Multisig Proof (threshold signatures) ----
+// Distinct signers are OR-ed into a slot bitmap: no allocation, duplicates count once
+bool isAuthorized(const std::vector<std::string> &proof) {
+    return popcount64(signers.maskOf(proof)) >= THRESHOLD;
 }
 
 // ---- Qnosis: Add signer (only contract deployer or Qnosis group) ----
 void addSigner(const std::string &newSigner, const std::vector<std::string> &multisigProof) {
+    QPROBE(probe, "vesting.addSigner");
     assert(signers.size() < MAX_SIGNERS);
     assert(isAuthorized(multisigProof));
-    signers.push_back(newSigner);
-    isSigner[newSigner] = true;
-    emitEvent("AddSigner", newSigner);
+    int slot = signers.add(newSigner);
+    assert(slot >= 0); // not already a signer
+    (void)slot;
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::AddSigner, newSigner);
 }
 
 // ---- Qnosis: Remove signer ----
 void removeSigner(const std::string &oldSigner, const std::vector<std::string> &multisigProof) {
-    assert(isSigner[oldSigner]);
+    QPROBE(probe, "vesting.removeSigner");
+    assert(signers.contains(oldSigner));
     assert(isAuthorized(multisigProof));
-    for (auto it = signers.begin(); it != signers.end(); ++it) {
-        if (*it == oldSigner) {
-            signers.erase(it);
-            break;
-        }
-    }
-    isSigner[oldSigner] = false;
-    emitEvent("RemoveSigner", oldSigner);
-}
-
-// ---- Qnosis: Check Multisig Proof (threshold signatures) ----
-bool isAuthorized(const std::vector<std::string> &proof) {
-    uint8_t valid = 0;
-    std::unordered_map<std::string, bool> seen;
-    for (const auto &sig : proof) {
-        if (isSigner[sig] && !seen[sig]) {
-            valid++;
-            seen[sig] = true;
-        }
-    }
-    return valid >= THRESHOLD;
+    signers.remove(oldSigner);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::RemoveSigner, oldSigner);
 }
 
 // ---- Mint Tokens (for Vesting) ----
 void mint(const std::string &to, uint64_t amount, const std::vector<std::string> &multisigProof) {
+    QPROBE(probe, "vesting.mint");
     assert(isAuthorized(multisigProof));
-    balances[to] += amount;
-    totalSupply += amount;
-    emitEvent("Mint", to);
+    uint64_t newSupply, newBalance;
+    bool fits = checkedAdd(totalSupply, amount, newSupply) && checkedAdd(balanceRef(to), amount, newBalance);
+    assert(fits);
+    (void)fits;
+    balanceRef(to) = newBalance;
+    totalSupply = newSupply;
+    dirtyBalances.markDirty(to);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::Mint, to, EventKeyRef(), amount);
 }
 
 // ---- Create Vesting ----
+// Lock the beneficiary's tokens into a new grant and arm its first unlock
+void openVesting(const std::string &id, const Vesting &v) {
+    assert(balanceRef(v.beneficiary) >= v.totalAmount);
+    assert(findVesting(id) == nullptr); // Unique vesting ID
+    vestings[id] = v;
+    indexGrant(v.beneficiary, id);
+    balanceRef(v.beneficiary) -= v.totalAmount; // Lock tokens for vesting
+    vestingChanged(id, v);
+    dirtyBalances.markDirty(v.beneficiary);
+    scheduleUnlock(id, v);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::CreateVesting, id, v.beneficiary, v.totalAmount);
+}
+
 void createVesting(
     const std::string &id,
     const std::string &beneficiary,
@@ -92,53 +389,288 @@ void createVesting(
     uint64_t duration,
     const std::vector<std::string> &multisigProof
 ) {
+    QPROBE(probe, "vesting.createVesting");
     assert(isAuthorized(multisigProof));
-    assert(balances[beneficiary] >= totalAmount);
-    assert(vestings.count(id) == 0); // Unique vesting ID
-    Vesting v = {beneficiary, totalAmount, startTime, duration, 0, false, false};
-    vestings[id] = v;
-    balances[beneficiary] -= totalAmount; // Lock tokens for vesting
-    emitEvent("CreateVesting", id);
+    openVesting(id, Vesting{beneficiary, totalAmount, startTime, duration, 0, false, false, VestingSchedule(), false, 0});
+}
+
+// ---- Create Scheduled Vesting (cliff, steps or piecewise; see qschedule.hpp) ----
+// The grant locks the schedule's final amount; with autoClaim, each unlock is
+// credited at the tick it passes instead of waiting for a claim
+void createScheduledVesting(
+    const std::string &id,
+    const std::string &beneficiary,
+    const VestingSchedule &schedule,
+    bool autoClaim,
+    const std::vector<std::string> &multisigProof
+) {
+    QPROBE(probe, "vesting.createScheduledVesting");
+    assert(isAuthorized(multisigProof));
+    assert(VestingSchedule::valid(schedule.breakpoints()));
+    openVesting(id, Vesting{beneficiary, schedule.total(), schedule.start(), schedule.end() - schedule.start(), 0,
+                            false, false, schedule, autoClaim, 0});
 }
 
 // ---- Claim Vesting ----
 void claimVesting(const std::string &id, const std::string &caller) {
-    assert(vestings.count(id));
-    Vesting &v = vestings[id];
+    QPROBE(probe, "vesting.claimVesting");
+    assert(findVesting(id));
+    Vesting &v = *findVesting(id);
     assert(v.beneficiary == caller);
     assert(!v.paused && !v.cancelled);
-    uint64_t now = getCurrentTimestamp(); // Qubic syscall to get block time
-    uint64_t elapsed = (now > v.startTime) ? now - v.startTime : 0;
-    uint64_t vested = (elapsed >= v.duration) ? v.totalAmount : (v.totalAmount * elapsed / v.duration);
-    uint64_t claimable = vested - v.claimedAmount;
+    uint64_t now = tickTimestamp(); // block time, cached once per tick
+    uint64_t claimable = vestedAmount(v, now) - v.claimedAmount;
     assert(claimable > 0);
     v.claimedAmount += claimable;
-    balances[caller] += claimable;
-    emitEvent("ClaimVesting", id);
+    balanceRef(caller) += claimable;
+    vestingChanged(id, v);
+    dirtyBalances.markDirty(caller);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::ClaimVesting, id, caller, claimable);
+}
+
+// ---- Claim All: every claimable grant of the caller, one balance update ----
+// Paused grants are skipped; returns the total credited (0 if nothing was due)
+uint64_t claimAll(const std::string &caller) {
+    QPROBE(probe, "vesting.claimAll");
+    uint64_t now = tickTimestamp();
+    uint64_t total = 0;
+    forEachGrant(caller, [&](const std::string &id, Vesting &v) {
+        if (v.paused) return;
+        uint64_t claimable = vestedAmount(v, now) - v.claimedAmount;
+        if (claimable == 0) return;
+        v.claimedAmount += claimable;
+        total += claimable;
+        vestingChanged(id, v);
+        emitEvent(EventContract::QNOSIS_VESTING, EventType::ClaimVesting, id, caller, claimable);
+    });
+    if (total == 0) return QPROBE_REJECT(probe, 0);
+    balanceRef(caller) += total;
+    dirtyBalances.markDirty(caller);
+    return total;
 }
 
 // ---- Pause/Unpause/Cancellation (Qnosis only) ----
 void pauseVesting(const std::string &id, const std::vector<std::string> &multisigProof) {
+    QPROBE(probe, "vesting.pauseVesting");
     assert(isAuthorized(multisigProof));
-    assert(vestings.count(id));
-    vestings[id].paused = true;
-    emitEvent("PauseVesting", id);
+    assert(findVesting(id));
+    Vesting &v = *findVesting(id);
+    v.paused = true;
+    vestingChanged(id, v);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::PauseVesting, id);
 }
 void unpauseVesting(const std::string &id, const std::vector<std::string> &multisigProof) {
+    QPROBE(probe, "vesting.unpauseVesting");
     assert(isAuthorized(multisigProof));
-    assert(vestings.count(id));
-    vestings[id].paused = false;
-    emitEvent("UnpauseVesting", id);
+    assert(findVesting(id));
+    Vesting &v = *findVesting(id);
+    v.paused = false;
+    vestingChanged(id, v);
+    scheduleUnlock(id, v); // the timer stopped at the first unlock while paused
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::UnpauseVesting, id);
 }
 void cancelVesting(const std::string &id, const std::vector<std::string> &multisigProof) {
+    QPROBE(probe, "vesting.cancelVesting");
     assert(isAuthorized(multisigProof));
-    assert(vestings.count(id));
-    vestings[id].cancelled = true;
-    emitEvent("CancelVesting", id);
+    assert(findVesting(id));
+    Vesting &v = *findVesting(id);
+    if (!v.cancelled) unindexGrant(v.beneficiary, id);
+    v.cancelled = true;
+    vestingChanged(id, v);
+    emitEvent(EventContract::QNOSIS_VESTING, EventType::CancelVesting, id);
+}
+
+bool exportDelta(uint64_t fromTick, std::ostream &out);
+
+// ---- Tick boundary: fire due unlocks, journal the tick, then close the dirty sets ----
+void endTick() {
+    QPROBE(probe, "vesting.endTick");
+    uint64_t now = tickTimestamp();
+    unlockWheel.advance(now, [now](uint64_t at, const std::string &id) { fireUnlock(at, id, now); });
+    uint64_t tick = dirtyBalances.currentTick();
+    journal().record(EventContract::QNOSIS_VESTING, JournalRecord::Delta, tick,
+                     [tick](std::ostream &out) { exportDelta(tick, out); });
+    dirtyBalances.endTick();
+    dirtyVestings.endTick();
+}
+
+// ---- Delta export: balances, then vestings, then totalSupply ----
+// False if fromTick is outside the retained window (use a full snapshot instead)
+bool exportDelta(uint64_t fromTick, std::ostream &out) {
+    bool ok = dirtyBalances.exportDelta<uint64_t>(fromTick, DELTA_TABLE_BALANCES, out,
+        [](const std::string &addr, uint64_t &amount) { amount = readBalance(addr); });
+    ok = ok && dirtyVestings.exportDelta<Vesting>(fromTick, DELTA_TABLE_VESTINGS, out,
+        [](const std::string &id, Vesting &v) { v = *findVesting(id); });
+    if (!ok) return false;
+    writeU64(out, totalSupply);
+    return bool(out);
+}
+
+// ---- Delta apply (peer catch-up) ----
+// The delta must start at the open tick. Every section is read before any state
+// changes; the dirty logs then continue after the delta's last tick.
+bool applyDelta(std::istream &in) {
+    DeltaHeader balancesHeader, vestingsHeader;
+    std::vector<std::pair<std::string, uint64_t>> balanceRecords;
+    std::vector<std::pair<std::string, Vesting>> vestingRecords;
+    uint64_t supply;
+    if (!readDelta(in, DELTA_TABLE_BALANCES, balancesHeader, balanceRecords) ||
+        !readDelta(in, DELTA_TABLE_VESTINGS, vestingsHeader, vestingRecords) || !readU64(in, supply))
+        return false;
+    if (balancesHeader.fromTick != dirtyBalances.currentTick() || !sameDeltaRange(balancesHeader, vestingsHeader))
+        return false;
+
+    for (const auto &r : balanceRecords) balances[r.first] = r.second;
+    for (const auto &r : vestingRecords) {
+        const std::string &id = r.first;
+        const Vesting &v = r.second;
+        // Grants from the snapshot stay listed by its grant table
+        if (!snapshot.findByKey(snapshotVestings, snapshotVestingCount, id)) {
+            auto old = vestings.find(id);
+            if (old != vestings.end() && !old->second.cancelled) unindexGrant(old->second.beneficiary, id);
+            if (!v.cancelled) indexGrant(v.beneficiary, id);
+        }
+        vestings[id] = v;
+        vestingChanged(id, v);
+        scheduleUnlock(id, v); // duplicates of a live timer are ignored when they fire
+    }
+    totalSupply = supply;
+    dirtyBalances.restart(balancesHeader.toTick + 1);
+    dirtyVestings.restart(balancesHeader.toTick + 1);
+    return true;
 }
 
-// ---- Util: Qubic timestamp syscall stub ----
-uint64_t getCurrentTimestamp() {
-    // TODO: Replace with Qubic system call for block timestamp
-    return 0;
+// ---- Journal replay: a tick recorded by endTick(), on top of the restored snapshot ----
+// Ticks the snapshot already holds are skipped; unlocks re-arm through applyDelta
+bool replayJournal(uint64_t tick, std::istream &in) {
+    if (tick < dirtyBalances.currentTick()) return true;
+    return applyDelta(in);
+}
+
+// ---- Snapshot save: overlay merged over the mapped base, sorted by key ----
+template <typename Map, typename Row, typename FromEntry, typename FromRow>
+void writeMergedTable(SnapshotWriter &w, uint32_t table, const Map &overlay, const Row *base, size_t baseCount,
+                      FromEntry fromEntry, FromRow fromRow) {
+    std::vector<const typename Map::value_type *> entries;
+    entries.reserve(overlay.size());
+    for (const auto &e : overlay) entries.push_back(&e);
+    std::sort(entries.begin(), entries.end(), [](const auto *a, const auto *b) { return a->first < b->first; });
+    w.beginTable(table, sizeof(Row));
+    size_t i = 0, j = 0;
+    while (i < entries.size() || j < baseCount) {
+        int c = i == entries.size() ? 1 : j == baseCount ? -1 : -snapshot.compare(base[j].key, entries[i]->first);
+        if (c <= 0) {
+            w.appendRow(fromEntry(w, *entries[i++]));
+            if (c == 0) ++j; // overlay shadows the base row
+        } else {
+            w.appendRow(fromRow(w, base[j++]));
+        }
+    }
+    w.endTable();
+}
+
+bool saveSnapshot(const std::string &path) {
+    SnapshotWriter w(path);
+    writeMergedTable(w, SNAPSHOT_TABLE_BALANCES, balances, snapshotBalances, snapshotBalanceCount,
+        [](SnapshotWriter &w, const std::pair<const std::string, uint64_t> &e) {
+            return BalanceRow{w.addString(e.first), e.second};
+        },
+        [](SnapshotWriter &w, const BalanceRow &r) {
+            return BalanceRow{w.addString(snapshot.string(r.key)), r.balance};
+        });
+    std::vector<ScheduleRow> scheduleRows; // written after the vesting table, row for row
+    auto makeVestingRow = [&scheduleRows](SnapshotWriter &w, const std::string &id, const Vesting &v) {
+        const auto &points = v.schedule.breakpoints();
+        ScheduleRow sched = {};
+        sched.points = w.addString(std::string(reinterpret_cast<const char *>(points.data()),
+                                               points.size() * sizeof(ScheduleBreakpoint)));
+        sched.unlockedThrough = v.unlockedThrough;
+        sched.autoClaim = v.autoClaim;
+        scheduleRows.push_back(sched);
+        VestingRow row = {};
+        row.key = w.addString(id);
+        row.beneficiary = w.addString(v.beneficiary);
+        row.totalAmount = v.totalAmount;
+        row.startTime = v.startTime;
+        row.duration = v.duration;
+        row.claimedAmount = v.claimedAmount;
+        row.paused = v.paused;
+        row.cancelled = v.cancelled;
+        return row;
+    };
+    writeMergedTable(w, SNAPSHOT_TABLE_VESTINGS, vestings, snapshotVestings, snapshotVestingCount,
+        [&](SnapshotWriter &w, const std::pair<const std::string, Vesting> &e) { return makeVestingRow(w, e.first, e.second); },
+        [&](SnapshotWriter &w, const VestingRow &r) { return makeVestingRow(w, snapshot.string(r.key), vestingFromRow(r)); });
+    w.beginTable(SNAPSHOT_TABLE_SCHEDULES, sizeof(ScheduleRow));
+    for (const auto &row : scheduleRows) w.appendRow(row);
+    w.endTable();
+    w.beginTable(SNAPSHOT_TABLE_UNLOCKS, sizeof(UnlockRow));
+    unlockWheel.forEach([&w](uint64_t deadline, const std::string &id) { w.appendRow(UnlockRow{w.addString(id), deadline}); });
+    w.endTable();
+    // Live grants: the base table minus grants cancelled since, merged with the overlay index
+    std::vector<std::pair<const std::string *, const std::string *>> added; // (beneficiary, id)
+    for (const auto &e : grantsByBeneficiary)
+        for (const auto &id : e.second) added.emplace_back(&e.first, &id);
+    std::sort(added.begin(), added.end(), [](const auto &a, const auto &b) {
+        return *a.first != *b.first ? *a.first < *b.first : *a.second < *b.second;
+    });
+    auto baseLive = [](const GrantRow &r) {
+        std::string id = snapshot.string(r.id);
+        auto it = vestings.find(id);
+        return it == vestings.end() || !it->second.cancelled;
+    };
+    auto baseFirst = [](const GrantRow &r, const std::string &beneficiary, const std::string &id) {
+        int c = snapshot.compare(r.key, beneficiary);
+        return c != 0 ? c < 0 : snapshot.compare(r.id, id) < 0;
+    };
+    w.beginTable(SNAPSHOT_TABLE_GRANTS, sizeof(GrantRow));
+    for (size_t i = 0, j = 0; i < added.size() || j < snapshotGrantCount;) {
+        if (j < snapshotGrantCount && (i == added.size() || baseFirst(snapshotGrants[j], *added[i].first, *added[i].second))) {
+            const GrantRow &r = snapshotGrants[j++];
+            if (baseLive(r)) w.appendRow(GrantRow{w.addString(snapshot.string(r.key)), w.addString(snapshot.string(r.id))});
+        } else {
+            w.appendRow(GrantRow{w.addString(*added[i].first), w.addString(*added[i].second)});
+            ++i;
+        }
+    }
+    w.endTable();
+    w.beginTable(SNAPSHOT_TABLE_SIGNERS, sizeof(SignerRow));
+    for (uint32_t slot = 0; slot < signers.slotSpan(); ++slot) w.appendRow(SignerRow{w.addString(signers.at(slot))});
+    w.endTable();
+    w.setScalar(SNAPSHOT_SCALAR_TOTAL_SUPPLY, totalSupply);
+    w.setScalar(SNAPSHOT_SCALAR_UNLOCK_TIME, unlockWheel.current());
+    return w.finish(dirtyBalances.currentTick());
+}
+
+// Same, from a forked copy-on-write child at a tick boundary
+pid_t saveSnapshotInBackground(const std::string &path) {
+    return snapshotInBackground([&path] { return saveSnapshot(path); });
+}
+
+// ---- Snapshot load: checksum, then map in place; O(signers + pending unlocks) beyond that ----
+bool loadSnapshot(const std::string &path) {
+    if (!snapshot.open(path, true)) return false;
+    snapshotBalances = snapshot.table<BalanceRow>(SNAPSHOT_TABLE_BALANCES, snapshotBalanceCount);
+    snapshotVestings = snapshot.table<VestingRow>(SNAPSHOT_TABLE_VESTINGS, snapshotVestingCount);
+    snapshotGrants = snapshot.table<GrantRow>(SNAPSHOT_TABLE_GRANTS, snapshotGrantCount);
+    snapshotSchedules = snapshot.table<ScheduleRow>(SNAPSHOT_TABLE_SCHEDULES, snapshotScheduleCount);
+    if (snapshotScheduleCount != snapshotVestingCount) snapshotScheduleCount = 0;
+    balances.clear();
+    vestings.clear();
+    grantsByBeneficiary.clear();
+    signers.clear();
+    size_t n;
+    const SignerRow *rows = snapshot.table<SignerRow>(SNAPSHOT_TABLE_SIGNERS, n);
+    for (size_t i = 0; i < n && i < SIGNER_SET_CAPACITY; ++i) {
+        std::string key = snapshot.string(rows[i].key);
+        if (!key.empty()) signers.assign(uint32_t(i), key);
+    }
+    totalSupply = snapshot.scalar(SNAPSHOT_SCALAR_TOTAL_SUPPLY);
+    unlockWheel.clear(snapshot.scalar(SNAPSHOT_SCALAR_UNLOCK_TIME));
+    const UnlockRow *unlocks = snapshot.table<UnlockRow>(SNAPSHOT_TABLE_UNLOCKS, n);
+    for (size_t i = 0; i < n; ++i) unlockWheel.schedule(unlocks[i].deadline, snapshot.string(unlocks[i].key));
+    dirtyBalances.restart(snapshot.tick());
+    dirtyVestings.restart(snapshot.tick());
+    if (vestingColumnsEnabled) enableVestingColumns();
+    return true;
 }
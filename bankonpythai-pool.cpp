@@ -0,0 +1,384 @@
+/*
+ * BANKONPYTHAI Pool – cBTC/STX pool and oracle-priced swap (port of bankonpythai-pool.clar)
+ * Swaps fill at the QOracle price with exact 128-bit math; LPs hold pool shares
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "qoracle.hpp"
+#include "qevents.hpp"
+#include "qfixed.hpp"
+#include "qprobe.hpp"
+
+// ====== Units and Feeds ======
+constexpr uint64_t SATS_PER_BTC = QbtcAmount::unit;   // cBTC has 8 decimals
+constexpr uint64_t USTX_PER_STX = StxAmount::unit;    // STX has 6 decimals
+constexpr uint64_t POOL_MAX_PRICE_AGE = 600;      // seconds
+const std::string POOL_STX_FEED = "STX/USD";
+const std::string POOL_BTC_FEED = "BTC/USD";
+
+// ====== Error Codes ======
+// Same numbers as the Clarity contract where one exists; its (err u0) for a
+// non-authority mint is ERR_NOT_AUTHORITY here, since 0 means success.
+enum PoolError : uint32_t {
+    POOL_OK = 0,
+    ERR_NOT_AUTHORITY = 1,
+    ERR_NOT_SENDER = 4,
+    ERR_ZERO_LIQUIDITY = 10,
+    ERR_INSUFFICIENT_LP_CBTC = 11,
+    ERR_INSUFFICIENT_LP_STX = 12,
+    ERR_ZERO_STX_IN = 20,
+    ERR_ZERO_CBTC_OUT = 21,
+    ERR_PRICE_UNAVAILABLE = 30,   // feed missing, stale, zero or on different scales
+    ERR_INSUFFICIENT_FUNDS = 31,  // caller cannot pay (ft-transfer?/stx-transfer? failure)
+    ERR_POOL_CBTC = 32,           // pool holds less cBTC than the swap pays out
+    ERR_OVERFLOW = 33,
+    ERR_SLIPPAGE = 34,            // fill below the order's minimum
+};
+
+// (ok { amount, new-total }) or (err code)
+struct PoolResult {
+    uint32_t error;
+    uint64_t amount;
+    uint64_t total;
+};
+
+// Per-LP view, as in liquidity-providers-balances
+struct LiquidityBalance {
+    uint64_t cbtcBalance;
+    uint64_t stxBalance;
+};
+
+struct SwapOrder {
+    std::string trader;
+    uint64_t stxIn;
+    uint64_t minCbtcOut;   // 0 accepts any non-zero fill
+};
+
+struct SwapFill {
+    uint32_t error;
+    uint64_t cbtcSatsOut;
+};
+
+// One oracle read, used for every fill it prices
+struct PoolPrice {
+    uint64_t stx;
+    uint64_t btc;
+    uint32_t error;
+};
+
+// ====== Exact Math ======
+// cBTC sats for stxIn micro-STX: stx-in * stx-price * 1e8 / (btc-price * 1e6),
+// exact in 128 bits (see convertAt in qfixed.hpp). The Clarity swap computes
+// stx-in * btc-price * 1e8 / stx-price, which has the prices inverted (it would
+// pay out BTC/STX squared times too much). Both feeds share one scale.
+inline bool cbtcSatsOut(uint64_t stxIn, uint64_t stxPrice, uint64_t btcPrice, uint64_t& out) {
+    QbtcAmount sats;
+    if (!convertAt<QbtcAmount::decimals>(StxAmount(stxIn), FeedPrice(stxPrice), FeedPrice(btcPrice), sats)) return false;
+    out = sats.raw;
+    return true;
+}
+
+// Sats worth of stx micro-STX, rounded up when the pool is the one being paid
+inline bool stxValueSats(uint64_t stx, uint64_t stxPrice, uint64_t btcPrice, bool roundUp, uint64_t& out) {
+    QbtcAmount sats;
+    if (!convertAt<QbtcAmount::decimals>(StxAmount(stx), FeedPrice(stxPrice), FeedPrice(btcPrice), sats,
+                                         roundUp ? Rounding::Up : Rounding::Down))
+        return false;
+    out = sats.raw;
+    return true;
+}
+
+// ====== Pool ======
+// cBTC is a SIP-010-style token minted by the authority; STX is the chain's
+// native coin and is modelled as a plain ledger credited with depositStx().
+// Liquidity is cBTC; swaps pay cBTC out of the pool for STX in, at the oracle
+// price with no fee. LP shares are a transferable token over both reserves, so
+// STX paid in by traders accrues to LPs pro rata.
+class BankonPythaiPool {
+private:
+    const QOracle& oracle;
+    std::string authority;
+
+    std::unordered_map<std::string, uint64_t> cbtcBalances;   // cBTC outside the pool
+    std::unordered_map<std::string, uint64_t> stxBalances;    // native STX stand-in
+    std::unordered_map<std::string, uint64_t> lpShares;       // provider -> shares
+    uint64_t cbtcSupply = 0;
+    uint64_t cbtcReserve = 0;   // cBTC held by the pool
+    uint64_t stxReserve = 0;    // STX held by the pool
+    uint64_t totalShares = 0;
+
+    std::vector<SwapOrder> pending;   // queued for settleTick()
+
+    static uint64_t get(const std::unordered_map<std::string, uint64_t>& m, const std::string& k) {
+        auto it = m.find(k);
+        return it == m.end() ? 0 : it->second;
+    }
+
+    static void set(std::unordered_map<std::string, uint64_t>& m, const std::string& k, uint64_t v) {
+        if (v) m[k] = v;
+        else m.erase(k);
+    }
+
+    // Pool value in sats at price p, STX side rounded down
+    bool poolValue(const PoolPrice& p, uint64_t& out) const {
+        uint64_t stxSats;
+        if (!stxValueSats(stxReserve, p.stx, p.btc, false, stxSats)) return false;
+        return checkedAdd(cbtcReserve, stxSats, out);
+    }
+
+    // Shares to burn for `value` sats out of the pool, rounded up
+    bool sharesFor(uint64_t value, const PoolPrice& p, uint64_t& out) const {
+        uint64_t nav;
+        if (!poolValue(p, nav) || nav == 0) return false;
+        return mulDiv(value, totalShares, nav, out, Rounding::Up);
+    }
+
+    void burnShares(const std::string& provider, uint64_t shares) {
+        set(lpShares, provider, get(lpShares, provider) - shares);
+        totalShares -= shares;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::RemoveLiquidity, provider, EventKeyRef(), shares);
+    }
+
+    SwapFill fill(const SwapOrder& o, const PoolPrice& p) {
+        QPROBE(probe, "pool.swap");
+        if (o.stxIn == 0) return QPROBE_REJECT(probe, SwapFill{ERR_ZERO_STX_IN, 0});
+        if (p.error) return QPROBE_REJECT(probe, SwapFill{p.error, 0});
+        uint64_t out;
+        if (!cbtcSatsOut(o.stxIn, p.stx, p.btc, out)) return QPROBE_REJECT(probe, SwapFill{ERR_OVERFLOW, 0});
+        if (out == 0) return QPROBE_REJECT(probe, SwapFill{ERR_ZERO_CBTC_OUT, 0});
+        if (out < o.minCbtcOut) return QPROBE_REJECT(probe, SwapFill{ERR_SLIPPAGE, 0});
+        if (out > cbtcReserve) return QPROBE_REJECT(probe, SwapFill{ERR_POOL_CBTC, 0});
+        uint64_t stx = get(stxBalances, o.trader);
+        if (stx < o.stxIn) return QPROBE_REJECT(probe, SwapFill{ERR_INSUFFICIENT_FUNDS, 0});
+        uint64_t reserve;
+        if (!checkedAdd(stxReserve, o.stxIn, reserve)) return QPROBE_REJECT(probe, SwapFill{ERR_OVERFLOW, 0});
+        set(stxBalances, o.trader, stx - o.stxIn);
+        stxReserve = reserve;
+        cbtcReserve -= out;
+        cbtcBalances[o.trader] += out;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::Swap, o.trader, EventKeyRef(), out, o.stxIn);
+        return {POOL_OK, out};
+    }
+
+public:
+    BankonPythaiPool(const QOracle& priceOracle, const std::string& authorityAddr)
+        : oracle(priceOracle), authority(authorityAddr) {}
+
+    // Both feeds present, fresh, non-zero and on the same scale
+    PoolPrice readPrice() const {
+        PriceData s = oracle.getPrice(POOL_STX_FEED), b = oracle.getPrice(POOL_BTC_FEED);
+        if (!s.price || !b.price || s.decimals != b.decimals ||
+            !oracle.isPriceFresh(POOL_STX_FEED, POOL_MAX_PRICE_AGE) ||
+            !oracle.isPriceFresh(POOL_BTC_FEED, POOL_MAX_PRICE_AGE))
+            return {0, 0, ERR_PRICE_UNAVAILABLE};
+        return {s.price, b.price, POOL_OK};
+    }
+
+    // --- cBTC token (SIP-010) ---
+
+    PoolResult mint(uint64_t amount, const std::string& recipient, const std::string& sender) {
+        QPROBE(probe, "pool.mint");
+        if (sender != authority) return QPROBE_REJECT(probe, PoolResult{ERR_NOT_AUTHORITY, 0, 0});
+        uint64_t supply;
+        if (amount == 0 || !checkedAdd(cbtcSupply, amount, supply)) return QPROBE_REJECT(probe, PoolResult{ERR_OVERFLOW, 0, 0});
+        cbtcSupply = supply;
+        cbtcBalances[recipient] += amount;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::Mint, recipient, EventKeyRef(), amount);
+        return {POOL_OK, amount, cbtcSupply};
+    }
+
+    PoolResult burn(uint64_t amount, const std::string& owner, const std::string& sender) {
+        QPROBE(probe, "pool.burn");
+        if (sender != owner) return QPROBE_REJECT(probe, PoolResult{ERR_NOT_SENDER, 0, 0});
+        uint64_t bal = get(cbtcBalances, owner);
+        if (amount == 0 || bal < amount) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_FUNDS, 0, 0});
+        set(cbtcBalances, owner, bal - amount);
+        cbtcSupply -= amount;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::Burn, owner, EventKeyRef(), amount);
+        return {POOL_OK, amount, cbtcSupply};
+    }
+
+    PoolResult transfer(uint64_t amount, const std::string& from, const std::string& to, const std::string& sender) {
+        QPROBE(probe, "pool.transfer");
+        if (sender != from) return QPROBE_REJECT(probe, PoolResult{ERR_NOT_SENDER, 0, 0});
+        uint64_t bal = get(cbtcBalances, from);
+        if (amount == 0 || bal < amount) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_FUNDS, 0, 0});
+        set(cbtcBalances, from, bal - amount);
+        cbtcBalances[to] += amount;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::Transfer, from, to, amount);
+        return {POOL_OK, amount, get(cbtcBalances, to)};
+    }
+
+    uint64_t getBalance(const std::string& owner) const { return get(cbtcBalances, owner); }
+    uint64_t getTotalSupply() const { return cbtcSupply; }
+    static const char* getName() { return "cBTC"; }
+    static const char* getSymbol() { return "cBTC"; }
+    static uint8_t getDecimals() { return 8; }
+
+    // --- Native STX stand-in ---
+
+    void depositStx(const std::string& account, uint64_t amount) { stxBalances[account] += amount; }
+    uint64_t stxBalanceOf(const std::string& account) const { return get(stxBalances, account); }
+
+    // --- Liquidity ---
+
+    // Deposit cBTC for shares at the pool's current value. The first deposit sets
+    // one share per sat; later ones get value * totalShares / poolValue, rounded down.
+    PoolResult addCbtcLiquidity(const std::string& provider, uint64_t cbtcSatsIn) {
+        QPROBE(probe, "pool.addCbtcLiquidity");
+        if (cbtcSatsIn == 0) return QPROBE_REJECT(probe, PoolResult{ERR_ZERO_LIQUIDITY, 0, 0});
+        uint64_t bal = get(cbtcBalances, provider);
+        if (bal < cbtcSatsIn) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_FUNDS, 0, 0});
+        uint64_t shares = cbtcSatsIn;
+        if (totalShares) {
+            PoolPrice p = readPrice();
+            if (p.error) return QPROBE_REJECT(probe, PoolResult{p.error, 0, 0});
+            uint64_t nav;
+            if (!poolValue(p, nav) || !mulDiv(cbtcSatsIn, totalShares, nav, shares))
+                return QPROBE_REJECT(probe, PoolResult{ERR_OVERFLOW, 0, 0});
+            if (shares == 0) return QPROBE_REJECT(probe, PoolResult{ERR_ZERO_LIQUIDITY, 0, 0});
+        }
+        uint64_t reserve, sharesAfter;
+        if (!checkedAdd(cbtcReserve, cbtcSatsIn, reserve) || !checkedAdd(totalShares, shares, sharesAfter))
+            return QPROBE_REJECT(probe, PoolResult{ERR_OVERFLOW, 0, 0});
+        set(cbtcBalances, provider, bal - cbtcSatsIn);
+        cbtcReserve = reserve;
+        totalShares = sharesAfter;
+        lpShares[provider] += shares;
+        emitEvent(EventContract::BANKONPYTHAI_POOL, EventType::AddLiquidity, provider, EventKeyRef(), cbtcSatsIn, shares);
+        return {POOL_OK, cbtcSatsIn, liquidityProviderBalance(provider).cbtcBalance};
+    }
+
+    // Withdraw cBTC, burning the shares it is worth (rounded up)
+    PoolResult removeCbtcLiquidity(const std::string& provider, uint64_t cbtcSatsOut) {
+        QPROBE(probe, "pool.removeCbtcLiquidity");
+        if (cbtcSatsOut == 0) return QPROBE_REJECT(probe, PoolResult{ERR_ZERO_LIQUIDITY, 0, 0});
+        if (cbtcSatsOut > cbtcReserve) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_LP_CBTC, 0, 0});
+        PoolPrice p = readPrice();
+        if (p.error) return QPROBE_REJECT(probe, PoolResult{p.error, 0, 0});
+        uint64_t shares;
+        if (!sharesFor(cbtcSatsOut, p, shares) || shares > get(lpShares, provider))
+            return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_LP_CBTC, 0, 0});
+        burnShares(provider, shares);
+        cbtcReserve -= cbtcSatsOut;
+        cbtcBalances[provider] += cbtcSatsOut;
+        return {POOL_OK, cbtcSatsOut, liquidityProviderBalance(provider).cbtcBalance};
+    }
+
+    // Withdraw STX earned from swaps, burning the shares it is worth (rounded up)
+    PoolResult withdrawStx(const std::string& provider, uint64_t stxOut) {
+        QPROBE(probe, "pool.withdrawStx");
+        if (stxOut == 0) return QPROBE_REJECT(probe, PoolResult{ERR_ZERO_LIQUIDITY, 0, 0});
+        if (stxOut > stxReserve) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_LP_STX, 0, 0});
+        PoolPrice p = readPrice();
+        if (p.error) return QPROBE_REJECT(probe, PoolResult{p.error, 0, 0});
+        uint64_t value, shares;
+        if (!stxValueSats(stxOut, p.stx, p.btc, true, value) || !sharesFor(value, p, shares) ||
+            shares > get(lpShares, provider))
+            return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_LP_STX, 0, 0});
+        burnShares(provider, shares);
+        stxReserve -= stxOut;
+        stxBalances[provider] += stxOut;
+        return {POOL_OK, stxOut, liquidityProviderBalance(provider).stxBalance};
+    }
+
+    // Burn shares for their pro-rata cut of both reserves (no oracle needed)
+    PoolResult removeShares(const std::string& provider, uint64_t shares) {
+        QPROBE(probe, "pool.removeShares");
+        if (shares == 0 || shares > get(lpShares, provider)) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_LP_CBTC, 0, 0});
+        uint64_t cbtcOut = 0, stxOut = 0;
+        mulDiv(shares, cbtcReserve, totalShares, cbtcOut);
+        mulDiv(shares, stxReserve, totalShares, stxOut);
+        burnShares(provider, shares);
+        cbtcReserve -= cbtcOut;
+        stxReserve -= stxOut;
+        if (cbtcOut) cbtcBalances[provider] += cbtcOut;
+        if (stxOut) stxBalances[provider] += stxOut;
+        return {POOL_OK, cbtcOut, stxOut};
+    }
+
+    // Pro-rata claim on each reserve, as in liquidity-providers-balances
+    LiquidityBalance liquidityProviderBalance(const std::string& provider) const {
+        uint64_t shares = get(lpShares, provider), c = 0, s = 0;
+        if (shares) {
+            mulDiv(shares, cbtcReserve, totalShares, c);
+            mulDiv(shares, stxReserve, totalShares, s);
+        }
+        return {c, s};
+    }
+
+    // --- LP share token ---
+
+    PoolResult transferShares(uint64_t amount, const std::string& from, const std::string& to, const std::string& sender) {
+        QPROBE(probe, "pool.transferShares");
+        if (sender != from) return QPROBE_REJECT(probe, PoolResult{ERR_NOT_SENDER, 0, 0});
+        uint64_t bal = get(lpShares, from);
+        if (amount == 0 || bal < amount) return QPROBE_REJECT(probe, PoolResult{ERR_INSUFFICIENT_FUNDS, 0, 0});
+        set(lpShares, from, bal - amount);
+        lpShares[to] += amount;
+        return {POOL_OK, amount, get(lpShares, to)};
+    }
+
+    uint64_t sharesOf(const std::string& provider) const { return get(lpShares, provider); }
+    uint64_t getTotalShares() const { return totalShares; }
+    uint64_t getCbtcReserve() const { return cbtcReserve; }
+    uint64_t getStxReserve() const { return stxReserve; }
+
+    // --- Swaps ---
+
+    // Quote without state change
+    SwapFill quoteSwap(uint64_t stxIn) const {
+        QPROBE(probe, "pool.quoteSwap");
+        PoolPrice p = readPrice();
+        if (p.error) return {p.error, 0};
+        uint64_t out;
+        if (!cbtcSatsOut(stxIn, p.stx, p.btc, out)) return {ERR_OVERFLOW, 0};
+        return {out ? uint32_t(POOL_OK) : uint32_t(ERR_ZERO_CBTC_OUT), out};
+    }
+
+    // swap-stx: pay stxIn, receive cBTC at the oracle price
+    SwapFill swapStx(const std::string& trader, uint64_t stxIn, uint64_t minCbtcOut = 0) {
+        return fill({trader, stxIn, minCbtcOut}, readPrice());
+    }
+
+    // Fill orders in order at a single oracle read. Each order succeeds or fails
+    // on its own; a failed order changes nothing.
+    std::vector<SwapFill> swapBatch(const std::vector<SwapOrder>& orders) {
+        QPROBE(probe, "pool.swapBatch");
+        std::vector<SwapFill> fills;
+        fills.reserve(orders.size());
+        PoolPrice p = readPrice();
+        for (const auto& o : orders) fills.push_back(fill(o, p));
+        return fills;
+    }
+
+    // Queue for the end of the tick; settleTick() fills everything queued since
+    // the last call, in arrival order, at one price
+    void queueSwap(const std::string& trader, uint64_t stxIn, uint64_t minCbtcOut = 0) {
+        pending.push_back({trader, stxIn, minCbtcOut});
+    }
+
+    size_t pendingSwaps() const { return pending.size(); }
+
+    std::vector<SwapFill> settleTick() {
+        QPROBE(probe, "pool.settleTick");
+        std::vector<SwapFill> fills = swapBatch(pending);
+        pending.clear();
+        return fills;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
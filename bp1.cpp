@@ -33,7 +33,20 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 ****************************************************************/
 
 #include <cstdint>
+#include <cstring>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "qstatetree.hpp"
+#include "qstatedelta.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qcall.hpp"
+#include "qholders.hpp"
+#include "qfixed.hpp"
+#include "qprobe.hpp"
 
 /**
  * BANKON PYTHAI (BKPY)
@@ -45,28 +58,27 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
  */
 
 // -------------------- PARAMETERS --------------------
-constexpr uint64_t DECIMALS = 1000000000000000ULL;      // 15 decimals
+constexpr uint64_t DECIMALS = BkpyAmount::unit;        // 15 decimals
 constexpr uint64_t TOTAL_SUPPLY = 100000 * DECIMALS;    // 100,000.000000000000
 // ----------------------------------------------------
 
-// -------------- SAFE MATH LIBRARY -------------------
-inline bool safeAdd(uint64_t a, uint64_t b, uint64_t& result) {
-    result = a + b;
-    return result >= a;
-}
-
-inline bool safeSub(uint64_t a, uint64_t b, uint64_t& result) {
-    if (a < b) return false;
-    result = a - b;
-    return true;
-}
-// ----------------------------------------------------
-
 // -------------- CONTRACT DEFINITION -----------------
 class BANKON_PYTHAI {
-    std::unordered_map<uint64_t, uint64_t> balances;  // address (uint64_t) => balance
+    std::unordered_map<uint64_t, uint64_t, TableHash> balances; // address (uint64_t) => balance
     uint64_t admin;            // contract deployer, receives initial supply
     bool minted = false;       // supply can only be minted ONCE
+    BalanceMerkleTree<uint64_t> balanceTree; // state commitment, committed per tick
+    DirtyLog<uint64_t> dirtyBalances;        // addresses changed per tick, for catch-up
+    HolderIndex<uint64_t> holders;           // rank by balance + per-tick balance versions
+    static constexpr uint16_t DELTA_TABLE_BALANCES = 0;
+
+    // Single write path for balances: keeps state root and dirty set in step
+    void setBalance(uint64_t user, uint64_t newBal) {
+        balances[user] = newBal;
+        balanceTree.update(user, newBal);
+        holders.update(user, newBal, dirtyBalances.currentTick());
+        dirtyBalances.markDirty(user);
+    }
 
 public:
     // Constructor: set contract deployer as admin
@@ -77,8 +89,10 @@ public:
      * Returns true on success, false if already minted.
      */
     bool mint() {
-        if (minted) return false;
-        balances[admin] = TOTAL_SUPPLY;
+        QPROBE(probe, "bkpy.mint");
+        if (minted) return QPROBE_REJECT(probe, false);
+        setBalance(admin, TOTAL_SUPPLY);
+        emitEvent(EventContract::BKPY, EventType::Mint, admin, EventKeyRef(), TOTAL_SUPPLY);
         minted = true;
         return true;
     }
@@ -88,26 +102,103 @@ public:
      * Ensures atomic, overflow/underflow-safe transfer.
      */
     bool transfer(uint64_t from, uint64_t to, uint64_t amount) {
-        if (amount == 0) return false;
-        if (from == to) return false;
+        QPROBE(probe, "bkpy.transfer");
+        if (amount == 0) return QPROBE_REJECT(probe, false);
+        if (from == to) return QPROBE_REJECT(probe, false);
         uint64_t fromBal = balances[from];
         uint64_t newFromBal;
-        if (!safeSub(fromBal, amount, newFromBal)) return false;
+        if (!checkedSub(fromBal, amount, newFromBal)) return QPROBE_REJECT(probe, false);
         uint64_t newToBal;
-        if (!safeAdd(balances[to], amount, newToBal)) return false;
-        balances[from] = newFromBal;
-        balances[to]   = newToBal;
+        if (!checkedAdd(balances[to], amount, newToBal)) return QPROBE_REJECT(probe, false);
+        setBalance(from, newFromBal);
+        setBalance(to, newToBal);
+        emitEvent(EventContract::BKPY, EventType::Transfer, from, to, amount);
         return true;
     }
 
+    /**
+     * Cross-contract calls (qcall.hpp) against this instance. BKPY addresses are
+     * 64-bit: a 32-byte account id whose last 24 bytes are zero maps to its first
+     * 8 bytes. Any other id is refused, so the mapping stays one-to-one.
+     */
+    static bool callAddress(const uint8_t account[32], uint64_t& addr) {
+        for (int i = 8; i < 32; ++i)
+            if (account[i]) return false;
+        memcpy(&addr, account, sizeof(addr));
+        return true;
+    }
+
+    void bindCalls(CallBus& bus) {
+        bus.bind<CallTransferInput, CallTransferOutput>(EventContract::BKPY, CallProcedure::Transfer, this,
+            [](void* self, const uint8_t caller[32], const CallTransferInput& input, CallTransferOutput& output) {
+                uint64_t from, to;
+                output.ok = callAddress(caller, from) && callAddress(input.to, to)
+                            && static_cast<BANKON_PYTHAI*>(self)->transfer(from, to, input.amount);
+            });
+        bus.bind<CallBalanceInput, CallBalanceOutput>(EventContract::BKPY, CallProcedure::BalanceOf, this,
+            [](void* self, const uint8_t*, const CallBalanceInput& input, CallBalanceOutput& output) {
+                uint64_t user;
+                output.addressable = callAddress(input.account, user);
+                output.balance = output.addressable ? static_cast<BANKON_PYTHAI*>(self)->balanceOf(user) : 0;
+            });
+    }
+
     /**
      * Returns balance of an address.
      */
     uint64_t balanceOf(uint64_t user) const {
+        QPROBE(probe, "bkpy.balanceOf");
         auto it = balances.find(user);
         return it != balances.end() ? it->second : 0;
     }
 
+    /**
+     * Balance of an address as of the end of a past tick.
+     * Returns false if the tick is older than the history kept; `balance` is then
+     * as of the oldest answerable tick.
+     */
+    bool balanceOfAt(uint64_t user, uint64_t tick, uint64_t& balance) const {
+        QPROBE(probe, "bkpy.balanceOfAt");
+        return holders.balanceAt(user, tick, balance);
+    }
+
+    /**
+     * Rank of an address by balance (0 = largest holder).
+     * Returns false if the address holds nothing.
+     */
+    bool holderRank(uint64_t user, uint64_t& rank) const {
+        QPROBE(probe, "bkpy.holderRank");
+        return holders.rankOf(user, rank);
+    }
+
+    /**
+     * Largest `count` holders as (address, balance), in rank order.
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> topHolders(uint64_t count) const {
+        QPROBE(probe, "bkpy.topHolders");
+        std::vector<std::pair<uint64_t, uint64_t>> out;
+        holders.topHolders(count, [&out](uint64_t user, uint64_t bal) { out.emplace_back(user, bal); });
+        return out;
+    }
+
+    /**
+     * Largest `count` holders as of the end of a past tick, in rank order.
+     * Scans every address, so meant for snapshots such as airdrops. Returns false
+     * if the tick is older than the history kept.
+     */
+    bool topHoldersAt(uint64_t tick, uint64_t count, std::vector<std::pair<uint64_t, uint64_t>>& out) const {
+        QPROBE(probe, "bkpy.topHoldersAt");
+        out.clear();
+        return holders.topHoldersAt(tick, count, [&out](uint64_t user, uint64_t bal) { out.emplace_back(user, bal); });
+    }
+
+    /**
+     * Number of addresses with a non-zero balance.
+     */
+    uint64_t holderCount() const {
+        return holders.holders();
+    }
+
     /**
      * Returns total supply of BANKON PYTHAI token.
      */
@@ -115,6 +206,77 @@ public:
         return TOTAL_SUPPLY;
     }
 
+    /**
+     * End of tick: journal the touched balances, then fold them into the state root.
+     * Cost is O(k log n) for k accounts touched this tick.
+     */
+    const Hash256& endTick() {
+        QPROBE(probe, "bkpy.endTick");
+        uint64_t tick = dirtyBalances.currentTick();
+        journal().record(EventContract::BKPY, JournalRecord::Delta, tick,
+                         [this, tick](std::ostream& out) { exportDelta(tick, out); });
+        dirtyBalances.endTick();
+        holders.endTick(dirtyBalances.currentTick());
+        return balanceTree.commit();
+    }
+
+    /**
+     * Stream balances changed since fromTick (node catch-up).
+     * Returns false if fromTick is outside the retained window.
+     */
+    bool exportDelta(uint64_t fromTick, std::ostream& out) const {
+        return dirtyBalances.exportDelta<uint64_t>(fromTick, DELTA_TABLE_BALANCES, out,
+            [this](uint64_t user, uint64_t& bal) { bal = balanceOf(user); });
+    }
+
+    /**
+     * Apply a delta produced by exportDelta() on a peer.
+     * It must start at the open tick and is read in full before any balance
+     * changes; the dirty log then continues after the delta's last tick.
+     */
+    bool applyDelta(std::istream& in) {
+        DeltaHeader header;
+        std::vector<std::pair<uint64_t, uint64_t>> records;
+        if (!readDelta(in, DELTA_TABLE_BALANCES, header, records)) return false;
+        if (header.fromTick != dirtyBalances.currentTick()) return false;
+        dirtyBalances.restart(header.toTick);
+        for (const auto& r : records) setBalance(r.first, r.second);
+        if (!balances.empty()) minted = true;
+        dirtyBalances.restart(header.toTick + 1);
+        holders.endTick(header.toTick + 1);
+        return true;
+    }
+
+    /**
+     * Re-apply a tick journaled by endTick() (qjournal.hpp).
+     * Ticks the restored state already holds are skipped; the root is
+     * folded once, by endJournalReplay().
+     */
+    bool replayJournal(uint64_t tick, std::istream& in) {
+        if (tick < dirtyBalances.currentTick()) return true;
+        return applyDelta(in);
+    }
+
+    const Hash256& endJournalReplay() {
+        return balanceTree.commit();
+    }
+
+    /**
+     * State root as of the last committed tick.
+     */
+    const Hash256& stateRoot() const {
+        return balanceTree.root();
+    }
+
+    /**
+     * Balance with Merkle inclusion proof against stateRoot().
+     * Returns false if the address has no committed balance.
+     */
+    bool balanceOfWithProof(uint64_t user, BalanceProof& proof) const {
+        QPROBE(probe, "bkpy.balanceOfWithProof");
+        return balanceTree.prove(user, proof);
+    }
+
     // No admin withdrawal, mint, or burn after initial mint.
     // No approve/allowance logic; transfer only.
     // All logic strictly checked for math and security.
@@ -129,6 +291,7 @@ AUDIT/SECURITY NOTES:
 - No further admin, mint, or burn functions after deployment.
 - Transfers use safe add/sub to prevent overflow/underflow.
 - No reentrancy (no external call/approval logic).
+- Balances are committed to a Merkle root at each tick end; proofs are verifiable off-chain.
 - No privileged operations post-mint.
 - Full license and prohibition against military use are included.
 - All state and logic are fully transparent and documented.
@@ -14,6 +14,10 @@
 #include <array>
 #include <algorithm>
 #include <cstring>
+#include "qadmission.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qprobe.hpp"
 
 // ---- Configuration ----
 constexpr uint32_t NUM_ORACLES = 7;  // set at deployment
@@ -43,6 +47,7 @@ OracleUpdate lastUpdate;
 // Verify Ed25519 sig (pseudo-function; replace w/ Qubic's actual signature verify)
 bool verify_ed25519(
     const uint8_t pubkey[32], const uint8_t *msg, uint32_t msglen, const uint8_t sig[64]) {
+    QPROBE(probe, "codeislaw.verify_ed25519");
     // ... platform-specific implementation
     return true; // stub
 }
@@ -65,13 +70,16 @@ bool check_signers(const OracleUpdate& upd) {
     return true;
 }
 
-// ---- Core Function: Submit Oracle Value ----
-extern "C" int submit_update(
+// ---- Core Function: Verify and Apply an Oracle Value ----
+// Every cheap check runs before the first signature; `verifications` counts the
+// Ed25519 checks performed
+int check_and_apply(
     const uint64_t value,
     const uint32_t timestamp,
     const uint8_t signatures[NUM_ORACLES][64],
     const uint8_t signers[NUM_ORACLES],
-    const uint8_t count
+    const uint8_t count,
+    uint32_t &verifications
 ) {
     // Only accept new updates
     if (timestamp <= lastUpdate.timestamp)
@@ -100,6 +108,7 @@ extern "C" int submit_update(
     for (uint8_t i = 0; i < count; ++i) {
         uint8_t idx = signers[i];
         if (idx >= NUM_ORACLES) return -4;
+        ++verifications;
         if (!verify_ed25519(ORACLE_PUBKEYS[idx], msg, 12, signatures[i]))
             return -5; // sig fail
         memcpy(upd.signatures[i], signatures[i], 64);
@@ -107,11 +116,73 @@ extern "C" int submit_update(
 
     // Majority confirmed, update state
     lastUpdate = upd;
+    journal().record(EventContract::CODEISLAW_COMMITTEE, JournalRecord::Price, 0, [](std::ostream &out) {
+        out.write(reinterpret_cast<const char *>(&lastUpdate), sizeof(lastUpdate));
+    });
+    emitEvent(EventContract::CODEISLAW_COMMITTEE, EventType::PriceUpdate, EventKeyRef(), EventKeyRef(),
+              value, timestamp);
     return 0;
 }
 
+// ---- Submit an Update (Admission Control) ----
+// Relays submit under their identity; the host calls process_updates() once per tick
+// to verify them, proven relays first, within a fixed budget (qadmission.hpp).
+// check_and_apply() is reached only from that drain.
+struct QueuedUpdate {
+    uint64_t value;
+    uint32_t timestamp;
+    uint8_t count;
+    uint8_t signers[NUM_ORACLES];
+    uint8_t signatures[NUM_ORACLES][64];
+};
+
+AdmissionQueue<QueuedUpdate> admission;
+
+// Returns an AdmissionResult
+extern "C" int submit_update(
+    const uint8_t submitter[32],
+    const uint64_t value,
+    const uint32_t timestamp,
+    const uint8_t signatures[NUM_ORACLES][64],
+    const uint8_t signers[NUM_ORACLES],
+    const uint8_t count
+) {
+    QPROBE(probe, "codeislaw.submit_update");
+    if (count < MAJORITY || count > NUM_ORACLES)
+        return QPROBE_REJECT(probe, int(AdmissionResult::Malformed));
+    QueuedUpdate u = {};
+    u.value = value;
+    u.timestamp = timestamp;
+    u.count = count;
+    memcpy(u.signers, signers, count);
+    memcpy(u.signatures, signatures, size_t(count) * 64);
+    Hash256 id;
+    memcpy(id.data(), submitter, 32);
+    AdmissionResult result = admission.admit(id, u, count);
+    if (result != AdmissionResult::Queued) return QPROBE_REJECT(probe, int(result));
+    return int(result);
+}
+
+extern "C" AdmissionTickStats process_updates() {
+    QPROBE(probe, "codeislaw.process_updates");
+    return admission.drain([](const QueuedUpdate &u, uint32_t &verifications) {
+        int rc = check_and_apply(u.value, u.timestamp, u.signatures, u.signers, u.count, verifications);
+        if (rc == 0) return AdmissionOutcome::Accepted;
+        return rc == -1 ? AdmissionOutcome::Superseded : AdmissionOutcome::Rejected;
+    });
+}
+
+// ---- Journal Replay (qjournal.hpp): the update as accepted ----
+bool replay_journal(std::istream &in) {
+    OracleUpdate upd;
+    if (!in.read(reinterpret_cast<char *>(&upd), sizeof(upd))) return false;
+    if (upd.timestamp > lastUpdate.timestamp) lastUpdate = upd;
+    return true;
+}
+
 // ---- Core Function: Read Oracle Value ----
 extern "C" int read_oracle(uint64_t* value, uint32_t* timestamp) {
+    QPROBE(probe, "codeislaw.read_oracle");
     *value = lastUpdate.value;
     *timestamp = lastUpdate.timestamp;
     return 0;
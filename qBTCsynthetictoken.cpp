@@ -7,46 +7,184 @@
 #include <cstdint>
 #include <unordered_map>
 #include <string>
+#include <utility>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "qstatetree.hpp"
+#include "qstatedelta.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qcall.hpp"
+#include "qholders.hpp"
+#include "qfixed.hpp"
+#include "qprobe.hpp"
 
 // Token parameters
 constexpr uint64_t QBTC_TOTAL_SUPPLY = 2100000000000000; // 21M * 10^8 = 2,100,000,000,000,000 (satoshis)
-constexpr uint8_t QBTC_DECIMALS = 8;
+constexpr uint8_t QBTC_DECIMALS = QbtcAmount::decimals;
 const std::string QBTC_SYMBOL = "qBTC";
 const std::string QBTC_NAME = "Synthetic Bitcoin";
 
 // Storage for balances (address as string)
-std::unordered_map<std::string, uint64_t> balances;
+std::unordered_map<std::string, uint64_t, TableHash> balances;
+
+// Merkle commitment over balances, committed once per tick
+BalanceMerkleTree<std::string> balanceTree;
+
+// Addresses changed per tick, for delta catch-up of lagging nodes
+DirtyLog<std::string> dirtyBalances;
+constexpr uint16_t DELTA_TABLE_BALANCES = 0;
+
+// Holder ranking and per-tick balance versions
+HolderIndex<std::string> holders;
 
 // Track initial minting
 bool minted = false;
 
+// Single write path for balances: keeps state root and dirty set in step
+void setBalance(const std::string& addr, uint64_t amount) {
+    balances[addr] = amount;
+    balanceTree.update(addr, amount);
+    holders.update(addr, amount, dirtyBalances.currentTick());
+    dirtyBalances.markDirty(addr);
+}
+
 // Mint function – can only be called once, all tokens go to deployer
 bool mint(const std::string& deployer_addr) {
-    if (minted) return false;
-    balances[deployer_addr] = QBTC_TOTAL_SUPPLY;
+    QPROBE(probe, "qbtc.mint");
+    if (minted) return QPROBE_REJECT(probe, false);
+    setBalance(deployer_addr, QBTC_TOTAL_SUPPLY);
+    emitEvent(EventContract::QBTC, EventType::Mint, deployer_addr, EventKeyRef(), QBTC_TOTAL_SUPPLY);
     minted = true;
     return true;
 }
 
 // Transfer function – transfer tokens between users
 bool transfer(const std::string& from, const std::string& to, uint64_t amount) {
-    if (balances[from] < amount) return false;
-    if (amount == 0 || from == to) return false;
-    balances[from] -= amount;
-    balances[to] += amount;
+    QPROBE(probe, "qbtc.transfer");
+    uint64_t newFrom, newTo;
+    if (amount == 0 || from == to) return QPROBE_REJECT(probe, false);
+    if (!checkedSub(balances[from], amount, newFrom)) return QPROBE_REJECT(probe, false);
+    if (!checkedAdd(balances[to], amount, newTo)) return QPROBE_REJECT(probe, false);
+    setBalance(from, newFrom);
+    setBalance(to, newTo);
+    emitEvent(EventContract::QBTC, EventType::Transfer, from, to, amount);
     return true;
 }
 
 // Read balance
 uint64_t balanceOf(const std::string& addr) {
+    QPROBE(probe, "qbtc.balanceOf");
     return balances.count(addr) ? balances[addr] : 0;
 }
 
+// Read balance as of the end of a past tick; false if the tick is older than the
+// history kept (balance is then as of the oldest answerable tick)
+bool balanceOfAt(const std::string& addr, uint64_t tick, uint64_t& balance) {
+    QPROBE(probe, "qbtc.balanceOfAt");
+    return holders.balanceAt(addr, tick, balance);
+}
+
+// Rank by balance (0 = largest holder); false if addr holds nothing
+bool holderRank(const std::string& addr, uint64_t& rank) {
+    QPROBE(probe, "qbtc.holderRank");
+    return holders.rankOf(addr, rank);
+}
+
+// Largest `count` holders as (address, balance), in rank order
+std::vector<std::pair<std::string, uint64_t>> topHolders(uint64_t count) {
+    QPROBE(probe, "qbtc.topHolders");
+    std::vector<std::pair<std::string, uint64_t>> out;
+    holders.topHolders(count, [&out](const std::string& addr, uint64_t amount) { out.emplace_back(addr, amount); });
+    return out;
+}
+
+// Largest `count` holders as of the end of a past tick, in rank order; scans every
+// address (airdrop snapshots). False if the tick is older than the history kept.
+bool topHoldersAt(uint64_t tick, uint64_t count, std::vector<std::pair<std::string, uint64_t>>& out) {
+    QPROBE(probe, "qbtc.topHoldersAt");
+    out.clear();
+    return holders.topHoldersAt(tick, count,
+        [&out](const std::string& addr, uint64_t amount) { out.emplace_back(addr, amount); });
+}
+
 // Read total supply
 uint64_t totalSupply() {
     return QBTC_TOTAL_SUPPLY;
 }
 
+// Cross-contract calls (qcall.hpp): the calling contract's 32-byte id is its address
+void bindCalls(CallBus& bus) {
+    bus.bind<CallTransferInput, CallTransferOutput>(EventContract::QBTC, CallProcedure::Transfer, nullptr,
+        [](void*, const uint8_t caller[32], const CallTransferInput& input, CallTransferOutput& output) {
+            output.ok = transfer(std::string(reinterpret_cast<const char*>(caller), 32),
+                                 std::string(reinterpret_cast<const char*>(input.to), 32), input.amount);
+        });
+    bus.bind<CallBalanceInput, CallBalanceOutput>(EventContract::QBTC, CallProcedure::BalanceOf, nullptr,
+        [](void*, const uint8_t*, const CallBalanceInput& input, CallBalanceOutput& output) {
+            output.balance = balanceOf(std::string(reinterpret_cast<const char*>(input.account), 32));
+            output.addressable = 1;
+        });
+}
+
+bool exportDelta(uint64_t fromTick, std::ostream& out);
+
+// End of tick: journal the touched balances, then fold them into the state root
+const Hash256& endTick() {
+    QPROBE(probe, "qbtc.endTick");
+    uint64_t tick = dirtyBalances.currentTick();
+    journal().record(EventContract::QBTC, JournalRecord::Delta, tick,
+                     [tick](std::ostream& out) { exportDelta(tick, out); });
+    dirtyBalances.endTick();
+    holders.endTick(dirtyBalances.currentTick());
+    return balanceTree.commit();
+}
+
+// State root as of the last committed tick
+const Hash256& stateRoot() {
+    return balanceTree.root();
+}
+
+// Stream balances changed since fromTick; false if outside the retained window
+bool exportDelta(uint64_t fromTick, std::ostream& out) {
+    return dirtyBalances.exportDelta<uint64_t>(fromTick, DELTA_TABLE_BALANCES, out,
+        [](const std::string& addr, uint64_t& amount) { amount = balanceOf(addr); });
+}
+
+// Apply a delta produced by exportDelta() on a peer. It must start at the open tick
+// and is read in full before any balance changes; the dirty log then continues after
+// the delta's last tick.
+bool applyDelta(std::istream& in) {
+    DeltaHeader header;
+    std::vector<std::pair<std::string, uint64_t>> records;
+    if (!readDelta(in, DELTA_TABLE_BALANCES, header, records)) return false;
+    if (header.fromTick != dirtyBalances.currentTick()) return false;
+    dirtyBalances.restart(header.toTick);
+    for (const auto& r : records) setBalance(r.first, r.second);
+    if (!balances.empty()) minted = true;
+    dirtyBalances.restart(header.toTick + 1);
+    holders.endTick(header.toTick + 1);
+    return true;
+}
+
+// Re-apply a tick journaled by endTick() (qjournal.hpp); ticks already held are skipped.
+// The root is folded once, by endJournalReplay().
+bool replayJournal(uint64_t tick, std::istream& in) {
+    if (tick < dirtyBalances.currentTick()) return true;
+    return applyDelta(in);
+}
+
+const Hash256& endJournalReplay() {
+    return balanceTree.commit();
+}
+
+// Read balance with Merkle inclusion proof against stateRoot()
+bool balanceOfWithProof(const std::string& addr, BalanceProof& proof) {
+    QPROBE(probe, "qbtc.balanceOfWithProof");
+    return balanceTree.prove(addr, proof);
+}
+
 /*
 Qubic Anti-Military License – Code is Law Edition
 Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
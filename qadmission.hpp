@@ -0,0 +1,214 @@
+/*
+ * qAdmission – Admission control in front of oracle signature verification
+ * Per-submitter cost and success history, tiered queues and a verification budget per tick
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include "qstatetree.hpp"
+#include "qprocessedids.hpp"
+
+// ====== Tiers ======
+// Proven relays are verified first, unknown submitters with what is left, and
+// offenders only every few ticks with what is left after that.
+enum class AdmissionTier : uint8_t { Proven = 0, Unknown = 1, Offender = 2 };
+constexpr size_t ADMISSION_TIERS = 3;
+
+enum class AdmissionResult : uint8_t {
+    Queued = 0,
+    Throttled = 1, // submitter already has its tier's share of pending submissions
+    QueueFull = 2, // tier queue at capacity
+    Malformed = 3, // refused by the contract's own shape checks, never queued
+};
+
+// What verifying a queued submission came to
+enum class AdmissionOutcome : uint8_t {
+    Accepted,   // signatures held and the feed moved
+    Rejected,   // malformed or a signature failed: counts against the submitter
+    Superseded, // well-formed but no longer newer than the feed (another relay won the race)
+};
+
+struct AdmissionLimits {
+    uint32_t verifyBudget = 64;                           // signature verifications per tick, all tiers
+    uint32_t queueCapacity[ADMISSION_TIERS] = {64, 128, 32};
+    uint8_t pendingPerSubmitter[ADMISSION_TIERS] = {8, 2, 1};
+    uint32_t offenderEvery = 4;                           // offenders are served on every Nth tick
+    uint32_t decayTicks = 256;                            // history halves every N ticks
+};
+
+// Counts decay so a relay that misbehaved once recovers and a proven relay has to keep proving itself
+struct SubmitterRecord {
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    uint64_t usefulVerifications = 0; // spent on submissions that were accepted
+    uint64_t wastedVerifications = 0; // spent on submissions that were rejected
+    uint64_t decayedAt = 0;           // tick of the last decay
+    uint8_t pending = 0;
+
+    // Proven: accepted before and at least 80% of the work spent on it was useful
+    AdmissionTier tier() const {
+        if (accepted > 0 && wastedVerifications * 4 <= usefulVerifications) return AdmissionTier::Proven;
+        if (rejected > accepted) return AdmissionTier::Offender;
+        return AdmissionTier::Unknown;
+    }
+
+    bool idle() const { return !accepted && !rejected && !usefulVerifications && !wastedVerifications && !pending; }
+};
+
+struct AdmissionTickStats {
+    uint32_t served = 0;        // submissions verified (or cheaply rejected) this tick
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    uint32_t superseded = 0;
+    uint32_t verifications = 0; // never above AdmissionLimits::verifyBudget
+    uint32_t carried = 0;       // still queued for the next tick
+};
+
+// ====== Admission Queue ======
+// Submissions are queued by the submitter's tier and verified at drain() (end of
+// tick) in tier order, FIFO within a tier, until the tick's verification budget
+// is spent; whatever does not fit waits for the next tick. Each entry carries its
+// worst-case cost (signature count) so the budget is never overrun. Anyone can
+// still mint fresh submitter ids, but those land in the Unknown tier behind every
+// proven relay and share its bounded queue, so junk cannot delay honest updates.
+template <typename Submission>
+class AdmissionQueue {
+private:
+    struct Entry {
+        Hash256 submitter;
+        uint32_t cost;
+        Submission submission;
+    };
+
+    AdmissionLimits limits;
+    std::unordered_map<Hash256, SubmitterRecord, Hash256Hash> records;
+    std::deque<Entry> queues[ADMISSION_TIERS];
+    uint64_t tick = 0; // drains so far
+
+    void decay(SubmitterRecord& r) const {
+        uint64_t halvings = (tick - r.decayedAt) / limits.decayTicks;
+        if (!halvings) return;
+        unsigned s = unsigned(std::min<uint64_t>(halvings, 63));
+        r.accepted >>= std::min(s, 31u);
+        r.rejected >>= std::min(s, 31u);
+        r.usefulVerifications >>= s;
+        r.wastedVerifications >>= s;
+        r.decayedAt += halvings * limits.decayTicks;
+    }
+
+    // Records with nothing left to remember, once per decay period
+    void prune() {
+        for (auto it = records.begin(); it != records.end();) {
+            decay(it->second);
+            if (it->second.idle()) it = records.erase(it);
+            else ++it;
+        }
+    }
+
+public:
+    AdmissionQueue() = default;
+    explicit AdmissionQueue(const AdmissionLimits& l) : limits(l) {}
+
+    const AdmissionLimits& config() const { return limits; }
+    void configure(const AdmissionLimits& l) { limits = l; }
+
+    AdmissionTier tierOf(const Hash256& submitter) {
+        auto it = records.find(submitter);
+        if (it == records.end()) return AdmissionTier::Unknown;
+        decay(it->second);
+        return it->second.tier();
+    }
+
+    const SubmitterRecord* record(const Hash256& submitter) const {
+        auto it = records.find(submitter);
+        return it == records.end() ? nullptr : &it->second;
+    }
+
+    size_t queued(AdmissionTier t) const { return queues[size_t(t)].size(); }
+    size_t submitters() const { return records.size(); }
+
+    // O(1): no signature is looked at. `cost` is the most verifications the submission can take.
+    AdmissionResult admit(const Hash256& submitter, Submission submission, uint32_t cost) {
+        AdmissionTier t = tierOf(submitter);
+        std::deque<Entry>& q = queues[size_t(t)];
+        if (q.size() >= limits.queueCapacity[size_t(t)]) return AdmissionResult::QueueFull;
+        SubmitterRecord& r = records[submitter];
+        if (r.idle()) r.decayedAt = tick;
+        if (r.pending >= limits.pendingPerSubmitter[size_t(t)]) return AdmissionResult::Throttled;
+        ++r.pending;
+        q.push_back({submitter, cost, std::move(submission)});
+        return AdmissionResult::Queued;
+    }
+
+    // `verify(submission, verifications)` runs the contract's checks, adds the signature
+    // verifications it performed and returns the outcome. Call once per tick.
+    template <typename Verify>
+    AdmissionTickStats drain(Verify verify) {
+        AdmissionTickStats stats;
+        uint32_t budget = limits.verifyBudget;
+        bool spent = false;
+        for (size_t t = 0; t < ADMISSION_TIERS && !spent; ++t) {
+            if (AdmissionTier(t) == AdmissionTier::Offender && tick % limits.offenderEvery != 0) continue;
+            std::deque<Entry>& q = queues[t];
+            while (!q.empty()) {
+                if (q.front().cost > budget) {
+                    spent = true;
+                    break;
+                }
+                Entry e = std::move(q.front());
+                q.pop_front();
+                uint32_t verifications = 0;
+                AdmissionOutcome outcome = verify(e.submission, verifications);
+                verifications = std::min(verifications, e.cost);
+                budget -= verifications;
+                stats.verifications += verifications;
+                ++stats.served;
+
+                SubmitterRecord& r = records[e.submitter];
+                decay(r);
+                --r.pending;
+                switch (outcome) {
+                case AdmissionOutcome::Accepted:
+                    ++r.accepted;
+                    r.usefulVerifications += verifications;
+                    ++stats.accepted;
+                    break;
+                case AdmissionOutcome::Rejected:
+                    ++r.rejected;
+                    r.wastedVerifications += verifications;
+                    ++stats.rejected;
+                    break;
+                case AdmissionOutcome::Superseded:
+                    ++stats.superseded;
+                    break;
+                }
+            }
+        }
+        for (const auto& q : queues) stats.carried += uint32_t(q.size());
+        if (++tick % limits.decayTicks == 0) prune();
+        return stats;
+    }
+
+    void clear() {
+        records.clear();
+        for (auto& q : queues) q.clear();
+        tick = 0;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,2355 @@
+/*
+ * qBench – Replays a seeded synthetic trace against the contracts and reports per-operation cost
+ * ops/s, p50/p99/p999 latency and allocations per operation, peak RSS, and a digest of the final state
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ *
+ * Build: g++ -O2 -std=c++17 -pthread qbench.cpp -o qbench
+ * Run:   ./qbench record --out mixed.qtrc --seed 7 --ticks 200
+ *        ./qbench replay --trace mixed.qtrc --contract qusd --json > qusd.json
+ *        ./qbench run --accounts 1000000 --zipf 1.3
+ *        ./qbench run --journal state.qjrn && ./qbench recover --journal state.qjrn
+ *        ./qbench spam --junk 20 --verify-us 30
+ *        ./qbench calls --calls 200000 --batch 64
+ *        ./qbench merkle --size 10000000 --changed 10000
+ *        ./qbench delta --size 10000000 --dir /tmp
+ *        ./qbench coldstart --size 10000000
+ *        ./qbench emit --rounds 10000000
+ *        ./qbench holders --size 10000000 --changed 10000
+ *        ./qbench bridge --changed 10000
+ *        ./qbench auth --size 32
+ *        ./qbench proposals --size 10000000 --dir /tmp
+ *        ./qbench queries --size 1000000
+ *        ./qbench multicall --changed 1000
+ *        ./qbench signed --verify-us 30
+ *        ./qbench claims --size 1000
+ *        ./qbench columns --size 10000000   (build with -mavx2 for the vector kernel)
+ *        ./qbench unlocks --size 1000000
+ *        ./qbench pool --changed 10000
+ *        ./qbench positions --size 1000000
+ *        ./qbench fixed --size 1000000   (build with -mavx2 for the batch kernels)
+ *        ./qbench probes --rounds 10000000   (build with -DQPROBES to measure the probes)
+ *        ./qbench scaling --size 4
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <endian.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "qstatetree.hpp"
+#include "qstatedelta.hpp"
+#include "qsnapshot.hpp"
+#include "qevents.hpp"
+#include "qholders.hpp"
+#include "qprocessedids.hpp"
+#include "qadmission.hpp"
+#include "qjournal.hpp"
+#include "qcall.hpp"
+#include "qcollateral.hpp"
+#include "qfixed.hpp"
+#include "qoracle.hpp"
+#include "qsignerset.hpp"
+#include "qproposalstore.hpp"
+#include "qvestingstore.hpp"
+#include "qschedule.hpp"
+#include "qworkers.hpp"
+#include "qprobe.hpp"
+#include "qtick.hpp"
+#include "qk12.hpp"
+#include "qtrace.hpp"
+
+// ====== Allocation Counting ======
+std::atomic<uint64_t> allocations{0};
+
+// The whole replaceable set over malloc/free, so every new pairs with its own delete
+void* countedAlloc(size_t n, size_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    n = n ? n : 1;
+    void* p = nullptr;
+    if (align <= alignof(std::max_align_t)) p = malloc(n);
+    else if (posix_memalign(&p, align, n) != 0) p = nullptr;
+    return p;
+}
+
+// Out of line: GCC must not see free() applied to what operator new returned
+__attribute__((noinline)) void countedFree(void* p) noexcept { free(p); }
+
+void* operator new(size_t n) {
+    if (void* p = countedAlloc(n, 0)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void* operator new(size_t n, std::align_val_t a) {
+    if (void* p = countedAlloc(n, size_t(a))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n, std::align_val_t a) { return operator new(n, a); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+// ====== Platform Stand-ins ======
+// Signature checks accept everything except signatures starting with STANDIN_FORGED:
+// timings are the contracts' own work, not the platform's Dilithium or Ed25519.
+// The spam and signed scenarios charge standinVerifyNs of busy time per
+// verification instead.
+void KangarooTwelve(const uint8_t* input, unsigned int inputByteLen, uint8_t* output, unsigned int outputByteLen) {
+    k12(input, inputByteLen, output, outputByteLen);
+}
+
+constexpr uint8_t STANDIN_FORGED = 0xFF;
+uint64_t standinVerifyNs = 0;
+uint64_t standinVerifications = 0;
+uint64_t standinValid = 0;
+uint64_t standinAcceptAfter = UINT64_MAX; // the spam scenario stamps the clock at this many valid signatures
+std::chrono::steady_clock::time_point standinAcceptedAt;
+
+// Busy time of one verification; reads no shared counters, so any thread may call it
+void standinVerifyTime() {
+    if (standinVerifyNs) {
+        auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(standinVerifyNs);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+}
+
+bool standinVerify(const uint8_t* sig, size_t sigLen) {
+    standinVerifyTime();
+    ++standinVerifications;
+    bool ok = sigLen == 0 || sig[0] != STANDIN_FORGED;
+    if (ok && ++standinValid == standinAcceptAfter) standinAcceptedAt = std::chrono::steady_clock::now();
+    return ok;
+}
+
+// ====== Contracts ======
+// Same arrangement as qrpcnode.cpp: one namespace per contract for its globals
+namespace qusd_sc {
+using ::readField; // its PositionRecord overloads would hide the generic helpers
+using ::writeField;
+#include "qusd.cpp"
+}
+namespace qbtc_sc {
+#include "qBTCsynthetictoken.cpp"
+}
+namespace bkpy_sc {
+#include "bp1.cpp"
+}
+namespace validator_sc {
+#include "qoracle1.cpp"
+bool dilithium_verify(const uint8_t*, const uint8_t*, size_t, const uint8_t* sig, size_t sigLen) {
+    return standinVerify(sig, sigLen);
+}
+}
+namespace committee_sc {
+#include "qoraclecommittee1.cpp"
+}
+namespace codeislaw_sc {
+#include "codeislaw_committee.cpp"
+}
+namespace btcq_sc {
+#include "BTCqoraclecommittee.cpp"
+}
+namespace vesting_sc {
+using ::applyDelta; // its own overloads would hide the generic helpers
+using ::readField;
+using ::writeField;
+#include "QnosisVesting.cpp"
+}
+namespace qgnosis_sc {
+#include "Qgnosis.cpp"
+// Called from the shared workers (verifySignatures), hence no counters
+bool dilithium_verify(const uint8_t*, const uint8_t*, size_t, const uint8_t* sig, size_t sigLen) {
+    standinVerifyTime();
+    return sigLen == 0 || sig[0] != STANDIN_FORGED;
+}
+}
+namespace pool_sc {
+#include "bankonpythai-pool.cpp"
+}
+
+// ====== Operation Table ======
+enum Family : uint8_t { QUSD, QBTC, BKPY, ORACLES, VESTING, QGNOSIS, FAMILIES };
+const char* const FAMILY_NAMES[FAMILIES] = {"qusd", "qbtc", "bkpy", "oracles", "vesting", "qgnosis"};
+
+enum Stat : uint8_t {
+    QUSD_MINT, QUSD_TRANSFER, QBTC_TRANSFER, BKPY_TRANSFER,
+    ORACLE_VALIDATOR, ORACLE_COMMITTEE, ORACLE_CODEISLAW, ORACLE_BTCQ,
+    VESTING_CREATE, VESTING_CLAIM_ALL, QGNOSIS_PROPOSE, QGNOSIS_SIGN, QGNOSIS_EXECUTE,
+    END_TICK, STATS
+};
+const char* const STAT_NAMES[STATS] = {
+    "qusd.mint", "qusd.transfer", "qbtc.transfer", "bkpy.transfer",
+    "oracle.validator", "oracle.committee", "oracle.codeislaw", "oracle.btcq",
+    "vesting.create", "vesting.claimAll", "qgnosis.propose", "qgnosis.sign", "qgnosis.execute",
+    "endTick"};
+
+Family familyOf(const TraceRecord& r) {
+    switch (TraceOp(r.op)) {
+    case TraceOp::QusdMint:
+    case TraceOp::QusdTransfer: return QUSD;
+    case TraceOp::QbtcTransfer: return QBTC;
+    case TraceOp::BkpyTransfer: return BKPY;
+    case TraceOp::OraclePrice: return ORACLES;
+    case TraceOp::VestingCreate:
+    case TraceOp::VestingClaim: return VESTING;
+    default: return QGNOSIS;
+    }
+}
+
+Stat statOf(const TraceRecord& r) {
+    switch (TraceOp(r.op)) {
+    case TraceOp::EndTick: return END_TICK;
+    case TraceOp::QusdMint: return QUSD_MINT;
+    case TraceOp::QusdTransfer: return QUSD_TRANSFER;
+    case TraceOp::QbtcTransfer: return QBTC_TRANSFER;
+    case TraceOp::BkpyTransfer: return BKPY_TRANSFER;
+    case TraceOp::OraclePrice: return Stat(ORACLE_VALIDATOR + std::min<unsigned>(r.arg, TRACE_ORACLES - 1));
+    case TraceOp::VestingCreate: return VESTING_CREATE;
+    case TraceOp::VestingClaim: return VESTING_CLAIM_ALL;
+    case TraceOp::ProposalCreate: return QGNOSIS_PROPOSE;
+    case TraceOp::ProposalSign: return QGNOSIS_SIGN;
+    default: return QGNOSIS_EXECUTE;
+    }
+}
+
+// ====== Replay ======
+// Account ids map to each contract's key type; everything is built before the
+// clock starts where the contract API allows it.
+void qusdAccount(uint32_t id, uint8_t out[32]) {
+    memset(out, 0, 32);
+    memcpy(out, &id, sizeof(id));
+    out[31] = 1; // never the all-zero custodian key
+}
+std::string qbtcAccount(uint32_t id) { return "a" + std::to_string(id); }
+std::string vestingAccount(uint32_t id) { return "b" + std::to_string(id); }
+
+bkpy_sc::BANKON_PYTHAI bkpy{0};
+std::unique_ptr<qgnosis_sc::Qnosis> vault; // built by the replayer, or by recover from the journal
+
+// K12 over the committed state of every enabled contract the journal covers:
+// equal digests mean equal end states
+std::string stateDigest(const bool (&enabled)[FAMILIES]) {
+    std::vector<uint8_t> buf;
+    auto put = [&buf](const void* p, size_t n) {
+        buf.insert(buf.end(), static_cast<const uint8_t*>(p), static_cast<const uint8_t*>(p) + n);
+    };
+    if (enabled[QUSD]) put(qusd_sc::getStateRoot().root, 32);
+    if (enabled[QBTC]) put(qbtc_sc::stateRoot().data(), 32);
+    if (enabled[BKPY]) put(bkpy.stateRoot().data(), 32);
+    if (enabled[ORACLES]) {
+        uint64_t v[4] = {validator_sc::get_last_price(), uint64_t(committee_sc::get_last_price().price),
+                         codeislaw_sc::lastUpdate.value, btcq_sc::latest_feed.price};
+        put(v, sizeof(v));
+    }
+    if (enabled[VESTING]) put(&vesting_sc::totalSupply, 8);
+    if (enabled[QGNOSIS] && vault) {
+        uint64_t v[3] = {vault->getThreshold(), vault->nextNonce(), vault->pendingProposals()};
+        put(v, sizeof(v));
+        for (const std::string& o : vault->getOwners()) put(o.data(), o.size());
+        for (auto page = vault->getPendingProposals(0, 1024);; page = vault->getPendingProposals(page.nextCursor, 1024)) {
+            for (uint64_t nonce : page.nonces) {
+                uint64_t approvals = vault->getApprovals(nonce);
+                put(&nonce, 8);
+                put(&approvals, 8);
+            }
+            if (page.nextCursor == 0) break;
+        }
+    }
+    uint8_t digest[32];
+    k12(buf.data(), buf.size(), digest, 32);
+    char hex[65];
+    for (int i = 0; i < 32; ++i) snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+    return hex;
+}
+
+class Replayer {
+private:
+    const TraceHeader& h;
+    bool enabled[FAMILIES];
+    std::vector<std::string> qbtcKeys, vestingKeys, owners;
+    std::vector<std::string> vestingProof = {"signer0", "signer1", "signer2"};
+    validator_sc::PriceUpdate validatorUpdate;
+    std::vector<committee_sc::OracleSignature> committeeSigs;
+    uint8_t committeeSigners[committee_sc::SIGS_REQUIRED];
+    uint8_t codeislawSigs[codeislaw_sc::NUM_ORACLES][64] = {};
+    uint8_t codeislawSigners[codeislaw_sc::NUM_ORACLES];
+    std::array<btcq_sc::Signature, btcq_sc::ORACLE_THRESHOLD> btcqSigs;
+    Hash256 relay; // the one relay every admission-controlled oracle update comes from
+
+    uint64_t timestampOf(uint64_t tick) const { return h.baseTimestamp + tick * h.tickSeconds; }
+
+    // false when the contract refused the operation. Oracles with admission control
+    // only queue the update; it is verified and applied by the end-of-tick drain.
+    bool apply(const TraceRecord& r) {
+        switch (TraceOp(r.op)) {
+        case TraceOp::EndTick: {
+            if (enabled[ORACLES]) {
+                validator_sc::process_price_updates();
+                committee_sc::process_price_updates();
+                codeislaw_sc::process_updates();
+            }
+            if (enabled[QUSD]) qusd_sc::endTick();
+            if (enabled[QBTC]) qbtc_sc::endTick();
+            if (enabled[BKPY]) bkpy.endTick();
+            if (enabled[VESTING]) vesting_sc::endTick();
+            if (enabled[QGNOSIS]) vault->endTick();
+            journal().commit(r.a); // no-op unless --journal
+            setTickTimestamp(timestampOf(r.a + 1));
+            eventLog().setTick(r.a + 1);
+            return true;
+        }
+        case TraceOp::QusdMint: {
+            static const uint8_t custodian[32] = {};
+            qusd_sc::MintBurnInput in = {};
+            qusdAccount(r.a, in.to_or_from);
+            in.amount = r.amount;
+            uint64_t before = qusd_sc::totalSupply;
+            qusd_sc::mint(in, custodian);
+            return qusd_sc::totalSupply != before;
+        }
+        case TraceOp::QusdTransfer: {
+            uint8_t from[32];
+            qusd_sc::TransferInput in = {};
+            qusdAccount(uint32_t(r.a), from);
+            qusdAccount(uint32_t(r.b), in.to);
+            in.amount = r.amount;
+            qusd_sc::BalanceOfInput q = {};
+            memcpy(q.account, from, 32);
+            uint64_t before = qusd_sc::balanceOf(q).balance;
+            qusd_sc::transfer(in, from);
+            return r.a == r.b || qusd_sc::balanceOf(q).balance != before;
+        }
+        case TraceOp::QbtcTransfer: return qbtc_sc::transfer(qbtcKeys[r.a], qbtcKeys[r.b], r.amount);
+        case TraceOp::BkpyTransfer: return bkpy.transfer(r.a, r.b, r.amount);
+        case TraceOp::OraclePrice: {
+            switch (TraceOracle(r.arg)) {
+            case TraceOracle::Validator:
+                validatorUpdate.message = {r.amount, r.b};
+                return validator_sc::submit_price_update(relay, validatorUpdate) == AdmissionResult::Queued;
+            case TraceOracle::Committee:
+                return committee_sc::submit_price_update(relay, {int64_t(r.amount), r.b}, committeeSigs.data(),
+                                                         committeeSigners,
+                                                         committee_sc::SIGS_REQUIRED) == AdmissionResult::Queued;
+            case TraceOracle::CodeIsLaw:
+                return codeislaw_sc::submit_update(relay.data(), r.amount, uint32_t(r.b), codeislawSigs,
+                                                   codeislawSigners,
+                                                   codeislaw_sc::MAJORITY) == int(AdmissionResult::Queued);
+            default: return btcq_sc::update_price(r.amount, r.b, btcqSigs);
+            }
+        }
+        case TraceOp::VestingCreate: {
+            const std::string& who = vestingKeys[r.a];
+            vesting_sc::mint(who, r.amount, vestingProof);
+            vesting_sc::createVesting("g" + std::to_string(r.b), who, r.amount, tickTimestamp(),
+                                      uint64_t(std::max<uint8_t>(r.arg, 1)) * h.tickSeconds, vestingProof);
+            return true;
+        }
+        case TraceOp::VestingClaim: vesting_sc::claimAll(vestingKeys[r.a]); return true; // 0 due is not a refusal
+        case TraceOp::ProposalCreate:
+            return vault->propose(owners[r.a], "treasury", r.amount, "") == r.b;
+        case TraceOp::ProposalSign: vault->sign(r.b, owners[r.a]); return true;
+        case TraceOp::ProposalExecute: vault->execute(r.b); return true;
+        }
+        return false;
+    }
+
+public:
+    struct OpStats {
+        uint64_t count = 0, rejects = 0, allocations = 0, totalNs = 0;
+        std::vector<uint32_t> latencyNs;
+    };
+    OpStats stats[STATS];
+    uint64_t measuredOps = 0;
+    double wallSeconds = 0;
+
+    Replayer(const TraceHeader& header, const bool (&families)[FAMILIES]) : h(header) {
+        std::copy(families, families + FAMILIES, enabled);
+        qbtcKeys.resize(h.accounts);
+        vestingKeys.resize(h.accounts);
+        for (uint32_t i = 0; i < h.accounts; ++i) {
+            qbtcKeys[i] = qbtcAccount(i);
+            vestingKeys[i] = vestingAccount(i);
+        }
+        for (uint16_t i = 0; i < std::max<uint16_t>(h.owners, 1); ++i) owners.push_back("owner" + std::to_string(i));
+        vault.reset(new qgnosis_sc::Qnosis(owners, std::max<uint16_t>(h.threshold, 1)));
+        for (const std::string& s : vestingProof) vesting_sc::signers.add(s);
+        for (size_t i = 0; i < validator_sc::QUORUM_THRESHOLD; ++i)
+            validatorUpdate.signatures.push_back({i, {}});
+        committeeSigs.resize(committee_sc::SIGS_REQUIRED);
+        for (uint8_t i = 0; i < committee_sc::SIGS_REQUIRED; ++i) committeeSigners[i] = i;
+        for (uint8_t i = 0; i < codeislaw_sc::NUM_ORACLES; ++i) codeislawSigners[i] = i;
+        for (size_t i = 0; i < btcq_sc::ORACLE_THRESHOLD; ++i) btcqSigs[i].pubkey = btcq_sc::committee_pubkeys[i];
+        relay.fill(0x0A);
+        qbtc_sc::mint(qbtcKeys[0]);
+        bkpy.mint();
+        setTickTimestamp(timestampOf(0));
+        eventLog().setTick(0);
+    }
+
+    // Genesis (tick 0) funds the accounts and is not measured
+    void run(const std::vector<TraceRecord>& records) {
+        size_t at = 0;
+        for (; at < records.size(); ++at) {
+            const TraceRecord& r = records[at];
+            if (TraceOp(r.op) != TraceOp::EndTick && !enabled[familyOf(r)]) continue;
+            apply(r);
+            if (TraceOp(r.op) == TraceOp::EndTick) break;
+        }
+        ++at;
+        uint64_t counts[STATS] = {};
+        for (size_t i = at; i < records.size(); ++i) ++counts[statOf(records[i])];
+        for (unsigned s = 0; s < STATS; ++s) stats[s].latencyNs.reserve(size_t(counts[s]));
+
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        for (size_t i = at; i < records.size(); ++i) {
+            const TraceRecord& r = records[i];
+            if (TraceOp(r.op) != TraceOp::EndTick && !enabled[familyOf(r)]) continue;
+            OpStats& s = stats[statOf(r)];
+            uint64_t allocsBefore = allocations.load(std::memory_order_relaxed);
+            auto t0 = Clock::now();
+            bool ok;
+            try {
+                ok = apply(r);
+            } catch (const std::exception&) {
+                ok = false; // Qgnosis refuses by throwing
+            }
+            uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+            s.allocations += allocations.load(std::memory_order_relaxed) - allocsBefore;
+            s.latencyNs.push_back(uint32_t(std::min<uint64_t>(ns, UINT32_MAX)));
+            s.totalNs += ns;
+            s.rejects += !ok;
+            ++s.count;
+            ++measuredOps;
+        }
+        wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string digest() const { return stateDigest(enabled); }
+};
+
+// ====== Report ======
+// Nearest-rank percentile over the sorted samples
+uint32_t percentileNs(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = size_t(p * double(sorted.size()) + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+uint64_t peakRssKb() {
+    rusage u;
+    getrusage(RUSAGE_SELF, &u);
+    return uint64_t(u.ru_maxrss); // KiB on Linux
+}
+
+// Resident anonymous memory now (heap and stacks, not mapped files); 0 if unknown
+uint64_t anonRssKb() {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return 0;
+    char line[128];
+    unsigned long long kb = 0;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "RssAnon: %llu", &kb) == 1) break;
+    fclose(f);
+    return kb;
+}
+
+void printTable(Replayer& rp, const Trace& t, const char* contract) {
+    printf("trace seed %llu, %u ticks, %u accounts, %zu records; contract %s\n",
+           (unsigned long long)t.header.seed, t.header.ticks, t.header.accounts, t.records.size(), contract);
+    printf("%-20s %10s %8s %12s %9s %9s %9s %10s %9s\n", "op", "count", "rejects", "ops/s", "p50 ns", "p99 ns",
+           "p999 ns", "max ns", "allocs/op");
+    for (unsigned s = 0; s < STATS; ++s) {
+        Replayer::OpStats& st = rp.stats[s];
+        if (!st.count) continue;
+        std::sort(st.latencyNs.begin(), st.latencyNs.end());
+        printf("%-20s %10llu %8llu %12.0f %9u %9u %9u %10u %9.2f\n", STAT_NAMES[s], (unsigned long long)st.count,
+               (unsigned long long)st.rejects, st.totalNs ? double(st.count) * 1e9 / double(st.totalNs) : 0.0,
+               percentileNs(st.latencyNs, 0.50), percentileNs(st.latencyNs, 0.99), percentileNs(st.latencyNs, 0.999),
+               st.latencyNs.back(), double(st.allocations) / double(st.count));
+    }
+    printf("total %llu ops in %.3f s, %.0f ops/s, peak RSS %.1f MiB, state %s\n",
+           (unsigned long long)rp.measuredOps, rp.wallSeconds,
+           rp.wallSeconds > 0 ? double(rp.measuredOps) / rp.wallSeconds : 0.0, peakRssKb() / 1024.0,
+           rp.digest().c_str());
+    if (journal().active())
+        printf("journal %.1f MiB in %llu tick groups\n", double(journal().size()) / 1048576.0,
+               (unsigned long long)journal().committedGroups());
+}
+
+void printJson(Replayer& rp, const Trace& t, const char* contract) {
+    printf("{\"trace\":{\"seed\":%llu,\"ticks\":%u,\"accounts\":%u,\"records\":%zu},\"contract\":\"%s\",",
+           (unsigned long long)t.header.seed, t.header.ticks, t.header.accounts, t.records.size(), contract);
+    printf("\"ops\":[");
+    bool first = true;
+    for (unsigned s = 0; s < STATS; ++s) {
+        Replayer::OpStats& st = rp.stats[s];
+        if (!st.count) continue;
+        std::sort(st.latencyNs.begin(), st.latencyNs.end());
+        printf("%s{\"op\":\"%s\",\"count\":%llu,\"rejects\":%llu,\"opsPerSecond\":%.1f,\"p50Ns\":%u,\"p99Ns\":%u,"
+               "\"p999Ns\":%u,\"maxNs\":%u,\"allocsPerOp\":%.3f}",
+               first ? "" : ",", STAT_NAMES[s], (unsigned long long)st.count, (unsigned long long)st.rejects,
+               st.totalNs ? double(st.count) * 1e9 / double(st.totalNs) : 0.0, percentileNs(st.latencyNs, 0.50),
+               percentileNs(st.latencyNs, 0.99), percentileNs(st.latencyNs, 0.999), st.latencyNs.back(),
+               double(st.allocations) / double(st.count));
+        first = false;
+    }
+    printf("],\"totalOps\":%llu,\"wallSeconds\":%.6f,\"opsPerSecond\":%.1f,\"peakRssKb\":%llu,\"stateDigest\":\"%s\","
+           "\"journalBytes\":%llu}\n",
+           (unsigned long long)rp.measuredOps, rp.wallSeconds,
+           rp.wallSeconds > 0 ? double(rp.measuredOps) / rp.wallSeconds : 0.0, (unsigned long long)peakRssKb(),
+           rp.digest().c_str(), (unsigned long long)(journal().active() ? journal().size() : 0));
+}
+
+// ====== Recovery ======
+// Replays a journal written by replay/run --journal onto fresh contract state (the
+// trace's genesis is journaled too) and reports how long it took. The digest
+// matches the one the journaling run printed.
+int runRecover(const std::string& path, const bool (&families)[FAMILIES], bool json) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    JournalReplay r;
+    vault.reset(new qgnosis_sc::Qnosis({"owner0"}, 1)); // owners and threshold come from the journal
+    bool ok = replayJournal(path, r, [&families](EventContract c, JournalRecord, uint64_t tick, std::istream& in) {
+        switch (c) {
+        case EventContract::QUSD: return !families[QUSD] || qusd_sc::replayJournal(tick, in);
+        case EventContract::QBTC: return !families[QBTC] || qbtc_sc::replayJournal(tick, in);
+        case EventContract::BKPY: return !families[BKPY] || bkpy.replayJournal(tick, in);
+        case EventContract::QNOSIS_VESTING: return !families[VESTING] || vesting_sc::replayJournal(tick, in);
+        case EventContract::QNOSIS: return !families[QGNOSIS] || vault->replayJournal(tick, in);
+        case EventContract::QORACLE_VALIDATOR: return !families[ORACLES] || validator_sc::replay_journal(in);
+        case EventContract::QORACLE_COMMITTEE: return !families[ORACLES] || committee_sc::replay_journal(in);
+        case EventContract::CODEISLAW_COMMITTEE: return !families[ORACLES] || codeislaw_sc::replay_journal(in);
+        case EventContract::BTCQ_COMMITTEE: return !families[ORACLES] || btcq_sc::replay_journal(in);
+        default: return true;
+        }
+    });
+    if (families[QUSD]) qusd_sc::endJournalReplay();
+    if (families[QBTC]) qbtc_sc::endJournalReplay();
+    if (families[BKPY]) bkpy.endJournalReplay();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (!ok) {
+        fprintf(stderr, "cannot replay journal %s\n", path.c_str());
+        return 1;
+    }
+    double mib = double(r.validBytes) / 1048576.0;
+    if (json) {
+        printf("{\"journalBytes\":%llu,\"groups\":%llu,\"frames\":%llu,\"tornTail\":%s,\"seconds\":%.6f,"
+               "\"mibPerSecond\":%.1f,\"peakRssKb\":%llu,\"stateDigest\":\"%s\"}\n",
+               (unsigned long long)r.validBytes, (unsigned long long)r.groups, (unsigned long long)r.frames,
+               r.tornTail ? "true" : "false", seconds, seconds > 0 ? mib / seconds : 0.0,
+               (unsigned long long)peakRssKb(), stateDigest(families).c_str());
+        return 0;
+    }
+    printf("recovered %.1f MiB, %llu tick groups, %llu frames%s in %.3f s (%.0f MiB/s), peak RSS %.1f MiB, state %s\n",
+           mib, (unsigned long long)r.groups, (unsigned long long)r.frames, r.tornTail ? " (torn tail dropped)" : "",
+           seconds, seconds > 0 ? mib / seconds : 0.0, peakRssKb() / 1024.0, stateDigest(families).c_str());
+    return 0;
+}
+
+// ====== Spam Scenario ======
+// Honest relays submit each tick's update (taking turns at being first) among
+// forged updates from a few repeat offenders and from fresh ids, in random order.
+// Forged updates carry a future timestamp within the skew window so they are never
+// cheaply stale. "direct" is the unmetered path the contract no longer exposes: it
+// verifies every arrival with validate_update(). "admission" submits through
+// submit_price_update() and verifies at process_price_updates(). A tick's updates
+// all arrive at its start, so honest latency runs from there to the accepted
+// update's last signature check under both policies: direct pays for the forged
+// updates verified ahead of it, admission for queueing every arrival and the drain.
+struct SpamOptions {
+    uint64_t seed = 1;
+    uint32_t ticks = 20;
+    uint32_t warmup = 8; // junk-free ticks first, so the relays have a history
+    uint32_t relays = 3;
+    uint32_t junk = 20;  // forged updates per tick at 1x
+    uint32_t verifyUs = 30;
+};
+
+struct SpamResult {
+    const char* policy;
+    uint32_t multiplier;
+    uint64_t junkPerTick;
+    double verificationsPerTick;
+    uint32_t honestAccepted;
+    std::vector<uint32_t> latencyNs; // sorted
+    double msPerTick;
+};
+
+constexpr uint32_t SPAM_OFFENDERS = 8;
+
+Hash256 spamIdentity(uint8_t kind, uint64_t n) {
+    Hash256 id = {};
+    id[0] = kind; // 1: relay, 2: offender, 3: fresh
+    memcpy(id.data() + 1, &n, sizeof(n));
+    return id;
+}
+
+SpamResult runSpamScenario(const SpamOptions& o, uint32_t multiplier, bool admission) {
+    using Clock = std::chrono::steady_clock;
+    validator_sc::feed = validator_sc::OracleFeed{};
+    validator_sc::admission.clear();
+    const uint64_t base = 1700000000;
+    TraceRandom rnd(o.seed);
+    validator_sc::PriceUpdate honest, forged;
+    for (size_t i = 0; i < validator_sc::QUORUM_THRESHOLD; ++i) {
+        honest.signatures.push_back({i, {}});
+        forged.signatures.push_back({i, {}});
+        forged.signatures.back().signature[0] = STANDIN_FORGED;
+    }
+    struct Arrival {
+        Hash256 who;
+        bool honest;
+    };
+    std::vector<Arrival> arrivals;
+    SpamResult r{admission ? "admission" : "direct", multiplier, uint64_t(o.junk) * multiplier, 0, 0, {}, 0};
+    uint64_t fresh = 0, verifications = 0;
+    double seconds = 0;
+    for (uint32_t t = 0; t < o.warmup + o.ticks; ++t) {
+        bool measured = t >= o.warmup;
+        uint64_t now = base + t;
+        setTickTimestamp(now);
+        arrivals.clear();
+        for (uint32_t i = 0; i < o.relays; ++i) arrivals.push_back({spamIdentity(1, (t + i) % o.relays), true});
+        for (uint64_t j = 0; measured && j < r.junkPerTick; ++j)
+            arrivals.push_back({j % 2 ? spamIdentity(2, j % SPAM_OFFENDERS) : spamIdentity(3, fresh++), false});
+        for (size_t i = arrivals.size(); i > 1; --i) std::swap(arrivals[i - 1], arrivals[rnd.below(i)]);
+        honest.message = {2000000000000000ULL + rnd.below(1000000000000ULL), now};
+
+        uint64_t verificationsBefore = standinVerifications;
+        standinAcceptAfter = standinValid + validator_sc::QUORUM_THRESHOLD;
+        auto t0 = Clock::now(); // arrival of the whole tick
+        for (const Arrival& a : arrivals) {
+            const validator_sc::PriceUpdate* u = &honest;
+            if (!a.honest) {
+                forged.message = {honest.message.price / 2, now + 1 + rnd.below(500)};
+                u = &forged;
+            }
+            if (admission) validator_sc::submit_price_update(a.who, *u);
+            else if (validator_sc::validate_update(*u)) validator_sc::apply_update(u->message);
+        }
+        if (admission) validator_sc::process_price_updates();
+        auto t1 = Clock::now();
+        if (!measured) continue;
+        verifications += standinVerifications - verificationsBefore;
+        seconds += std::chrono::duration<double>(t1 - t0).count();
+        if (validator_sc::feed.last_timestamp == now) {
+            ++r.honestAccepted;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(standinAcceptedAt - t0).count();
+            r.latencyNs.push_back(uint32_t(ns));
+        }
+    }
+    standinAcceptAfter = UINT64_MAX;
+    std::sort(r.latencyNs.begin(), r.latencyNs.end());
+    r.verificationsPerTick = double(verifications) / o.ticks;
+    r.msPerTick = seconds * 1e3 / o.ticks;
+    return r;
+}
+
+int runSpam(const SpamOptions& o, bool json) {
+    standinVerifyNs = uint64_t(o.verifyUs) * 1000;
+    std::vector<SpamResult> results;
+    for (uint32_t multiplier : {1u, 10u, 100u})
+        for (bool admission : {false, true}) results.push_back(runSpamScenario(o, multiplier, admission));
+    standinVerifyNs = 0;
+    if (json) {
+        printf("{\"scenario\":\"spam\",\"relays\":%u,\"ticks\":%u,\"verifyUs\":%u,\"runs\":[", o.relays, o.ticks, o.verifyUs);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const SpamResult& r = results[i];
+            printf("%s{\"policy\":\"%s\",\"multiplier\":%u,\"junkPerTick\":%llu,\"verificationsPerTick\":%.1f,"
+                   "\"honestAccepted\":%u,\"p50Ns\":%u,\"p99Ns\":%u,\"maxNs\":%u,\"msPerTick\":%.3f}",
+                   i ? "," : "", r.policy, r.multiplier, (unsigned long long)r.junkPerTick, r.verificationsPerTick,
+                   r.honestAccepted, percentileNs(r.latencyNs, 0.50), percentileNs(r.latencyNs, 0.99),
+                   r.latencyNs.empty() ? 0 : r.latencyNs.back(), r.msPerTick);
+        }
+        printf("],\"peakRssKb\":%llu}\n", (unsigned long long)peakRssKb());
+        return 0;
+    }
+    printf("spam: %u relays, %u ticks, %u us per verification (qoracle1)\n", o.relays, o.ticks, o.verifyUs);
+    printf("%-10s %6s %10s %11s %8s %10s %10s %10s %9s\n", "policy", "junk", "junk/tick", "verify/tick", "honest",
+           "p50 us", "p99 us", "max us", "ms/tick");
+    for (const SpamResult& r : results)
+        printf("%-10s %5ux %10llu %11.1f %4u/%-3u %10.1f %10.1f %10.1f %9.2f\n", r.policy, r.multiplier,
+               (unsigned long long)r.junkPerTick, r.verificationsPerTick, r.honestAccepted, o.ticks,
+               percentileNs(r.latencyNs, 0.50) / 1e3, percentileNs(r.latencyNs, 0.99) / 1e3,
+               (r.latencyNs.empty() ? 0 : r.latencyNs.back()) / 1e3, r.msPerTick);
+    return 0;
+}
+
+// ====== Cross-contract Calls ======
+// The same qUSD transfer called directly (the extern "C" entry point) and through
+// the call bus (qcall.hpp), one at a time and in batches; an empty procedure both
+// ways isolates the bus's own cost. The last row is the Qnosis vault end to end:
+// multicall proposals of token transfers, each proposed, signed to the threshold
+// and executed, so one authorization fans out `batch` token calls.
+struct CallsOptions {
+    uint32_t calls = 200000;
+    uint32_t batch = 64;
+};
+
+struct CallsResult {
+    const char* path;
+    uint64_t calls;
+    double seconds;
+    uint64_t allocations;
+};
+
+constexpr EventContract CALLS_NOOP = EventContract(CALL_CONTRACTS - 1); // unused id, bench only
+volatile uint64_t callsSink = 0;
+
+__attribute__((noinline)) void callsNoop(void*, const uint8_t*, const CallTransferInput& input, CallTransferOutput& output) {
+    callsSink = callsSink + input.amount;
+    output.ok = 1;
+}
+
+// Account ids every token can address: BKPY maps only ids whose last 24 bytes are zero
+void callsAccount(uint64_t id, uint8_t out[32]) {
+    memset(out, 0, 32);
+    memcpy(out, &id, sizeof(id));
+}
+
+template <typename Body>
+CallsResult measureCalls(const char* path, uint64_t calls, Body body) {
+    uint64_t allocs = allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return {path, calls, seconds, allocations.load() - allocs};
+}
+
+int runCalls(const CallsOptions& o, bool json) {
+    const uint32_t batch = std::max<uint32_t>(o.batch, 1);
+    const uint32_t rounds = std::max<uint32_t>(o.calls / batch, 1);
+    const uint64_t calls = uint64_t(rounds) * batch;
+    constexpr uint32_t RECIPIENTS = 1024;
+
+    Hash256 vaultId;
+    callsAccount(0xA5A5A5A5A5A5A5A5ULL, vaultId.data());
+    const uint8_t* vault = vaultId.data();
+    static const uint8_t custodian[32] = {};
+    qusd_sc::MintBurnInput mint = {};
+    memcpy(mint.to_or_from, vault, 32);
+    mint.amount = 1ULL << 62;
+    qusd_sc::mint(mint, custodian);
+    qbtc_sc::mint(std::string(reinterpret_cast<const char*>(vault), 32));
+    bkpy.mint();
+    bkpy.transfer(0, 0xA5A5A5A5A5A5A5A5ULL, bkpy.balanceOf(0));
+    qusd_sc::bindCalls(callBus());
+    qbtc_sc::bindCalls(callBus());
+    bkpy.bindCalls(callBus());
+    callBus().bind<CallTransferInput, CallTransferOutput>(CALLS_NOOP, CallProcedure::Transfer, nullptr, &callsNoop);
+
+    std::vector<CallTransferInput> inputs(batch);
+    std::vector<CallTransferOutput> outputs(batch);
+    std::vector<CrossCall> batchCalls(batch);
+    for (uint32_t i = 0; i < batch; ++i) {
+        callsAccount(1 + i % RECIPIENTS, inputs[i].to);
+        inputs[i].amount = 1;
+    }
+    auto fill = [&](EventContract contract) {
+        for (uint32_t i = 0; i < batch; ++i)
+            batchCalls[i] = {contract, CallProcedure::Transfer, &inputs[i], &outputs[i]};
+    };
+    // Untimed pass: every recipient exists before the clock starts
+    for (uint32_t i = 0; i < RECIPIENTS; ++i) {
+        qusd_sc::TransferInput in = {};
+        callsAccount(1 + i, in.to);
+        in.amount = 1;
+        qusd_sc::transfer(in, vault);
+    }
+
+    std::vector<CallsResult> results;
+    results.push_back(measureCalls("noop direct", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (uint32_t i = 0; i < batch; ++i) callsNoop(nullptr, vault, inputs[i], outputs[i]);
+    }));
+    results.push_back(measureCalls("noop bus", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (uint32_t i = 0; i < batch; ++i)
+                callBus().call(CALLS_NOOP, CallProcedure::Transfer, vault, inputs[i], outputs[i]);
+    }));
+    fill(CALLS_NOOP);
+    results.push_back(measureCalls("noop bus batch", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r) callBus().callBatch(vault, batchCalls.data(), batch);
+    }));
+    results.push_back(measureCalls("qusd.transfer direct", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (uint32_t i = 0; i < batch; ++i) {
+                const qusd_sc::TransferInput& in = reinterpret_cast<const qusd_sc::TransferInput&>(inputs[i]);
+                qusd_sc::transfer(in, vault);
+            }
+    }));
+    results.push_back(measureCalls("qusd.transfer bus", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (uint32_t i = 0; i < batch; ++i)
+                callBus().call(EventContract::QUSD, CallProcedure::Transfer, vault, inputs[i], outputs[i]);
+    }));
+    fill(EventContract::QUSD);
+    results.push_back(measureCalls("qusd.transfer bus batch", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r) callBus().callBatch(vault, batchCalls.data(), batch);
+    }));
+
+    // Vault end to end: tokens rotate qusd, bkpy, qbtc within each multicall
+    std::vector<std::string> owners = {"owner0", "owner1", "owner2"};
+    qgnosis_sc::Qnosis safe(owners, 2);
+    safe.setDomain(vaultId);
+    std::vector<qgnosis_sc::Qnosis::CallInput> subs(batch);
+    static const char* const TOKENS[] = {"qusd", "bkpy", "qbtc"};
+    for (uint32_t i = 0; i < batch; ++i) {
+        uint8_t to[32];
+        callsAccount(1 + i % RECIPIENTS, to);
+        subs[i] = {"transfer", std::string(reinterpret_cast<const char*>(to), 32), 1, TOKENS[i % 3]};
+    }
+    const std::string data = safe.encodeMulticall(subs);
+    uint64_t executed = 0;
+    results.push_back(measureCalls("qgnosis multicall", calls, [&] {
+        for (uint32_t r = 0; r < rounds; ++r) {
+            uint64_t nonce = safe.propose(owners[0], "tokens", 0, data, "multicall");
+            safe.sign(nonce, owners[0]);
+            safe.sign(nonce, owners[1]);
+            safe.execute(nonce);
+            executed += safe.isExecuted(nonce);
+        }
+    }));
+    if (executed != rounds) {
+        fprintf(stderr, "vault executed %llu of %u proposals\n", (unsigned long long)executed, rounds);
+        return 1;
+    }
+
+    if (json) {
+        printf("{\"scenario\":\"calls\",\"calls\":%llu,\"batch\":%u,\"runs\":[", (unsigned long long)calls, batch);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const CallsResult& r = results[i];
+            printf("%s{\"path\":\"%s\",\"callsPerSec\":%.0f,\"nsPerCall\":%.1f,\"allocsPerCall\":%.2f}",
+                   i ? "," : "", r.path, r.calls / r.seconds, r.seconds * 1e9 / r.calls,
+                   double(r.allocations) / r.calls);
+        }
+        printf("],\"peakRssKb\":%llu}\n", (unsigned long long)peakRssKb());
+        return 0;
+    }
+    printf("calls: %llu per row, batch %u (multicall: %u token transfers per proposal)\n",
+           (unsigned long long)calls, batch, batch);
+    printf("%-24s %12s %10s %12s\n", "path", "calls/s", "ns/call", "allocs/call");
+    for (const CallsResult& r : results)
+        printf("%-24s %12.0f %10.1f %12.2f\n", r.path, r.calls / r.seconds, r.seconds * 1e9 / r.calls,
+               double(r.allocations) / r.calls);
+    return 0;
+}
+
+// ====== Scenarios ======
+// Focused benchmarks, one per feature, each reproducing the figure quoted when the
+// feature went in. Sizes default to the quoted ones; --size, --changed and --rounds
+// scale them down. A scenario fills metric rows; text and JSON print the same rows.
+struct ScenarioOptions {
+    uint64_t seed = 1;
+    uint64_t size = 0;    // state size (accounts, proposals, grants...); 0: the scenario's default
+    uint64_t changed = 0; // touched per tick or round; 0: the scenario's default
+    uint32_t rounds = 0;  // measured ticks or repetitions; 0: the scenario's default
+    uint32_t verifyUs = 30; // stand-in signature verification time (signed)
+    std::string dir = "/tmp"; // scratch files (snapshots, archives)
+};
+
+struct ScenarioRow {
+    std::string metric;
+    double value;
+    const char* unit;
+};
+
+struct ScenarioReport {
+    std::string setup; // sizes and parameters, one line
+    std::vector<ScenarioRow> rows;
+
+    void add(std::string metric, double value, const char* unit) { rows.push_back({std::move(metric), value, unit}); }
+};
+
+template <typename Body>
+uint64_t elapsedNs(Body body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+// p50, p99 and max of per-round samples, in `unit` (ns divided by `scale`)
+void addLatencyRows(ScenarioReport& rep, const std::string& what, std::vector<uint32_t> ns, double scale,
+                    const char* unit) {
+    std::sort(ns.begin(), ns.end());
+    rep.add(what + " p50", percentileNs(ns, 0.50) / scale, unit);
+    rep.add(what + " p99", percentileNs(ns, 0.99) / scale, unit);
+    rep.add(what + " max", (ns.empty() ? 0 : ns.back()) / scale, unit);
+}
+
+uint64_t pick(uint64_t value, uint64_t fallback) { return value ? value : fallback; }
+
+uint64_t fileBytes(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? uint64_t(st.st_size) : 0;
+}
+
+std::string fileContents(const std::string& path) {
+    std::string out;
+    if (FILE* f = fopen(path.c_str(), "rb")) {
+        char buf[1 << 16];
+        for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) out.append(buf, n);
+        fclose(f);
+    }
+    return out;
+}
+
+// Untimed setup shared by the qusd scenarios: `n` accounts holding 1000 each, committed
+void mintQusdAccounts(uint64_t n) {
+    static const uint8_t custodian[32] = {};
+    qusd_sc::MintBurnInput in = {};
+    in.amount = 1000;
+    for (uint64_t i = 0; i < n; ++i) {
+        qusdAccount(uint32_t(i), in.to_or_from);
+        qusd_sc::mint(in, custodian);
+    }
+}
+
+// The vesting contract's full signer set ("signer0".."signer9"); returns a
+// threshold proof from it
+std::vector<std::string> vestingSignerProof() {
+    std::vector<std::string> proof;
+    for (uint8_t i = 0; i < vesting_sc::MAX_SIGNERS; ++i) {
+        std::string s = "signer" + std::to_string(i);
+        if (!vesting_sc::signers.contains(s)) vesting_sc::signers.add(s);
+        if (i < vesting_sc::THRESHOLD) proof.push_back(s);
+    }
+    return proof;
+}
+
+// ---- merkle: qusd root update per tick, `changed` accounts touched out of `size` ----
+// endTick() is the whole tick boundary (liquidation check, dirty logs, holder index
+// pruning and the tree commit over the shared workers).
+int runMerkle(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = std::min<uint64_t>(pick(o.size, 10000000), UINT32_MAX);
+    const uint64_t k = std::min(pick(o.changed, 10000), n);
+    const uint32_t rounds = uint32_t(pick(o.rounds, 20));
+    static const uint8_t custodian[32] = {};
+    qusd_sc::MintBurnInput in = {};
+    mintQusdAccounts(n);
+    uint64_t buildNs = elapsedNs([] { qusd_sc::endTick(); });
+
+    TraceRandom rnd(o.seed);
+    std::vector<uint32_t> tickNs;
+    in.amount = 1;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint64_t j = 0; j < k; ++j) {
+            qusdAccount(uint32_t(rnd.below(n)), in.to_or_from);
+            qusd_sc::mint(in, custodian);
+        }
+        tickNs.push_back(uint32_t(std::min<uint64_t>(elapsedNs([] { qusd_sc::endTick(); }), UINT32_MAX)));
+    }
+    rep.setup = "qusd, " + std::to_string(n) + " accounts, " + std::to_string(k) + " changed per tick, " +
+                std::to_string(rounds) + " ticks, " + std::to_string(sharedWorkers().concurrency()) + " threads";
+    rep.add("first commit (full build)", buildNs / 1e6, "ms");
+    addLatencyRows(rep, "root update per tick", tickNs, 1e6, "ms");
+    return 0;
+}
+
+// ---- delta: catching a node up by exportDelta/applyDelta vs by a full snapshot ----
+// The receiver holds the snapshot from before the churn. Delta sync streams the
+// changed accounts (default 1% of `size`) and applies them; snapshot sync writes the
+// whole state and maps it (first query), with the index rebuild reported apart.
+// Both receivers must reach the sender's state root.
+int runDelta(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = std::min<uint64_t>(pick(o.size, 10000000), UINT32_MAX);
+    const uint64_t k = std::min(pick(o.changed, std::max<uint64_t>(n / 100, 1)), n);
+    const std::string base = o.dir + "/qbench-delta-base.snap", full = o.dir + "/qbench-delta-full.snap";
+    static const uint8_t custodian[32] = {};
+    mintQusdAccounts(n);
+    qusd_sc::endTick();
+    if (!qusd_sc::saveSnapshot(base)) {
+        fprintf(stderr, "cannot write %s\n", base.c_str());
+        return 1;
+    }
+
+    uint64_t fromTick = qusd_sc::dirtyBalances.currentTick();
+    TraceRandom rnd(o.seed);
+    qusd_sc::MintBurnInput in = {};
+    in.amount = 1;
+    for (uint64_t j = 0; j < k; ++j) {
+        qusdAccount(uint32_t(rnd.below(n)), in.to_or_from);
+        qusd_sc::mint(in, custodian);
+    }
+    std::stringstream delta;
+    uint64_t exportNs = elapsedNs([&] { qusd_sc::exportDelta(fromTick, delta); });
+    qusd_sc::StateRootOutput sender = qusd_sc::endTick();
+    uint64_t writeNs = elapsedNs([&] { qusd_sc::saveSnapshot(full); });
+
+    if (qusd_sc::loadSnapshot(base)) qusd_sc::reseedIndexes();
+    bool applied = false;
+    uint64_t applyNs = elapsedNs([&] { applied = qusd_sc::applyDelta(delta); });
+    bool deltaRootOk = applied && memcmp(qusd_sc::endJournalReplay().root, sender.root, 32) == 0;
+
+    bool loaded = false;
+    uint64_t loadNs = elapsedNs([&] { loaded = qusd_sc::loadSnapshot(full); });
+    uint64_t reseedNs = elapsedNs([] {
+        if (qusd_sc::indexReseedPending) qusd_sc::reseedIndexes();
+    });
+    bool snapshotRootOk = loaded && memcmp(qusd_sc::getStateRoot().root, sender.root, 32) == 0;
+    uint64_t snapshotBytes = fileBytes(full);
+    unlink(base.c_str());
+    unlink(full.c_str());
+    if (!deltaRootOk || !snapshotRootOk) {
+        fprintf(stderr, "receiver root differs from the sender's (delta %s, snapshot %s)\n",
+                deltaRootOk ? "ok" : "differs", snapshotRootOk ? "ok" : "differs");
+        return 1;
+    }
+
+    rep.setup = "qusd, " + std::to_string(n) + " accounts, " + std::to_string(k) + " changed (mints to random accounts)";
+    rep.add("delta bytes", double(delta.str().size()), "B");
+    rep.add("delta export", exportNs / 1e6, "ms");
+    rep.add("delta apply", applyNs / 1e6, "ms");
+    rep.add("snapshot bytes", double(snapshotBytes), "B");
+    rep.add("snapshot write", writeNs / 1e6, "ms");
+    rep.add("snapshot load (to first query)", loadNs / 1e6, "ms");
+    rep.add("snapshot index rebuild", reseedNs / 1e6, "ms");
+    return 0;
+}
+
+// ---- coldstart: restart to first query, restoring a snapshot vs replaying history ----
+// Replay re-executes the mints that built `size` accounts and commits the root;
+// restore maps the snapshot written from that state. The replayed state is dropped
+// before the restore is timed, so the restore does not pay for freeing it.
+// Then the snapshot is restored again and, with the index reseed still pending and
+// a mint to an old and a new account made, saved with saveSnapshotInBackground();
+// the caller's time is reported, and the file must equal a foreground save made
+// once the indexes are adopted.
+int runColdStart(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = std::min<uint64_t>(pick(o.size, 10000000), UINT32_MAX);
+    const std::string path = o.dir + "/qbench-coldstart.snap";
+    uint64_t replayNs = elapsedNs([n] {
+        mintQusdAccounts(n);
+        qusd_sc::endTick();
+    });
+    bool saved = false;
+    uint64_t writeNs = elapsedNs([&] { saved = qusd_sc::saveSnapshot(path); });
+    qusd_sc::StateRootOutput replayed = qusd_sc::getStateRoot();
+    if (!saved) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+    std::map<std::vector<uint8_t>, uint64_t>().swap(qusd_sc::balances);
+    qusd_sc::balanceTree = decltype(qusd_sc::balanceTree)();
+    qusd_sc::holders = decltype(qusd_sc::holders)();
+    qusd_sc::dirtyBalances.restart(qusd_sc::dirtyBalances.currentTick());
+
+    qusd_sc::BalanceOfInput q = {};
+    qusdAccount(uint32_t(n / 2), q.account);
+    bool loaded = false;
+    uint64_t balance = 0;
+    uint64_t loadNs = elapsedNs([&] { loaded = qusd_sc::loadSnapshot(path); });
+    uint64_t queryNs = elapsedNs([&] { balance = qusd_sc::balanceOf(q).balance; });
+    uint64_t reseedNs = elapsedNs([] {
+        if (qusd_sc::indexReseedPending) qusd_sc::reseedIndexes();
+    });
+    bool same = loaded && balance == 1000 && memcmp(qusd_sc::getStateRoot().root, replayed.root, 32) == 0;
+    uint64_t bytes = fileBytes(path);
+
+    static const uint8_t custodian[32] = {};
+    const std::string background = path + ".bg", foreground = path + ".fg";
+    qusd_sc::MintBurnInput in = {};
+    in.amount = 1;
+    bool pending = qusd_sc::loadSnapshot(path) && qusd_sc::indexReseedPending;
+    for (uint32_t account : {uint32_t(n / 2), uint32_t(n)}) {
+        qusdAccount(account, in.to_or_from);
+        qusd_sc::mint(in, custodian);
+    }
+    pid_t pid = -1;
+    uint64_t backgroundNs = elapsedNs([&] { pid = qusd_sc::saveSnapshotInBackground(background); });
+    int status;
+    while ((status = reapBackgroundSnapshot(pid)) < 0) usleep(1000);
+    if (qusd_sc::indexReseedPending) qusd_sc::reseedIndexes();
+    bool saveSame = pending && status == 0 && qusd_sc::saveSnapshot(foreground) &&
+                    fileContents(background) == fileContents(foreground);
+    unlink(path.c_str());
+    unlink(background.c_str());
+    unlink(foreground.c_str());
+    if (!same) {
+        fprintf(stderr, "restored state differs from the replayed one\n");
+        return 1;
+    }
+    if (!saveSame) {
+        fprintf(stderr, "background snapshot during the reseed differs from a foreground one\n");
+        return 1;
+    }
+
+    rep.setup = "qusd, " + std::to_string(n) + " accounts, snapshot " + std::to_string(bytes >> 20) + " MiB";
+    rep.add("replay to first query", replayNs / 1e6, "ms");
+    rep.add("snapshot write", writeNs / 1e6, "ms");
+    rep.add("restore to first query", (loadNs + queryNs) / 1e6, "ms");
+    rep.add("  of which first balanceOf", queryNs / 1e3, "us");
+    rep.add("indexes ready after restore", (loadNs + queryNs + reseedNs) / 1e6, "ms");
+    rep.add("saveSnapshotInBackground during reseed (caller)", backgroundNs / 1e6, "ms");
+    return 0;
+}
+
+// ---- emit: cost of one event into the ring (qevents.hpp) ----
+// emitEvent() with two 32-byte keys into the in-process ring, the same into a
+// ring backed by a spill file, and a key over 32 bytes (stored as its K12 digest),
+// first repeated as contracts emit it, then a new key every event so each one
+// misses the digest cache. The cached digest must match a fresh K12.
+int runEmit(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t events = pick(o.rounds, 10000000);
+    const std::string path = o.dir + "/qbench-emit.qevt";
+    uint8_t subject[32], counterparty[32];
+    qusdAccount(1, subject);
+    qusdAccount(2, counterparty);
+    std::string longKey(48, 'k');
+    EventLog spill;
+    if (!spill.open(path)) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    auto measure = [&](const char* what, auto emitOne) {
+        uint64_t allocs = allocations.load();
+        uint64_t ns = elapsedNs([&] {
+            for (uint64_t i = 0; i < events; ++i) emitOne(i);
+        });
+        rep.add(std::string(what) + " per event", double(ns) / double(events), "ns");
+        rep.add(std::string(what) + " allocations", double(allocations.load() - allocs) / double(events), "per event");
+    };
+    measure("emitEvent (in-process ring)", [&](uint64_t i) {
+        emitEvent(EventContract::QUSD, EventType::Transfer, subject, counterparty, i);
+    });
+    measure("EventLog::emit (spill file)", [&](uint64_t i) {
+        spill.emit(EventContract::QUSD, EventType::Transfer, subject, counterparty, i, 0);
+    });
+    measure("emitEvent (48-byte key)", [&](uint64_t i) {
+        emitEvent(EventContract::QNOSIS_VESTING, EventType::ClaimVesting, longKey, subject, i);
+    });
+    measure("emitEvent (new 48-byte key)", [&](uint64_t i) {
+        memcpy(&longKey[0], &i, sizeof(i));
+        emitEvent(EventContract::QNOSIS_VESTING, EventType::ClaimVesting, longKey, subject, i);
+    });
+    EventRecord r = {};
+    uint8_t expect[32];
+    fillEventRecord(r, EventContract::QNOSIS_VESTING, EventType::ClaimVesting, longKey, subject, 0, 0);
+    KangarooTwelve(reinterpret_cast<const uint8_t*>(longKey.data()), unsigned(longKey.size()), expect, 32);
+    if (r.subjectLen != EVENT_KEY_DIGEST || memcmp(r.subject, expect, 32) != 0) {
+        fprintf(stderr, "cached key digest differs from K12\n");
+        return 1;
+    }
+    spill.close();
+    unlink(path.c_str());
+    rep.setup = std::to_string(events) + " events per row, ring of " + std::to_string(EVENT_LOG_DEFAULT_CAPACITY);
+    return 0;
+}
+
+// ---- holders: holder index upkeep per transfer and query latency (qholders.hpp) ----
+// `rounds` ticks of `changed` random transfers over `size` holders. The index share
+// of a transfer is timed on its own by moving one unit back and forth between the
+// same two holders through the index only, within the tick, which leaves it as it
+// was; allocations are counted over that loop. Queries run on the final state; every
+// balanceOfAt() at the minting tick must read the minted 1000 exactly, and so must
+// every holder topHoldersAt() returns for it.
+int runHolders(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = std::min<uint64_t>(std::max<uint64_t>(pick(o.size, 10000000), 2), UINT32_MAX);
+    const uint64_t k = pick(o.changed, 10000);
+    const uint32_t rounds = uint32_t(pick(o.rounds, 10));
+    const uint64_t queries = 10000;
+    mintQusdAccounts(n);
+    const uint64_t mintTick = qusd_sc::dirtyBalances.currentTick();
+    qusd_sc::endTick();
+
+    TraceRandom rnd(o.seed);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(k);
+    uint64_t transferNs = 0, indexNs = 0, indexAllocs = 0, transfers = 0;
+    qusd_sc::TransferInput in = {};
+    uint8_t from[32];
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (auto& p : pairs) {
+            p.first = uint32_t(rnd.below(n));
+            p.second = uint32_t((p.first + 1 + rnd.below(n - 1)) % n);
+        }
+        transferNs += elapsedNs([&] {
+            for (const auto& p : pairs) {
+                qusdAccount(p.first, from);
+                qusdAccount(p.second, in.to);
+                in.amount = 1 + p.first % 100;
+                qusd_sc::transfer(in, from);
+            }
+        });
+        const uint64_t tick = qusd_sc::dirtyBalances.currentTick();
+        std::vector<uint8_t> a(32), b(32);
+        uint64_t allocs = allocations.load();
+        indexNs += elapsedNs([&] {
+            for (const auto& p : pairs) {
+                qusdAccount(p.first, a.data());
+                qusdAccount(p.second, b.data());
+                uint64_t ba = qusd_sc::holders.balanceOf(a), bb = qusd_sc::holders.balanceOf(b);
+                if (!bb) continue;
+                qusd_sc::holders.update(a, ba + 1, tick);
+                qusd_sc::holders.update(b, bb - 1, tick);
+                qusd_sc::holders.update(a, ba, tick);
+                qusd_sc::holders.update(b, bb, tick);
+            }
+        });
+        indexAllocs += allocations.load() - allocs;
+        transfers += k;
+        qusd_sc::endTick();
+    }
+
+    std::vector<uint32_t> rankNs, topNs, atNs, topAtNs;
+    qusd_sc::BalanceOfInput q = {};
+    qusd_sc::BalanceOfAtInput at = {};
+    at.tick = mintTick;
+    qusd_sc::TopHoldersInput top = {qusd_sc::MAX_TOP_HOLDERS};
+    qusd_sc::TopHoldersAtInput topAt = {mintTick, qusd_sc::MAX_TOP_HOLDERS};
+    bool consistent = true;
+    for (uint64_t i = 0; i < queries; ++i) {
+        qusdAccount(uint32_t(rnd.below(n)), q.account);
+        memcpy(at.account, q.account, 32);
+        qusd_sc::HolderRankOutput rank;
+        qusd_sc::BalanceOfAtOutput then;
+        rankNs.push_back(uint32_t(elapsedNs([&] { rank = qusd_sc::holderRank(q); })));
+        atNs.push_back(uint32_t(elapsedNs([&] { then = qusd_sc::balanceOfAt(at); })));
+        consistent &= then.exact && then.balance == 1000 && (rank.found || qusd_sc::balanceOf(q).balance == 0);
+        if (i % 100 == 0) {
+            qusd_sc::TopHoldersOutput out;
+            topNs.push_back(uint32_t(elapsedNs([&] { out = qusd_sc::topHolders(top); })));
+            for (uint32_t j = 1; j < out.count; ++j) consistent &= out.holders[j - 1].balance >= out.holders[j].balance;
+        }
+        if (i % 1000 == 0) {
+            qusd_sc::TopHoldersAtOutput out;
+            topAtNs.push_back(uint32_t(elapsedNs([&] { out = qusd_sc::topHoldersAt(topAt); })));
+            consistent &= out.exact && out.count == std::min<uint64_t>(n, qusd_sc::MAX_TOP_HOLDERS);
+            for (uint32_t j = 0; j < out.count; ++j) consistent &= out.holders[j].balance == 1000;
+        }
+    }
+    if (!consistent) {
+        fprintf(stderr, "holder index disagrees with the balances\n");
+        return 1;
+    }
+
+    rep.setup = "qusd, " + std::to_string(n) + " holders, " + std::to_string(k) + " transfers per tick, " +
+                std::to_string(rounds) + " ticks";
+    rep.add("transfer (with index upkeep)", double(transferNs) / double(transfers), "ns");
+    rep.add("  of which holder index", double(indexNs) / 2 / double(transfers), "ns");
+    rep.add("  holder index allocations", double(indexAllocs) / 2 / double(transfers), "per transfer");
+    addLatencyRows(rep, "holderRank", rankNs, 1, "ns");
+    addLatencyRows(rep, "topHolders(64)", topNs, 1, "ns");
+    addLatencyRows(rep, "balanceOfAt (mint tick)", atNs, 1, "ns");
+    addLatencyRows(rep, "topHoldersAt(64) (mint tick)", topAtNs, 1000, "us");
+    return 0;
+}
+
+// ---- bridge: custodian mints one call per deposit vs mintBatch of `changed` ----
+// Both paths credit random accounts among `size` existing holders, one tick per
+// round (endTick untimed). Each batch is then re-submitted as a bridge would after
+// a timeout: every id must come back as a duplicate and nothing be minted twice.
+int runBridge(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = std::min<uint64_t>(pick(o.size, 1000000), UINT32_MAX);
+    const uint32_t batch = uint32_t(std::min<uint64_t>(pick(o.changed, 10000), qusd_sc::MAX_BRIDGE_BATCH));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 20));
+    static const uint8_t custodian[32] = {};
+    mintQusdAccounts(n);
+    qusd_sc::endTick();
+
+    TraceRandom rnd(o.seed);
+    std::unique_ptr<qusd_sc::BridgeBatchInput> in(new qusd_sc::BridgeBatchInput());
+    uint64_t singleNs = 0, batchNs = 0, resubmitNs = 0, nextId = 0;
+    bool exact = true;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        in->count = batch;
+        in->expiryTick = qusd_sc::dirtyBalances.currentTick() + 1;
+        for (uint32_t i = 0; i < batch; ++i) {
+            qusd_sc::BridgeEntry& e = in->entries[i];
+            uint64_t id[4] = {rnd.next(), rnd.next(), o.seed, nextId++}; // random as a txid, unique by the counter
+            memcpy(e.id, id, 32);
+            qusdAccount(uint32_t(rnd.below(n)), e.account);
+            e.amount = 1 + rnd.below(1000);
+        }
+        singleNs += elapsedNs([&] {
+            qusd_sc::MintBurnInput one = {};
+            for (uint32_t i = 0; i < batch; ++i) {
+                memcpy(one.to_or_from, in->entries[i].account, 32);
+                one.amount = in->entries[i].amount;
+                qusd_sc::mint(one, custodian);
+            }
+        });
+        uint64_t supply = qusd_sc::totalSupply;
+        qusd_sc::BridgeBatchOutput first, again;
+        batchNs += elapsedNs([&] { first = qusd_sc::mintBatch(*in, custodian); });
+        resubmitNs += elapsedNs([&] { again = qusd_sc::mintBatch(*in, custodian); });
+        uint64_t minted = 0;
+        for (uint32_t i = 0; i < batch; ++i) minted += in->entries[i].amount;
+        exact &= first.accepted && first.applied == batch && again.accepted && again.duplicates == batch &&
+                 qusd_sc::totalSupply == supply + minted;
+        qusd_sc::endTick();
+    }
+    if (!exact) {
+        fprintf(stderr, "a batch was not applied exactly once\n");
+        return 1;
+    }
+
+    const double entries = double(batch) * rounds;
+    rep.setup = "qusd, " + std::to_string(n) + " accounts, batches of " + std::to_string(batch) + ", " +
+                std::to_string(rounds) + " rounds";
+    rep.add("mint (one call per deposit)", entries / (singleNs / 1e9), "mints/s");
+    rep.add("mintBatch", entries / (batchNs / 1e9), "mints/s");
+    rep.add("mintBatch re-submitted (all duplicates)", entries / (resubmitNs / 1e9), "ids/s");
+    rep.add("processed ids live", double(qusd_sc::processedBridgeIds.size()), "ids");
+    return 0;
+}
+
+// ---- auth: signer-slot authorization and approvals (qsignerset.hpp) ----
+// A `size`-owner vault (threshold = every owner) checks owners and collects every
+// owner's approval on `rounds` proposals; the vesting contract checks a threshold
+// proof against its full signer set. All proposals must end up executable.
+int runAuth(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint32_t ownerCount = uint32_t(std::min<uint64_t>(pick(o.size, 32), SIGNER_SET_CAPACITY));
+    const uint64_t proposals = pick(o.rounds, 100000);
+    const uint64_t checks = 10000000;
+    std::vector<std::string> owners;
+    for (uint32_t i = 0; i < ownerCount; ++i) owners.push_back("owner" + std::to_string(i));
+    qgnosis_sc::Qnosis v(owners, ownerCount);
+
+    bool exact = true;
+    uint64_t hits = 0;
+    const std::string stranger = "stranger";
+    uint64_t ownerNs = elapsedNs([&] {
+        for (uint64_t i = 0; i < checks; ++i) hits += v.isOwner((i & 1) ? stranger : owners[i % ownerCount]);
+    });
+    exact &= hits == checks / 2;
+
+    for (uint64_t i = 0; i < proposals; ++i) v.propose(owners[0], "to", 1, "");
+    uint64_t signNs = elapsedNs([&] {
+        for (uint64_t nonce = 1; nonce <= proposals; ++nonce)
+            for (const std::string& owner : owners) v.sign(nonce, owner);
+    });
+    for (uint64_t nonce = 1; nonce <= proposals; ++nonce) exact &= v.canExecute(nonce);
+
+    const std::vector<std::string> proof = vestingSignerProof();
+    std::vector<std::string> forged = {proof[0]}; // one real signer, repeated strangers
+    forged.resize(proof.size(), stranger);
+    uint64_t allowed = 0;
+    uint64_t vestingNs = elapsedNs([&] {
+        for (uint64_t i = 0; i < checks; ++i) allowed += vesting_sc::isAuthorized((i & 1) ? forged : proof);
+    });
+    exact &= allowed == checks / 2;
+    if (!exact) {
+        fprintf(stderr, "authorization disagrees with the signer sets\n");
+        return 1;
+    }
+
+    rep.setup = "qgnosis " + std::to_string(ownerCount) + " owners, " + std::to_string(proposals) +
+                " proposals signed by all; vesting " + std::to_string(int(vesting_sc::THRESHOLD)) + "-of-" +
+                std::to_string(vesting_sc::signers.size()) + " proofs";
+    rep.add("Qnosis::isOwner (half strangers)", checks / (ownerNs / 1e9), "checks/s");
+    rep.add("Qnosis::sign", double(proposals) * ownerCount / (signNs / 1e9), "signs/s");
+    rep.add("vesting isAuthorized (half forged)", checks / (vestingNs / 1e9), "checks/s");
+    return 0;
+}
+
+// ---- proposals: memory and lookups after `size` proposals, 1 in 1000 left pending ----
+// A one-owner vault with a file-backed archive proposes, signs and executes in
+// nonce order, closing a tick every `changed` proposals. Lookups go to random
+// nonces; each view must report the right nonce and executed flag. Anonymous
+// memory leaves out the mapped archive, whose pages the kernel can drop; its growth
+// includes the delta log's window of touched nonces (DELTA_RETAINED_TICKS ticks).
+int runProposals(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = pick(o.size, 10000000);
+    const uint64_t perTick = pick(o.changed, 10000);
+    const uint64_t lookups = pick(o.rounds, 100000);
+    const std::string path = o.dir + "/qbench-proposals.qarc";
+    unlink(path.c_str());
+    unlink((path + ".idx").c_str());
+    const std::string owner = "owner0";
+    qgnosis_sc::Qnosis v({owner}, 1);
+    if (!v.openArchive(path)) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    const uint64_t anonBeforeKb = anonRssKb();
+    uint64_t fillNs = elapsedNs([&] {
+        for (uint64_t i = 1; i <= n; ++i) {
+            uint64_t nonce = v.propose(owner, "recipient", i, "");
+            if (nonce % 1000 != 0) {
+                v.sign(nonce, owner);
+                v.execute(nonce);
+            }
+            if (i % perTick == 0) v.endTick();
+        }
+        v.endTick();
+    });
+
+    TraceRandom rnd(o.seed);
+    std::vector<uint32_t> archivedNs, hotNs;
+    bool exact = true;
+    for (uint64_t i = 0; i < lookups; ++i) {
+        // Alternate pending and archived nonces
+        bool pending = (i & 1) && n >= 1000;
+        uint64_t nonce = pending ? 1000 * (1 + rnd.below(n / 1000)) : 1 + rnd.below(n);
+        if (!pending && nonce % 1000 == 0) --nonce;
+        qgnosis_sc::Qnosis::ProposalView view;
+        uint32_t ns = uint32_t(elapsedNs([&] { view = v.getProposal(nonce); }));
+        (pending ? hotNs : archivedNs).push_back(ns);
+        exact &= view.nonce == nonce && view.executed == !pending && view.value == nonce;
+    }
+    exact &= v.pendingProposals() == n / 1000;
+    uint64_t anonKb = anonRssKb() - std::min(anonRssKb(), anonBeforeKb);
+    uint64_t archiveBytes = fileBytes(path) + fileBytes(path + ".idx");
+    unlink(path.c_str());
+    unlink((path + ".idx").c_str());
+    if (!exact) {
+        fprintf(stderr, "a proposal view disagrees with what was proposed\n");
+        return 1;
+    }
+
+    rep.setup = "qgnosis, " + std::to_string(n) + " proposals (1 in 1000 pending), archive in " + o.dir;
+    rep.add("propose + sign + execute", double(n) / (fillNs / 1e9), "proposals/s");
+    rep.add("hot proposals", double(v.pendingProposals()), "");
+    rep.add("anonymous memory growth", anonKb / 1024.0, "MiB");
+    rep.add("archive on disk", archiveBytes / 1048576.0, "MiB");
+    addLatencyRows(rep, "getProposal (archived)", archivedNs, 1, "ns");
+    addLatencyRows(rep, "getProposal (pending)", hotNs, 1, "ns");
+    return 0;
+}
+
+// ---- queries: ready/awaiting pages vs a canExecute scan over `size` open proposals ----
+// A 3-of-5 vault where 1 in 100 proposals has reached the threshold and owner0 has
+// signed half of the rest. Paging through the ready index must find exactly the
+// nonces the full scan finds.
+int runQueries(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = pick(o.size, 1000000);
+    const uint32_t rounds = uint32_t(pick(o.rounds, 100));
+    const size_t pageSize = 100;
+    std::vector<std::string> owners;
+    for (int i = 0; i < 5; ++i) owners.push_back("owner" + std::to_string(i));
+    qgnosis_sc::Qnosis v(owners, 3);
+    TraceRandom rnd(o.seed);
+    for (uint64_t i = 1; i <= n; ++i) {
+        uint64_t nonce = v.propose(owners[0], "recipient", i, "");
+        if (nonce % 100 == 0) {
+            for (int s = 0; s < 3; ++s) v.sign(nonce, owners[s]);
+        } else if (rnd.below(2)) {
+            v.sign(nonce, owners[0]);
+        }
+    }
+
+    std::vector<uint64_t> scanned, paged;
+    std::vector<uint32_t> scanNs, readyNs, awaitingNs, pendingNs;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        scanned.clear();
+        scanNs.push_back(uint32_t(std::min<uint64_t>(elapsedNs([&] {
+            for (uint64_t nonce = 1; nonce <= n; ++nonce)
+                if (v.canExecute(nonce)) scanned.push_back(nonce);
+        }), UINT32_MAX)));
+        readyNs.push_back(uint32_t(elapsedNs([&] { v.getReadyToExecute(0, pageSize); })));
+        awaitingNs.push_back(uint32_t(elapsedNs([&] { v.getAwaitingSignature(owners[0], 0, pageSize); })));
+        pendingNs.push_back(uint32_t(elapsedNs([&] { v.getPendingProposals(0, pageSize); })));
+    }
+    uint64_t allPagesNs = elapsedNs([&] {
+        for (uint64_t cursor = 0;;) {
+            qgnosis_sc::Qnosis::ProposalPage page = v.getReadyToExecute(cursor, pageSize);
+            paged.insert(paged.end(), page.nonces.begin(), page.nonces.end());
+            if (!page.nextCursor) break;
+            cursor = page.nextCursor;
+        }
+    });
+    if (paged != scanned || scanned.size() != n / 100) {
+        fprintf(stderr, "ready pages (%zu nonces) differ from the scan (%zu)\n", paged.size(), scanned.size());
+        return 1;
+    }
+
+    rep.setup = "qgnosis 3-of-5, " + std::to_string(n) + " open proposals, " + std::to_string(scanned.size()) +
+                " ready, pages of " + std::to_string(pageSize);
+    addLatencyRows(rep, "full canExecute scan", scanNs, 1e6, "ms");
+    addLatencyRows(rep, "getReadyToExecute page", readyNs, 1e3, "us");
+    addLatencyRows(rep, "getAwaitingSignature page", awaitingNs, 1e3, "us");
+    addLatencyRows(rep, "getPendingProposals page", pendingNs, 1e3, "us");
+    rep.add("every ready nonce, paged", allPagesNs / 1e6, "ms");
+    return 0;
+}
+
+// ---- multicall: executed actions/s, one per proposal vs `changed` per multicall ----
+// A 2-of-3 vault holding qusd sends 1-unit qusd transfers three ways: one proposal
+// per transfer, each executed alone; the same proposals through executeBatch; and
+// one multicall proposal carrying `changed` transfers. Only execution is timed.
+// The vault's balance must drop by exactly the transfers made. Last, qusd is rebound
+// to refuse one transfer in the middle of a multicall: the execution must fail with
+// every transfer before it reversed and the proposal still pending.
+int runMulticall(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint32_t batch = uint32_t(std::min<uint64_t>(pick(o.changed, 1000),
+                                                       qgnosis_sc::Qnosis::MAX_MULTICALL_CALLS));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 100));
+    const uint64_t actions = uint64_t(batch) * rounds;
+    constexpr uint32_t RECIPIENTS = 1024;
+
+    Hash256 vaultId;
+    callsAccount(0x5A5A5A5A5A5A5A5AULL, vaultId.data());
+    static const uint8_t custodian[32] = {};
+    qusd_sc::MintBurnInput mint = {};
+    memcpy(mint.to_or_from, vaultId.data(), 32);
+    mint.amount = 1ULL << 40;
+    qusd_sc::mint(mint, custodian);
+    qusd_sc::bindCalls(callBus());
+    std::vector<std::string> owners = {"owner0", "owner1", "owner2"};
+    qgnosis_sc::Qnosis safe(owners, 2);
+    safe.setDomain(vaultId);
+    std::vector<qgnosis_sc::Qnosis::CallInput> subs(batch);
+    for (uint32_t i = 0; i < batch; ++i) {
+        uint8_t to[32];
+        callsAccount(1 + i % RECIPIENTS, to);
+        subs[i] = {"transfer", std::string(reinterpret_cast<const char*>(to), 32), 1, "qusd"};
+    }
+    qusd_sc::BalanceOfInput vaultQuery = {};
+    memcpy(vaultQuery.account, vaultId.data(), 32);
+    const uint64_t before = qusd_sc::balanceOf(vaultQuery).balance;
+
+    auto proposeSigned = [&](const qgnosis_sc::Qnosis::CallInput& c, const std::string& data, const char* action) {
+        uint64_t nonce = safe.propose(owners[0], c.to, c.value, data, action, c.param);
+        safe.sign(nonce, owners[0]);
+        safe.sign(nonce, owners[1]);
+        return nonce;
+    };
+    std::vector<uint64_t> nonces(batch);
+    uint64_t singleNs = 0, batchNs = 0, multicallNs = 0;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < batch; ++i) nonces[i] = proposeSigned(subs[i], "", "transfer");
+        singleNs += elapsedNs([&] {
+            for (uint64_t nonce : nonces) safe.execute(nonce);
+        });
+        for (uint32_t i = 0; i < batch; ++i) nonces[i] = proposeSigned(subs[i], "", "transfer");
+        batchNs += elapsedNs([&] { safe.executeBatch(nonces); });
+        uint64_t nonce = proposeSigned({"multicall", "tokens", 0, ""}, safe.encodeMulticall(subs), "multicall");
+        multicallNs += elapsedNs([&] { safe.execute(nonce); });
+        qusd_sc::endTick();
+    }
+    if (before - qusd_sc::balanceOf(vaultQuery).balance != 3 * actions) {
+        fprintf(stderr, "vault balance does not match the transfers executed\n");
+        return 1;
+    }
+
+    constexpr uint64_t REFUSED = 7;
+    callBus().bind<CallTransferInput, CallTransferOutput>(EventContract::QUSD, CallProcedure::Transfer, nullptr,
+        [](void*, const uint8_t caller[32], const CallTransferInput& input, CallTransferOutput& output) {
+            output.ok = input.amount != REFUSED && qusd_sc::moveBalance(caller, input.to, input.amount);
+        });
+    std::vector<qgnosis_sc::Qnosis::CallInput> flaky(subs.begin(), subs.begin() + std::min<uint32_t>(batch, 8));
+    flaky[flaky.size() / 2].value = REFUSED;
+    qusd_sc::BalanceOfInput firstQuery = {};
+    memcpy(firstQuery.account, flaky[0].to.data(), 32);
+    const uint64_t vaultBefore = qusd_sc::balanceOf(vaultQuery).balance;
+    const uint64_t firstBefore = qusd_sc::balanceOf(firstQuery).balance;
+    uint64_t nonce = proposeSigned({"multicall", "tokens", 0, ""}, safe.encodeMulticall(flaky), "multicall");
+    bool refused = false;
+    try {
+        safe.execute(nonce);
+    } catch (const std::exception&) {
+        refused = true;
+    }
+    qusd_sc::bindCalls(callBus());
+    if (!refused || safe.isExecuted(nonce) || qusd_sc::balanceOf(vaultQuery).balance != vaultBefore ||
+        qusd_sc::balanceOf(firstQuery).balance != firstBefore) {
+        fprintf(stderr, "a refused transfer left earlier transfers of its multicall in place\n");
+        return 1;
+    }
+
+    rep.setup = "qgnosis 2-of-3, qusd transfers, " + std::to_string(batch) + " actions per batch, " +
+                std::to_string(rounds) + " rounds";
+    rep.add("execute, 1 action per proposal", actions / (singleNs / 1e9), "actions/s");
+    rep.add("executeBatch, 1 action per proposal", actions / (batchNs / 1e9), "actions/s");
+    rep.add("execute, multicall of " + std::to_string(batch), actions / (multicallNs / 1e9), "actions/s");
+    return 0;
+}
+
+// ---- signed: submitSigned vs propose, sign..., execute for 3-of-5 and 7-of-10 ----
+// Owners are Dilithium-sized keys and every verification costs --verify-us of busy
+// time. The incremental flow is one transaction per step, each paying one
+// verification of its sender's signature; submitSigned gets every owner's
+// signature and verifies on the shared workers until the threshold is met.
+// Round trips between transactions are not modelled. Every proposal must execute.
+int runSigned(const ScenarioOptions& o, ScenarioReport& rep) {
+    using qgnosis_sc::Qnosis;
+    const uint32_t rounds = uint32_t(pick(o.rounds, 200));
+    standinVerifyNs = uint64_t(o.verifyUs) * 1000;
+    Hash256 vaultId;
+    callsAccount(0x3C3C3C3C3C3C3C3CULL, vaultId.data());
+    bool exact = true;
+    for (const auto& [threshold, ownerCount] : {std::pair<uint32_t, uint32_t>{3, 5}, {7, 10}}) {
+        std::vector<std::string> owners;
+        std::vector<Qnosis::OwnerSignature> sigs;
+        for (uint32_t i = 0; i < ownerCount; ++i) {
+            owners.push_back(std::string(Qnosis::OWNER_PUBKEY_SIZE, char('A' + i)));
+            sigs.push_back({i, std::vector<uint8_t>(Qnosis::OWNER_SIG_SIZE, 0)});
+        }
+        Qnosis v(owners, threshold);
+        v.setDomain(vaultId);
+        std::vector<uint32_t> incrementalNs, signedNs;
+        for (uint32_t r = 0; r < rounds; ++r) {
+            const std::string to = "recipient" + std::to_string(r);
+            uint64_t nonce = 0;
+            incrementalNs.push_back(uint32_t(elapsedNs([&] {
+                standinVerifyTime();
+                nonce = v.propose(owners[0], to, r, "");
+                for (uint32_t s = 0; s < threshold; ++s) {
+                    standinVerifyTime();
+                    v.sign(nonce, owners[s]);
+                }
+                standinVerifyTime();
+                v.execute(nonce);
+            })));
+            exact &= v.isExecuted(nonce);
+            signedNs.push_back(uint32_t(elapsedNs([&] {
+                standinVerifyTime(); // the submitting transaction itself
+                nonce = v.submitSigned(v.proposalHash(v.nextNonce(), to, r, ""), sigs, to, r, "");
+            })));
+            exact &= v.isExecuted(nonce);
+        }
+        const std::string shape = std::to_string(threshold) + "-of-" + std::to_string(ownerCount);
+        addLatencyRows(rep, shape + " incremental (" + std::to_string(threshold + 2) + " tx)", incrementalNs, 1e3, "us");
+        addLatencyRows(rep, shape + " submitSigned (1 tx)", signedNs, 1e3, "us");
+    }
+    standinVerifyNs = 0;
+    if (!exact) {
+        fprintf(stderr, "a proposal did not execute\n");
+        return 1;
+    }
+    rep.setup = std::to_string(rounds) + " proposals per shape, " + std::to_string(o.verifyUs) +
+                " us per verification, " + std::to_string(sharedWorkers().concurrency()) + " threads";
+    return 0;
+}
+
+// ---- claims: claimAll vs one claimVesting per grant, `size` grants per user ----
+// `rounds` users each hold `size` linear grants, half vested when the claims run.
+// Even users claim grant by grant, odd users with one claimAll; both must end with
+// exactly half of every grant credited.
+int runClaims(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t grants = pick(o.size, 1000);
+    const uint32_t users = std::max<uint32_t>(uint32_t(pick(o.rounds, 100)), 2);
+    const uint64_t amount = 1000, duration = 1000, start = 1700000000;
+    const std::vector<std::string> proof = vestingSignerProof();
+    setTickTimestamp(start);
+    std::vector<std::string> who(users), ids(grants);
+    for (uint32_t u = 0; u < users; ++u) {
+        who[u] = "claimer" + std::to_string(u);
+        vesting_sc::mint(who[u], grants * amount, proof);
+        for (uint64_t g = 0; g < grants; ++g)
+            vesting_sc::createVesting(who[u] + "/" + std::to_string(g), who[u], amount, start, duration, proof);
+    }
+    setTickTimestamp(start + duration / 2);
+
+    std::vector<uint32_t> perIdNs, allNs;
+    bool exact = true;
+    for (uint32_t u = 0; u < users; ++u) {
+        if (u % 2 == 0) {
+            for (uint64_t g = 0; g < grants; ++g) ids[g] = who[u] + "/" + std::to_string(g);
+            perIdNs.push_back(uint32_t(std::min<uint64_t>(elapsedNs([&] {
+                for (const std::string& id : ids) vesting_sc::claimVesting(id, who[u]);
+            }), UINT32_MAX)));
+        } else {
+            allNs.push_back(uint32_t(std::min<uint64_t>(elapsedNs([&] { vesting_sc::claimAll(who[u]); }), UINT32_MAX)));
+        }
+        exact &= vesting_sc::readBalance(who[u]) == grants * amount / 2;
+    }
+    vesting_sc::endTick();
+    if (!exact) {
+        fprintf(stderr, "a user was not credited exactly half of every grant\n");
+        return 1;
+    }
+
+    rep.setup = "vesting, " + std::to_string(users) + " users with " + std::to_string(grants) + " grants each";
+    addLatencyRows(rep, "claimVesting per grant, per user", perIdNs, 1e3, "us");
+    addLatencyRows(rep, "claimAll, per user", allNs, 1e3, "us");
+    std::sort(perIdNs.begin(), perIdNs.end());
+    std::sort(allNs.begin(), allNs.end());
+    rep.add("claimAll speedup (p50)", double(percentileNs(perIdNs, 0.5)) / std::max<uint32_t>(percentileNs(allNs, 0.5), 1),
+            "x");
+    return 0;
+}
+
+// ---- columns: bulk vestedAt(t) over `size` grants, scalar vs the column kernel ----
+// The store is filled directly (10M string-keyed grants do not fit the contract's
+// maps on a small box). 1 in 64 grants has a total past the vector path's exact
+// range so the scalar fix-up runs too. Every kernel result must equal
+// linearVested(), and totalsAt() the scalar sums. The kernel is AVX2 only when
+// built with -mavx2 (or -march=native); otherwise both rows run the scalar code.
+int runColumns(const ScenarioOptions& o, ScenarioReport& rep) {
+    const size_t n = size_t(pick(o.size, 10000000));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 5));
+    const uint64_t now = 1700000000;
+    TraceRandom rnd(o.seed);
+    VestingStore store;
+    store.reserve(n);
+    std::vector<uint64_t> start(n), duration(n), total(n), claimed(n);
+    for (size_t i = 0; i < n; ++i) {
+        duration[i] = 1 + rnd.below(uint64_t(1) << 31);
+        start[i] = now - duration[i] + rnd.below(2 * duration[i]);
+        total[i] = i % 64 == 63 ? (uint64_t(1) << 62) + rnd.below(uint64_t(1) << 62) : 1 + rnd.below(uint64_t(1) << 50);
+        claimed[i] = rnd.below(total[i] / 2 + 1);
+        store.append(start[i], duration[i], total[i], claimed[i], 0);
+    }
+
+    std::vector<uint64_t> scalar(n), kernel(n), parallel;
+    VestingTotals totals;
+    uint64_t scalarNs = 0, kernelNs = 0, parallelNs = 0, totalsNs = 0;
+    bool exact = true;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        const uint64_t t = now + r * 86400;
+        scalarNs += elapsedNs([&] {
+            for (size_t i = 0; i < n; ++i) scalar[i] = linearVested(total[i], start[i], duration[i], t);
+        });
+        kernelNs += elapsedNs([&] { store.vestedAt(t, 0, n, kernel.data()); });
+        parallelNs += elapsedNs([&] { parallel = store.vestedAt(t); });
+        totalsNs += elapsedNs([&] { totals = store.totalsAt(t); });
+        VestingTotals expect;
+        for (size_t i = 0; i < n; ++i) {
+            expect.vested += scalar[i];
+            expect.claimed += claimed[i];
+            expect.claimable += scalar[i] - std::min(scalar[i], claimed[i]);
+        }
+        exact &= kernel == scalar && parallel == scalar && totals.vested == expect.vested &&
+                 totals.claimed == expect.claimed && totals.claimable == expect.claimable;
+    }
+    if (!exact) {
+        fprintf(stderr, "the column kernel disagrees with linearVested\n");
+        return 1;
+    }
+
+#if defined(__AVX2__)
+    const char* kernelName = "AVX2";
+#else
+    const char* kernelName = "scalar (built without AVX2)";
+#endif
+    const double evaluated = double(n) * rounds;
+    rep.setup = std::to_string(n) + " grants, " + std::to_string(rounds) + " evaluation times, " + kernelName +
+                " kernel, " + std::to_string(sharedWorkers().concurrency()) + " threads";
+    rep.add("linearVested, scalar loop", evaluated / (scalarNs / 1e9), "grants/s");
+    rep.add("VestingStore::vestedAt, one thread", evaluated / (kernelNs / 1e9), "grants/s");
+    rep.add("VestingStore::vestedAt, workers", evaluated / (parallelNs / 1e9), "grants/s");
+    rep.add("VestingStore::totalsAt, workers", evaluated / (totalsNs / 1e9), "grants/s");
+    return 0;
+}
+
+// ---- unlocks: vesting endTick() with `size` scheduled grants on the timer wheel ----
+// Grants alternate 4-step and cliff schedules starting within the `rounds`-tick
+// window (one tick per second); half credit their unlocks automatically. Each
+// endTick() fires the unlocks due. A polling pass (vestedAmount over every grant)
+// is timed for comparison. Afterwards every auto-claim grant must hold exactly
+// what had vested at its last passed breakpoint.
+int runUnlocks(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = pick(o.size, 1000000);
+    const uint32_t ticks = uint32_t(pick(o.rounds, 1000));
+    const uint64_t start = 1700000000, amount = 1000;
+    const std::vector<std::string> proof = vestingSignerProof();
+    TraceRandom rnd(o.seed);
+    setTickTimestamp(start);
+    const std::string holder = "scheduler";
+    vesting_sc::mint(holder, n * amount, proof);
+    std::vector<std::string> ids(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        ids[i] = "sched" + std::to_string(i);
+        uint64_t begin = start + rnd.below(ticks), span = 1 + rnd.below(ticks);
+        VestingSchedule s = i % 2 ? VestingSchedule::cliff(amount, begin, span / 4, span)
+                                  : VestingSchedule::steps(amount, begin, 1 + span / 4, 4);
+        vesting_sc::createScheduledVesting(ids[i], holder, s, i % 4 < 2, proof);
+    }
+    vesting_sc::endTick();
+
+    std::vector<uint32_t> tickNs;
+    uint64_t fired = 0, eventsBefore = eventLog().head();
+    for (uint32_t t = 1; t <= ticks; ++t) {
+        setTickTimestamp(start + t);
+        tickNs.push_back(uint32_t(std::min<uint64_t>(elapsedNs([] { vesting_sc::endTick(); }), UINT32_MAX)));
+    }
+    fired = eventLog().head() - eventsBefore;
+    const uint64_t now = tickTimestamp();
+    uint64_t pending = 0;
+    uint64_t pollNs = elapsedNs([&] {
+        for (const auto& e : vesting_sc::vestings) pending += vesting_sc::vestedAmount(e.second, now) - e.second.claimedAmount;
+    });
+    bool exact = pending > 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        const vesting_sc::Vesting& v = vesting_sc::vestings.at(ids[i]);
+        if (v.autoClaim)
+            exact &= v.claimedAmount == vesting_sc::vestedAmount(v, v.unlockedThrough) &&
+                     vesting_sc::nextUnlock(v, v.unlockedThrough) > now;
+    }
+    if (!exact) {
+        fprintf(stderr, "an auto-claim grant missed an unlock\n");
+        return 1;
+    }
+
+    rep.setup = "vesting, " + std::to_string(n) + " scheduled grants (half auto-claim), " + std::to_string(ticks) +
+                " ticks of 1 s";
+    addLatencyRows(rep, "endTick", tickNs, 1e3, "us");
+    rep.add("unlock and claim events per tick", double(fired) / ticks, "events");
+    rep.add("polling pass over every grant", pollNs / 1e6, "ms");
+    return 0;
+}
+
+// ---- pool: oracle-priced swaps/s, one at a time vs batched (bankonpythai-pool.cpp) ----
+// 1000 traders holding STX swap against a deep cBTC pool; `changed` swaps per tick
+// over `rounds` ticks, three ways: swapStx (one oracle read per swap), swapBatch
+// and queueSwap + settleTick (one read per tick). Every fill must succeed and pay
+// cbtcSatsOut() at the tick's price.
+int runPool(const ScenarioOptions& o, ScenarioReport& rep) {
+    using namespace pool_sc;
+    const uint32_t perTick = uint32_t(pick(o.changed, 10000));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 20));
+    const std::string admin = "QBENCH_ORACLE", authority = "QBENCH_POOL", provider = "QBENCH_LP";
+    const uint64_t stxPrice = 2ULL * 100000000ULL, btcPrice = 60000ULL * 100000000ULL;
+    QOracle oracle(admin);
+    BankonPythaiPool pool(oracle, authority);
+    setTickTimestamp(1700000000);
+    oracle.pushPrice(POOL_STX_FEED, stxPrice, 8, admin);
+    oracle.pushPrice(POOL_BTC_FEED, btcPrice, 8, admin);
+    pool.mint(1000000 * SATS_PER_BTC, provider, authority);
+    pool.addCbtcLiquidity(provider, 1000000 * SATS_PER_BTC);
+    std::vector<std::string> traders;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        traders.push_back("trader" + std::to_string(i));
+        pool.depositStx(traders.back(), uint64_t(1) << 50);
+    }
+
+    TraceRandom rnd(o.seed);
+    std::vector<SwapOrder> orders(perTick);
+    uint64_t singleNs = 0, batchNs = 0, settleNs = 0;
+    bool exact = true;
+    auto check = [&](const SwapOrder& order, const SwapFill& f) {
+        uint64_t expect = 0;
+        exact &= f.error == POOL_OK && cbtcSatsOut(order.stxIn, stxPrice, btcPrice, expect) && f.cbtcSatsOut == expect;
+    };
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (auto& order : orders) order = {traders[rnd.below(traders.size())], 1000000 + rnd.below(100000000), 0};
+        std::vector<SwapFill> fills(perTick);
+        singleNs += elapsedNs([&] {
+            for (uint32_t i = 0; i < perTick; ++i) fills[i] = pool.swapStx(orders[i].trader, orders[i].stxIn);
+        });
+        for (uint32_t i = 0; i < perTick; ++i) check(orders[i], fills[i]);
+        batchNs += elapsedNs([&] { fills = pool.swapBatch(orders); });
+        for (uint32_t i = 0; i < perTick; ++i) check(orders[i], fills[i]);
+        settleNs += elapsedNs([&] {
+            for (const SwapOrder& order : orders) pool.queueSwap(order.trader, order.stxIn);
+            fills = pool.settleTick();
+        });
+        for (uint32_t i = 0; i < perTick; ++i) check(orders[i], fills[i]);
+    }
+    if (!exact) {
+        fprintf(stderr, "a swap did not fill at the oracle price\n");
+        return 1;
+    }
+
+    const double swaps = double(perTick) * rounds;
+    rep.setup = "cBTC/STX pool, 1000 traders, " + std::to_string(perTick) + " swaps per tick, " +
+                std::to_string(rounds) + " ticks";
+    rep.add("swapStx (oracle read per swap)", swaps / (singleNs / 1e9), "swaps/s");
+    rep.add("swapBatch (one read)", swaps / (batchNs / 1e9), "swaps/s");
+    rep.add("queueSwap + settleTick", swaps / (settleNs / 1e9), "swaps/s");
+    return 0;
+}
+
+// ---- positions: price ticks with `size` open qusd positions (qcollateral.hpp) ----
+// Each tick is a random step of up to 1%, one committee price and endTick(), which
+// liquidates what the step pushed under water. A naive scan of every position is
+// timed for comparison; endTick must close exactly the positions it finds.
+int runPositions(const ScenarioOptions& o, ScenarioReport& rep) {
+    static const uint8_t custodian[32] = {};
+    const uint64_t n = std::min<uint64_t>(pick(o.size, 1000000), UINT32_MAX);
+    const uint32_t rounds = uint32_t(pick(o.rounds, 100));
+    const uint64_t startPrice = 60000 * FeedPrice::unit;
+    qusd_sc::updateCollateralPrice({startPrice}, custodian);
+    // Debt of 0.005..0.01 qUSD each keeps 1M positions under the 64-bit supply;
+    // collateral covers 1.5x to 4.5x of the minimum ratio at the start price
+    TraceRandom rnd(o.seed);
+    qusd_sc::CollateralInput c = {};
+    for (uint64_t i = 0; i < n; ++i) {
+        const uint64_t debt = QusdAmount::unit / 200 + rnd.below(QusdAmount::unit / 200);
+        const uint64_t minSats = liquidationPrice(1, debt, COLLATERAL_MIN_RATIO_BPS) / startPrice + 1;
+        qusdAccount(uint32_t(i), c.owner);
+        c.positionId = 0;
+        c.amount = minSats + rnd.below(2 * minSats);
+        c.positionId = qusd_sc::depositCollateral(c, custodian).positionId;
+        c.amount = debt;
+        if (!qusd_sc::mintAgainstCollateral(c, c.owner).ok) {
+            fprintf(stderr, "could not open position %llu\n", (unsigned long long)i);
+            return 1;
+        }
+    }
+    qusd_sc::endTick();
+    qusd_sc::endTick(); // the tick after the seeding burst frees its dirty set
+
+    std::vector<uint32_t> tickNs;
+    uint64_t price = startPrice, scanNs = 0, liquidated = 0;
+    bool exact = true;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        price = price / 100000 * (99000 + rnd.below(2001));
+        size_t naive = 0;
+        scanNs += elapsedNs([&] {
+            qusd_sc::collateral.forEach([&](uint64_t, const CollateralPosition<std::vector<uint8_t>>& pos) {
+                naive += pos.liqPrice > price;
+            });
+        });
+        const uint64_t before = qusd_sc::getCollateralStats().positions;
+        tickNs.push_back(uint32_t(elapsedNs([&] {
+            qusd_sc::updateCollateralPrice({price}, custodian);
+            qusd_sc::endTick();
+        })));
+        qusd_sc::CollateralStatsOutput after = qusd_sc::getCollateralStats();
+        exact &= before - after.positions == naive && after.unsafe == 0;
+        liquidated += naive;
+    }
+    if (!exact) {
+        fprintf(stderr, "liquidation disagrees with a scan of every position\n");
+        return 1;
+    }
+
+    rep.setup = "qusd, " + std::to_string(n) + " open positions, " + std::to_string(rounds) +
+                " price ticks of up to 1%, " + std::to_string(liquidated) + " liquidated";
+    addLatencyRows(rep, "price update + endTick", tickNs, 1e3, "us");
+    rep.add("naive scan of every position", scanNs / 1e6 / rounds, "ms");
+    rep.add("liquidations per tick", double(liquidated) / rounds, "positions");
+    return 0;
+}
+
+// ---- fixed: qBTC valued in qUSD and rescaled, scalar loops vs the batch kernels (qfixed.hpp) ----
+// `size` balances at `rounds` feed prices, alternating Down and HalfEven rounding.
+// Every batch result must equal the scalar one. The kernels are AVX2 only when
+// built with -mavx2; otherwise both rows run the scalar code.
+int runFixed(const ScenarioOptions& o, ScenarioReport& rep) {
+    const size_t n = size_t(pick(o.size, 1000000));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 20));
+    TraceRandom rnd(o.seed);
+    std::vector<uint64_t> sats(n), qusd(n), scalar(n), batch(n);
+    for (size_t i = 0; i < n; ++i) {
+        sats[i] = rnd.below(QbtcAmount::unit / 10); // qUSD's 64 bits at 15 decimals hold ~18k dollars
+        qusd[i] = rnd.below(uint64_t(1) << 63);
+    }
+
+    // qBTC valued in qUSD at a BTC/USD feed price, and qUSD rescaled down to 8 decimals
+    uint64_t valueNs[2] = {}, rescaleNs[2] = {};
+    bool exact = true;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        const FeedPrice price(20000 * FeedPrice::unit + rnd.below(80000 * FeedPrice::unit));
+        const Rounding mode = r % 2 ? Rounding::HalfEven : Rounding::Down;
+        valueNs[0] += elapsedNs([&] {
+            for (size_t i = 0; i < n; ++i) {
+                QusdAmount v;
+                exact &= valueAt<QusdAmount::decimals>(QbtcAmount(sats[i]), price, v, mode);
+                scalar[i] = v.raw;
+            }
+        });
+        valueNs[1] += elapsedNs([&] {
+            exact &= valueBatch<QusdAmount::decimals, QbtcAmount::decimals>(sats.data(), price, batch.data(), n, mode);
+        });
+        exact &= scalar == batch;
+        rescaleNs[0] += elapsedNs([&] {
+            for (size_t i = 0; i < n; ++i) {
+                QbtcAmount v;
+                exact &= rescale<QbtcAmount::decimals>(QusdAmount(qusd[i]), v, mode);
+                scalar[i] = v.raw;
+            }
+        });
+        rescaleNs[1] += elapsedNs([&] {
+            exact &= rescaleBatch<QbtcAmount::decimals, QusdAmount::decimals>(qusd.data(), batch.data(), n, mode);
+        });
+        exact &= scalar == batch;
+    }
+    if (!exact) {
+        fprintf(stderr, "a batch kernel disagrees with the scalar path\n");
+        return 1;
+    }
+
+#if defined(__AVX2__)
+    const char* kernelName = "AVX2";
+#else
+    const char* kernelName = "scalar (built without AVX2)";
+#endif
+    const double converted = double(n) * rounds;
+    rep.setup = std::to_string(n) + " balances, " + std::to_string(rounds) + " prices (Down and HalfEven), " +
+                kernelName + " kernel";
+    rep.add("valueAt, scalar loop", converted / (valueNs[0] / 1e9), "values/s");
+    rep.add("valueBatch", converted / (valueNs[1] / 1e9), "values/s");
+    rep.add("rescale 15 -> 8, scalar loop", converted / (rescaleNs[0] / 1e9), "values/s");
+    rep.add("rescaleBatch 15 -> 8", converted / (rescaleNs[1] / 1e9), "values/s");
+    return 0;
+}
+
+// ---- probes: per-scope overhead of QPROBE, plain vs probed vs rejecting calls ----
+// `rounds` chained calls per variant. Under -DQPROBES the snapshot must count every
+// call and every reject; compiled out, nothing may be recorded.
+// The same few cycles of work with and without a probe scope; the chained
+// calls and the empty asm keep either from being folded into the loop
+__attribute__((noinline)) uint64_t plainStep(uint64_t x) {
+    asm volatile("" : "+r"(x));
+    return x * 0x9E3779B97F4A7C15ULL + 1;
+}
+__attribute__((noinline)) uint64_t probedStep(uint64_t x) {
+    QPROBE(probe, "qbench.probedStep");
+    asm volatile("" : "+r"(x));
+    return x * 0x9E3779B97F4A7C15ULL + 1;
+}
+__attribute__((noinline)) uint64_t rejectedStep(uint64_t x) {
+    QPROBE(probe, "qbench.rejectedStep");
+    asm volatile("" : "+r"(x));
+    return QPROBE_REJECT(probe, x * 0x9E3779B97F4A7C15ULL + 1);
+}
+
+int runProbes(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint64_t n = pick(o.rounds, 10000000);
+    uint64_t x = o.seed, y = o.seed, z = o.seed;
+    uint64_t plainNs = elapsedNs([&] {
+        for (uint64_t i = 0; i < n; ++i) x = plainStep(x);
+    });
+    uint64_t probedNs = elapsedNs([&] {
+        for (uint64_t i = 0; i < n; ++i) y = probedStep(y);
+    });
+    uint64_t rejectedNs = elapsedNs([&] {
+        for (uint64_t i = 0; i < n; ++i) z = rejectedStep(z);
+    });
+    uint64_t calls = 0, rejects = 0;
+    for (const ProbeStats& s : probeSnapshot()) {
+        if (s.name == "qbench.probedStep") calls += s.calls;
+        if (s.name == "qbench.rejectedStep") calls += s.calls, rejects += s.rejects;
+    }
+#if defined(QPROBES)
+    const bool counted = calls == 2 * n && rejects == n;
+    const std::string build = "probes compiled in (-DQPROBES), 1 in " + std::to_string(PROBE_SAMPLE_MASK + 1) + " timed";
+#else
+    const bool counted = calls == 0;
+    const std::string build = "probes compiled out (build with -DQPROBES to measure them)";
+#endif
+    if (x != y || x != z || !counted) {
+        fprintf(stderr, "the probed steps disagree with the plain one or were miscounted\n");
+        return 1;
+    }
+
+    rep.setup = std::to_string(n) + " calls per variant, " + build;
+    rep.add("plain call", double(plainNs) / n, "ns");
+    rep.add("probed call", double(probedNs) / n, "ns");
+    rep.add("probed call, rejected", double(rejectedNs) / n, "ns");
+    rep.add("overhead per scope", (double(probedNs) - double(plainNs)) / n, "ns");
+    return 0;
+}
+
+// ---- scaling: TickExecutor transfers/s, runTickSerial vs runTick up to `size` threads ----
+// qusd, qbtc and bkpy are three independent lanes, `changed` transfers each per
+// tick. Every parallel tick must drop nothing and publish exactly the serial
+// tick's events, in the same order.
+int runScaling(const ScenarioOptions& o, ScenarioReport& rep) {
+    const uint32_t accounts = 10000;
+    // A tick's events must fit in the ring to be compared
+    const uint32_t perLane = uint32_t(std::min<uint64_t>(pick(o.changed, 5000), EVENT_LOG_DEFAULT_CAPACITY / 8));
+    const uint32_t rounds = uint32_t(pick(o.rounds, 20));
+    const unsigned maxThreads = unsigned(std::max<uint64_t>(pick(o.size, 3), 1));
+    mintQusdAccounts(accounts);
+    std::vector<std::string> qbtcKeys(accounts);
+    for (uint32_t i = 0; i < accounts; ++i) qbtcKeys[i] = qbtcAccount(i);
+    qbtc_sc::mint(qbtcKeys[0]);
+    bkpy.mint();
+    for (uint32_t i = 1; i < accounts; ++i) {
+        qbtc_sc::transfer(qbtcKeys[0], qbtcKeys[i], TRACE_QBTC_GENESIS);
+        bkpy.transfer(0, i, TRACE_BKPY_GENESIS);
+    }
+    qusd_sc::endTick();
+    qbtc_sc::endTick();
+    bkpy.endTick();
+
+    // Three islands, each with perLane transfers and then their reverses in
+    // reverse order, so every thread count starts its ticks from the same state
+    // and must publish the same events in the same order
+    struct Move {
+        uint32_t from, to;
+        uint64_t amount;
+    };
+    auto submitTick = [&](TickExecutor& exec, const uint16_t (&lanes)[3], uint32_t r) {
+        TraceRandom rnd(o.seed + r);
+        for (uint16_t lane : lanes) {
+            std::vector<Move> moves(perLane);
+            for (Move& m : moves) m = {uint32_t(rnd.below(accounts)), uint32_t(rnd.below(accounts)), 1 + rnd.below(10)};
+            for (size_t k = 0; k < 2 * moves.size(); ++k) {
+                Move m = k < moves.size() ? moves[k] : moves[2 * moves.size() - 1 - k];
+                if (k >= moves.size()) std::swap(m.from, m.to);
+                if (lane == lanes[0])
+                    exec.submit(lane, [m] {
+                        uint8_t from[32];
+                        qusd_sc::TransferInput in = {};
+                        qusdAccount(m.from, from);
+                        qusdAccount(m.to, in.to);
+                        in.amount = m.amount;
+                        qusd_sc::transfer(in, from);
+                    });
+                else if (lane == lanes[1])
+                    exec.submit(lane, [m, &qbtcKeys] {
+                        qbtc_sc::transfer(qbtcKeys[m.from], qbtcKeys[m.to], m.amount);
+                    });
+                else
+                    exec.submit(lane, [m] { bkpy.transfer(m.from, m.to, m.amount); });
+            }
+        }
+    };
+    auto eventsDigest = [](uint64_t fromSeq, uint64_t& digest) {
+        return eventLog().poll(fromSeq, [&](const EventRecord& e) {
+            digest = digest * 0x100000001B3ULL ^
+                     tableHash(&e.contract, offsetof(EventRecord, reserved1) - offsetof(EventRecord, contract));
+        });
+    };
+
+    std::vector<uint64_t> reference;
+    uint64_t tick = qusd_sc::dirtyBalances.currentTick(), serialNs = 0;
+    bool exact = true;
+    rep.setup = "qusd, qbtc and bkpy lanes, " + std::to_string(2 * perLane) + " transfers per lane per tick, " +
+                std::to_string(rounds) + " ticks, " + std::to_string(std::thread::hardware_concurrency()) + " cores";
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+        TickExecutor exec(threads - 1);
+        const uint16_t lanes[3] = {exec.addLane("qusd"), exec.addLane("qbtc"), exec.addLane("bkpy")};
+        exec.onEndTick(lanes[0], [] { qusd_sc::endTick(); });
+        exec.onEndTick(lanes[1], [] { qbtc_sc::endTick(); });
+        exec.onEndTick(lanes[2], [] { bkpy.endTick(); });
+        uint64_t runNs = 0;
+        for (uint32_t r = 0; r < rounds; ++r, ++tick) {
+            submitTick(exec, lanes, r);
+            const uint64_t seq = eventLog().head();
+            uint64_t failed = 0, digest = 0;
+            runNs += elapsedNs([&] {
+                const uint64_t timestamp = 1700000000 + tick;
+                failed = threads == 1 ? exec.runTickSerial(tick, timestamp) : exec.runTick(tick, timestamp);
+            });
+            exact &= failed == 0 && eventsDigest(seq, digest) == eventLog().head();
+            if (threads == 1) reference.push_back(digest);
+            else exact &= digest == reference[r];
+        }
+        if (threads == 1) serialNs = runNs;
+        const double transfers = 6.0 * perLane * rounds;
+        rep.add(threads == 1 ? "serial (runTickSerial)" : "runTick, " + std::to_string(threads) + " threads",
+                transfers / (runNs / 1e9), "transfers/s");
+        if (threads > 1) rep.add("speedup, " + std::to_string(threads) + " threads", double(serialNs) / runNs, "x");
+    }
+    if (!exact) {
+        fprintf(stderr, "a parallel tick published different events than the serial one\n");
+        return 1;
+    }
+    return 0;
+}
+
+struct Scenario {
+    const char* mode;
+    int (*run)(const ScenarioOptions&, ScenarioReport&);
+    const char* usage; // options after the mode
+};
+
+const Scenario SCENARIOS[] = {
+    {"merkle", runMerkle, "[--size n (accounts)] [--changed n (per tick)] [--rounds n (ticks)]"},
+    {"delta", runDelta, "[--size n (accounts)] [--changed n] [--dir scratch]"},
+    {"coldstart", runColdStart, "[--size n (accounts)] [--dir scratch]"},
+    {"emit", runEmit, "[--rounds n (events)] [--dir scratch]"},
+    {"holders", runHolders, "[--size n (holders)] [--changed n (transfers per tick)] [--rounds n (ticks)]"},
+    {"bridge", runBridge, "[--size n (accounts)] [--changed n (batch size)] [--rounds n (batches)]"},
+    {"auth", runAuth, "[--size n (owners, up to 64)] [--rounds n (proposals)]"},
+    {"proposals", runProposals, "[--size n (proposals)] [--changed n (per tick)] [--rounds n (lookups)] [--dir scratch]"},
+    {"queries", runQueries, "[--size n (open proposals)] [--rounds n]"},
+    {"multicall", runMulticall, "[--changed n (actions per batch)] [--rounds n (batches)]"},
+    {"signed", runSigned, "[--rounds n (proposals)] [--verify-us n]"},
+    {"claims", runClaims, "[--size n (grants per user)] [--rounds n (users)]"},
+    {"columns", runColumns, "[--size n (grants)] [--rounds n (evaluation times)]"},
+    {"unlocks", runUnlocks, "[--size n (scheduled grants)] [--rounds n (ticks)]"},
+    {"pool", runPool, "[--changed n (swaps per tick)] [--rounds n (ticks)]"},
+    {"positions", runPositions, "[--size n (open positions)] [--rounds n (price ticks)]"},
+    {"fixed", runFixed, "[--size n (balances)] [--rounds n (prices)]"},
+    {"probes", runProbes, "[--rounds n (calls per variant)]"},
+    {"scaling", runScaling, "[--size n (max threads)] [--changed n (transfers per lane)] [--rounds n (ticks)]"},
+};
+
+const Scenario* findScenario(const std::string& mode) {
+    for (const Scenario& sc : SCENARIOS)
+        if (mode == sc.mode) return &sc;
+    return nullptr;
+}
+
+int runScenario(const Scenario& sc, const ScenarioOptions& o, bool json) {
+    ScenarioReport rep;
+    if (int rc = sc.run(o, rep)) return rc;
+    if (json) {
+        printf("{\"scenario\":\"%s\",\"setup\":\"%s\",\"rows\":[", sc.mode, rep.setup.c_str());
+        for (size_t i = 0; i < rep.rows.size(); ++i)
+            printf("%s{\"metric\":\"%s\",\"value\":%.4f,\"unit\":\"%s\"}", i ? "," : "",
+                   rep.rows[i].metric.c_str(), rep.rows[i].value, rep.rows[i].unit);
+        printf("],\"peakRssKb\":%llu}\n", (unsigned long long)peakRssKb());
+        return 0;
+    }
+    printf("%s: %s\n", sc.mode, rep.setup.c_str());
+    for (const ScenarioRow& r : rep.rows) printf("%-36s %14.3f %s\n", r.metric.c_str(), r.value, r.unit);
+    printf("peak RSS %.1f MiB\n", peakRssKb() / 1024.0);
+    return 0;
+}
+
+// ====== Options ======
+struct Options {
+    std::string mode;
+    std::string tracePath;
+    std::string outPath;
+    std::string contract = "all";
+    std::string journalPath;
+    bool journalSync = true;
+    bool json = false;
+    TraceConfig gen;
+    SpamOptions spam;
+    CallsOptions calls;
+    ScenarioOptions scenario;
+};
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    if (argc < 2) return false;
+    o.mode = argv[1];
+    if (o.mode != "record" && o.mode != "replay" && o.mode != "run" && o.mode != "recover" && o.mode != "spam"
+        && o.mode != "calls" && !findScenario(o.mode))
+        return false;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--json") {
+            o.json = true;
+            continue;
+        }
+        if (a == "--no-sync") {
+            o.journalSync = false;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const char* v = argv[++i];
+        auto u32 = [v] { return uint32_t(strtoul(v, nullptr, 10)); };
+        if (a == "--trace") o.tracePath = v;
+        else if (a == "--out") o.outPath = v;
+        else if (a == "--contract") o.contract = v;
+        else if (a == "--journal") o.journalPath = v;
+        else if (a == "--seed") o.gen.seed = o.spam.seed = o.scenario.seed = strtoull(v, nullptr, 10);
+        else if (a == "--ticks") o.gen.ticks = o.spam.ticks = u32();
+        else if (a == "--accounts") o.gen.accounts = u32();
+        else if (a == "--transfers") o.gen.transfersPerTick = u32();
+        else if (a == "--zipf") o.gen.zipf = strtod(v, nullptr);
+        else if (a == "--oracle-rate") o.gen.oracleRate = uint32_t(strtod(v, nullptr) * 1000000);
+        else if (a == "--vesting-every") o.gen.vestingEvery = u32();
+        else if (a == "--vesting-burst") o.gen.vestingBurst = u32();
+        else if (a == "--vesting-ticks") o.gen.vestingTicks = u32();
+        else if (a == "--claim-every") o.gen.claimEvery = u32();
+        else if (a == "--claim-burst") o.gen.claimBurst = u32();
+        else if (a == "--proposals") o.gen.proposalsPerTick = u32();
+        else if (a == "--owners") o.gen.owners = uint16_t(std::min<uint32_t>(u32(), 32));
+        else if (a == "--threshold") o.gen.threshold = uint16_t(u32());
+        else if (a == "--relays") o.spam.relays = std::max(u32(), 1u);
+        else if (a == "--junk") o.spam.junk = u32();
+        else if (a == "--verify-us") o.spam.verifyUs = o.scenario.verifyUs = u32();
+        else if (a == "--calls") o.calls.calls = u32();
+        else if (a == "--batch") o.calls.batch = std::min(u32(), uint32_t(qgnosis_sc::Qnosis::MAX_MULTICALL_CALLS));
+        else if (a == "--size") o.scenario.size = strtoull(v, nullptr, 10);
+        else if (a == "--changed") o.scenario.changed = strtoull(v, nullptr, 10);
+        else if (a == "--rounds") o.scenario.rounds = u32();
+        else if (a == "--dir") o.scenario.dir = v;
+        else return false;
+    }
+    if (o.mode == "record" && o.outPath.empty()) return false;
+    if (o.mode == "replay" && o.tracePath.empty()) return false;
+    if (o.mode == "recover" && o.journalPath.empty()) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        fprintf(stderr,
+                "usage: %s record --out file [generator options]\n"
+                "       %s replay --trace file [--contract name] [--journal file [--no-sync]] [--json]\n"
+                "       %s run [generator options] [--contract name] [--journal file [--no-sync]] [--json]\n"
+                "       %s recover --journal file [--contract name] [--json]\n"
+                "       %s spam [--ticks n] [--relays n] [--junk n (per tick at 1x)] [--verify-us n] [--json]\n"
+                "       %s calls [--calls n] [--batch n] [--json]\n"
+                "contracts: all qusd qbtc bkpy oracles vesting qgnosis\n"
+                "generator: --seed n --ticks n --accounts n --transfers n (per tick) --zipf s --oracle-rate p\n"
+                "           --vesting-every n --vesting-burst n --vesting-ticks n --claim-every n --claim-burst n\n"
+                "           --proposals n (per tick) --owners n --threshold n\n",
+                argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+        for (const Scenario& sc : SCENARIOS)
+            fprintf(stderr, "       %s %s %s [--seed n] [--json]\n", argv[0], sc.mode, sc.usage);
+        return 2;
+    }
+    if (const Scenario* sc = findScenario(o.mode)) return runScenario(*sc, o.scenario, o.json);
+    if (o.mode == "spam") return runSpam(o.spam, o.json);
+    if (o.mode == "calls") return runCalls(o.calls, o.json);
+    bool families[FAMILIES] = {};
+    for (unsigned f = 0; f < FAMILIES; ++f) families[f] = o.contract == "all" || o.contract == FAMILY_NAMES[f];
+    if (std::find(families, families + FAMILIES, true) == families + FAMILIES) {
+        fprintf(stderr, "unknown contract %s\n", o.contract.c_str());
+        return 2;
+    }
+
+    if (o.mode == "recover") return runRecover(o.journalPath, families, o.json);
+
+    Trace trace;
+    if (o.mode == "replay") {
+        if (!readTrace(o.tracePath, trace)) {
+            fprintf(stderr, "cannot read trace %s\n", o.tracePath.c_str());
+            return 1;
+        }
+    } else {
+        trace = generateTrace(o.gen);
+    }
+    if (o.mode == "record") {
+        if (!writeTrace(o.outPath, trace)) {
+            fprintf(stderr, "cannot write trace %s\n", o.outPath.c_str());
+            return 1;
+        }
+        printf("%s: %zu records, %u ticks, %.1f MiB\n", o.outPath.c_str(), trace.records.size(), trace.header.ticks,
+               double(sizeof(TraceHeader) + trace.records.size() * sizeof(TraceRecord)) / 1048576.0);
+        return 0;
+    }
+
+    if (!o.journalPath.empty()) {
+        unlink(o.journalPath.c_str());
+        if (!journal().open(o.journalPath)) {
+            fprintf(stderr, "cannot open journal %s\n", o.journalPath.c_str());
+            return 1;
+        }
+        journal().setSync(o.journalSync);
+    }
+    Replayer rp(trace.header, families);
+    rp.run(trace.records);
+    if (o.json) printJson(rp, trace, o.contract.c_str());
+    else printTable(rp, trace, o.contract.c_str());
+    return 0;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,153 @@
+/*
+ * qCall – In-process cross-contract calls with fixed-layout inputs and outputs
+ * Contracts bind procedures by contract id; callers pass their own buffers by reference
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <type_traits>
+#include "qevents.hpp"
+
+// ====== Procedures ======
+// Contract ids are the EventContract values. A procedure's input and output are
+// plain structs with a fixed layout (like qusd.cpp's TransferInput); nothing is
+// serialized on the way: the callee reads the caller's input in place and writes
+// the caller's output buffer.
+enum class CallProcedure : uint16_t {
+    Transfer = 0,  // CallTransferInput -> CallTransferOutput, from the caller's account
+    BalanceOf = 1, // CallBalanceInput -> CallBalanceOutput
+    Count
+};
+
+constexpr size_t CALL_CONTRACTS = 16; // EventContract values below this can be bound
+
+// Accounts are 32-byte ids. A contract keyed otherwise maps them one-to-one in its
+// own binding and refuses (or reports as not addressable) ids it cannot map.
+struct CallTransferInput {
+    uint8_t to[32];
+    uint64_t amount;
+};
+struct CallTransferOutput {
+    uint8_t ok; // 0: refused (zero amount, self transfer, balance or overflow)
+};
+struct CallBalanceInput {
+    uint8_t account[32];
+};
+struct CallBalanceOutput {
+    uint64_t balance;
+    uint8_t addressable; // 0: the contract cannot hold an account under this id
+};
+
+// One call of a batch; input and output point into buffers the caller owns
+struct CrossCall {
+    EventContract contract;
+    CallProcedure procedure;
+    const void* input;
+    void* output;
+};
+
+// ====== Call Bus ======
+// A flat table of (contract, procedure) -> handler. Handlers are plain function
+// pointers taking the bound contract instance, the calling contract's account and
+// typed input/output references; a call is one table lookup and two indirect calls.
+// The caller is whoever holds the account: contracts pass their own id, and any
+// authorization (quorum, admin) is checked by the caller before it calls.
+//
+// Calls run on the calling thread, inside the caller's transaction. Under the tick
+// executor (qtick.hpp) the caller's lane must be link()ed to every lane it calls.
+class CallBus {
+private:
+    using Raw = void (*)();
+    using Invoke = void (*)(Raw fn, void* self, const uint8_t caller[32], const void* input, void* output);
+
+    struct Entry {
+        Invoke invoke = nullptr;
+        Raw fn = nullptr;
+        void* self = nullptr;
+        uint32_t inputSize = 0;
+        uint32_t outputSize = 0;
+    };
+
+    template <typename Input, typename Output>
+    using Handler = void (*)(void* self, const uint8_t caller[32], const Input& input, Output& output);
+
+    template <typename Input, typename Output>
+    static void invoke(Raw fn, void* self, const uint8_t caller[32], const void* input, void* output) {
+        reinterpret_cast<Handler<Input, Output>>(fn)(self, caller, *static_cast<const Input*>(input),
+                                                     *static_cast<Output*>(output));
+    }
+
+    std::array<Entry, CALL_CONTRACTS * size_t(CallProcedure::Count)> table{};
+
+    const Entry* entry(EventContract contract, CallProcedure procedure) const {
+        size_t c = size_t(contract), p = size_t(procedure);
+        if (c >= CALL_CONTRACTS || p >= size_t(CallProcedure::Count)) return nullptr;
+        const Entry& e = table[c * size_t(CallProcedure::Count) + p];
+        return e.invoke ? &e : nullptr;
+    }
+
+public:
+    // Bind a contract's procedure; `self` is handed back to the handler (nullptr for
+    // contracts whose state is global). Rebinding replaces the handler.
+    template <typename Input, typename Output>
+    bool bind(EventContract contract, CallProcedure procedure, void* self, Handler<Input, Output> handler) {
+        static_assert(std::is_trivially_copyable<Input>::value && std::is_trivially_copyable<Output>::value,
+                      "call inputs and outputs are fixed-layout structs");
+        size_t c = size_t(contract), p = size_t(procedure);
+        if (c >= CALL_CONTRACTS || p >= size_t(CallProcedure::Count) || !handler) return false;
+        table[c * size_t(CallProcedure::Count) + p] = {&CallBus::invoke<Input, Output>, reinterpret_cast<Raw>(handler),
+                                                        self, uint32_t(sizeof(Input)), uint32_t(sizeof(Output))};
+        return true;
+    }
+
+    void unbind(EventContract contract) {
+        if (size_t(contract) >= CALL_CONTRACTS) return;
+        for (size_t p = 0; p < size_t(CallProcedure::Count); ++p)
+            table[size_t(contract) * size_t(CallProcedure::Count) + p] = Entry();
+    }
+
+    bool bound(EventContract contract, CallProcedure procedure) const { return entry(contract, procedure) != nullptr; }
+
+    // False if nothing is bound there or the structs are not the bound ones
+    template <typename Input, typename Output>
+    bool call(EventContract contract, CallProcedure procedure, const uint8_t caller[32], const Input& input,
+              Output& output) const {
+        const Entry* e = entry(contract, procedure);
+        if (!e || e->inputSize != sizeof(Input) || e->outputSize != sizeof(Output)) return false;
+        e->invoke(e->fn, e->self, caller, &input, &output);
+        return true;
+    }
+
+    // Run calls in order under one caller. Every target is resolved before the first
+    // call runs, so a batch naming an unbound procedure has no effect at all; the
+    // index of the first such call is returned (count when all ran).
+    size_t callBatch(const uint8_t caller[32], const CrossCall* calls, size_t count) const {
+        for (size_t i = 0; i < count; ++i)
+            if (!entry(calls[i].contract, calls[i].procedure)) return i;
+        for (size_t i = 0; i < count; ++i) {
+            const Entry* e = entry(calls[i].contract, calls[i].procedure);
+            e->invoke(e->fn, e->self, caller, calls[i].input, calls[i].output);
+        }
+        return count;
+    }
+};
+
+inline CallBus& callBus() {
+    static CallBus bus;
+    return bus;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,286 @@
+/*
+ * qCollateral – Collateralized debt positions: qUSD minted against qBTC at oracle price
+ * Positions ordered by liquidation price: O(log n + k) per price update, batched liquidation
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <unordered_map>
+#include <algorithm>
+#include "qfixed.hpp"
+
+// Units: collateral is QbtcAmount (sats), debt QusdAmount, price FeedPrice
+// (BTC/USD). Collateral worth in qUSD units is valueAt(), i.e. sats * price /
+// COLLATERAL_VALUE_DIVISOR.
+static_assert(QbtcAmount::decimals + FeedPrice::decimals >= QusdAmount::decimals, "value is a division");
+constexpr uint64_t COLLATERAL_VALUE_DIVISOR = pow10u64(QbtcAmount::decimals + FeedPrice::decimals - QusdAmount::decimals);
+
+// Minimum collateral value over debt, in basis points
+constexpr uint64_t COLLATERAL_MIN_RATIO_BPS = 15000;
+
+// Lowest price at which the position is still safe:
+// sats * price * 10000 >= debt * ratio * divisor  <=>  price >= ceil(debt * ratio * divisor / (sats * 10000)).
+// Debt-free positions are safe at any price (0); unbacked debt never is (UINT64_MAX).
+inline uint64_t liquidationPrice(uint64_t collateral, uint64_t debt, uint64_t ratioBps) {
+    if (debt == 0) return 0;
+    if (collateral == 0) return UINT64_MAX;
+    uint64_t p;
+    if (!mulDivWide(debt, ratioBps * COLLATERAL_VALUE_DIVISOR, (unsigned __int128)collateral * 10000, p, Rounding::Up))
+        return UINT64_MAX;
+    return p;
+}
+
+template <typename Owner>
+struct CollateralPosition {
+    Owner owner;
+    uint64_t collateral;   // sats of qBTC locked
+    uint64_t debt;         // qUSD minted and not repaid
+    uint64_t liqPrice;     // liquidationPrice(collateral, debt), the index key
+};
+
+// A position closed by liquidate(): its collateral is seized, its debt written off
+template <typename Owner>
+struct CollateralLiquidation {
+    uint64_t id;
+    Owner owner;
+    uint64_t collateral;
+    uint64_t debt;
+};
+
+// ====== Collateral Engine ======
+// Accounting only: the caller moves tokens for what each operation returns. Every
+// position with debt sits in a set ordered by (liquidation price, id); a position
+// is unsafe exactly when the current price is below its key, so the unsafe ones are
+// always the top of the set. A price drop walks only the keys it crossed; tick end
+// liquidates the whole unsafe tail in one pass.
+template <typename Owner>
+class CollateralEngine {
+private:
+    using Key = std::pair<uint64_t, uint64_t>; // (liqPrice, id)
+
+    std::unordered_map<uint64_t, CollateralPosition<Owner>> positions;
+    std::set<Key> byLiqPrice;                  // positions with debt only
+    uint64_t ratioBps;
+    uint64_t price = 0;                        // 0 until the first update
+    uint64_t nextId = 1;
+    uint64_t totalCollateral = 0;
+    uint64_t totalDebt = 0;
+
+    // First key unsafe at price p
+    typename std::set<Key>::const_iterator firstUnsafe(uint64_t p) const {
+        return byLiqPrice.upper_bound(Key{p, UINT64_MAX});
+    }
+
+    bool safeAt(uint64_t liqPrice) const { return liqPrice == 0 || (price && price >= liqPrice); }
+
+    // Single write path: keeps the index key and totals in step with the position
+    void set(uint64_t id, CollateralPosition<Owner>& pos, uint64_t collateral, uint64_t debt) {
+        if (pos.debt) byLiqPrice.erase(Key{pos.liqPrice, id});
+        totalCollateral = totalCollateral - pos.collateral + collateral;
+        totalDebt = totalDebt - pos.debt + debt;
+        pos.collateral = collateral;
+        pos.debt = debt;
+        pos.liqPrice = liquidationPrice(collateral, debt, ratioBps);
+        if (debt) byLiqPrice.insert(Key{pos.liqPrice, id});
+    }
+
+    CollateralPosition<Owner>* owned(uint64_t id, const Owner& owner) {
+        auto it = positions.find(id);
+        return it == positions.end() || !(it->second.owner == owner) ? nullptr : &it->second;
+    }
+
+public:
+    explicit CollateralEngine(uint64_t minRatioBps = COLLATERAL_MIN_RATIO_BPS) : ratioBps(minRatioBps) {}
+
+    uint64_t currentPrice() const { return price; }
+    uint64_t minRatioBps() const { return ratioBps; }
+    size_t size() const { return positions.size(); }
+    uint64_t collateralLocked() const { return totalCollateral; }
+    uint64_t debtOutstanding() const { return totalDebt; }
+
+    const CollateralPosition<Owner>* find(uint64_t id) const {
+        auto it = positions.find(id);
+        return it == positions.end() ? nullptr : &it->second;
+    }
+
+    uint64_t open(const Owner& owner) {
+        uint64_t id = nextId++;
+        positions.emplace(id, CollateralPosition<Owner>{owner, 0, 0, 0});
+        return id;
+    }
+
+    // Drop an empty position, e.g. one open()ed for a deposit that then failed
+    bool discard(uint64_t id) {
+        auto it = positions.find(id);
+        if (it == positions.end() || it->second.collateral || it->second.debt) return false;
+        positions.erase(it);
+        return true;
+    }
+
+    // Lock more collateral; always allowed
+    bool deposit(uint64_t id, uint64_t sats) {
+        auto it = positions.find(id);
+        uint64_t locked;
+        if (it == positions.end() || sats == 0 || !checkedAdd(totalCollateral, sats, locked)) return false;
+        set(id, it->second, it->second.collateral + sats, it->second.debt);
+        return true;
+    }
+
+    // Release collateral, if the position stays safe at the current price
+    bool withdraw(uint64_t id, const Owner& owner, uint64_t sats) {
+        auto* pos = owned(id, owner);
+        if (!pos || sats == 0 || sats > pos->collateral) return false;
+        if (!safeAt(liquidationPrice(pos->collateral - sats, pos->debt, ratioBps))) return false;
+        set(id, *pos, pos->collateral - sats, pos->debt);
+        return true;
+    }
+
+    // Take on debt, if the position stays safe at the current price
+    bool mint(uint64_t id, const Owner& owner, uint64_t amount) {
+        auto* pos = owned(id, owner);
+        uint64_t outstanding;
+        if (!pos || amount == 0 || !checkedAdd(totalDebt, amount, outstanding)) return false;
+        if (!safeAt(liquidationPrice(pos->collateral, pos->debt + amount, ratioBps))) return false;
+        set(id, *pos, pos->collateral, pos->debt + amount);
+        return true;
+    }
+
+    // Pay down debt (anyone may repay any position)
+    bool repay(uint64_t id, uint64_t amount) {
+        auto it = positions.find(id);
+        if (it == positions.end() || amount == 0 || amount > it->second.debt) return false;
+        set(id, it->second, it->second.collateral, it->second.debt - amount);
+        return true;
+    }
+
+    // Close a debt-free position, returning its collateral
+    bool close(uint64_t id, const Owner& owner, uint64_t& collateralOut) {
+        auto* pos = owned(id, owner);
+        if (!pos || pos->debt) return false;
+        collateralOut = pos->collateral;
+        set(id, *pos, 0, 0);
+        positions.erase(id);
+        return true;
+    }
+
+    // Redeem qUSD for collateral at the current price, taking debt from the safe
+    // positions closest to liquidation first. Each step either uses up the request
+    // or clears a position's debt, so this is O((k + 1) log n) for k positions.
+    // Returns the qUSD amount accepted; satsOut is what the redeemer is owed.
+    template <typename Touched>
+    uint64_t redeem(uint64_t amount, uint64_t& satsOut, Touched touched) {
+        satsOut = 0;
+        if (!price) return 0;
+        uint64_t remaining = amount;
+        while (remaining) {
+            auto it = firstUnsafe(price);
+            if (it == byLiqPrice.begin()) break;
+            --it;
+            uint64_t id = it->second;
+            auto& pos = positions.find(id)->second;
+            uint64_t take = std::min(remaining, pos.debt);
+            QbtcAmount owed;
+            if (!quantityAt<QbtcAmount::decimals>(QusdAmount(take), FeedPrice(price), owed)) owed.raw = UINT64_MAX;
+            uint64_t sats = std::min(owed.raw, pos.collateral);
+            set(id, pos, pos.collateral - sats, pos.debt - take);
+            remaining -= take;
+            satsOut += sats;
+            touched(id, pos, take, sats);
+        }
+        return amount - remaining;
+    }
+
+    // New oracle price. On a drop, calls onUnsafe(id, position) for each position
+    // that was safe at the old price and is not at the new one: O(log n + k).
+    // Returns k. Liquidation itself waits for liquidate() at tick end.
+    template <typename OnUnsafe>
+    size_t updatePrice(uint64_t newPrice, OnUnsafe onUnsafe) {
+        uint64_t old = price ? price : UINT64_MAX;
+        price = newPrice;
+        if (newPrice >= old) return 0;
+        size_t k = 0;
+        auto end = firstUnsafe(old);
+        for (auto it = firstUnsafe(newPrice); it != end; ++it, ++k)
+            onUnsafe(it->second, positions.find(it->second)->second);
+        return k;
+    }
+
+    // Positions unsafe at the current price, O(log n + k)
+    size_t unsafeCount() const {
+        return price ? size_t(std::distance(firstUnsafe(price), byLiqPrice.cend())) : 0;
+    }
+
+    // ---- Restore (snapshot load, delta catch-up) ----
+    // Positions are written whole, so they bypass the safety checks; index and
+    // totals stay in step. False if the totals would overflow.
+    bool restore(uint64_t id, const Owner& owner, uint64_t collateral, uint64_t debt) {
+        auto it = positions.find(id);
+        uint64_t oldCollateral = it == positions.end() ? 0 : it->second.collateral;
+        uint64_t oldDebt = it == positions.end() ? 0 : it->second.debt;
+        uint64_t locked, outstanding;
+        if (!checkedAdd(totalCollateral - oldCollateral, collateral, locked) ||
+            !checkedAdd(totalDebt - oldDebt, debt, outstanding))
+            return false;
+        if (it == positions.end()) it = positions.emplace(id, CollateralPosition<Owner>{owner, 0, 0, 0}).first;
+        it->second.owner = owner;
+        set(id, it->second, collateral, debt);
+        if (id >= nextId) nextId = id + 1;
+        return true;
+    }
+
+    void remove(uint64_t id) {
+        auto it = positions.find(id);
+        if (it == positions.end()) return;
+        set(id, it->second, 0, 0);
+        positions.erase(it);
+    }
+
+    uint64_t nextPositionId() const { return nextId; }
+
+    // Price and id counter as saved; nextId never goes below ids already restored
+    void restoreCounters(uint64_t savedPrice, uint64_t savedNextId) {
+        price = savedPrice;
+        nextId = std::max(nextId, std::max<uint64_t>(savedNextId, 1));
+    }
+
+    // Every position, in no particular order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& p : positions) visit(p.first, p.second);
+    }
+
+    // Tick end: close every position unsafe at the current price, seizing its
+    // collateral and writing off its debt, in (liquidation price, id) order.
+    // Calls onLiquidation(record) per position; returns how many were closed.
+    template <typename OnLiquidation>
+    size_t liquidate(OnLiquidation onLiquidation) {
+        if (!price) return 0;
+        auto first = firstUnsafe(price);
+        size_t k = 0;
+        for (auto it = first; it != byLiqPrice.end(); ++it, ++k) {
+            auto node = positions.find(it->second);
+            CollateralPosition<Owner>& pos = node->second;
+            totalCollateral -= pos.collateral;
+            totalDebt -= pos.debt;
+            onLiquidation(CollateralLiquidation<Owner>{it->second, std::move(pos.owner), pos.collateral, pos.debt});
+            positions.erase(node);
+        }
+        byLiqPrice.erase(first, byLiqPrice.end());
+        return k;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
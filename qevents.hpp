@@ -0,0 +1,428 @@
+/*
+ * qEvents – Typed binary event log shared by all contracts
+ * Fixed-layout records in a lock-free single-producer ring, backed by an
+ * mmap'd spill file that indexers tail in place
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Qubic KangarooTwelve hash (platform provided)
+extern void KangarooTwelve(const uint8_t* input, unsigned int inputByteLen, uint8_t* output, unsigned int outputByteLen);
+
+// ====== Event Types ======
+enum class EventContract : uint16_t {
+    QUSD = 1,
+    BKPY = 2,
+    QBTC = 3,
+    QORACLE = 4,
+    QORACLE_VALIDATOR = 5,
+    QORACLE_COMMITTEE = 6,
+    CODEISLAW_COMMITTEE = 7,
+    BTCQ_COMMITTEE = 8,
+    QNOSIS_VESTING = 9,
+    QNOSIS = 10,
+    BANKONPYTHAI_POOL = 11,
+};
+
+enum class EventType : uint16_t {
+    Transfer = 1,         // subject: from, counterparty: to, amount
+    Mint = 2,             // subject: to, amount
+    Burn = 3,             // subject: from, amount
+    PriceUpdate = 4,      // subject: asset (if any), amount: price, aux: price timestamp
+    ClaimVesting = 5,     // subject: vesting id, counterparty: beneficiary, amount: claimed
+    ProposalExecuted = 6, // subject: destination, amount: value, aux: nonce
+    CreateVesting = 7,    // subject: vesting id, counterparty: beneficiary, amount: total
+    PauseVesting = 8,     // subject: vesting id
+    UnpauseVesting = 9,   // subject: vesting id
+    CancelVesting = 10,   // subject: vesting id
+    AddSigner = 11,       // subject: signer
+    RemoveSigner = 12,    // subject: signer
+    VestingUnlocked = 13, // subject: vesting id, counterparty: beneficiary, amount: claimable, aux: unlock time
+    Swap = 14,            // subject: trader, amount: out, aux: in
+    AddLiquidity = 15,    // subject: provider, amount: deposited, aux: shares minted
+    RemoveLiquidity = 16, // subject: provider, amount: shares burned
+    CollateralLocked = 17,   // subject: position id, counterparty: owner, amount: sats
+    CollateralReleased = 18, // subject: position id, counterparty: owner, amount: sats
+    PositionUnsafe = 19,     // subject: position id, counterparty: owner, aux: liquidation price
+    Liquidation = 20,        // subject: position id, counterparty: owner, amount: sats seized, aux: debt
+    Redemption = 21,         // subject: redeemer, amount: qUSD redeemed, aux: sats owed
+};
+
+// Key length marker: the key was longer than 32 bytes and is stored as its K12 digest
+constexpr uint8_t EVENT_KEY_DIGEST = 0xFF;
+
+// ====== Record (128 bytes, two cache lines, little endian) ======
+struct EventRecord {
+    uint64_t sequence;       // position in the log, gap-free
+    uint64_t tick;
+    uint16_t contract;       // EventContract
+    uint16_t type;           // EventType
+    uint8_t subjectLen;      // bytes used in subject, or EVENT_KEY_DIGEST
+    uint8_t counterpartyLen; // bytes used in counterparty, or EVENT_KEY_DIGEST
+    uint8_t reserved0[2];
+    uint8_t subject[32];
+    uint8_t counterparty[32];
+    uint64_t amount;
+    uint64_t aux;
+    uint8_t reserved1[24];
+};
+static_assert(sizeof(EventRecord) == 128, "event record layout is part of the file format");
+static_assert(offsetof(EventRecord, sequence) == 0, "the slot's sequence leads the record");
+
+// ====== Slot Sequence (per-slot seqlock) ======
+// A slot's `sequence` doubles as its lock word: the producer sets it to
+// EVENT_SLOT_BUSY, writes the body, then stores the record's sequence with release.
+// A reader checks the sequence before and after copying the slot; if either check
+// fails, the slot was rewritten under it. The word is accessed atomically through
+// the compiler builtins so the record stays a plain, trivially copyable struct.
+constexpr uint64_t EVENT_SLOT_BUSY = UINT64_MAX;
+
+inline void beginEventSlot(EventRecord& slot) {
+    __atomic_store_n(&slot.sequence, EVENT_SLOT_BUSY, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE); // the mark lands before any body byte
+}
+
+inline void endEventSlot(EventRecord& slot, uint64_t seq) {
+    __atomic_store_n(&slot.sequence, seq, __ATOMIC_RELEASE);
+}
+
+// Copy record `seq` out of its slot; false if the slot no longer holds it whole
+inline bool readEventSlot(const EventRecord& slot, uint64_t seq, EventRecord& out) {
+    if (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != seq) return false;
+    memcpy(&out, &slot, sizeof(EventRecord));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // the copy completes before the re-check
+    if (__atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) != seq) return false;
+    out.sequence = seq;
+    return true;
+}
+
+// Borrowed view of an account/id in any of the contracts' key types
+struct EventKeyRef {
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+    uint8_t inl[8];
+
+    EventKeyRef() {}
+    EventKeyRef(const uint8_t* key32) : data(key32), len(32) {}
+    EventKeyRef(uint64_t v) : data(inl), len(8) {
+        for (int i = 0; i < 8; ++i) inl[i] = uint8_t(v >> (8 * i));
+    }
+    EventKeyRef(const std::string& s) : data(reinterpret_cast<const uint8_t*>(s.data())), len(s.size()) {}
+    EventKeyRef(const std::vector<uint8_t>& v) : data(v.data()), len(v.size()) {}
+    EventKeyRef(const EventKeyRef&) = delete; // may point into itself
+};
+
+// ====== Long Key Digests ======
+// Contracts emit the same few long keys over and over (vesting ids, beneficiaries,
+// addresses), so each thread keeps a direct-mapped cache of their K12 digests. A hit
+// costs a multiply hash and a compare instead of K12. A colliding key evicts the
+// entry and is hashed again, so crafted keys only fall back to hashing every emit;
+// keys over EVENT_KEY_CACHE_MAX_LEN bytes always do.
+constexpr size_t EVENT_KEY_CACHE_MAX_LEN = 64;
+constexpr size_t EVENT_KEY_CACHE_SLOTS = 1024; // power of two
+
+struct EventKeyDigestCache {
+    struct Entry {
+        uint8_t len; // 0: empty
+        uint8_t key[EVENT_KEY_CACHE_MAX_LEN];
+        uint8_t digest[32];
+    };
+    Entry entries[EVENT_KEY_CACHE_SLOTS];
+
+    void digest(const uint8_t* key, size_t len, uint8_t out[32]) {
+        if (len > EVENT_KEY_CACHE_MAX_LEN) {
+            KangarooTwelve(key, unsigned(len), out, 32);
+            return;
+        }
+        uint64_t h = len;
+        for (size_t i = 0; i < len; i += 8) {
+            uint64_t w = 0;
+            memcpy(&w, key + i, len - i < 8 ? len - i : 8);
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+        }
+        Entry& e = entries[(h ^ (h >> 32)) & (EVENT_KEY_CACHE_SLOTS - 1)];
+        if (e.len != len || memcmp(e.key, key, len) != 0) {
+            KangarooTwelve(key, unsigned(len), e.digest, 32);
+            memcpy(e.key, key, len);
+            e.len = uint8_t(len);
+        }
+        memcpy(out, e.digest, 32);
+    }
+};
+
+inline thread_local EventKeyDigestCache eventKeyDigests;
+
+inline uint8_t storeEventKey(uint8_t out[32], const EventKeyRef& key) {
+    if (key.len <= 32) {
+        if (key.len) memcpy(out, key.data, key.len);
+        memset(out + key.len, 0, 32 - key.len);
+        return uint8_t(key.len);
+    }
+    eventKeyDigests.digest(key.data, key.len, out);
+    return EVENT_KEY_DIGEST;
+}
+
+// Fill everything but sequence and tick, which the log assigns when publishing
+inline void fillEventRecord(EventRecord& r, EventContract contract, EventType type, const EventKeyRef& subject,
+                            const EventKeyRef& counterparty, uint64_t amount, uint64_t aux) {
+    r.contract = uint16_t(contract);
+    r.type = uint16_t(type);
+    r.subjectLen = storeEventKey(r.subject, subject);
+    r.counterpartyLen = storeEventKey(r.counterparty, counterparty);
+    r.amount = amount;
+    r.aux = aux;
+}
+
+// ====== Spill File Layout ======
+// [EventLogHeader][capacity x EventRecord]. Record `seq` lives in slot seq % capacity.
+constexpr char EVENT_LOG_MAGIC[4] = {'Q', 'E', 'V', 'T'};
+constexpr uint32_t EVENT_LOG_VERSION = 1;
+constexpr uint64_t EVENT_LOG_DEFAULT_CAPACITY = 1 << 16;
+
+struct EventLogHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t capacity;                  // power of two
+    alignas(64) std::atomic<uint64_t> head; // records published so far
+    uint8_t pad[56];
+};
+static_assert(sizeof(EventLogHeader) == 128, "keeps records cache-line aligned");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "head is shared across processes");
+
+// ====== Event Log ======
+// The producer never blocks: a consumer more than `capacity` records behind loses
+// the oldest ones and sees a sequence gap. Emitting is a slot fill between two
+// stores of the slot's sequence, plus one release store of head, with no
+// allocation and no syscall.
+class EventLog {
+private:
+    EventLogHeader* header = nullptr;
+    EventRecord* records = nullptr;
+    size_t mappedBytes = 0;
+    uint64_t mask = 0;
+    uint64_t next = 0; // producer-local copy of head
+    uint64_t tick = 0;
+
+    bool map(int fd, uint64_t capacity) {
+        mappedBytes = sizeof(EventLogHeader) + capacity * sizeof(EventRecord);
+        int flags = fd < 0 ? (MAP_PRIVATE | MAP_ANONYMOUS) : MAP_SHARED;
+        void* m = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, flags | MAP_POPULATE, fd, 0);
+        if (m == MAP_FAILED) { mappedBytes = 0; return false; }
+        header = static_cast<EventLogHeader*>(m);
+        records = reinterpret_cast<EventRecord*>(header + 1);
+        return true;
+    }
+
+public:
+    EventLog() = default;
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+    ~EventLog() { close(); }
+
+    // Back the ring with a spill file that other processes can map and tail.
+    // An existing file with the same capacity is resumed, not truncated.
+    bool open(const std::string& spillPath, uint64_t capacity = EVENT_LOG_DEFAULT_CAPACITY) {
+        if (capacity == 0 || (capacity & (capacity - 1))) return false;
+        close();
+        int fd = ::open(spillPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+        struct stat st;
+        uint64_t bytes = sizeof(EventLogHeader) + capacity * sizeof(EventRecord);
+        bool resume = fstat(fd, &st) == 0 && uint64_t(st.st_size) == bytes;
+        bool ok = (resume || ftruncate(fd, off_t(bytes)) == 0) && map(fd, capacity);
+        ::close(fd);
+        if (!ok) return false;
+        if (!resume || memcmp(header->magic, EVENT_LOG_MAGIC, 4) != 0 || header->capacity != capacity) {
+            memcpy(header->magic, EVENT_LOG_MAGIC, 4);
+            header->version = EVENT_LOG_VERSION;
+            header->recordSize = sizeof(EventRecord);
+            header->capacity = capacity;
+            header->head.store(0, std::memory_order_release);
+        }
+        mask = capacity - 1;
+        next = header->head.load(std::memory_order_acquire);
+        return true;
+    }
+
+    // In-process ring only (no external tailers)
+    bool openAnonymous(uint64_t capacity = EVENT_LOG_DEFAULT_CAPACITY) {
+        if (capacity == 0 || (capacity & (capacity - 1))) return false;
+        close();
+        if (!map(-1, capacity)) return false;
+        memcpy(header->magic, EVENT_LOG_MAGIC, 4);
+        header->version = EVENT_LOG_VERSION;
+        header->recordSize = sizeof(EventRecord);
+        header->capacity = capacity;
+        header->head.store(0, std::memory_order_relaxed);
+        mask = capacity - 1;
+        next = 0;
+        return true;
+    }
+
+    void close() {
+        if (header) munmap(header, mappedBytes);
+        header = nullptr;
+        records = nullptr;
+        mappedBytes = 0;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    void setTick(uint64_t t) { tick = t; }
+
+    // Producer only
+    void emit(EventContract contract, EventType type, const EventKeyRef& subject, const EventKeyRef& counterparty,
+              uint64_t amount, uint64_t aux) {
+        if (!header && !openAnonymous()) return;
+        EventRecord& r = records[next & mask];
+        beginEventSlot(r);
+        r.tick = tick;
+        fillEventRecord(r, contract, type, subject, counterparty, amount, aux);
+        endEventSlot(r, next);
+        header->head.store(++next, std::memory_order_release);
+    }
+
+    // Producer only: append a record filled elsewhere (see EventCapture)
+    void publish(const EventRecord& filled) {
+        if (!header && !openAnonymous()) return;
+        EventRecord& r = records[next & mask];
+        beginEventSlot(r);
+        constexpr size_t body = sizeof(r.sequence); // everything after the lock word
+        memcpy(reinterpret_cast<uint8_t*>(&r) + body, reinterpret_cast<const uint8_t*>(&filled) + body,
+               sizeof(EventRecord) - body);
+        r.tick = tick;
+        endEventSlot(r, next);
+        header->head.store(++next, std::memory_order_release);
+    }
+
+    uint64_t head() const { return header ? header->head.load(std::memory_order_acquire) : 0; }
+
+    // Consumer: visit records [fromSeq, head). Returns the next sequence to ask for;
+    // if it jumped past fromSeq, the records in between were overwritten. Each record
+    // is copied out under its slot's sequence (see readEventSlot), so what a visitor
+    // sees is exact; a record the producer laps mid-copy ends the poll there and the
+    // caller's next poll resumes at the oldest record still intact.
+    template <typename Visit>
+    uint64_t poll(uint64_t fromSeq, Visit visit) const {
+        return pollRing(header, records, fromSeq, visit);
+    }
+
+    template <typename Visit>
+    static uint64_t pollRing(const EventLogHeader* h, const EventRecord* recs, uint64_t fromSeq, Visit visit) {
+        if (!h) return fromSeq;
+        uint64_t cap = h->capacity;
+        uint64_t end = h->head.load(std::memory_order_acquire);
+        // The producer rewrites slot `seq` while publishing seq + cap, so the
+        // oldest slot is never safe to hand out
+        uint64_t seq = (end >= cap && fromSeq <= end - cap) ? end - cap + 1 : fromSeq;
+        EventRecord copy;
+        for (; seq < end; ++seq) {
+            if (!readEventSlot(recs[seq & (cap - 1)], seq, copy)) return seq; // lapped: caller re-polls
+            visit(copy);
+        }
+        return seq;
+    }
+};
+
+// ====== Tailing From Another Process ======
+class EventLogTail {
+private:
+    const EventLogHeader* header = nullptr;
+    const EventRecord* records = nullptr;
+    size_t mappedBytes = 0;
+
+public:
+    EventLogTail() = default;
+    EventLogTail(const EventLogTail&) = delete;
+    EventLogTail& operator=(const EventLogTail&) = delete;
+    ~EventLogTail() { close(); }
+
+    bool open(const std::string& spillPath) {
+        close();
+        int fd = ::open(spillPath.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(EventLogHeader);
+        void* m = ok ? mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (m == MAP_FAILED) return false;
+        const EventLogHeader* h = static_cast<const EventLogHeader*>(m);
+        if (memcmp(h->magic, EVENT_LOG_MAGIC, 4) != 0 || h->recordSize != sizeof(EventRecord)
+            || sizeof(EventLogHeader) + h->capacity * sizeof(EventRecord) != uint64_t(st.st_size)) {
+            munmap(m, size_t(st.st_size));
+            return false;
+        }
+        header = h;
+        records = reinterpret_cast<const EventRecord*>(h + 1);
+        mappedBytes = size_t(st.st_size);
+        return true;
+    }
+
+    void close() {
+        if (header) munmap(const_cast<EventLogHeader*>(header), mappedBytes);
+        header = nullptr;
+        records = nullptr;
+        mappedBytes = 0;
+    }
+
+    uint64_t head() const { return header ? header->head.load(std::memory_order_acquire) : 0; }
+
+    template <typename Visit>
+    uint64_t poll(uint64_t fromSeq, Visit visit) const {
+        return EventLog::pollRing(header, records, fromSeq, visit);
+    }
+};
+
+// Process-wide log; contracts run on the tick thread, which is its single producer
+inline EventLog& eventLog() {
+    static EventLog log;
+    return log;
+}
+
+// ====== Deferred Emission ======
+// Contracts running off the tick thread (TickExecutor in qtick.hpp) must not touch
+// the ring. While a thread has a capture installed, emitEvent() fills records into
+// it, tagged with the caller's ordering key; the tick thread later publishes all
+// captures merged by key, so the log matches a serial run byte for byte.
+struct EventCapture {
+    std::vector<EventRecord> records;
+    std::vector<uint64_t> keys; // ordering key of each record
+    uint64_t key = 0;           // applies to records emitted from now on
+};
+
+inline thread_local EventCapture* eventCapture = nullptr;
+
+inline void emitEvent(EventContract contract, EventType type, const EventKeyRef& subject,
+                      const EventKeyRef& counterparty = EventKeyRef(), uint64_t amount = 0, uint64_t aux = 0) {
+    if (EventCapture* c = eventCapture) {
+        c->records.emplace_back(); // zeroed, so reserved bytes match the ring's
+        fillEventRecord(c->records.back(), contract, type, subject, counterparty, amount, aux);
+        c->keys.push_back(c->key);
+        return;
+    }
+    eventLog().emit(contract, type, subject, counterparty, amount, aux);
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
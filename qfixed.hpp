@@ -0,0 +1,340 @@
+/*
+ * qFixed – Fixed-point decimals, checked 128-bit mul-div and batch rescaling
+ * Decimal<N> amounts with compile-time rescaling; exact AVX2 kernels for arrays
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ====== Checked Integer Math ======
+// Every function reports overflow by returning false and leaves `out` unspecified.
+
+constexpr bool checkedAdd(uint64_t a, uint64_t b, uint64_t& out) {
+    out = a + b;
+    return out >= a;
+}
+
+constexpr bool checkedSub(uint64_t a, uint64_t b, uint64_t& out) {
+    if (b > a) return false;
+    out = a - b;
+    return true;
+}
+
+constexpr bool checkedMul(uint64_t a, uint64_t b, uint64_t& out) {
+    unsigned __int128 p = (unsigned __int128)a * b;
+    out = uint64_t(p);
+    return p >> 64 == 0;
+}
+
+// How a quotient is rounded: toward zero, away from zero, or to nearest with
+// ties away from zero (HalfUp) or to the even neighbour (HalfEven)
+enum class Rounding : uint8_t { Down, Up, HalfUp, HalfEven };
+
+// Whether q (the floor of n / d) should go up by one given remainder rem
+template <typename T>
+constexpr bool roundsUp(T q, T rem, T d, Rounding mode) {
+    switch (mode) {
+    case Rounding::Down: return false;
+    case Rounding::Up: return rem != 0;
+    case Rounding::HalfUp: return rem >= d - rem;
+    case Rounding::HalfEven: return rem > d - rem || (rem == d - rem && (q & 1));
+    }
+    return false;
+}
+
+// n / d rounded, into 64 bits
+constexpr bool divRound(unsigned __int128 n, unsigned __int128 d, uint64_t& out, Rounding mode = Rounding::Down) {
+    if (d == 0) return false;
+    unsigned __int128 q = n / d;
+    q += roundsUp(q, n - q * d, d, mode);
+    out = uint64_t(q);
+    return q >> 64 == 0;
+}
+
+// a * b / d with the full 128-bit product
+constexpr bool mulDiv(uint64_t a, uint64_t b, uint64_t d, uint64_t& out, Rounding mode = Rounding::Down) {
+    return divRound((unsigned __int128)a * b, d, out, mode);
+}
+
+// a * b / d for a divisor wider than 64 bits
+constexpr bool mulDivWide(uint64_t a, uint64_t b, unsigned __int128 d, uint64_t& out, Rounding mode = Rounding::Down) {
+    return divRound((unsigned __int128)a * b, d, out, mode);
+}
+
+// a * b * scale / d, exact even when a * b * scale needs more than 128 bits:
+// a * b is split by d first, and the remainder (< d) times scale still fits.
+constexpr bool mulDivScaled(uint64_t a, uint64_t b, uint64_t scale, uint64_t d, uint64_t& out,
+                            Rounding mode = Rounding::Down) {
+    if (d == 0) return false;
+    unsigned __int128 p = (unsigned __int128)a * b;
+    unsigned __int128 q = p / d, r = (p - q * d) * scale;
+    if (scale && q > UINT64_MAX / scale) return false;
+    unsigned __int128 q2 = r / d;
+    q = q * scale + q2;
+    q += roundsUp(q, r - q2 * d, (unsigned __int128)d, mode);
+    out = uint64_t(q);
+    return q >> 64 == 0;
+}
+
+constexpr unsigned __int128 pow10Wide(unsigned n) {
+    unsigned __int128 v = 1;
+    while (n--) v *= 10;
+    return v;
+}
+
+constexpr uint64_t pow10u64(unsigned n) { return uint64_t(pow10Wide(n)); }
+
+// ====== Decimal<N> ======
+// An amount with N decimals held as raw integer units (raw = value * 10^N).
+// Arithmetic is explicit and checked; mixing bases goes through rescale(),
+// valueAt(), quantityAt() or convertAt(), whose powers of ten are constants.
+template <unsigned N>
+struct Decimal {
+    static_assert(N <= 19, "10^N must fit in 64 bits");
+    static constexpr unsigned decimals = N;
+    static constexpr uint64_t unit = pow10u64(N);
+
+    uint64_t raw = 0;
+
+    constexpr Decimal() = default;
+    constexpr explicit Decimal(uint64_t rawUnits) : raw(rawUnits) {}
+
+    // `whole` units, e.g. fromWhole(3) is 3.000...
+    static constexpr bool fromWhole(uint64_t whole, Decimal& out) { return checkedMul(whole, unit, out.raw); }
+
+    constexpr uint64_t whole() const { return raw / unit; }
+    constexpr uint64_t fraction() const { return raw % unit; }
+
+    constexpr bool operator==(Decimal o) const { return raw == o.raw; }
+    constexpr bool operator!=(Decimal o) const { return raw != o.raw; }
+    constexpr bool operator<(Decimal o) const { return raw < o.raw; }
+    constexpr bool operator<=(Decimal o) const { return raw <= o.raw; }
+    constexpr bool operator>(Decimal o) const { return raw > o.raw; }
+    constexpr bool operator>=(Decimal o) const { return raw >= o.raw; }
+};
+
+template <unsigned N>
+constexpr bool checkedAdd(Decimal<N> a, Decimal<N> b, Decimal<N>& out) { return checkedAdd(a.raw, b.raw, out.raw); }
+
+template <unsigned N>
+constexpr bool checkedSub(Decimal<N> a, Decimal<N> b, Decimal<N>& out) { return checkedSub(a.raw, b.raw, out.raw); }
+
+// a * num / den in the same base, e.g. a pro-rata share
+template <unsigned N>
+constexpr bool mulDiv(Decimal<N> a, uint64_t num, uint64_t den, Decimal<N>& out, Rounding mode = Rounding::Down) {
+    return mulDiv(a.raw, num, den, out.raw, mode);
+}
+
+// Same value in another base: a multiply (checked) or a rounded divide by 10^|To - From|
+template <unsigned To, unsigned From>
+constexpr bool rescale(Decimal<From> v, Decimal<To>& out, Rounding mode = Rounding::Down) {
+    if constexpr (To >= From) return checkedMul(v.raw, pow10u64(To - From), out.raw);
+    else return divRound(v.raw, pow10u64(From - To), out.raw, mode);
+}
+
+// Quote value of `amount` at `price` (quote per whole unit): amount * price in
+// base A + P, rescaled to Out
+template <unsigned Out, unsigned A, unsigned P>
+constexpr bool valueAt(Decimal<A> amount, Decimal<P> price, Decimal<Out>& out, Rounding mode = Rounding::Down) {
+    if constexpr (A + P >= Out) return mulDivWide(amount.raw, price.raw, pow10Wide(A + P - Out), out.raw, mode);
+    else return mulDivScaled(amount.raw, price.raw, pow10u64(Out - A - P), 1, out.raw, mode);
+}
+
+// Units of an asset priced at `price` that `value` buys: the inverse of valueAt()
+template <unsigned Out, unsigned V, unsigned P>
+constexpr bool quantityAt(Decimal<V> value, Decimal<P> price, Decimal<Out>& out, Rounding mode = Rounding::Down) {
+    if constexpr (Out + P >= V) return mulDivScaled(value.raw, pow10u64(Out + P - V), 1, price.raw, out.raw, mode);
+    else return mulDivWide(value.raw, 1, (unsigned __int128)price.raw * pow10u64(V - Out - P), out.raw, mode);
+}
+
+// `amount` of one asset in units of another, both priced in the same quote:
+// amount * fromPrice / toPrice, rescaled from A to Out
+template <unsigned Out, unsigned A, unsigned P>
+constexpr bool convertAt(Decimal<A> amount, Decimal<P> fromPrice, Decimal<P> toPrice, Decimal<Out>& out,
+                         Rounding mode = Rounding::Down) {
+    if constexpr (Out >= A) return mulDivScaled(amount.raw, fromPrice.raw, pow10u64(Out - A), toPrice.raw, out.raw, mode);
+    else return mulDivWide(amount.raw, fromPrice.raw, (unsigned __int128)toPrice.raw * pow10u64(A - Out), out.raw, mode);
+}
+
+// The bases in use across the contracts
+using QbtcAmount = Decimal<8>;       // qBTC, cBTC: sats
+using QusdAmount = Decimal<15>;      // qUSD
+using BkpyAmount = Decimal<15>;      // BANKON PYTHAI
+using StxAmount = Decimal<6>;        // micro-STX
+using FeedPrice = Decimal<8>;        // QOracle feeds (e.g. BTC/USD)
+using CommitteePrice = Decimal<15>;  // oracle committee messages
+
+#if defined(__AVX2__)
+// ====== AVX2 Lane Helpers ======
+// Four uint64 lanes per register. AVX2 has no 64-bit multiply, divide or
+// int64 <-> double conversion, so these build them from 32-bit pieces.
+struct Avx2U64 {
+    // uint64 < 2^52 -> double, and back for non-negative doubles < 2^52
+    static __m256d toDouble(__m256i v) {
+        const __m256i magic = _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0)); // 2^52
+        return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(v, magic)), _mm256_set1_pd(4503599627370496.0));
+    }
+    static __m256i toUint(__m256d v) {
+        const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+        return _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(v, magic)), _mm256_castpd_si256(magic));
+    }
+    // int64 with |v| < 2^51 -> double, and back
+    static __m256d signedToDouble(__m256i v) {
+        const __m256d magic = _mm256_set1_pd(6755399441055744.0); // 2^52 + 2^51
+        return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, _mm256_castpd_si256(magic))), magic);
+    }
+    static __m256i toSigned(__m256d v) {
+        const __m256d magic = _mm256_set1_pd(6755399441055744.0);
+        return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(v, magic)), _mm256_castpd_si256(magic));
+    }
+    // Any uint64 -> nearest double (one rounding)
+    static __m256d wideToDouble(__m256i v) {
+        __m256d hi = toDouble(_mm256_srli_epi64(v, 32));
+        __m256d lo = toDouble(_mm256_and_si256(v, _mm256_set1_epi64x(0xFFFFFFFF)));
+        return _mm256_add_pd(_mm256_mul_pd(hi, _mm256_set1_pd(4294967296.0)), lo);
+    }
+    // Any int64 -> nearest double (one rounding)
+    static __m256d wideSignedToDouble(__m256i v) {
+        __m256i hi = _mm256_srli_epi64(v, 32);
+        hi = _mm256_sub_epi64(hi, _mm256_and_si256(_mm256_cmpgt_epi64(hi, _mm256_set1_epi64x(0x7FFFFFFF)),
+                                                   _mm256_set1_epi64x(int64_t(1) << 32)));
+        __m256d lo = toDouble(_mm256_and_si256(v, _mm256_set1_epi64x(0xFFFFFFFF)));
+        return _mm256_add_pd(_mm256_mul_pd(signedToDouble(hi), _mm256_set1_pd(4294967296.0)), lo);
+    }
+    // Integral double in [0, 2^64) -> uint64
+    static __m256i wideToUint(__m256d v) {
+        __m256d hi = _mm256_floor_pd(_mm256_mul_pd(v, _mm256_set1_pd(1.0 / 4294967296.0)));
+        __m256d lo = _mm256_sub_pd(v, _mm256_mul_pd(hi, _mm256_set1_pd(4294967296.0)));
+        return _mm256_or_si256(_mm256_slli_epi64(toUint(hi), 32), toUint(lo));
+    }
+    // Low 64 bits of a * b for b < 2^32
+    static __m256i mulLow(__m256i a, __m256i b) {
+        __m256i lo = _mm256_mul_epu32(a, b);
+        __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    }
+    // Low 64 bits of a * b for any a, b
+    static __m256i mulLowWide(__m256i a, __m256i b) {
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                         _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+    }
+    static __m256i lessThan(__m256i a, __m256i b) { // unsigned a < b
+        const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(b, bias), _mm256_xor_si256(a, bias));
+    }
+};
+#endif
+
+// ====== Batch Kernels ======
+// out[i] = a[i] * b / d, rounded, for every i; lanes that overflow get UINT64_MAX
+// and make the call return false. Results are identical to scalar mulDiv().
+//
+// AVX2 path (d < 2^60): a double estimate of the quotient (product times 1/d),
+// within ~2^-50 of it, leaves a remainder a*b - q*d that is exact mod 2^64 and
+// small enough to be signed; one more estimate and a compare step make it exact.
+// Lanes whose product is too large for that bound (>= 2^110) or whose quotient
+// may not fit (>= 2^64 - 2^16) are redone in scalar.
+inline bool mulDivBatch(const uint64_t* a, uint64_t b, uint64_t d, uint64_t* out, size_t n,
+                        Rounding mode = Rounding::Down) {
+    bool ok = d != 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    if (d != 0 && d < (uint64_t(1) << 60)) {
+        const __m256i bv = _mm256_set1_epi64x(int64_t(b)), dv = _mm256_set1_epi64x(int64_t(d));
+        const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi64x(1);
+        const __m256d bd = _mm256_set1_pd(double(b)), inv = _mm256_set1_pd(1.0 / double(d));
+        const __m256d productLimit = _mm256_set1_pd(1298074214633706907132624082305024.0); // 2^110
+        const __m256d quotientLimit = _mm256_set1_pd(18446744073709486080.0);              // 2^64 - 2^16
+        for (; i + 4 <= n; i += 4) {
+            __m256i av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256d prod = _mm256_mul_pd(Avx2U64::wideToDouble(av), bd);
+            __m256d qd = _mm256_floor_pd(_mm256_mul_pd(prod, inv));
+            __m256d slow = _mm256_or_pd(_mm256_cmp_pd(prod, productLimit, _CMP_GE_OQ),
+                                        _mm256_cmp_pd(qd, quotientLimit, _CMP_GE_OQ));
+            qd = _mm256_andnot_pd(slow, qd);
+            __m256i q = Avx2U64::wideToUint(qd);
+            __m256i r = _mm256_sub_epi64(Avx2U64::mulLowWide(av, bv), Avx2U64::mulLowWide(q, dv));
+            __m256i c = Avx2U64::toSigned(_mm256_floor_pd(_mm256_mul_pd(Avx2U64::wideSignedToDouble(r), inv)));
+            q = _mm256_add_epi64(q, c);
+            r = _mm256_sub_epi64(r, Avx2U64::mulLowWide(c, dv));
+            __m256i neg = _mm256_cmpgt_epi64(zero, r);                            // r < 0: one too many
+            q = _mm256_add_epi64(q, neg);
+            r = _mm256_add_epi64(r, _mm256_and_si256(neg, dv));
+            __m256i over = _mm256_cmpgt_epi64(r, _mm256_sub_epi64(dv, one));      // r >= d: one too few
+            q = _mm256_sub_epi64(q, over);
+            r = _mm256_sub_epi64(r, _mm256_and_si256(over, dv));
+            __m256i up = zero;
+            __m256i half = _mm256_sub_epi64(dv, r);                               // d - r, r in [0, d)
+            switch (mode) {
+            case Rounding::Down: break;
+            case Rounding::Up: up = _mm256_xor_si256(_mm256_cmpeq_epi64(r, zero), _mm256_set1_epi64x(-1)); break;
+            case Rounding::HalfUp: up = _mm256_xor_si256(_mm256_cmpgt_epi64(half, r), _mm256_set1_epi64x(-1)); break;
+            case Rounding::HalfEven:
+                up = _mm256_or_si256(_mm256_cmpgt_epi64(r, half),
+                                     _mm256_and_si256(_mm256_cmpeq_epi64(r, half),
+                                                      _mm256_cmpeq_epi64(_mm256_and_si256(q, one), one)));
+                break;
+            }
+            q = _mm256_sub_epi64(q, up);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), q);
+            for (int m = _mm256_movemask_pd(slow), lane = 0; m; ++lane, m >>= 1)
+                if ((m & 1) && !mulDiv(a[i + lane], b, d, out[i + lane], mode)) {
+                    out[i + lane] = UINT64_MAX;
+                    ok = false;
+                }
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        if (!mulDiv(a[i], b, d, out[i], mode)) {
+            out[i] = UINT64_MAX;
+            ok = false;
+        }
+    return ok;
+}
+
+// rescale() over an array of raw amounts
+template <unsigned To, unsigned From>
+inline bool rescaleBatch(const uint64_t* in, uint64_t* out, size_t n, Rounding mode = Rounding::Down) {
+    if constexpr (To >= From) return mulDivBatch(in, pow10u64(To - From), 1, out, n, mode);
+    else return mulDivBatch(in, 1, pow10u64(From - To), out, n, mode);
+}
+
+// valueAt() over an array of raw amounts at one price
+template <unsigned Out, unsigned A, unsigned P>
+inline bool valueBatch(const uint64_t* amounts, Decimal<P> price, uint64_t* out, size_t n,
+                       Rounding mode = Rounding::Down) {
+    if constexpr (A + P >= Out && A + P - Out <= 18) {
+        return mulDivBatch(amounts, price.raw, pow10u64(A + P - Out), out, n, mode);
+    } else {
+        bool ok = true;
+        for (size_t i = 0; i < n; ++i) {
+            Decimal<Out> v;
+            if (!valueAt<Out>(Decimal<A>(amounts[i]), price, v, mode)) {
+                v.raw = UINT64_MAX;
+                ok = false;
+            }
+            out[i] = v.raw;
+        }
+        return ok;
+    }
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
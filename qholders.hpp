@@ -0,0 +1,362 @@
+/*
+ * qHolders – Holder ranking index and point-in-time balances
+ * O(log n) rank / top-N by balance, balanceOfAt(account, tick) and top-N at a past tick from versioned history
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <algorithm>
+#include "qstatetree.hpp"
+
+// Ticks of balance history answerable exactly by balanceAt() and topHoldersAt()
+constexpr uint64_t HOLDER_HISTORY_TICKS = 4096;
+// Expired versions pruned per closed tick on top of those written during it
+constexpr uint64_t HOLDER_PRUNE_SLICE = 1024;
+
+// ====== Holder Index ======
+// Size-augmented treap ordered by (balance desc, key asc), holding every account
+// with a non-zero balance. Each key is interned once into an account slot that
+// carries the key, its treap priority and a short list of (tick, balance)
+// versions; tree nodes and the prune queue refer to slots, never copy keys.
+// Nodes, slots and the queue are pooled and reused, so once an account is known,
+// transfers touching it do not allocate. Reads at an older tick never block writes.
+// Treap priorities are a seeded hash of the whole key and split/merge walk the
+// tree iteratively, so crafted keys can neither skew the shape nor the stack.
+template <typename Key, typename KeyHash = TableHash>
+class HolderIndex {
+private:
+    struct Node {
+        uint32_t account;
+        uint32_t prio;
+        uint64_t balance;
+        uint64_t order; // keyOrder() of the account's key
+        uint32_t left, right, size;
+    };
+    struct Version {
+        uint64_t tick;
+        uint64_t balance;
+    };
+    struct Account {
+        Key key;
+        uint64_t order;
+        uint32_t prio;
+        std::vector<Version> versions; // oldest first; back() is current; empty: slot free
+    };
+
+    std::vector<Node> nodes;     // index 0 is the null node
+    std::vector<uint32_t> freeList;
+    uint32_t root = 0;
+    std::unordered_map<Key, uint32_t, KeyHash> slots; // key -> accounts index
+    std::vector<Account> accounts;
+    std::vector<uint32_t> freeAccounts;
+    std::vector<std::pair<uint64_t, uint32_t>> superseding; // (tick, slot) of versions that replaced an older one
+    size_t supersedingHead = 0;
+    std::vector<uint32_t> path;  // split/merge scratch
+    uint64_t horizon = 0;        // oldest tick balanceAt() answers exactly
+    uint64_t writtenThisTick = 0;
+
+    // Leading key bytes as a number, so most balance ties are broken inside the node:
+    // keyOrder(a) < keyOrder(b) implies a < b, and only equal orders compare keys
+    static uint64_t keyOrder(uint64_t key) { return key; }
+    template <typename Bytes>
+    static uint64_t keyOrder(const Bytes& key) {
+        uint64_t order = 0;
+        for (size_t i = 0; i < 8; ++i) order = order << 8 | (i < key.size() ? uint8_t(key[i]) : 0);
+        return order;
+    }
+
+    // Strict order: does (b1, account a1) rank ahead of (b2, account a2)?
+    bool ahead(uint64_t b1, uint64_t o1, uint32_t a1, uint64_t b2, uint64_t o2, uint32_t a2) const {
+        if (b1 != b2) return b1 > b2;
+        if (o1 != o2) return o1 < o2;
+        return a1 != a2 && accounts[a1].key < accounts[a2].key;
+    }
+
+    uint32_t size(uint32_t t) const { return t ? nodes[t].size : 0; }
+    void pull(uint32_t t) { nodes[t].size = 1 + size(nodes[t].left) + size(nodes[t].right); }
+
+    uint32_t alloc(uint32_t account, uint64_t balance) {
+        uint32_t t;
+        if (!freeList.empty()) {
+            t = freeList.back();
+            freeList.pop_back();
+            nodes[t] = Node{account, accounts[account].prio, balance, accounts[account].order, 0, 0, 1};
+        } else {
+            t = uint32_t(nodes.size());
+            nodes.push_back(Node{account, accounts[account].prio, balance, accounts[account].order, 0, 0, 1});
+        }
+        return t;
+    }
+
+    // Slot of `key`, taking a free one (whose key and version buffers are reused) if new
+    uint32_t intern(const Key& key) {
+        uint32_t slot;
+        if (!freeAccounts.empty()) {
+            slot = freeAccounts.back();
+            freeAccounts.pop_back();
+            accounts[slot].key = key;
+        } else {
+            slot = uint32_t(accounts.size());
+            accounts.push_back(Account{key, 0, 0, {}});
+        }
+        accounts[slot].order = keyOrder(key);
+        uint64_t h = uint64_t(TableHash()(key));
+        accounts[slot].prio = uint32_t(h ^ (h >> 32));
+        slots.emplace(key, slot);
+        return slot;
+    }
+
+    // Split t into nodes ranking ahead of (balance, account) and the rest;
+    // with `inclusive`, (balance, account) itself goes left
+    void split(uint32_t t, uint64_t balance, uint32_t account, bool inclusive, uint32_t& l, uint32_t& r) {
+        uint32_t* lh = &l;
+        uint32_t* rh = &r;
+        const uint64_t order = accounts[account].order;
+        path.clear();
+        while (t) {
+            path.push_back(t);
+            Node& n = nodes[t];
+            bool goesLeft = ahead(n.balance, n.order, n.account, balance, order, account) ||
+                            (inclusive && n.balance == balance && n.account == account);
+            if (goesLeft) {
+                *lh = t;
+                lh = &n.right;
+                t = n.right;
+            } else {
+                *rh = t;
+                rh = &n.left;
+                t = n.left;
+            }
+        }
+        *lh = *rh = 0;
+        for (size_t i = path.size(); i--;) pull(path[i]); // each node hangs below the ones visited before it
+    }
+
+    uint32_t merge(uint32_t l, uint32_t r) {
+        uint32_t result = 0;
+        uint32_t* hook = &result;
+        path.clear();
+        while (l && r) {
+            if (nodes[l].prio > nodes[r].prio) {
+                *hook = l;
+                path.push_back(l);
+                hook = &nodes[l].right;
+                l = nodes[l].right;
+            } else {
+                *hook = r;
+                path.push_back(r);
+                hook = &nodes[r].left;
+                r = nodes[r].left;
+            }
+        }
+        *hook = l ? l : r;
+        for (size_t i = path.size(); i--;) pull(path[i]);
+        return result;
+    }
+
+    void insert(uint32_t account, uint64_t balance) {
+        uint32_t l, r;
+        split(root, balance, account, false, l, r);
+        root = merge(merge(l, alloc(account, balance)), r);
+    }
+
+    void erase(uint32_t account, uint64_t balance) {
+        uint32_t l, mid, r;
+        split(root, balance, account, false, l, r);
+        split(r, balance, account, true, mid, r);
+        if (mid) freeList.push_back(mid);
+        root = merge(l, r);
+    }
+
+    // Balance of a slot as of the end of `tick`
+    uint64_t versionAt(const Account& a, uint64_t tick) const {
+        auto pos = std::upper_bound(a.versions.begin(), a.versions.end(), tick,
+            [](uint64_t t, const Version& ver) { return t < ver.tick; });
+        return pos == a.versions.begin() ? 0 : (pos - 1)->balance;
+    }
+
+    // Drop versions of a slot no longer needed to answer queries at or after `tick`;
+    // a slot left holding only a zero balance is released
+    void prune(uint32_t slot, uint64_t tick) {
+        auto& v = accounts[slot].versions;
+        if (v.empty()) return;
+        auto pos = std::upper_bound(v.begin(), v.end(), tick,
+            [](uint64_t t, const Version& ver) { return t < ver.tick; });
+        if (pos != v.begin()) v.erase(v.begin(), pos - 1);
+        if (v.size() == 1 && v.front().balance == 0) {
+            v.clear();
+            slots.erase(accounts[slot].key);
+            freeAccounts.push_back(slot);
+        }
+    }
+
+public:
+    HolderIndex() { nodes.push_back(Node{0, 0, 0, 0, 0, 0, 0}); }
+
+    // Record a balance change at `tick` (ticks must not go backwards per account)
+    void update(const Key& key, uint64_t balance, uint64_t tick) {
+        auto it = slots.find(key);
+        uint32_t slot;
+        if (it == slots.end()) {
+            if (!balance) return;
+            slot = intern(key);
+        } else {
+            slot = it->second;
+        }
+        auto& versions = accounts[slot].versions;
+        uint64_t old = versions.empty() ? 0 : versions.back().balance;
+        if (old == balance && !versions.empty()) return;
+        if (old) erase(slot, old);
+        if (balance) insert(slot, balance);
+        if (!versions.empty() && versions.back().tick == tick) {
+            versions.back().balance = balance;
+            return;
+        }
+        if (!versions.empty()) {
+            superseding.emplace_back(tick, slot);
+            ++writtenThisTick;
+        }
+        versions.push_back({tick, balance});
+    }
+
+    uint64_t holders() const { return size(root); }
+
+    uint64_t balanceOf(const Key& key) const {
+        auto it = slots.find(key);
+        return it == slots.end() ? 0 : accounts[it->second].versions.back().balance;
+    }
+
+    // Balance as of the end of `tick`: O(log v) over the account's versions. Returns
+    // false if `tick` is older than the HOLDER_HISTORY_TICKS kept; `balance` is then
+    // as of the oldest answerable tick.
+    bool balanceAt(const Key& key, uint64_t tick, uint64_t& balance) const {
+        auto it = slots.find(key);
+        balance = it == slots.end() ? 0 : versionAt(accounts[it->second], std::max(tick, horizon));
+        return tick >= horizon;
+    }
+
+    // 0-based rank by balance (0 = largest holder); false if the account holds nothing
+    bool rankOf(const Key& key, uint64_t& rank) const {
+        auto it = slots.find(key);
+        if (it == slots.end()) return false;
+        uint32_t account = it->second;
+        uint64_t balance = accounts[account].versions.back().balance;
+        uint64_t order = accounts[account].order;
+        if (!balance) return false;
+        rank = 0;
+        for (uint32_t t = root; t;) {
+            const Node& n = nodes[t];
+            if (n.account == account) { rank += size(n.left); return true; }
+            if (ahead(n.balance, n.order, n.account, balance, order, account)) {
+                rank += size(n.left) + 1;
+                t = n.right;
+            } else {
+                t = n.left;
+            }
+        }
+        return false;
+    }
+
+    // Holder at a 0-based rank
+    bool holderAt(uint64_t rank, Key& key, uint64_t& balance) const {
+        for (uint32_t t = root; t;) {
+            const Node& n = nodes[t];
+            uint64_t ls = size(n.left);
+            if (rank < ls) { t = n.left; continue; }
+            if (rank == ls) { key = accounts[n.account].key; balance = n.balance; return true; }
+            rank -= ls + 1;
+            t = n.right;
+        }
+        return false;
+    }
+
+    // Largest `count` holders, in rank order: O(log n + count)
+    template <typename Visit>
+    void topHolders(uint64_t count, Visit visit) const {
+        std::vector<uint32_t> stack;
+        for (uint32_t t = root; (t || !stack.empty()) && count;) {
+            if (t) {
+                stack.push_back(t);
+                t = nodes[t].left;
+                continue;
+            }
+            t = stack.back();
+            stack.pop_back();
+            visit(accounts[nodes[t].account].key, nodes[t].balance);
+            --count;
+            t = nodes[t].right;
+        }
+    }
+
+    // Largest `count` holders as of the end of `tick`, in rank order. The tree only
+    // ranks current balances, so this scans every account's versions with a bounded
+    // heap: O(a log count) over the a accounts with history, meant for snapshots such
+    // as airdrops rather than per-tick use. Returns false if `tick` is older than the
+    // HOLDER_HISTORY_TICKS kept; holders are then as of the oldest answerable tick.
+    template <typename Visit>
+    bool topHoldersAt(uint64_t tick, uint64_t count, Visit visit) const {
+        const uint64_t at = std::max(tick, horizon);
+        std::vector<std::pair<uint64_t, uint32_t>> heap; // (balance, slot); front ranks last
+        auto later = [this](const std::pair<uint64_t, uint32_t>& x, const std::pair<uint64_t, uint32_t>& y) {
+            return ahead(x.first, accounts[x.second].order, x.second, y.first, accounts[y.second].order, y.second);
+        };
+        for (uint32_t slot = 0; slot < accounts.size() && count; ++slot) {
+            if (accounts[slot].versions.empty()) continue;
+            uint64_t balance = versionAt(accounts[slot], at);
+            if (!balance) continue;
+            if (heap.size() < count) {
+                heap.emplace_back(balance, slot);
+                std::push_heap(heap.begin(), heap.end(), later);
+            } else if (later({balance, slot}, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                heap.back() = {balance, slot};
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end(), later);
+        for (const auto& h : heap) visit(accounts[h.second].key, h.first);
+        return tick >= horizon;
+    }
+
+    // Drop versions of `key` no longer needed to answer queries at or after `tick`
+    void pruneHistory(const Key& key, uint64_t tick) {
+        auto it = slots.find(key);
+        if (it != slots.end()) prune(it->second, tick);
+    }
+
+    // Call once per closed tick. Versions are queued in tick order as they are
+    // superseded; each tick prunes the expired ones in a slice bounded by the
+    // writes it saw plus HOLDER_PRUNE_SLICE, so the queue drains at write speed
+    // and no tick sweeps every account. A slot released and reused meanwhile is
+    // only pruned to the horizon, which is always safe.
+    void endTick(uint64_t tick) {
+        if (tick < HOLDER_HISTORY_TICKS) return;
+        horizon = std::max(horizon, tick - HOLDER_HISTORY_TICKS);
+        uint64_t budget = writtenThisTick + HOLDER_PRUNE_SLICE;
+        writtenThisTick = 0;
+        while (budget-- && supersedingHead < superseding.size() && superseding[supersedingHead].first <= horizon) {
+            prune(superseding[supersedingHead].second, horizon);
+            ++supersedingHead;
+        }
+        if (supersedingHead > superseding.size() / 2) { // compact in place, keeping capacity
+            superseding.erase(superseding.begin(), superseding.begin() + supersedingHead);
+            supersedingHead = 0;
+        }
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,313 @@
+/*
+ * qJournal – Write-ahead journal of contract state changes between snapshots
+ * Typed per-contract records, one write and one fsync per tick, replay onto the last snapshot
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "qevents.hpp"
+#include "qsnapshot.hpp"
+#include "qstatedelta.hpp"
+
+// ====== File Layout ======
+// [JournalHeader][frame][frame]...[commit frame] [frame]...[commit frame] ...
+// A frame is a JournalFrame followed by its payload, padded to 8 bytes. A tick's
+// frames are written together and end with a Commit frame; on replay a group
+// without its Commit (the write a crash cut short) is discarded whole.
+constexpr char JOURNAL_MAGIC[4] = {'Q', 'J', 'R', 'N'};
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+struct JournalHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t reserved;
+};
+
+enum class JournalRecord : uint8_t {
+    Commit = 0, // end of a tick's group; tick is the host tick
+    Delta = 1,  // the contract's exportDelta() for one of its ticks
+    Price = 2,  // an oracle's feed state after an accepted update, raw struct
+};
+
+// What records: qusd (balances and collateral positions), qBTC, BKPY, vesting and
+// the Qnosis vault journal a Delta per tick; the oracles journal a Price per update.
+// Not journaled: the bankonpythai-pool. It has no snapshot or delta to restore its
+// hash maps onto, so a Delta would have nothing to replay against once the journal
+// is reset after a snapshot; its host re-seeds it at startup instead.
+
+struct JournalFrame {
+    uint32_t length;   // payload bytes, before padding
+    uint16_t contract; // EventContract
+    uint8_t kind;      // JournalRecord
+    uint8_t reserved;
+    uint64_t tick;     // the contract's own tick (Delta), host tick (Commit)
+    uint64_t checksum; // SnapshotChecksum over the 16 bytes above and the payload
+};
+
+// ====== Stream Adapters ======
+// Contracts serialize with std::ostream/istream (qstatedelta.hpp); these run them
+// straight over journal buffers and the mapped file without copies.
+class JournalSink : public std::streambuf {
+private:
+    std::vector<uint8_t>& buf;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) buf.push_back(uint8_t(c));
+        return c;
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(s), reinterpret_cast<const uint8_t*>(s) + n);
+        return n;
+    }
+
+public:
+    explicit JournalSink(std::vector<uint8_t>& b) : buf(b) {}
+};
+
+class JournalSource : public std::streambuf {
+public:
+    JournalSource(const uint8_t* data, size_t n) {
+        char* p = const_cast<char*>(reinterpret_cast<const char*>(data));
+        setg(p, p, p + n);
+    }
+};
+
+inline uint64_t journalChecksum(const JournalFrame& f, const uint8_t* payload) {
+    SnapshotChecksum sum;
+    sum.update(&f, offsetof(JournalFrame, checksum));
+    sum.update(payload, f.length);
+    return sum.final();
+}
+
+inline size_t journalPadded(size_t n) { return (n + 7) & ~size_t(7); }
+
+// ====== Journal ======
+// Contracts record() their changes as they close a tick; the host calls commit()
+// once per tick, after every contract's endTick, to make the group durable with a
+// single write and fdatasync. Until then the group lives in memory only, so a crash
+// loses at most the tick in flight. record() may be called from concurrent tick
+// lanes (qtick.hpp); frames of one tick can land in any order, which replay does
+// not mind since each contract only reads its own frames.
+//
+// Recover first (replayJournal onto the restored snapshots), then open() with the
+// replay's validBytes so a torn tail is cut off before new groups are appended.
+// Once every journaled contract has a newer snapshot, reset() empties the file.
+class Journal {
+private:
+    int fd = -1;
+    std::mutex lock;
+    std::vector<uint8_t> pending; // frames of the open group
+    uint64_t bytes = 0;           // file size after the last commit
+    uint64_t groups = 0;
+    bool sync = true;
+
+    static void appendFrame(std::vector<uint8_t>& out, EventContract contract, JournalRecord kind, uint64_t tick,
+                            const uint8_t* payload, size_t n) {
+        JournalFrame f = {};
+        f.length = uint32_t(n);
+        f.contract = uint16_t(contract);
+        f.kind = uint8_t(kind);
+        f.tick = tick;
+        f.checksum = journalChecksum(f, payload);
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(&f);
+        out.insert(out.end(), h, h + sizeof(f));
+        out.insert(out.end(), payload, payload + n);
+        out.resize(out.size() + journalPadded(n) - n, 0);
+    }
+
+    bool writeAll(const uint8_t* p, size_t n) {
+        while (n) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            n -= size_t(w);
+        }
+        return true;
+    }
+
+public:
+    ~Journal() { close(); }
+
+    // Create, or append to an existing journal cut back to validBytes
+    bool open(const std::string& path, uint64_t validBytes = UINT64_MAX) {
+        close();
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return close(), false;
+        uint64_t size = uint64_t(st.st_size);
+        if (size == 0) {
+            JournalHeader h = {};
+            memcpy(h.magic, JOURNAL_MAGIC, 4);
+            h.version = JOURNAL_VERSION;
+            if (!writeAll(reinterpret_cast<const uint8_t*>(&h), sizeof(h)) || fdatasync(fd) != 0) return close(), false;
+            size = sizeof(h);
+        } else {
+            JournalHeader h;
+            if (pread(fd, &h, sizeof(h), 0) != ssize_t(sizeof(h)) || memcmp(h.magic, JOURNAL_MAGIC, 4) != 0
+                || h.version != JOURNAL_VERSION)
+                return close(), false;
+            if (validBytes < size) {
+                if (validBytes < sizeof(h) || ftruncate(fd, off_t(validBytes)) != 0) return close(), false;
+                size = validBytes;
+            }
+        }
+        if (lseek(fd, off_t(size), SEEK_SET) < 0) return close(), false;
+        bytes = size;
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        pending.clear();
+    }
+
+    bool active() const { return fd >= 0; }
+    uint64_t size() const { return bytes; }
+    uint64_t committedGroups() const { return groups; }
+
+    // Benchmarks only: commit without fdatasync
+    void setSync(bool on) { sync = on; }
+
+    // write(std::ostream&) produces the payload. No-op while the journal is closed.
+    template <typename Write>
+    void record(EventContract contract, JournalRecord kind, uint64_t tick, Write write) {
+        if (!active()) return;
+        thread_local std::vector<uint8_t> payload;
+        payload.clear();
+        JournalSink sink(payload);
+        std::ostream out(&sink);
+        write(out);
+        std::lock_guard<std::mutex> guard(lock);
+        appendFrame(pending, contract, kind, tick, payload.data(), payload.size());
+    }
+
+    // Make the tick's group durable: one write, one fdatasync. Nothing recorded, nothing written.
+    bool commit(uint64_t tick) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!active() || pending.empty()) return true;
+        appendFrame(pending, EventContract(0), JournalRecord::Commit, tick, nullptr, 0);
+        bool ok = writeAll(pending.data(), pending.size()) && (!sync || fdatasync(fd) == 0);
+        if (ok) {
+            bytes += pending.size();
+            ++groups;
+        } else if (ftruncate(fd, off_t(bytes)) != 0 || lseek(fd, off_t(bytes), SEEK_SET) < 0) {
+            ::close(fd); // a half-written group would sit in front of every later one
+            fd = -1;
+        }
+        pending.clear();
+        return ok;
+    }
+
+    // Drop everything journaled so far; call once newer snapshots cover it
+    bool reset() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!active()) return false;
+        pending.clear();
+        if (ftruncate(fd, off_t(sizeof(JournalHeader))) != 0 || fdatasync(fd) != 0) return false;
+        bytes = sizeof(JournalHeader);
+        return lseek(fd, off_t(bytes), SEEK_SET) >= 0;
+    }
+};
+
+inline Journal& journal() {
+    static Journal j;
+    return j;
+}
+
+// ====== Replay ======
+struct JournalReplay {
+    uint64_t groups = 0;
+    uint64_t frames = 0;
+    uint64_t validBytes = 0; // end of the last complete group; open() the journal with this
+    bool tornTail = false;   // bytes after validBytes were dropped
+};
+
+// Map the journal and hand every frame of every committed group, in file order, to
+// apply(contract, kind, tick, std::istream& payload), which returns false on a
+// payload it cannot apply. False if the file is not a journal or apply() failed.
+template <typename Apply>
+bool replayJournal(const std::string& path, JournalReplay& r, Apply apply) {
+    r = JournalReplay();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(JournalHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = size_t(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    madvise(map, size, MADV_SEQUENTIAL);
+    const uint8_t* base = static_cast<const uint8_t*>(map);
+    JournalHeader h;
+    memcpy(&h, base, sizeof(h));
+    bool ok = memcmp(h.magic, JOURNAL_MAGIC, 4) == 0 && h.version == JOURNAL_VERSION;
+
+    std::vector<size_t> group; // frame offsets, applied once the Commit is seen
+    size_t at = sizeof(JournalHeader);
+    r.validBytes = at;
+    while (ok && at + sizeof(JournalFrame) <= size) {
+        JournalFrame f;
+        memcpy(&f, base + at, sizeof(f));
+        const uint8_t* payload = base + at + sizeof(f);
+        size_t next = at + sizeof(f) + journalPadded(f.length);
+        if (next > size || journalChecksum(f, payload) != f.checksum) break;
+        if (JournalRecord(f.kind) != JournalRecord::Commit) {
+            group.push_back(at);
+            at = next;
+            continue;
+        }
+        for (size_t offset : group) {
+            JournalFrame g;
+            memcpy(&g, base + offset, sizeof(g));
+            JournalSource source(base + offset + sizeof(g), g.length);
+            std::istream in(&source);
+            if (!apply(EventContract(g.contract), JournalRecord(g.kind), g.tick, in)) {
+                ok = false;
+                break;
+            }
+        }
+        r.frames += group.size();
+        ++r.groups;
+        group.clear();
+        at = next;
+        r.validBytes = at;
+    }
+    r.tornTail = ok && r.validBytes < size;
+    munmap(map, size);
+    return ok;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
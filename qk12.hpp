@@ -0,0 +1,221 @@
+/*
+ * qK12 – Reference KangarooTwelve for off-chain tools (the node provides its own)
+ * Keccak-p[1600,12] sponge, TurboSHAKE128 and the 8 KiB-chunk tree mode
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Contracts declare KangarooTwelve() as a platform extern. Tools that run them
+// outside a node (qrpcnode.cpp) define it with k12() so state roots and event
+// keys match what a node computes.
+
+// ====== Keccak-p[1600, 12] ======
+// Steps unrolled over the 25 lanes held in locals, so the state stays in
+// registers across a round and every rotation is by a constant.
+inline void keccakP1600x12(uint64_t s[25]) {
+    static constexpr uint64_t RC[12] = {
+        0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+    auto rol = [](uint64_t x, unsigned n) { return (x << n) | (x >> (64 - n)); };
+    uint64_t a0 = s[0], a1 = s[1], a2 = s[2], a3 = s[3], a4 = s[4];
+    uint64_t a5 = s[5], a6 = s[6], a7 = s[7], a8 = s[8], a9 = s[9];
+    uint64_t a10 = s[10], a11 = s[11], a12 = s[12], a13 = s[13], a14 = s[14];
+    uint64_t a15 = s[15], a16 = s[16], a17 = s[17], a18 = s[18], a19 = s[19];
+    uint64_t a20 = s[20], a21 = s[21], a22 = s[22], a23 = s[23], a24 = s[24];
+    for (uint64_t rc : RC) {
+        // theta
+        const uint64_t c0 = a0 ^ a5 ^ a10 ^ a15 ^ a20;
+        const uint64_t c1 = a1 ^ a6 ^ a11 ^ a16 ^ a21;
+        const uint64_t c2 = a2 ^ a7 ^ a12 ^ a17 ^ a22;
+        const uint64_t c3 = a3 ^ a8 ^ a13 ^ a18 ^ a23;
+        const uint64_t c4 = a4 ^ a9 ^ a14 ^ a19 ^ a24;
+        const uint64_t d0 = c4 ^ rol(c1, 1);
+        const uint64_t d1 = c0 ^ rol(c2, 1);
+        const uint64_t d2 = c1 ^ rol(c3, 1);
+        const uint64_t d3 = c2 ^ rol(c4, 1);
+        const uint64_t d4 = c3 ^ rol(c0, 1);
+        // rho and pi
+        const uint64_t b0 = a0 ^ d0;
+        const uint64_t b1 = rol(a6 ^ d1, 44);
+        const uint64_t b2 = rol(a12 ^ d2, 43);
+        const uint64_t b3 = rol(a18 ^ d3, 21);
+        const uint64_t b4 = rol(a24 ^ d4, 14);
+        const uint64_t b5 = rol(a3 ^ d3, 28);
+        const uint64_t b6 = rol(a9 ^ d4, 20);
+        const uint64_t b7 = rol(a10 ^ d0, 3);
+        const uint64_t b8 = rol(a16 ^ d1, 45);
+        const uint64_t b9 = rol(a22 ^ d2, 61);
+        const uint64_t b10 = rol(a1 ^ d1, 1);
+        const uint64_t b11 = rol(a7 ^ d2, 6);
+        const uint64_t b12 = rol(a13 ^ d3, 25);
+        const uint64_t b13 = rol(a19 ^ d4, 8);
+        const uint64_t b14 = rol(a20 ^ d0, 18);
+        const uint64_t b15 = rol(a4 ^ d4, 27);
+        const uint64_t b16 = rol(a5 ^ d0, 36);
+        const uint64_t b17 = rol(a11 ^ d1, 10);
+        const uint64_t b18 = rol(a17 ^ d2, 15);
+        const uint64_t b19 = rol(a23 ^ d3, 56);
+        const uint64_t b20 = rol(a2 ^ d2, 62);
+        const uint64_t b21 = rol(a8 ^ d3, 55);
+        const uint64_t b22 = rol(a14 ^ d4, 39);
+        const uint64_t b23 = rol(a15 ^ d0, 41);
+        const uint64_t b24 = rol(a21 ^ d1, 2);
+        // chi, iota
+        a0 = b0 ^ (~b1 & b2);
+        a1 = b1 ^ (~b2 & b3);
+        a2 = b2 ^ (~b3 & b4);
+        a3 = b3 ^ (~b4 & b0);
+        a4 = b4 ^ (~b0 & b1);
+        a5 = b5 ^ (~b6 & b7);
+        a6 = b6 ^ (~b7 & b8);
+        a7 = b7 ^ (~b8 & b9);
+        a8 = b8 ^ (~b9 & b5);
+        a9 = b9 ^ (~b5 & b6);
+        a10 = b10 ^ (~b11 & b12);
+        a11 = b11 ^ (~b12 & b13);
+        a12 = b12 ^ (~b13 & b14);
+        a13 = b13 ^ (~b14 & b10);
+        a14 = b14 ^ (~b10 & b11);
+        a15 = b15 ^ (~b16 & b17);
+        a16 = b16 ^ (~b17 & b18);
+        a17 = b17 ^ (~b18 & b19);
+        a18 = b18 ^ (~b19 & b15);
+        a19 = b19 ^ (~b15 & b16);
+        a20 = b20 ^ (~b21 & b22);
+        a21 = b21 ^ (~b22 & b23);
+        a22 = b22 ^ (~b23 & b24);
+        a23 = b23 ^ (~b24 & b20);
+        a24 = b24 ^ (~b20 & b21);
+
+        a0 ^= rc;
+    }
+    s[0] = a0; s[1] = a1; s[2] = a2; s[3] = a3; s[4] = a4;
+    s[5] = a5; s[6] = a6; s[7] = a7; s[8] = a8; s[9] = a9;
+    s[10] = a10; s[11] = a11; s[12] = a12; s[13] = a13; s[14] = a14;
+    s[15] = a15; s[16] = a16; s[17] = a17; s[18] = a18; s[19] = a19;
+    s[20] = a20; s[21] = a21; s[22] = a22; s[23] = a23; s[24] = a24;
+}
+
+// ====== TurboSHAKE128 ======
+// Streaming absorb, then one squeeze. Lanes are little-endian bytes of the state:
+// whole lanes are loaded and stored at once on little-endian hosts, and bytes
+// before the next lane boundary go one at a time.
+class TurboShake128 {
+private:
+    static constexpr unsigned RATE = 168;
+    static constexpr bool LITTLE_ENDIAN_HOST = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+    uint64_t state[25] = {};
+    unsigned pos = 0;
+
+    void xorByte(unsigned i, uint8_t b) { state[i / 8] ^= uint64_t(b) << (8 * (i % 8)); }
+
+    static uint64_t loadLane(const uint8_t* p) {
+        uint64_t v;
+        if (LITTLE_ENDIAN_HOST) {
+            memcpy(&v, p, 8);
+        } else {
+            v = 0;
+            for (int i = 7; i >= 0; --i) v = v << 8 | p[i];
+        }
+        return v;
+    }
+
+public:
+    void absorb(const uint8_t* data, size_t len) {
+        while (len) {
+            if (pos % 8 == 0 && len >= 8) {
+                unsigned lanes = unsigned(std::min<size_t>(len / 8, (RATE - pos) / 8));
+                for (unsigned i = 0; i < lanes; ++i) state[pos / 8 + i] ^= loadLane(data + 8 * i);
+                pos += 8 * lanes;
+                data += 8 * lanes;
+                len -= 8 * lanes;
+            } else {
+                xorByte(pos++, *data++);
+                --len;
+            }
+            if (pos == RATE) {
+                keccakP1600x12(state);
+                pos = 0;
+            }
+        }
+    }
+
+    void squeeze(uint8_t domain, uint8_t* out, size_t len) {
+        xorByte(pos, domain);
+        xorByte(RATE - 1, 0x80);
+        keccakP1600x12(state);
+        for (size_t at = 0; len;) {
+            if (at == RATE) {
+                keccakP1600x12(state);
+                at = 0;
+            }
+            if (LITTLE_ENDIAN_HOST) {
+                size_t n = std::min<size_t>(len, RATE - at);
+                memcpy(out, reinterpret_cast<const uint8_t*>(state) + at, n);
+                out += n;
+                at += n;
+                len -= n;
+            } else {
+                *out++ = uint8_t(state[at / 8] >> (8 * (at % 8)));
+                ++at;
+                --len;
+            }
+        }
+    }
+};
+
+// ====== KangarooTwelve ======
+// Empty customization string. Inputs up to one chunk are a single TurboSHAKE;
+// longer ones hash every chunk after the first to a 32-byte chaining value.
+inline void k12(const uint8_t* input, size_t len, uint8_t* out, size_t outLen) {
+    static constexpr size_t CHUNK = 8192;
+    static constexpr uint8_t EMPTY_CUSTOMIZATION = 0x00; // length_encode(0)
+    if (len + 1 <= CHUNK) {
+        TurboShake128 t;
+        t.absorb(input, len);
+        t.absorb(&EMPTY_CUSTOMIZATION, 1);
+        t.squeeze(0x07, out, outLen);
+        return;
+    }
+    // S = M || length_encode(0); the first chunk goes into the final node as is
+    static constexpr uint8_t NODE_SEPARATOR[8] = {0x03, 0, 0, 0, 0, 0, 0, 0};
+    TurboShake128 final;
+    final.absorb(input, CHUNK);
+    final.absorb(NODE_SEPARATOR, sizeof(NODE_SEPARATOR));
+    size_t total = len + 1, chunks = 0;
+    for (size_t at = CHUNK; at < total; at += CHUNK, ++chunks) {
+        size_t end = at + CHUNK < total ? at + CHUNK : total;
+        TurboShake128 leaf;
+        leaf.absorb(input + at, (end < len ? end : len) - at);
+        if (end > len) leaf.absorb(&EMPTY_CUSTOMIZATION, 1);
+        uint8_t cv[32];
+        leaf.squeeze(0x0B, cv, sizeof(cv));
+        final.absorb(cv, sizeof(cv));
+    }
+    uint8_t enc[9];
+    unsigned n = 0;
+    for (size_t v = chunks; v; v >>= 8) ++n;
+    for (unsigned i = 0; i < n; ++i) enc[i] = uint8_t(chunks >> (8 * (n - 1 - i)));
+    enc[n] = uint8_t(n);
+    final.absorb(enc, n + 1);
+    static constexpr uint8_t TERMINATOR[2] = {0xFF, 0xFF};
+    final.absorb(TERMINATOR, sizeof(TERMINATOR));
+    final.squeeze(0x06, out, outLen);
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
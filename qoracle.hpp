@@ -5,10 +5,13 @@
  * License: Qubic Anti-Military, see end of file.
  */
 
+#pragma once
+
 #include <cstdint>
 #include <string>
 #include <unordered_map>
-#include <chrono>
+#include "qevents.hpp"
+#include "qtick.hpp"
 
 struct PriceData {
     uint64_t price;         // Latest price (e.g. BTC/USD, 1e8 precision for 8 decimals)
@@ -37,7 +40,9 @@ public:
     // Push a price update (only admin, before burn)
     bool pushPrice(const std::string& assetSymbol, uint64_t newPrice, uint8_t decimals, const std::string& sender) {
         if (adminBurned || sender != admin) return false;
-        prices[assetSymbol] = { newPrice, now(), decimals };
+        uint64_t ts = now();
+        prices[assetSymbol] = { newPrice, ts, decimals };
+        emitEvent(EventContract::QORACLE, EventType::PriceUpdate, assetSymbol, EventKeyRef(), newPrice, ts);
         return true;
     }
 
@@ -55,10 +60,9 @@ public:
         return (now() - it->second.timestamp) <= maxAgeSeconds;
     }
 
-    // Get system time (for demo; on Qubic, use contract clock)
+    // Block time of the current tick (see qtick.hpp); one value for the whole tick
     uint64_t now() const {
-        // Use system time (for illustration – replace with Qubic's on-chain timestamp)
-        return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        return tickTimestamp();
     }
 };
 
@@ -34,10 +34,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <cstdint>
 #include <vector>
 #include <array>
-#include <set>
 #include <cstring>
 #include <algorithm>
 #include <stdexcept>
+#include <string>
+#include "qadmission.hpp"
+#include "qsnapshot.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qprobe.hpp"
+#include "qtick.hpp"
 
 // ====== Configurable Oracle Committee Parameters ======
 constexpr size_t NUM_ORACLES = 7;           // committee size
@@ -93,57 +99,102 @@ struct OracleFeed {
     size_t max_history = 1024;
 } feed;
 
-// ====== Get Trusted Block Timestamp ======
-extern uint64_t get_current_block_timestamp(); // Use Qubic trusted source
-
 // ====== Validate a Single Oracle Signature ======
 bool validate_signature(const OraclePubKey& pubkey, const PriceMessage& msg, const std::array<uint8_t, SIG_SIZE>& sig) {
+    QPROBE(probe, "qoracle1.dilithium_verify");
     uint8_t data[16];
     serialize_message(msg, data);
     bool ok = dilithium_verify(pubkey.pubkey.data(), data, sizeof(data), sig.data(), sig.size());
     memset(data, 0, sizeof(data));
-    return ok;
+    if (!ok) return QPROBE_REJECT(probe, false);
+    return true;
 }
 
 // ====== Validate the Oracle Multi-Sig Update ======
-bool validate_update(const PriceUpdate& update) {
-    // A. Input: must have enough signatures, no dupes, valid signers only
-    if (update.signatures.size() < QUORUM_THRESHOLD) return false;
-    std::set<size_t> seen;
-    size_t valid = 0;
+// Cheap checks come first, so a stale, skewed or out-of-range update costs no
+// Dilithium verification. Signatures stop at quorum or once quorum is out of reach;
+// `verifications` counts the ones performed.
+bool validate_update(const PriceUpdate& update, uint32_t& verifications) {
+    QPROBE(probe, "qoracle1.validate_update");
+    // A. Input: must have enough signatures
+    if (update.signatures.size() < QUORUM_THRESHOLD) return QPROBE_REJECT(probe, false);
+
+    // B. Monotonic timestamp, no replay
+    if (update.message.timestamp <= feed.last_timestamp) return QPROBE_REJECT(probe, false);
+
+    // C. Timestamp sanity (prevent far future, far past)
+    uint64_t now = tickTimestamp(); // trusted block time, set by the host once per tick
+    if (update.message.timestamp > now + MAX_TIMESTAMP_SKEW) return QPROBE_REJECT(probe, false);
+    if (now > 0 && update.message.timestamp + MAX_TIMESTAMP_SKEW < now) return QPROBE_REJECT(probe, false);
+
+    // D. Price bounds
+    if (update.message.price < MIN_PRICE || update.message.price > MAX_PRICE) return QPROBE_REJECT(probe, false);
 
+    // E. Signatures: no dupes, valid signers only
+    std::array<bool, NUM_ORACLES> seen{};
+    size_t valid = 0;
+    size_t remaining = update.signatures.size();
     for (const auto& sig : update.signatures) {
+        if (valid == QUORUM_THRESHOLD || valid + remaining < QUORUM_THRESHOLD) break;
+        --remaining;
         if (sig.signer_index >= NUM_ORACLES) continue;
-        if (!seen.insert(sig.signer_index).second) continue; // skip dupes
+        if (seen[sig.signer_index]) continue; // skip dupes
+        seen[sig.signer_index] = true;
+        ++verifications;
         if (validate_signature(trusted_oracles[sig.signer_index], update.message, sig.signature)) {
             ++valid;
         }
     }
-    if (valid < QUORUM_THRESHOLD) return false;
+    if (valid < QUORUM_THRESHOLD) return QPROBE_REJECT(probe, false);
 
-    // B. Monotonic timestamp, no replay
-    if (update.message.timestamp <= feed.last_timestamp) return false;
+    return true;
+}
 
-    // C. Timestamp sanity (prevent far future, far past)
-    uint64_t now = get_current_block_timestamp();
-    if (update.message.timestamp > now + MAX_TIMESTAMP_SKEW) return false;
-    if (now > 0 && update.message.timestamp + MAX_TIMESTAMP_SKEW < now) return false;
+bool validate_update(const PriceUpdate& update) {
+    uint32_t verifications = 0;
+    return validate_update(update, verifications);
+}
 
-    // D. Price bounds
-    if (update.message.price < MIN_PRICE || update.message.price > MAX_PRICE) return false;
+void store_price(const PriceMessage& message) {
+    feed.last_price = message.price;
+    feed.last_timestamp = message.timestamp;
+    if (feed.history.size() == feed.max_history)
+        feed.history.erase(feed.history.begin());
+    feed.history.push_back(message);
+}
 
-    return true;
+void apply_update(const PriceMessage& message) {
+    store_price(message);
+    journal().record(EventContract::QORACLE_VALIDATOR, JournalRecord::Price, 0, [&message](std::ostream& out) {
+        out.write(reinterpret_cast<const char*>(&message), sizeof(message));
+    });
+    emitEvent(EventContract::QORACLE_VALIDATOR, EventType::PriceUpdate, EventKeyRef(), EventKeyRef(),
+              message.price, message.timestamp);
 }
 
 // ====== Submit an Oracle Price Update ======
-bool submit_price_update(const PriceUpdate& update) {
-    if (!validate_update(update)) return false;
-    feed.last_price = update.message.price;
-    feed.last_timestamp = update.message.timestamp;
-    if (feed.history.size() == feed.max_history)
-        feed.history.erase(feed.history.begin());
-    feed.history.push_back(update.message);
-    return true;
+// Relays submit updates under their identity; process_price_updates() verifies them
+// at end of tick, proven relays first, within a fixed verification budget
+// (see qadmission.hpp). Nothing reaches validate_update() except through the queue.
+AdmissionQueue<PriceUpdate> admission;
+
+AdmissionResult submit_price_update(const Hash256& submitter, PriceUpdate update) {
+    QPROBE(probe, "qoracle1.submit_price_update");
+    if (update.signatures.size() < QUORUM_THRESHOLD) return QPROBE_REJECT(probe, AdmissionResult::Malformed);
+    uint32_t cost = uint32_t(std::min(update.signatures.size(), NUM_ORACLES)); // dupes are never verified
+    AdmissionResult result = admission.admit(submitter, std::move(update), cost);
+    if (result != AdmissionResult::Queued) return QPROBE_REJECT(probe, result);
+    return result;
+}
+
+AdmissionTickStats process_price_updates() {
+    QPROBE(probe, "qoracle1.process_price_updates");
+    return admission.drain([](const PriceUpdate& update, uint32_t& verifications) {
+        if (update.message.timestamp <= feed.last_timestamp) return AdmissionOutcome::Superseded;
+        if (!validate_update(update, verifications)) return AdmissionOutcome::Rejected;
+        apply_update(update.message);
+        return AdmissionOutcome::Accepted;
+    });
 }
 
 // ====== External Interface ======
@@ -151,6 +202,47 @@ uint64_t get_last_price()      { return feed.last_price; }
 uint64_t get_last_timestamp()  { return feed.last_timestamp; }
 const std::vector<PriceMessage>& get_history() { return feed.history; }
 
+// ====== Journal Replay (qjournal.hpp) ======
+// Updates the snapshot already holds are not newer than its last timestamp
+bool replay_journal(std::istream& in) {
+    PriceMessage message;
+    if (!in.read(reinterpret_cast<char*>(&message), sizeof(message))) return false;
+    if (message.timestamp > feed.last_timestamp) store_price(message);
+    return true;
+}
+
+// ====== Snapshot (feed state survives restarts) ======
+// History is bounded by max_history, so restore copies it: O(1) in chain length.
+constexpr uint32_t SNAPSHOT_TABLE_HISTORY = 0;   // PriceMessage rows, oldest first
+constexpr size_t SNAPSHOT_SCALAR_LAST_PRICE = 0;
+constexpr size_t SNAPSHOT_SCALAR_LAST_TIMESTAMP = 1;
+constexpr size_t SNAPSHOT_SCALAR_MAX_HISTORY = 2;
+
+bool save_snapshot(const std::string& path, uint64_t tick) {
+    SnapshotWriter w(path);
+    w.beginTable(SNAPSHOT_TABLE_HISTORY, sizeof(PriceMessage));
+    for (const auto& msg : feed.history) w.appendRow(msg);
+    w.endTable();
+    w.setScalar(SNAPSHOT_SCALAR_LAST_PRICE, feed.last_price);
+    w.setScalar(SNAPSHOT_SCALAR_LAST_TIMESTAMP, feed.last_timestamp);
+    w.setScalar(SNAPSHOT_SCALAR_MAX_HISTORY, feed.max_history);
+    return w.finish(tick);
+}
+
+bool load_snapshot(const std::string& path) {
+    SnapshotView view;
+    if (!view.open(path) || !view.verify()) return false;
+    size_t n;
+    const PriceMessage* rows = view.table<PriceMessage>(SNAPSHOT_TABLE_HISTORY, n);
+    size_t max_history = size_t(view.scalar(SNAPSHOT_SCALAR_MAX_HISTORY));
+    if (max_history == 0 || n > max_history) return false;
+    feed.last_price = view.scalar(SNAPSHOT_SCALAR_LAST_PRICE);
+    feed.last_timestamp = view.scalar(SNAPSHOT_SCALAR_LAST_TIMESTAMP);
+    feed.max_history = max_history;
+    feed.history.assign(rows, rows + n);
+    return true;
+}
+
 // ====== Emergency/Admin (Future, Placeholder) ======
 // Could add admin multi-sig to update committee, pause contract, etc.
 
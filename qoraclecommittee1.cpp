@@ -2,6 +2,12 @@
 // BANKON PYTHAI Oracle Committee Example (Qubic C++ Contract)
 #include <cstdint>
 #include <cstring>
+#include <vector>
+#include "qadmission.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qprobe.hpp"
+#include "qtick.hpp"
 
 // Number of oracles in committee (can be increased, but 7 is a practical demo size)
 constexpr uint8_t NUM_ORACLES = 7;
@@ -49,8 +55,9 @@ bool is_admin_multisig(const uint8_t* signers, uint8_t num_signers) {
 
 // Add new oracle (admin only, requires multi-sig)
 bool add_oracle(const OraclePubKey& new_pk, const uint8_t* signers, uint8_t num_signers) {
-    if (!is_admin_multisig(signers, num_signers)) return false;
-    if (committee_size >= NUM_ORACLES) return false;
+    QPROBE(probe, "qoraclecommittee1.add_oracle");
+    if (!is_admin_multisig(signers, num_signers)) return QPROBE_REJECT(probe, false);
+    if (committee_size >= NUM_ORACLES) return QPROBE_REJECT(probe, false);
     committee[committee_size] = new_pk;
     is_admin[committee_size] = 0; // new member not admin by default
     committee_size++;
@@ -59,8 +66,9 @@ bool add_oracle(const OraclePubKey& new_pk, const uint8_t* signers, uint8_t num_
 
 // Remove oracle by index (admin only)
 bool remove_oracle(uint8_t idx, const uint8_t* signers, uint8_t num_signers) {
-    if (!is_admin_multisig(signers, num_signers)) return false;
-    if (idx >= committee_size) return false;
+    QPROBE(probe, "qoraclecommittee1.remove_oracle");
+    if (!is_admin_multisig(signers, num_signers)) return QPROBE_REJECT(probe, false);
+    if (idx >= committee_size) return QPROBE_REJECT(probe, false);
     // Shift remaining oracles down
     for (uint8_t i = idx; i + 1 < committee_size; i++) {
         committee[i] = committee[i+1];
@@ -72,54 +80,118 @@ bool remove_oracle(uint8_t idx, const uint8_t* signers, uint8_t num_signers) {
 
 // Rotate (replace) oracle at idx
 bool rotate_oracle(uint8_t idx, const OraclePubKey& new_pk, const uint8_t* signers, uint8_t num_signers) {
-    if (!is_admin_multisig(signers, num_signers)) return false;
-    if (idx >= committee_size) return false;
+    QPROBE(probe, "qoraclecommittee1.rotate_oracle");
+    if (!is_admin_multisig(signers, num_signers)) return QPROBE_REJECT(probe, false);
+    if (idx >= committee_size) return QPROBE_REJECT(probe, false);
     committee[idx] = new_pk;
     return true;
 }
 
-// Price update: require SIGS_REQUIRED valid signatures from current committee
+// Placeholder for Dilithium3 signature verification (implement with your library)
+bool verify_dilithium3_sig(const PriceMessage& msg, const OracleSignature& sig, const OraclePubKey& pk) {
+    // TODO: Call quantum-safe verification library here
+    return true;
+}
+
+// Price update: require SIGS_REQUIRED valid signatures from current committee.
+// Every signature given must verify and each member may sign once; `verifications`
+// counts the Dilithium checks performed.
 bool verify_oracle_signatures(
     const PriceMessage& msg,
     const OracleSignature* sigs,
     const uint8_t* signer_indices,
-    uint8_t num_sigs
+    uint8_t num_sigs,
+    uint32_t& verifications
 ) {
-    if (num_sigs < SIGS_REQUIRED) return false;
-    // For each signature, verify against committee pubkey at signer_indices[i]
+    QPROBE(probe, "qoraclecommittee1.verify_signatures");
+    if (num_sigs < SIGS_REQUIRED || num_sigs > committee_size) return QPROBE_REJECT(probe, false);
+    // Signer indices are checked before any signature, so a malformed update costs nothing
+    bool seen[NUM_ORACLES] = {};
     for (uint8_t i = 0; i < num_sigs; i++) {
         uint8_t idx = signer_indices[i];
-        if (idx >= committee_size) return false;
-        if (!verify_dilithium3_sig(msg, sigs[i], committee[idx])) return false;
+        if (idx >= committee_size || seen[idx]) return QPROBE_REJECT(probe, false);
+        seen[idx] = true;
+    }
+    // For each signature, verify against committee pubkey at signer_indices[i]
+    for (uint8_t i = 0; i < num_sigs; i++) {
+        ++verifications;
+        if (!verify_dilithium3_sig(msg, sigs[i], committee[signer_indices[i]])) return QPROBE_REJECT(probe, false);
     }
     return true;
 }
 
-// Core on-chain update entry (called by anyone, but only updates if signatures are valid)
-bool submit_price_update(
+bool verify_oracle_signatures(
     const PriceMessage& msg,
     const OracleSignature* sigs,
     const uint8_t* signer_indices,
     uint8_t num_sigs
 ) {
-    if (!verify_oracle_signatures(msg, sigs, signer_indices, num_sigs)) return false;
-    // Price staleness check (timestamp >= last seen, within tolerance)
-    if (msg.timestamp <= last_price.timestamp || msg.timestamp > now() + 600) return false;
+    uint32_t verifications = 0;
+    return verify_oracle_signatures(msg, sigs, signer_indices, num_sigs, verifications);
+}
+
+// Price staleness check (timestamp > last seen, within tolerance)
+bool is_fresh(const PriceMessage& msg) {
+    return msg.timestamp > last_price.timestamp && msg.timestamp <= tickTimestamp() + 600;
+}
+
+void apply_price(const PriceMessage& msg) {
     last_price.price = msg.price;
     last_price.timestamp = msg.timestamp;
-    return true;
+    journal().record(EventContract::QORACLE_COMMITTEE, JournalRecord::Price, 0, [](std::ostream& out) {
+        out.write(reinterpret_cast<const char*>(&last_price), sizeof(last_price));
+    });
+    emitEvent(EventContract::QORACLE_COMMITTEE, EventType::PriceUpdate, EventKeyRef(), EventKeyRef(),
+              uint64_t(msg.price), msg.timestamp);
 }
 
-// Placeholder for Dilithium3 signature verification (implement with your library)
-bool verify_dilithium3_sig(const PriceMessage& msg, const OracleSignature& sig, const OraclePubKey& pk) {
-    // TODO: Call quantum-safe verification library here
-    return true;
+// Core on-chain update entry (called by anyone): relays submit under their identity
+// and the host calls process_price_updates() once per tick, which verifies queued
+// updates within a fixed budget (see qadmission.hpp). Signatures are never checked
+// outside that drain.
+struct QueuedUpdate {
+    PriceMessage msg;
+    std::vector<OracleSignature> sigs; // only the signatures given, not NUM_ORACLES of them
+    std::vector<uint8_t> signer_indices;
+};
+
+AdmissionQueue<QueuedUpdate> admission;
+
+AdmissionResult submit_price_update(
+    const Hash256& submitter,
+    const PriceMessage& msg,
+    const OracleSignature* sigs,
+    const uint8_t* signer_indices,
+    uint8_t num_sigs
+) {
+    QPROBE(probe, "qoraclecommittee1.submit_price_update");
+    if (num_sigs < SIGS_REQUIRED || num_sigs > committee_size) return QPROBE_REJECT(probe, AdmissionResult::Malformed);
+    QueuedUpdate u{msg, std::vector<OracleSignature>(sigs, sigs + num_sigs),
+                   std::vector<uint8_t>(signer_indices, signer_indices + num_sigs)};
+    AdmissionResult result = admission.admit(submitter, std::move(u), num_sigs);
+    if (result != AdmissionResult::Queued) return QPROBE_REJECT(probe, result);
+    return result;
+}
+
+AdmissionTickStats process_price_updates() {
+    QPROBE(probe, "qoraclecommittee1.process_price_updates");
+    return admission.drain([](const QueuedUpdate& u, uint32_t& verifications) {
+        if (u.msg.timestamp <= last_price.timestamp) return AdmissionOutcome::Superseded;
+        if (!is_fresh(u.msg)
+            || !verify_oracle_signatures(u.msg, u.sigs.data(), u.signer_indices.data(),
+                                         uint8_t(u.signer_indices.size()), verifications))
+            return AdmissionOutcome::Rejected;
+        apply_price(u.msg);
+        return AdmissionOutcome::Accepted;
+    });
 }
 
-// Util: On-chain time
-uint64_t now() {
-    // Platform/host to provide current block time
-    return 0; // stub
+// Journal replay (qjournal.hpp): the price state after an accepted update
+bool replay_journal(std::istream& in) {
+    LastPrice p;
+    if (!in.read(reinterpret_cast<char*>(&p), sizeof(p))) return false;
+    if (p.timestamp > last_price.timestamp) last_price = p;
+    return true;
 }
 
 // Read function to get the current on-chain price
@@ -0,0 +1,359 @@
+/*
+ * qProbe – Compile-time hot-path instrumentation: scoped timers, call/reject counters
+ * Per-thread log-linear latency histograms, merged on demand into JSON or Prometheus text
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Build with -DQPROBES to record. Without it QPROBE() is an empty statement,
+// QPROBE_REJECT(p, v) is just v, and the snapshot calls report nothing, so
+// instrumented entry points compile to exactly what they were before.
+//
+//     bool submit(...) {
+//         QPROBE(probe, "contract.submit");
+//         if (!valid) return QPROBE_REJECT(probe, false);
+//         ...
+//     }
+//
+// In functions returning void, `return QPROBE_REJECT_VOID(probe);`.
+//
+// QPROBE_THROWING() also counts a scope left by an exception as a reject, for
+// entry points that refuse by throwing (require() in Qgnosis).
+
+#if defined(QPROBES)
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Probe sites per process; a name used in several places is one site
+constexpr unsigned PROBE_MAX_SITES = 256;
+
+// Log-linear buckets: exact below 32 ticks, then 16 per power of two (under
+// 6.25% relative error), covering the whole 64-bit range
+constexpr unsigned PROBE_SUB_BITS = 5;
+constexpr unsigned PROBE_SUB = 1u << PROBE_SUB_BITS;
+constexpr unsigned PROBE_HALF = PROBE_SUB / 2;
+constexpr unsigned PROBE_BUCKETS = PROBE_SUB + (64 - PROBE_SUB_BITS) * PROBE_HALF;
+
+inline unsigned probeBucket(uint64_t v) {
+    if (v < PROBE_SUB) return unsigned(v);
+    unsigned shift = unsigned(63 - __builtin_clzll(v)) - (PROBE_SUB_BITS - 1);
+    return PROBE_SUB + (shift - 1) * PROBE_HALF + unsigned(v >> shift) - PROBE_HALF;
+}
+
+// Largest value that lands in bucket b
+inline uint64_t probeBucketTop(unsigned b) {
+    if (b < PROBE_SUB) return b;
+    unsigned shift = (b - PROBE_SUB) / PROBE_HALF + 1;
+    uint64_t sub = (b - PROBE_SUB) % PROBE_HALF + PROBE_HALF;
+    return ((sub + 1) << shift) - 1;
+}
+
+// Timestamp counter where there is one (a few ns to read), else the monotonic clock in ns
+inline uint64_t probeTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+#endif
+}
+
+inline uint64_t probeMonotonicNs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ====== Per-Thread Storage ======
+// Only the owning thread writes a slot, so counting is a plain load and store
+// (no locked instruction); snapshots read concurrently and may be a few calls behind.
+struct ProbeSlot {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> rejects;
+    std::atomic<uint64_t> sumTicks;
+    std::atomic<uint64_t> maxTicks;
+    std::atomic<uint64_t> buckets[PROBE_BUCKETS];
+};
+
+struct ProbeThread {
+    std::atomic<ProbeSlot*> slots[PROBE_MAX_SITES];
+};
+
+inline void probeBump(std::atomic<uint64_t>& c, uint64_t by = 1) {
+    c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+// Sites and threads are registered once and never removed: a thread's counts
+// outlive it, and slot pointers stay valid for readers.
+class ProbeRegistry {
+private:
+    std::mutex lock;
+    std::vector<std::string> siteNames;
+    std::vector<ProbeThread*> threads;
+    uint64_t baseTicks = probeTicks();
+    uint64_t baseNs = probeMonotonicNs();
+
+public:
+    unsigned site(const char* name) {
+        std::lock_guard<std::mutex> g(lock);
+        for (unsigned i = 0; i < siteNames.size(); ++i)
+            if (siteNames[i] == name) return i;
+        if (siteNames.size() == PROBE_MAX_SITES) return PROBE_MAX_SITES - 1; // last site absorbs overflow
+        siteNames.push_back(name);
+        return unsigned(siteNames.size() - 1);
+    }
+
+    ProbeThread* attach() {
+        ProbeThread* t = new ProbeThread();
+        std::lock_guard<std::mutex> g(lock);
+        threads.push_back(t);
+        return t;
+    }
+
+    // Ticks per ns since the registry started; waits out a short baseline
+    double ticksPerNs() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (probeMonotonicNs() - baseNs < 20000000) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return double(probeTicks() - baseTicks) / double(probeMonotonicNs() - baseNs);
+#else
+        return 1.0;
+#endif
+    }
+
+    template <typename Visit>
+    void forEachSite(Visit visit) {
+        std::lock_guard<std::mutex> g(lock);
+        for (unsigned i = 0; i < siteNames.size(); ++i) {
+            std::vector<const ProbeSlot*> slots;
+            for (const ProbeThread* t : threads)
+                if (const ProbeSlot* s = t->slots[i].load(std::memory_order_acquire)) slots.push_back(s);
+            visit(siteNames[i], slots);
+        }
+    }
+};
+
+inline ProbeRegistry& probeRegistry() {
+    static ProbeRegistry r;
+    return r;
+}
+
+inline unsigned probeSite(const char* name) {
+    return probeRegistry().site(name);
+}
+
+// Constant-initialized, so reaching it is one thread-pointer-relative load
+inline thread_local ProbeThread* probeThreadSlots = nullptr;
+
+inline ProbeSlot& probeSlot(unsigned site) {
+    ProbeThread* mine = probeThreadSlots;
+    if (__builtin_expect(!mine, 0)) mine = probeThreadSlots = probeRegistry().attach();
+    ProbeSlot* s = mine->slots[site].load(std::memory_order_relaxed);
+    if (__builtin_expect(!s, 0)) {
+        s = new ProbeSlot();
+        mine->slots[site].store(s, std::memory_order_release);
+    }
+    return *s;
+}
+
+// ====== Scoped Timer ======
+// Counters are exact. Latency is taken on one call in 2^QPROBE_SAMPLE_SHIFT per
+// thread and site: reading the timestamp counter is most of a scope's cost, and
+// under a hypervisor it can be 20+ ns a read, so hot sites can be sampled.
+#if !defined(QPROBE_SAMPLE_SHIFT)
+#define QPROBE_SAMPLE_SHIFT 3
+#endif
+constexpr uint64_t PROBE_SAMPLE_MASK = (uint64_t(1) << QPROBE_SAMPLE_SHIFT) - 1;
+
+// Throwing = true also counts a scope left by an exception as a reject. It is
+// opt-in because std::uncaught_exceptions() is two calls into the runtime.
+template <bool Throwing>
+class ProbeScope {
+private:
+    ProbeSlot& slot;
+    bool rejected = false;
+    bool timed;
+    int exceptions = 0;
+    uint64_t start = 0;
+
+public:
+    explicit ProbeScope(unsigned site)
+        : slot(probeSlot(site)), timed((slot.calls.load(std::memory_order_relaxed) & PROBE_SAMPLE_MASK) == 0) {
+        if (Throwing) exceptions = std::uncaught_exceptions();
+        if (timed) start = probeTicks();
+    }
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+    ~ProbeScope() {
+        uint64_t ticks = timed ? probeTicks() - start : 0;
+        probeBump(slot.calls);
+        if (rejected || (Throwing && std::uncaught_exceptions() != exceptions)) probeBump(slot.rejects);
+        if (!timed) return;
+        probeBump(slot.sumTicks, ticks);
+        if (ticks > slot.maxTicks.load(std::memory_order_relaxed)) slot.maxTicks.store(ticks, std::memory_order_relaxed);
+        probeBump(slot.buckets[probeBucket(ticks)]);
+    }
+    void reject() { rejected = true; }
+};
+
+#define QPROBE(var, name)                                   \
+    static const unsigned var##ProbeSite = probeSite(name); \
+    ProbeScope<false> var(var##ProbeSite)
+#define QPROBE_THROWING(var, name)                          \
+    static const unsigned var##ProbeSite = probeSite(name); \
+    ProbeScope<true> var(var##ProbeSite)
+#define QPROBE_REJECT(var, ...) (var.reject(), __VA_ARGS__)
+#define QPROBE_REJECT_VOID(var) var.reject()
+
+#else
+
+#define QPROBE(var, name) ((void)0)
+#define QPROBE_THROWING(var, name) ((void)0)
+#define QPROBE_REJECT(var, ...) (__VA_ARGS__)
+#define QPROBE_REJECT_VOID(var) ((void)0)
+
+#endif
+
+// ====== Snapshot ======
+// Merged over all threads, latencies in ns (upper bucket edge, so never understated)
+struct ProbeStats {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t rejects = 0;
+    double meanNs = 0;
+    double p50Ns = 0;
+    double p99Ns = 0;
+    double p999Ns = 0;
+    double maxNs = 0;
+};
+
+inline std::vector<ProbeStats> probeSnapshot() {
+    std::vector<ProbeStats> out;
+#if defined(QPROBES)
+    double perNs = probeRegistry().ticksPerNs();
+    probeRegistry().forEachSite([&](const std::string& name, const std::vector<const ProbeSlot*>& slots) {
+        ProbeStats st;
+        st.name = name;
+        std::vector<uint64_t> merged(PROBE_BUCKETS, 0);
+        uint64_t sum = 0, max = 0;
+        for (const ProbeSlot* s : slots) {
+            st.calls += s->calls.load(std::memory_order_relaxed);
+            st.rejects += s->rejects.load(std::memory_order_relaxed);
+            sum += s->sumTicks.load(std::memory_order_relaxed);
+            max = std::max(max, s->maxTicks.load(std::memory_order_relaxed));
+            for (unsigned b = 0; b < PROBE_BUCKETS; ++b) merged[b] += s->buckets[b].load(std::memory_order_relaxed);
+        }
+        uint64_t total = 0;
+        for (uint64_t c : merged) total += c;
+        auto quantile = [&](double q) {
+            uint64_t rank = uint64_t(q * double(total) + 0.999999), seen = 0;
+            if (rank == 0) rank = 1;
+            for (unsigned b = 0; b < PROBE_BUCKETS; ++b)
+                if ((seen += merged[b]) >= rank) return double(std::min(probeBucketTop(b), max)) / perNs;
+            return double(max) / perNs;
+        };
+        if (total) {
+            st.meanNs = double(sum) / double(total) / perNs;
+            st.p50Ns = quantile(0.50);
+            st.p99Ns = quantile(0.99);
+            st.p999Ns = quantile(0.999);
+            st.maxNs = double(max) / perNs;
+        }
+        out.push_back(st);
+    });
+#endif
+    return out;
+}
+
+inline std::string probesJson() {
+    std::string out;
+#if defined(QPROBES)
+    out = "{\"enabled\":true,\"probes\":[";
+#else
+    out = "{\"enabled\":false,\"probes\":[";
+#endif
+    char buf[512];
+    bool first = true;
+    for (const ProbeStats& s : probeSnapshot()) {
+        snprintf(buf, sizeof(buf),
+                 "%s{\"name\":\"%s\",\"calls\":%llu,\"rejects\":%llu,\"meanNs\":%.1f,\"p50Ns\":%.1f,"
+                 "\"p99Ns\":%.1f,\"p999Ns\":%.1f,\"maxNs\":%.1f}",
+                 first ? "" : ",", s.name.c_str(), (unsigned long long)s.calls, (unsigned long long)s.rejects,
+                 s.meanNs, s.p50Ns, s.p99Ns, s.p999Ns, s.maxNs);
+        out += buf;
+        first = false;
+    }
+    return out + "]}";
+}
+
+// Prometheus text exposition: a summary per probe plus call and reject counters
+inline std::string probesPrometheus() {
+    std::vector<ProbeStats> stats = probeSnapshot();
+    std::string out;
+    char buf[512];
+    out += "# HELP qubic_probe_latency_seconds Contract entry point latency\n"
+           "# TYPE qubic_probe_latency_seconds summary\n";
+    for (const ProbeStats& s : stats) {
+        const char* n = s.name.c_str();
+        snprintf(buf, sizeof(buf),
+                 "qubic_probe_latency_seconds{probe=\"%s\",quantile=\"0.5\"} %.9g\n"
+                 "qubic_probe_latency_seconds{probe=\"%s\",quantile=\"0.99\"} %.9g\n"
+                 "qubic_probe_latency_seconds{probe=\"%s\",quantile=\"0.999\"} %.9g\n"
+                 "qubic_probe_latency_seconds_sum{probe=\"%s\"} %.9g\n"
+                 "qubic_probe_latency_seconds_count{probe=\"%s\"} %llu\n",
+                 n, s.p50Ns * 1e-9, n, s.p99Ns * 1e-9, n, s.p999Ns * 1e-9, n, s.meanNs * double(s.calls) * 1e-9, n,
+                 (unsigned long long)s.calls);
+        out += buf;
+    }
+    out += "# HELP qubic_probe_calls_total Contract entry point calls\n# TYPE qubic_probe_calls_total counter\n";
+    for (const ProbeStats& s : stats) {
+        snprintf(buf, sizeof(buf), "qubic_probe_calls_total{probe=\"%s\"} %llu\n", s.name.c_str(),
+                 (unsigned long long)s.calls);
+        out += buf;
+    }
+    out += "# HELP qubic_probe_rejects_total Calls that were refused or threw\n"
+           "# TYPE qubic_probe_rejects_total counter\n";
+    for (const ProbeStats& s : stats) {
+        snprintf(buf, sizeof(buf), "qubic_probe_rejects_total{probe=\"%s\"} %llu\n", s.name.c_str(),
+                 (unsigned long long)s.rejects);
+        out += buf;
+    }
+    return out;
+}
+
+// Write a snapshot to path via a temporary and rename, so a textfile collector
+// never reads half a file
+inline bool writeProbes(const std::string& path, bool prometheus) {
+    std::string body = prometheus ? probesPrometheus() : probesJson();
+    std::string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(body.data(), 1, body.size(), f) == body.size();
+    ok = (fclose(f) == 0) && ok;
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,84 @@
+/*
+ * qProcessedIds – Bounded set of processed bridge deposit/withdrawal ids
+ * Replay protection for idempotent re-submission, pruned by expiry epoch
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include "qstatetree.hpp"
+
+// Ids are grouped by expiry into epochs of this many ticks and dropped an epoch at a time
+constexpr uint64_t PROCESSED_ID_EPOCH_TICKS = 64;
+
+// 32-byte ids (deposit txids, submitters); keyed over the whole id (qstatetree.hpp)
+using Hash256Hash = TableHash;
+
+// ====== Processed Id Set ======
+// Every id carries the last tick at which its batch may still execute. Once that
+// tick has passed the id can never be submitted again, so it is safe to forget:
+// memory is bounded by throughput times the submission window, not by history.
+class ProcessedIdSet {
+private:
+    std::unordered_map<Hash256, uint64_t, Hash256Hash> ids; // id -> expiryTick
+    std::map<uint64_t, std::vector<std::pair<Hash256, uint64_t>>> byEpoch; // epoch -> (id, expiryTick)
+
+public:
+    bool contains(const Hash256& id) const { return ids.count(id) != 0; }
+
+    bool expiryOf(const Hash256& id, uint64_t& expiryTick) const {
+        auto it = ids.find(id);
+        if (it == ids.end()) return false;
+        expiryTick = it->second;
+        return true;
+    }
+
+    // Record an id valid through expiryTick; false if it was already processed
+    bool insert(const Hash256& id, uint64_t expiryTick) {
+        if (!ids.emplace(id, expiryTick).second) return false;
+        byEpoch[expiryTick / PROCESSED_ID_EPOCH_TICKS].emplace_back(id, expiryTick);
+        return true;
+    }
+
+    // Forget ids whose whole epoch expired before `tick`; shrinks the table after large drops
+    void prune(uint64_t tick) {
+        bool dropped = false;
+        while (!byEpoch.empty() && (byEpoch.begin()->first + 1) * PROCESSED_ID_EPOCH_TICKS <= tick) {
+            for (const auto& entry : byEpoch.begin()->second) ids.erase(entry.first);
+            byEpoch.erase(byEpoch.begin());
+            dropped = true;
+        }
+        if (dropped && ids.bucket_count() > 4 * std::max<size_t>(ids.size(), 64)) ids.rehash(0);
+    }
+
+    size_t size() const { return ids.size(); }
+
+    void clear() {
+        ids.clear();
+        byEpoch.clear();
+    }
+
+    // Visit (id, expiryTick) in expiry-epoch order, for snapshots
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& epoch : byEpoch)
+            for (const auto& entry : epoch.second) visit(entry.first, entry.second);
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,440 @@
+/*
+ * qProposalStore – Nonce-indexed hot slab and mmap'd cold archive
+ * Pending items live in dense segments; finished ones move to an append-only file
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+constexpr uint32_t NONCE_SLAB_SEGMENT = 1024;
+
+// ====== Nonce Slab ======
+// Segmented index over dense, increasing nonces. Each segment is a 2 KB position
+// table plus a dense vector of its live items, so a segment pinned by one old
+// pending item costs a few KB, not a full array of items. Segments are freed
+// once empty. Lookup is two array indexings. Pointers from find() are valid
+// until the next insert() or erase().
+template <typename T>
+class NonceSlab {
+private:
+    struct Segment {
+        std::array<uint16_t, NONCE_SLAB_SEGMENT> pos{}; // index + 1 into items, 0 if absent
+        std::vector<std::pair<uint16_t, T>> items;      // (offset in segment, item)
+    };
+    std::deque<std::unique_ptr<Segment>> segments; // segments[i] holds nonces of segment firstSegment + i
+    uint64_t firstSegment = 0;
+    size_t liveItems = 0;
+
+    Segment* segmentOf(uint64_t nonce) const {
+        uint64_t s = nonce / NONCE_SLAB_SEGMENT;
+        if (s < firstSegment || s - firstSegment >= segments.size()) return nullptr;
+        return segments[size_t(s - firstSegment)].get();
+    }
+
+public:
+    NonceSlab() = default;
+    NonceSlab(NonceSlab&&) = default;
+    NonceSlab& operator=(NonceSlab&&) = default;
+    NonceSlab(const NonceSlab& o) : firstSegment(o.firstSegment), liveItems(o.liveItems) {
+        for (const auto& s : o.segments) segments.emplace_back(s ? new Segment(*s) : nullptr);
+    }
+    NonceSlab& operator=(const NonceSlab& o) {
+        if (this != &o) *this = NonceSlab(o);
+        return *this;
+    }
+
+    T* find(uint64_t nonce) {
+        Segment* s = segmentOf(nonce);
+        if (!s) return nullptr;
+        uint16_t p = s->pos[nonce % NONCE_SLAB_SEGMENT];
+        return p ? &s->items[p - 1].second : nullptr;
+    }
+    const T* find(uint64_t nonce) const { return const_cast<NonceSlab*>(this)->find(nonce); }
+
+    // Store value at nonce, replacing a live item
+    T& insert(uint64_t nonce, T value) {
+        uint64_t s = nonce / NONCE_SLAB_SEGMENT;
+        if (segments.empty()) firstSegment = s;
+        while (s < firstSegment) {
+            segments.emplace_front();
+            --firstSegment;
+        }
+        while (s - firstSegment >= segments.size()) segments.emplace_back();
+        auto& seg = segments[size_t(s - firstSegment)];
+        if (!seg) seg.reset(new Segment());
+        uint16_t off = uint16_t(nonce % NONCE_SLAB_SEGMENT);
+        if (seg->pos[off]) return seg->items[seg->pos[off] - 1].second = std::move(value);
+        seg->items.emplace_back(off, std::move(value));
+        seg->pos[off] = uint16_t(seg->items.size());
+        liveItems++;
+        return seg->items.back().second;
+    }
+
+    // Drop the item at nonce (swap-remove); empty segments are released, edge gaps trimmed
+    bool erase(uint64_t nonce) {
+        Segment* seg = segmentOf(nonce);
+        uint16_t off = uint16_t(nonce % NONCE_SLAB_SEGMENT);
+        if (!seg || !seg->pos[off]) return false;
+        size_t idx = seg->pos[off] - 1;
+        if (idx + 1 != seg->items.size()) {
+            seg->items[idx] = std::move(seg->items.back());
+            seg->pos[seg->items[idx].first] = uint16_t(idx + 1);
+        }
+        seg->items.pop_back();
+        seg->pos[off] = 0;
+        liveItems--;
+        if (seg->items.empty()) {
+            segments[size_t(nonce / NONCE_SLAB_SEGMENT - firstSegment)].reset();
+            while (!segments.empty() && !segments.front()) {
+                segments.pop_front();
+                ++firstSegment;
+            }
+            while (!segments.empty() && !segments.back()) segments.pop_back();
+        }
+        return true;
+    }
+
+    void clear() {
+        segments.clear();
+        firstSegment = 0;
+        liveItems = 0;
+    }
+
+    size_t size() const { return liveItems; }
+
+    size_t allocatedSegments() const {
+        size_t n = 0;
+        for (const auto& s : segments) n += s != nullptr;
+        return n;
+    }
+
+    // First live nonce >= from, or UINT64_MAX
+    uint64_t next(uint64_t from) const {
+        uint64_t s = std::max(from / NONCE_SLAB_SEGMENT, firstSegment);
+        uint32_t i = s == from / NONCE_SLAB_SEGMENT ? from % NONCE_SLAB_SEGMENT : 0;
+        for (; s - firstSegment < segments.size(); ++s, i = 0) {
+            const Segment* seg = segments[size_t(s - firstSegment)].get();
+            if (!seg) continue;
+            for (; i < NONCE_SLAB_SEGMENT; ++i)
+                if (seg->pos[i]) return s * NONCE_SLAB_SEGMENT + i;
+        }
+        return UINT64_MAX;
+    }
+
+    // Visit (nonce, item) for live items in nonce order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (size_t k = 0; k < segments.size(); ++k) {
+            const Segment* seg = segments[k].get();
+            if (!seg) continue;
+            for (uint32_t i = 0; i < NONCE_SLAB_SEGMENT; ++i)
+                if (seg->pos[i]) visit((firstSegment + k) * NONCE_SLAB_SEGMENT + i, seg->items[seg->pos[i] - 1].second);
+        }
+    }
+};
+
+// ====== Nonce Bitset ======
+// Set of nonces as a bit per nonce plus a summary bit per non-empty word, so
+// next(from) skips 4096 clear nonces per summary bit. Storage starts at the
+// lowest live region: leading empty blocks are dropped as they clear.
+class NonceBitset {
+private:
+    static constexpr uint64_t BLOCK = 64 * 64; // nonces covered by one summary word
+
+    std::vector<uint64_t> words;   // bit per nonce, from base
+    std::vector<uint64_t> summary; // bit per non-empty word
+    uint64_t base = 0;             // first nonce covered, multiple of BLOCK
+    size_t count = 0;
+
+    static uint32_t lowestBit(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+        return uint32_t(__builtin_ctzll(w));
+#else
+        uint32_t n = 0;
+        while (!(w & 1)) { w >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    // Drop leading empty blocks once they make up half the storage
+    void trim() {
+        size_t empty = 0;
+        while (empty < summary.size() && summary[empty] == 0) ++empty;
+        if (empty == summary.size()) {
+            words.clear();
+            summary.clear();
+            return;
+        }
+        if (empty * 2 < summary.size()) return;
+        summary.erase(summary.begin(), summary.begin() + empty);
+        words.erase(words.begin(), words.begin() + empty * 64);
+        base += empty * BLOCK;
+    }
+
+public:
+    bool test(uint64_t n) const {
+        if (n < base || n - base >= words.size() * 64) return false;
+        uint64_t i = n - base;
+        return (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    void set(uint64_t n) {
+        if (words.empty()) base = n / BLOCK * BLOCK;
+        if (n < base) {
+            size_t grow = size_t((base - n / BLOCK * BLOCK) / BLOCK);
+            summary.insert(summary.begin(), grow, 0);
+            words.insert(words.begin(), grow * 64, 0);
+            base -= grow * BLOCK;
+        }
+        uint64_t i = n - base;
+        if (i / 64 >= words.size()) {
+            size_t blocks = size_t(i / BLOCK + 1);
+            summary.resize(blocks, 0);
+            words.resize(blocks * 64, 0);
+        }
+        uint64_t bit = uint64_t(1) << (i % 64);
+        if (words[i / 64] & bit) return;
+        words[i / 64] |= bit;
+        summary[i / BLOCK] |= uint64_t(1) << ((i / 64) % 64);
+        count++;
+    }
+
+    void reset(uint64_t n) {
+        if (!test(n)) return;
+        uint64_t i = n - base;
+        words[i / 64] &= ~(uint64_t(1) << (i % 64));
+        if (words[i / 64] == 0) {
+            summary[i / BLOCK] &= ~(uint64_t(1) << ((i / 64) % 64));
+            if (summary[i / BLOCK] == 0) trim();
+        }
+        count--;
+    }
+
+    // First member >= from, or UINT64_MAX
+    uint64_t next(uint64_t from) const {
+        if (from < base) from = base;
+        uint64_t i = from - base;
+        size_t w = size_t(i / 64);
+        if (w >= words.size()) return UINT64_MAX;
+        uint64_t bits = words[w] & (~uint64_t(0) << (i % 64));
+        if (bits) return base + w * 64 + lowestBit(bits);
+        // Next non-empty word through the summary
+        size_t sw = (w + 1) / 64;
+        uint64_t sbits = sw < summary.size() ? summary[sw] & (~uint64_t(0) << ((w + 1) % 64)) : 0;
+        while (!sbits) {
+            if (++sw >= summary.size()) return UINT64_MAX;
+            sbits = summary[sw];
+        }
+        size_t word = sw * 64 + lowestBit(sbits);
+        return base + word * 64 + lowestBit(words[word]);
+    }
+
+    size_t size() const { return count; }
+
+    void clear() {
+        words.clear();
+        summary.clear();
+        base = 0;
+        count = 0;
+    }
+};
+
+// ====== Nonce Archive ======
+// Append-only record file "<path>" plus a dense offset index "<path>.idx"
+// (8 bytes per nonce), both mapped shared. Records are written in completion
+// order; the index makes them addressable by nonce in O(1). Without open() the
+// archive lives in anonymous memory with the same layout. Writes reach the disk
+// at sync(): records first, then the index.
+constexpr char NONCE_ARCHIVE_MAGIC[4] = {'Q', 'A', 'R', 'C'};
+constexpr uint32_t NONCE_ARCHIVE_VERSION = 1;
+constexpr size_t NONCE_ARCHIVE_MIN_BYTES = 1 << 16;
+
+struct NonceArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t end;          // bytes of records after the header
+    uint64_t reserved[6];
+};
+static_assert(sizeof(NonceArchiveHeader) == 64, "NonceArchiveHeader must stay 64 bytes");
+
+class NonceArchive {
+private:
+    int dataFd = -1, indexFd = -1;
+    uint8_t* data = nullptr;
+    size_t dataCap = 0;
+    uint8_t* index = nullptr; // uint64_t per nonce: record offset, 0 if absent
+    size_t indexCap = 0;
+    bool unsynced = false; // appended or truncated since the last sync()
+
+    NonceArchiveHeader* header() const { return reinterpret_cast<NonceArchiveHeader*>(data); }
+
+    static bool grow(int fd, uint8_t*& base, size_t& cap, size_t need) {
+        if (need <= cap) return true;
+        size_t newCap = std::max(cap, NONCE_ARCHIVE_MIN_BYTES);
+        while (newCap < need) newCap *= 2;
+        if (fd >= 0 && ftruncate(fd, off_t(newCap)) != 0) return false;
+        int flags = fd >= 0 ? MAP_SHARED : (MAP_PRIVATE | MAP_ANONYMOUS);
+        void* m = mmap(nullptr, newCap, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (m == MAP_FAILED) return false;
+        if (base) {
+            if (fd < 0) memcpy(m, base, cap);
+            munmap(base, cap);
+        }
+        base = static_cast<uint8_t*>(m);
+        cap = newCap;
+        return true;
+    }
+
+    // Map an existing file at its current size
+    static bool mapExisting(int fd, uint8_t*& base, size_t& cap) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        if (st.st_size == 0) return true;
+        void* m = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) return false;
+        base = static_cast<uint8_t*>(m);
+        cap = size_t(st.st_size);
+        return true;
+    }
+
+    bool ensureOpen() {
+        if (data) return true;
+        if (!grow(dataFd, data, dataCap, NONCE_ARCHIVE_MIN_BYTES)) return false;
+        NonceArchiveHeader* h = header();
+        memcpy(h->magic, NONCE_ARCHIVE_MAGIC, 4);
+        h->version = NONCE_ARCHIVE_VERSION;
+        h->end = 0;
+        return true;
+    }
+
+    uint64_t offsetOf(uint64_t nonce) const {
+        if ((nonce + 1) * 8 > indexCap) return 0;
+        uint64_t off;
+        memcpy(&off, index + nonce * 8, 8);
+        return off;
+    }
+
+public:
+    NonceArchive() = default;
+    NonceArchive(const NonceArchive&) = delete;
+    NonceArchive& operator=(const NonceArchive&) = delete;
+    ~NonceArchive() { close(); }
+
+    // Open or resume a file-backed archive; existing records stay queryable
+    bool open(const std::string& path) {
+        close();
+        dataFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        indexFd = ::open((path + ".idx").c_str(), O_RDWR | O_CREAT, 0644);
+        if (dataFd < 0 || indexFd < 0 || !mapExisting(dataFd, data, dataCap) || !mapExisting(indexFd, index, indexCap)) {
+            close();
+            return false;
+        }
+        if (data && (dataCap < sizeof(NonceArchiveHeader) || memcmp(header()->magic, NONCE_ARCHIVE_MAGIC, 4) != 0 ||
+                     header()->version != NONCE_ARCHIVE_VERSION || header()->end > dataCap - sizeof(NonceArchiveHeader))) {
+            close();
+            return false;
+        }
+        return ensureOpen();
+    }
+
+    void close() {
+        if (data) munmap(data, dataCap);
+        if (index) munmap(index, indexCap);
+        if (dataFd >= 0) ::close(dataFd);
+        if (indexFd >= 0) ::close(indexFd);
+        data = index = nullptr;
+        dataCap = indexCap = 0;
+        dataFd = indexFd = -1;
+    }
+
+    // Append the record for nonce. Pointers from find() are invalid afterwards.
+    bool append(uint64_t nonce, const uint8_t* bytes, size_t len) {
+        if (!ensureOpen()) return false;
+        uint64_t off = sizeof(NonceArchiveHeader) + header()->end;
+        size_t padded = (16 + len + 7) & ~size_t(7);
+        if (!grow(dataFd, data, dataCap, off + padded)) return false;
+        if (!grow(indexFd, index, indexCap, (nonce + 1) * 8)) return false;
+        uint8_t* rec = data + off;
+        uint64_t len64 = len;
+        memcpy(rec, &nonce, 8);
+        memcpy(rec + 8, &len64, 8);
+        memcpy(rec + 16, bytes, len);
+        header()->end += padded;          // publish the record, then the index entry
+        memcpy(index + nonce * 8, &off, 8);
+        unsynced = true;
+        return true;
+    }
+
+    // Record bytes for nonce in place, or nullptr. The index entry and the record's
+    // length are checked against the written records, so a torn or corrupt file
+    // cannot send a read past them.
+    const uint8_t* find(uint64_t nonce, size_t& len) const {
+        uint64_t off = offsetOf(nonce);
+        if (!off || !data) return nullptr;
+        uint64_t limit = sizeof(NonceArchiveHeader) + header()->end;
+        if (off < sizeof(NonceArchiveHeader) || off > limit || limit - off < 16) return nullptr;
+        uint64_t recNonce, len64;
+        memcpy(&recNonce, data + off, 8);
+        memcpy(&len64, data + off + 8, 8);
+        if (recNonce != nonce || len64 > limit - off - 16) return nullptr;
+        len = size_t(len64);
+        return data + off + 16;
+    }
+
+    // Record bytes written so far; a snapshot stores this to roll the archive back
+    uint64_t end() const { return data ? header()->end : 0; }
+
+    // Forget records past `newEnd` (restore to an earlier snapshot). Index entries
+    // into the dropped tail are cleared so later records cannot alias them. O(nonces).
+    bool truncate(uint64_t newEnd) {
+        if (!ensureOpen() || newEnd > header()->end) return false;
+        if (newEnd == header()->end) return true;
+        header()->end = newEnd;
+        unsynced = true;
+        for (size_t at = 0; at + 8 <= indexCap; at += 8) {
+            uint64_t off;
+            memcpy(&off, index + at, 8);
+            if (off >= sizeof(NonceArchiveHeader) + newEnd) memset(index + at, 0, 8);
+        }
+        return true;
+    }
+
+    // Flush records (with the header's end), then the index, to disk. After it
+    // returns true every entry on disk points at a durable record. Hosts sync before
+    // a snapshot references end() and at tick boundaries; anonymous archives have
+    // nothing to flush.
+    bool sync() {
+        if (!unsynced || dataFd < 0) return true;
+        if (msync(data, dataCap, MS_SYNC) != 0 || fsync(dataFd) != 0) return false;
+        if ((index && msync(index, indexCap, MS_SYNC) != 0) || fsync(indexFd) != 0) return false;
+        unsynced = false;
+        return true;
+    }
+
+    size_t mappedBytes() const { return dataCap + indexCap; }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
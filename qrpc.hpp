@@ -0,0 +1,151 @@
+/*
+ * qRPC – querySmartContract wire format shared by the local node and load generator
+ * Base64 payloads, the handful of JSON fields the protocol uses, HTTP/1.1 framing
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// ====== Base64 ======
+inline std::string base64Encode(const uint8_t* data, size_t len) {
+    static const char* ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = uint32_t(data[i]) << 16 | uint32_t(data[i + 1]) << 8 | data[i + 2];
+        out += ALPHABET[v >> 18];
+        out += ALPHABET[(v >> 12) & 63];
+        out += ALPHABET[(v >> 6) & 63];
+        out += ALPHABET[v & 63];
+    }
+    if (i < len) {
+        uint32_t v = uint32_t(data[i]) << 16 | (i + 1 < len ? uint32_t(data[i + 1]) << 8 : 0);
+        out += ALPHABET[v >> 18];
+        out += ALPHABET[(v >> 12) & 63];
+        out += i + 1 < len ? ALPHABET[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+// Standard alphabet; padding optional. Returns false on any other character.
+inline bool base64Decode(const char* s, size_t len, std::vector<uint8_t>& out) {
+    out.clear();
+    uint32_t acc = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < len; ++i) {
+        char c = s[i];
+        uint32_t v;
+        if (c >= 'A' && c <= 'Z') v = uint32_t(c - 'A');
+        else if (c >= 'a' && c <= 'z') v = uint32_t(c - 'a' + 26);
+        else if (c >= '0' && c <= '9') v = uint32_t(c - '0' + 52);
+        else if (c == '+') v = 62;
+        else if (c == '/') v = 63;
+        else if (c == '=') break;
+        else return false;
+        acc = acc << 6 | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(uint8_t(acc >> bits));
+        }
+    }
+    return true;
+}
+
+// ====== JSON Fields ======
+// Requests are flat objects with number and string members, so fields are found
+// by key rather than parsing a tree. Values must not contain escaped quotes.
+inline const char* jsonValue(const std::string& body, const char* key) {
+    std::string quoted = std::string("\"") + key + "\"";
+    size_t at = body.find(quoted);
+    if (at == std::string::npos) return nullptr;
+    const char* p = body.c_str() + at + quoted.size();
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+    if (*p++ != ':') return nullptr;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+    return p;
+}
+
+inline bool jsonUint(const std::string& body, const char* key, uint64_t& out) {
+    const char* p = jsonValue(body, key);
+    if (!p) return false;
+    bool quoted = *p == '"'; // 64-bit values may be sent as strings
+    if (quoted) ++p;
+    if (*p < '0' || *p > '9') return false;
+    char* end;
+    out = strtoull(p, &end, 10);
+    return !quoted || *end == '"';
+}
+
+inline bool jsonString(const std::string& body, const char* key, const char*& begin, size_t& len) {
+    const char* p = jsonValue(body, key);
+    if (!p || *p != '"') return false;
+    begin = p + 1;
+    const char* end = strchr(begin, '"');
+    if (!end) return false;
+    len = size_t(end - begin);
+    return true;
+}
+
+// ====== HTTP/1.1 Framing ======
+// Header block and body of one message; both sides keep connections open and may
+// pipeline, so a buffer can hold several messages or part of one.
+struct HttpMessage {
+    std::string startLine;     // "POST /v1/querySmartContract HTTP/1.1" or "HTTP/1.1 200 OK"
+    std::string body;
+    bool keepAlive = true;
+};
+
+inline bool headerIs(const char* line, size_t len, const char* name) {
+    size_t n = strlen(name);
+    if (len < n + 1 || line[n] != ':') return false;
+    for (size_t i = 0; i < n; ++i)
+        if ((line[i] | 0x20) != (name[i] | 0x20)) return false;
+    return true;
+}
+
+// 1: message parsed and consumed from buf; 0: need more bytes; -1: malformed
+inline int httpParse(std::string& buf, HttpMessage& msg) {
+    size_t headerEnd = buf.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return buf.size() > 65536 ? -1 : 0;
+    size_t lineEnd = buf.find("\r\n");
+    msg.startLine.assign(buf, 0, lineEnd);
+    msg.keepAlive = msg.startLine.find("HTTP/1.0") == std::string::npos;
+    size_t contentLength = 0;
+    for (size_t at = lineEnd + 2; at < headerEnd;) {
+        size_t next = buf.find("\r\n", at);
+        const char* line = buf.c_str() + at;
+        size_t len = next - at;
+        if (headerIs(line, len, "content-length")) contentLength = strtoull(line + 15, nullptr, 10);
+        else if (headerIs(line, len, "connection")) {
+            std::string v(line + 11, len - 11);
+            if (v.find("close") != std::string::npos) msg.keepAlive = false;
+            if (v.find("keep-alive") != std::string::npos) msg.keepAlive = true;
+        }
+        at = next + 2;
+    }
+    if (contentLength > (1u << 20)) return -1;
+    if (buf.size() < headerEnd + 4 + contentLength) return 0;
+    msg.body.assign(buf, headerEnd + 4, contentLength);
+    buf.erase(0, headerEnd + 4 + contentLength);
+    return 1;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
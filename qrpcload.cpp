@@ -0,0 +1,329 @@
+/*
+ * qRPCLoad – Multi-connection load generator for the querySmartContract RPC
+ * Closed loop over keep-alive connections; QPS and p50/p99/p999 latency per function
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ *
+ * Build: g++ -O2 -std=c++17 -pthread qrpcload.cpp -o qrpcload
+ * Run:   ./qrpcload --url http://127.0.0.1:8000/v1 --connections 64 --duration 10
+ *        ./qrpcload --call GetPriceFeed=13:2:AA== --call balanceOf=14:1:AQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "qrpc.hpp"
+
+// One function under load: a fixed request, sent as is every time
+struct Call {
+    std::string name;
+    uint32_t contract;
+    uint32_t inputType;
+    std::string requestData; // base64
+    std::string request;     // full HTTP message
+};
+
+// Default mix: what tests/ queries, plus the qUSD and pool reads qrpcnode serves
+const char* DEFAULT_CALLS[] = {
+    "GetTokenInfo=13:1:",
+    "GetPriceFeed=13:2:AA==",
+    "GetSyntheticAssetInfo=13:3:AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=",
+    "qusd.balanceOf=14:1:AQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA=",
+    "qusd.getStateRoot=14:3:",
+    "pool.quoteSwap=15:1:QEIPAAAAAAA=",
+};
+
+struct Options {
+    std::string host = "127.0.0.1";
+    std::string port = "8000";
+    std::string basePath = "/v1";
+    unsigned connections = 64;
+    unsigned threads = 0;         // 0: min(connections, hardware threads)
+    double duration = 10;         // seconds measured
+    double warmup = 1;            // seconds run but not recorded
+    std::vector<Call> calls;
+};
+
+// name=contract:inputType:base64
+bool parseCall(const std::string& spec, Call& c) {
+    size_t eq = spec.find('='), c1 = spec.find(':', eq + 1), c2 = spec.find(':', c1 + 1);
+    if (eq == std::string::npos || c1 == std::string::npos || c2 == std::string::npos) return false;
+    c.name = spec.substr(0, eq);
+    c.contract = uint32_t(strtoul(spec.c_str() + eq + 1, nullptr, 10));
+    c.inputType = uint32_t(strtoul(spec.c_str() + c1 + 1, nullptr, 10));
+    c.requestData = spec.substr(c2 + 1);
+    std::vector<uint8_t> bytes;
+    return base64Decode(c.requestData.data(), c.requestData.size(), bytes);
+}
+
+// http://host[:port][/path]
+bool parseUrl(const std::string& url, Options& o) {
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0) return false;
+    size_t hostEnd = url.find('/', scheme.size());
+    std::string authority = url.substr(scheme.size(), hostEnd - scheme.size());
+    o.basePath = hostEnd == std::string::npos ? "" : url.substr(hostEnd);
+    while (!o.basePath.empty() && o.basePath.back() == '/') o.basePath.pop_back();
+    size_t colon = authority.rfind(':');
+    o.host = authority.substr(0, colon);
+    o.port = colon == std::string::npos ? "80" : authority.substr(colon + 1);
+    return !o.host.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if (a == "--url") {
+            if (!parseUrl(v, o)) return false;
+        } else if (a == "--connections") o.connections = std::max(1u, unsigned(strtoul(v, nullptr, 10)));
+        else if (a == "--threads") o.threads = unsigned(strtoul(v, nullptr, 10));
+        else if (a == "--duration") o.duration = strtod(v, nullptr);
+        else if (a == "--warmup") o.warmup = strtod(v, nullptr);
+        else if (a == "--call") {
+            Call c;
+            if (!parseCall(v, c)) return false;
+            o.calls.push_back(c);
+        } else return false;
+        ++i;
+    }
+    if (o.calls.empty())
+        for (const char* spec : DEFAULT_CALLS) {
+            Call c;
+            parseCall(spec, c);
+            o.calls.push_back(c);
+        }
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    if (o.threads == 0) o.threads = std::min(o.connections, hw);
+    o.threads = std::min(o.threads, o.connections);
+    return o.duration > 0;
+}
+
+void buildRequests(Options& o) {
+    for (Call& c : o.calls) {
+        std::vector<uint8_t> bytes;
+        base64Decode(c.requestData.data(), c.requestData.size(), bytes);
+        std::string body = "{\"contractIndex\":" + std::to_string(c.contract) + ",\"inputType\":" +
+                           std::to_string(c.inputType) + ",\"inputSize\":" + std::to_string(bytes.size()) +
+                           ",\"requestData\":\"" + c.requestData + "\"}";
+        c.request = "POST " + o.basePath + "/querySmartContract HTTP/1.1\r\nHost: " + o.host + ":" + o.port +
+                    "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                    "\r\n\r\n" + body;
+    }
+}
+
+// ====== Workers ======
+// Each thread owns a slice of the connections and one epoll set. A connection
+// has at most one request in flight and cycles through the calls, starting at
+// its own offset, so every function sees the same share of the load.
+using Clock = std::chrono::steady_clock;
+
+struct CallStats {
+    std::vector<uint32_t> latencyNs; // saturating; 4.29 s cap is far above any sane answer
+    uint64_t errors = 0;
+};
+
+struct Conn {
+    int fd = -1;
+    size_t next;                     // call index
+    size_t inFlight;
+    Clock::time_point sentAt;
+    std::string in;
+    size_t written = 0;
+};
+
+int connectTo(const addrinfo* ai) {
+    int fd = socket(ai->ai_family, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+void runWorker(const Options& o, const addrinfo* ai, unsigned first, unsigned count, Clock::time_point recordFrom,
+               Clock::time_point stopAt, std::vector<CallStats>& stats, uint64_t& connectFailures) {
+    stats.assign(o.calls.size(), CallStats());
+    std::vector<Conn> conns(count);
+    int ep = epoll_create1(0);
+    auto issue = [&](Conn& c) {
+        c.inFlight = c.next;
+        c.next = (c.next + 1) % o.calls.size();
+        c.written = 0;
+        c.sentAt = Clock::now();
+        const std::string& req = o.calls[c.inFlight].request;
+        ssize_t n = ::send(c.fd, req.data(), req.size(), MSG_NOSIGNAL);
+        c.written = n > 0 ? size_t(n) : 0;
+        if (c.written == req.size()) return;
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLOUT; // rest of the request once the socket drains
+        ev.data.u64 = size_t(&c - conns.data());
+        epoll_ctl(ep, EPOLL_CTL_MOD, c.fd, &ev);
+    };
+    auto reconnect = [&](Conn& c) {
+        if (c.fd >= 0) {
+            epoll_ctl(ep, EPOLL_CTL_DEL, c.fd, nullptr);
+            close(c.fd);
+        }
+        c.in.clear();
+        c.fd = connectTo(ai);
+        if (c.fd < 0) {
+            ++connectFailures;
+            return false;
+        }
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = size_t(&c - conns.data());
+        epoll_ctl(ep, EPOLL_CTL_ADD, c.fd, &ev);
+        return true;
+    };
+    for (unsigned i = 0; i < count; ++i) {
+        conns[i].next = (first + i) % o.calls.size();
+        if (reconnect(conns[i])) issue(conns[i]);
+    }
+    std::vector<epoll_event> events(count);
+    char buf[65536];
+    while (Clock::now() < stopAt) {
+        int n = epoll_wait(ep, events.data(), int(events.size()), 50);
+        for (int e = 0; e < n; ++e) {
+            Conn& c = conns[events[e].data.u64];
+            const std::string& req = o.calls[c.inFlight].request;
+            if ((events[e].events & EPOLLOUT) && c.written < req.size()) {
+                ssize_t w = ::send(c.fd, req.data() + c.written, req.size() - c.written, MSG_NOSIGNAL);
+                if (w > 0) c.written += size_t(w);
+                if (c.written == req.size()) {
+                    epoll_event ev = {};
+                    ev.events = EPOLLIN;
+                    ev.data.u64 = events[e].data.u64;
+                    epoll_ctl(ep, EPOLL_CTL_MOD, c.fd, &ev);
+                }
+            }
+            if (!(events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) continue;
+            ssize_t r;
+            while ((r = recv(c.fd, buf, sizeof(buf), 0)) > 0) c.in.append(buf, size_t(r));
+            bool dead = r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+            HttpMessage resp;
+            int parsed = httpParse(c.in, resp);
+            if (parsed == 1) {
+                auto done = Clock::now();
+                if (c.sentAt >= recordFrom && done <= stopAt) {
+                    CallStats& s = stats[c.inFlight];
+                    size_t sp = resp.startLine.find(' ');
+                    if (sp == std::string::npos || atoi(resp.startLine.c_str() + sp + 1) != 200) ++s.errors;
+                    uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(done - c.sentAt).count());
+                    s.latencyNs.push_back(uint32_t(std::min<uint64_t>(ns, UINT32_MAX)));
+                }
+                if (!resp.keepAlive && !reconnect(c)) continue;
+                issue(c);
+            } else if (parsed < 0 || dead) {
+                if (c.sentAt >= recordFrom) ++stats[c.inFlight].errors;
+                if (reconnect(c)) issue(c);
+            }
+        }
+    }
+    for (Conn& c : conns)
+        if (c.fd >= 0) close(c.fd);
+    close(ep);
+}
+
+// ====== Report ======
+// Nearest-rank percentile over the sorted samples
+double percentileUs(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = size_t(p * double(sorted.size()) + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1] / 1000.0;
+}
+
+void printRow(const char* name, std::vector<uint32_t>& lat, uint64_t errors, double seconds) {
+    std::sort(lat.begin(), lat.end());
+    printf("%-30s %10zu %10.0f %9.1f %9.1f %9.1f %9.1f %8llu\n", name, lat.size(), double(lat.size()) / seconds,
+           percentileUs(lat, 0.50), percentileUs(lat, 0.99), percentileUs(lat, 0.999),
+           lat.empty() ? 0.0 : lat.back() / 1000.0, (unsigned long long)errors);
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        fprintf(stderr, "usage: %s [--url http://host:port/v1] [--connections n] [--threads n] [--duration s] "
+                        "[--warmup s] [--call name=contract:inputType:base64]...\n", argv[0]);
+        return 2;
+    }
+    buildRequests(o);
+    addrinfo hints = {}, *ai = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(o.host.c_str(), o.port.c_str(), &hints, &ai) != 0 || !ai) {
+        fprintf(stderr, "cannot resolve %s:%s\n", o.host.c_str(), o.port.c_str());
+        return 1;
+    }
+    printf("%u connections on %u threads, %zu functions, %.1f s (+%.1f s warmup) against http://%s:%s%s\n",
+           o.connections, o.threads, o.calls.size(), o.duration, o.warmup, o.host.c_str(), o.port.c_str(),
+           o.basePath.c_str());
+    auto start = Clock::now();
+    auto recordFrom = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(o.warmup));
+    auto stopAt = recordFrom + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(o.duration));
+    std::vector<std::vector<CallStats>> stats(o.threads);
+    std::vector<uint64_t> connectFailures(o.threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0, first = 0; t < o.threads; ++t) {
+        unsigned count = o.connections / o.threads + (t < o.connections % o.threads ? 1 : 0);
+        workers.emplace_back(runWorker, std::cref(o), ai, first, count, recordFrom, stopAt, std::ref(stats[t]),
+                             std::ref(connectFailures[t]));
+        first += count;
+    }
+    for (auto& w : workers) w.join();
+    freeaddrinfo(ai);
+
+    printf("%-30s %10s %10s %9s %9s %9s %9s %8s\n", "function", "requests", "qps", "p50 us", "p99 us", "p999 us",
+           "max us", "errors");
+    std::vector<uint32_t> all;
+    uint64_t allErrors = 0;
+    for (size_t c = 0; c < o.calls.size(); ++c) {
+        std::vector<uint32_t> lat;
+        uint64_t errors = 0;
+        for (auto& s : stats) {
+            lat.insert(lat.end(), s[c].latencyNs.begin(), s[c].latencyNs.end());
+            errors += s[c].errors;
+        }
+        all.insert(all.end(), lat.begin(), lat.end());
+        allErrors += errors;
+        std::string label = o.calls[c].name + " (" + std::to_string(o.calls[c].contract) + ":" +
+                            std::to_string(o.calls[c].inputType) + ")";
+        printRow(label.c_str(), lat, errors, o.duration);
+    }
+    printRow("total", all, allErrors, o.duration);
+    uint64_t failures = 0;
+    for (uint64_t f : connectFailures) failures += f;
+    if (failures) printf("connect failures: %llu\n", (unsigned long long)failures);
+    return allErrors || failures ? 1 : 0;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
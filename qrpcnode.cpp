@@ -0,0 +1,553 @@
+/*
+ * qRPCNode – Offline stand-in for the Qubic RPC, serving querySmartContract from in-process contracts
+ * Same JSON/base64 protocol as rpc.qubic.org/v1: point RPC_URL at it and the tests/ scripts run unchanged
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ *
+ * Build: g++ -O2 -std=c++17 -pthread qrpcnode.cpp -o qrpcnode
+ * Run:   ./qrpcnode --port 8000
+ *        RPC_URL=http://127.0.0.1:8000/v1 bash tests/bankon_pythai_contract_test.sh
+ * Add -DQPROBES to the build for per-entry-point latency at /v1/probes (JSON) and /metrics (Prometheus).
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "qstatetree.hpp"
+#include "qstatedelta.hpp"
+#include "qsnapshot.hpp"
+#include "qevents.hpp"
+#include "qholders.hpp"
+#include "qprocessedids.hpp"
+#include "qjournal.hpp"
+#include "qcall.hpp"
+#include "qcollateral.hpp"
+#include "qfixed.hpp"
+#include "qoracle.hpp"
+#include "qk12.hpp"
+#include "qrpc.hpp"
+#include "qprobe.hpp"
+#include "qtick.hpp"
+
+// ====== Platform Stand-ins ======
+void KangarooTwelve(const uint8_t* input, unsigned int inputByteLen, uint8_t* output, unsigned int outputByteLen) {
+    k12(input, inputByteLen, output, outputByteLen);
+}
+
+// ====== Contracts ======
+// On chain every contract is its own module; here they share one binary, so each
+// gets a namespace for its globals. Every header they include is already included
+// above, which makes the includes inside the namespaces no-ops.
+namespace qusd_sc {
+using ::readField; // its PositionRecord overloads would hide the generic helpers
+using ::writeField;
+#include "qusd.cpp"
+}
+namespace bkpy_sc {
+#include "bp1.cpp"
+}
+namespace pool_sc {
+#include "bankonpythai-pool.cpp"
+}
+
+// Contract indexes served. 13 is the one tests/ queries; 14 and 15 are free slots
+// used by this node only. Anything else answers "not found", like an undeployed index.
+constexpr uint32_t CONTRACT_BANKON_PYTHAI = 13;
+constexpr uint32_t CONTRACT_QUSD = 14;
+constexpr uint32_t CONTRACT_POOL = 15;
+
+const std::string ORACLE_ADMIN = "QRPCNODE_ORACLE";
+const std::string POOL_AUTHORITY = "QRPCNODE_POOL";
+const std::string POOL_PROVIDER = "QRPCNODE_LP";
+constexpr uint64_t BKPY_ADMIN = 1;
+
+// Feeds by GetPriceFeed asset index, 8 decimals
+struct SeedFeed {
+    const char* symbol;
+    uint64_t price;
+};
+const SeedFeed SEED_FEEDS[] = {
+    {"BTC/USD", 60000ULL * 100000000ULL},
+    {"ETH/USD", 3000ULL * 100000000ULL},
+    {"STX/USD", 2ULL * 100000000ULL},
+};
+
+QOracle oracle(ORACLE_ADMIN);
+bkpy_sc::BANKON_PYTHAI bkpy(BKPY_ADMIN);
+pool_sc::BankonPythaiPool pool(oracle, POOL_AUTHORITY);
+
+// ====== BANKON PYTHAI Query Layout (contract 13) ======
+struct TokenInfoOutput {
+    uint64_t totalSupply;
+    uint64_t holders;
+    uint8_t decimals;
+    uint8_t stateRoot[32];
+};
+struct PriceFeedInput {
+    uint8_t asset;       // index into SEED_FEEDS
+};
+struct PriceFeedOutput {
+    uint64_t price;
+    uint64_t timestamp;
+    uint8_t decimals;
+    bool fresh;          // within POOL_MAX_PRICE_AGE
+};
+struct SyntheticAssetInput {
+    uint8_t account[32];
+};
+struct SyntheticAssetOutput {
+    uint64_t qusdSupply;
+    uint64_t qusdBalance; // of the requested identity
+    uint64_t collateral;  // qBTC sats locked
+    uint64_t debt;
+    uint64_t btcPrice;
+};
+struct BkpyBalanceInput {
+    uint64_t address;
+};
+struct BkpyBalanceOutput {
+    uint64_t balance;
+};
+
+// ====== Pool Query Layout (contract 15) ======
+struct QuoteSwapInput {
+    uint64_t stxIn;
+};
+struct PoolStateOutput {
+    uint64_t stxPrice;
+    uint64_t btcPrice;
+    uint32_t priceError;
+    uint64_t cbtcSupply;
+};
+
+// ====== Query Registry ======
+// A function sees its input struct zero-filled up to sizeof(input), as a node
+// passes it, and its output struct is returned byte for byte.
+struct QueryFunction {
+    std::string name;
+    uint32_t inputSize;
+    std::function<void(const uint8_t* in, std::string& out)> call;
+};
+
+std::map<std::pair<uint32_t, uint32_t>, QueryFunction> queries;
+
+template <typename Out>
+void appendBytes(std::string& out, const Out& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(Out));
+}
+
+template <typename In, typename Out>
+void registerQuery(uint32_t contract, uint32_t inputType, const char* name, Out (*fn)(const In&)) {
+    queries[{contract, inputType}] = {name, uint32_t(sizeof(In)), [fn](const uint8_t* in, std::string& out) {
+        In input;
+        memcpy(&input, in, sizeof(In));
+        appendBytes(out, fn(input));
+    }};
+}
+
+template <typename Out>
+void registerQuery(uint32_t contract, uint32_t inputType, const char* name, Out (*fn)()) {
+    queries[{contract, inputType}] = {name, 0, [fn](const uint8_t*, std::string& out) { appendBytes(out, fn()); }};
+}
+
+TokenInfoOutput getTokenInfo() {
+    TokenInfoOutput out = {};
+    out.totalSupply = bkpy.totalSupply();
+    out.holders = bkpy.holderCount();
+    out.decimals = BkpyAmount::decimals;
+    memcpy(out.stateRoot, bkpy.stateRoot().data(), 32);
+    return out;
+}
+
+PriceFeedOutput getPriceFeed(const PriceFeedInput& in) {
+    PriceFeedOutput out = {};
+    if (in.asset >= sizeof(SEED_FEEDS) / sizeof(SEED_FEEDS[0])) return out;
+    PriceData p = oracle.getPrice(SEED_FEEDS[in.asset].symbol);
+    out.price = p.price;
+    out.timestamp = p.timestamp;
+    out.decimals = p.decimals;
+    out.fresh = oracle.isPriceFresh(SEED_FEEDS[in.asset].symbol, pool_sc::POOL_MAX_PRICE_AGE);
+    return out;
+}
+
+SyntheticAssetOutput getSyntheticAssetInfo(const SyntheticAssetInput& in) {
+    qusd_sc::BalanceOfInput who;
+    memcpy(who.account, in.account, 32);
+    qusd_sc::CollateralStatsOutput stats = qusd_sc::getCollateralStats();
+    return {qusd_sc::getTotalSupply().totalSupply, qusd_sc::balanceOf(who).balance, stats.collateral, stats.debt,
+            stats.price};
+}
+
+BkpyBalanceOutput getBkpyBalance(const BkpyBalanceInput& in) {
+    return {bkpy.balanceOf(in.address)};
+}
+
+pool_sc::SwapFill quoteSwap(const QuoteSwapInput& in) {
+    return pool.quoteSwap(in.stxIn);
+}
+
+PoolStateOutput getPoolState() {
+    pool_sc::PoolPrice p = pool.readPrice();
+    return {p.stx, p.btc, p.error, pool.getTotalSupply()};
+}
+
+void registerQueries() {
+    registerQuery(CONTRACT_BANKON_PYTHAI, 1, "GetTokenInfo", getTokenInfo);
+    registerQuery(CONTRACT_BANKON_PYTHAI, 2, "GetPriceFeed", getPriceFeed);
+    registerQuery(CONTRACT_BANKON_PYTHAI, 3, "GetSyntheticAssetInfo", getSyntheticAssetInfo);
+    registerQuery(CONTRACT_BANKON_PYTHAI, 4, "BalanceOf", getBkpyBalance);
+
+    registerQuery(CONTRACT_QUSD, 1, "balanceOf", qusd_sc::balanceOf);
+    registerQuery(CONTRACT_QUSD, 2, "getTotalSupply", qusd_sc::getTotalSupply);
+    registerQuery(CONTRACT_QUSD, 3, "getStateRoot", qusd_sc::getStateRoot);
+    registerQuery(CONTRACT_QUSD, 4, "holderRank", qusd_sc::holderRank);
+    registerQuery(CONTRACT_QUSD, 5, "topHolders", qusd_sc::topHolders);
+    registerQuery(CONTRACT_QUSD, 6, "balanceOfAt", qusd_sc::balanceOfAt);
+    registerQuery(CONTRACT_QUSD, 7, "getPosition", qusd_sc::getPosition);
+    registerQuery(CONTRACT_QUSD, 8, "getCollateralStats", qusd_sc::getCollateralStats);
+    registerQuery(CONTRACT_QUSD, 9, "balanceOfWithProof", qusd_sc::balanceOfWithProof);
+    registerQuery(CONTRACT_QUSD, 10, "topHoldersAt", qusd_sc::topHoldersAt);
+
+    registerQuery(CONTRACT_POOL, 1, "quoteSwap", quoteSwap);
+    registerQuery(CONTRACT_POOL, 2, "getPoolState", getPoolState);
+}
+
+// ====== Seed State ======
+// Deterministic, so load runs against fresh nodes are comparable. qUSD account i
+// is the identity whose first 8 bytes are i + 1 (little-endian), BKPY address i + 2.
+void seedAccount(uint64_t i, uint8_t account[32]) {
+    memset(account, 0, 32);
+    uint64_t id = i + 1;
+    memcpy(account, &id, sizeof(id));
+}
+
+void pushSeedPrices() {
+    for (const SeedFeed& f : SEED_FEEDS) oracle.pushPrice(f.symbol, f.price, FeedPrice::decimals, ORACLE_ADMIN);
+}
+
+void seedState(uint64_t accounts) {
+    static const uint8_t custodian[32] = {}; // matches the unset AUTHORIZED_MINT_BURN_PUBKEY
+    pushSeedPrices();
+    qusd_sc::updateCollateralPrice({SEED_FEEDS[0].price}, custodian);
+    bkpy.mint();
+    for (uint64_t i = 0; i < accounts; ++i) {
+        qusd_sc::MintBurnInput m = {};
+        seedAccount(i, m.to_or_from);
+        m.amount = (i % 1000 + 1) * (QusdAmount::unit / 10000); // supply is 64-bit at 15 decimals
+        qusd_sc::mint(m, custodian);
+        bkpy.transfer(BKPY_ADMIN, i + 2, (i % 100 + 1) * BkpyAmount::unit / 1000);
+        if (i % 16 == 0) {
+            qusd_sc::CollateralInput c = {};
+            memcpy(c.owner, m.to_or_from, 32);
+            c.amount = 100000 + i % 1000; // sats
+            qusd_sc::CollateralOutput opened = qusd_sc::depositCollateral(c, custodian);
+            c.positionId = opened.positionId;
+            c.amount = QusdAmount::unit / 10;
+            qusd_sc::mintAgainstCollateral(c, c.owner);
+        }
+    }
+    pool.mint(100 * QbtcAmount::unit, POOL_PROVIDER, POOL_AUTHORITY);
+    pool.addCbtcLiquidity(POOL_PROVIDER, 100 * QbtcAmount::unit);
+}
+
+// ====== Ticks ======
+uint64_t initialTick = 0;
+uint64_t currentTick = 0;
+uint32_t epoch = 1;
+
+// qUSD and BKPY are islands; the pool prices off the oracle, so those two share a group
+TickExecutor ticks;
+
+void registerLanes() {
+    uint16_t qusdLane = ticks.addLane("qusd");
+    uint16_t bkpyLane = ticks.addLane("bkpy");
+    uint16_t poolLane = ticks.addLane("pool");
+    uint16_t oracleLane = ticks.addLane("oracle");
+    ticks.link(poolLane, oracleLane);
+    ticks.onEndTick(qusdLane, [] { qusd_sc::endTick(); });
+    ticks.onEndTick(bkpyLane, [] { bkpy.endTick(); });
+    ticks.onEndTick(poolLane, [] { pool.settleTick(); });
+    ticks.onEndTick(oracleLane, pushSeedPrices); // keeps the feeds fresh for the pool
+}
+
+uint64_t wallClockSeconds() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void endTick() {
+    ticks.runTick(currentTick, wallClockSeconds());
+    eventLog().setTick(++currentTick);
+}
+
+// ====== HTTP ======
+struct Connection {
+    std::string in;
+    std::string out;
+    bool closing = false;
+    bool watchingOut = false; // registered for EPOLLOUT while output is pending
+};
+
+void respond(std::string& out, int status, const std::string& body, const char* contentType = "application/json") {
+    const char* reason = status == 200 ? "OK" : status == 400 ? "Bad Request" : status == 404 ? "Not Found"
+                                                                               : "Method Not Allowed";
+    char head[192];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n",
+                     status, reason, contentType, body.size());
+    out.append(head, size_t(n));
+    out += body;
+}
+
+std::string errorJson(int code, const char* message) {
+    return std::string("{\"code\":") + std::to_string(code) + ",\"message\":\"" + message + "\",\"details\":[]}";
+}
+
+void handleQuery(const std::string& body, std::string& out) {
+    uint64_t contract, inputType, inputSize = 0;
+    const char* data = "";
+    size_t dataLen = 0;
+    if (!jsonUint(body, "contractIndex", contract) || !jsonUint(body, "inputType", inputType))
+        return respond(out, 400, errorJson(3, "contractIndex and inputType are required"));
+    bool sized = jsonUint(body, "inputSize", inputSize);
+    jsonString(body, "requestData", data, dataLen);
+    std::vector<uint8_t> input;
+    if (!base64Decode(data, dataLen, input)) return respond(out, 400, errorJson(3, "requestData is not base64"));
+    if (sized && inputSize != input.size())
+        return respond(out, 400, errorJson(3, "inputSize does not match requestData"));
+    auto it = queries.find({uint32_t(contract), uint32_t(inputType)});
+    if (contract > UINT32_MAX || inputType > UINT32_MAX || it == queries.end())
+        return respond(out, 404, errorJson(5, "contract function not found"));
+    const QueryFunction& fn = it->second;
+    if (input.size() > fn.inputSize)
+        return respond(out, 400, errorJson(3, "requestData larger than the function input"));
+    input.resize(fn.inputSize, 0);
+    std::string response;
+    fn.call(input.data(), response);
+    respond(out, 200, "{\"responseData\":\"" +
+                          base64Encode(reinterpret_cast<const uint8_t*>(response.data()), response.size()) + "\"}");
+}
+
+void handleRequest(const HttpMessage& req, std::string& out) {
+    size_t sp = req.startLine.find(' ');
+    size_t sp2 = req.startLine.find(' ', sp + 1);
+    std::string method = req.startLine.substr(0, sp);
+    std::string path = sp == std::string::npos ? "" : req.startLine.substr(sp + 1, sp2 - sp - 1);
+    if (path == "/v1/querySmartContract") {
+        if (method != "POST") return respond(out, 405, errorJson(12, "use POST"));
+        return handleQuery(req.body, out);
+    }
+    if (path == "/v1/tick-info") {
+        return respond(out, 200, "{\"tickInfo\":{\"tick\":" + std::to_string(currentTick) +
+                                     ",\"duration\":1,\"epoch\":" + std::to_string(epoch) +
+                                     ",\"initialTick\":" + std::to_string(initialTick) + "}}");
+    }
+    if (path == "/v1/latestTick") return respond(out, 200, "{\"latestTick\":" + std::to_string(currentTick) + "}");
+    if (path == "/v1/probes") return respond(out, 200, probesJson());
+    if (path == "/metrics") return respond(out, 200, probesPrometheus(), "text/plain; version=0.0.4");
+    respond(out, 404, errorJson(5, "Not Found"));
+}
+
+// ====== Event Loop ======
+// One thread runs every contract call, as a node's tick processor would, so the
+// contracts need no locking; epoll keeps thousands of keep-alive clients on it.
+volatile sig_atomic_t stopping = 0;
+
+void onSignal(int) { stopping = 1; }
+
+struct Options {
+    const char* bind = "127.0.0.1";
+    uint16_t port = 8000;
+    uint64_t accounts = 10000;
+    uint64_t tickMs = 1000;
+    const char* events = nullptr;
+};
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if (a == "--bind") o.bind = v;
+        else if (a == "--port") o.port = uint16_t(strtoul(v, nullptr, 10));
+        else if (a == "--accounts") o.accounts = strtoull(v, nullptr, 10);
+        else if (a == "--tick-ms") o.tickMs = std::max<uint64_t>(1, strtoull(v, nullptr, 10));
+        else if (a == "--tick") initialTick = currentTick = strtoull(v, nullptr, 10);
+        else if (a == "--epoch") epoch = uint32_t(strtoul(v, nullptr, 10));
+        else if (a == "--events") o.events = v;
+        else return false;
+        ++i;
+    }
+    return true;
+}
+
+// Write what the socket takes; false if the connection is gone
+bool flush(int fd, Connection& c) {
+    while (!c.out.empty()) {
+        ssize_t n = send(fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.out.erase(0, size_t(n));
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--bind addr] [--port n] [--accounts n] [--tick-ms n] [--tick n] [--epoch n] "
+                        "[--events spill-file]\n", argv[0]);
+        return 2;
+    }
+    if (opt.events && !eventLog().open(opt.events)) {
+        fprintf(stderr, "cannot open event spill file %s\n", opt.events);
+        return 1;
+    }
+    eventLog().setTick(currentTick);
+    setTickTimestamp(wallClockSeconds());
+    registerQueries();
+    registerLanes();
+    seedState(opt.accounts);
+    endTick();
+
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(opt.port);
+    if (inet_pton(AF_INET, opt.bind, &addr.sin_addr) != 1 ||
+        bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 4096) != 0) {
+        fprintf(stderr, "cannot listen on %s:%u: %s\n", opt.bind, opt.port, strerror(errno));
+        return 1;
+    }
+    int ep = epoll_create1(0);
+    epoll_event lev = {};
+    lev.events = EPOLLIN;
+    lev.data.fd = listener;
+    epoll_ctl(ep, EPOLL_CTL_ADD, listener, &lev);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    printf("qrpcnode on http://%s:%u/v1, %zu query functions, %llu seeded accounts, tick %llu\n", opt.bind,
+           opt.port, queries.size(), (unsigned long long)opt.accounts, (unsigned long long)currentTick);
+    fflush(stdout);
+
+    std::unordered_map<int, Connection> conns;
+    auto closeConn = [&](int fd) {
+        epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(fd);
+    };
+    using Clock = std::chrono::steady_clock;
+    auto nextTick = Clock::now() + std::chrono::milliseconds(opt.tickMs);
+    uint64_t served = 0;
+    std::vector<epoll_event> events(1024);
+    char buf[65536];
+
+    while (!stopping) {
+        auto now = Clock::now();
+        if (now >= nextTick) {
+            endTick();
+            nextTick += std::chrono::milliseconds(opt.tickMs);
+            if (nextTick < now) nextTick = now + std::chrono::milliseconds(opt.tickMs);
+            continue;
+        }
+        int timeout = int(std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count()) + 1;
+        int n = epoll_wait(ep, events.data(), int(events.size()), timeout);
+        for (int e = 0; e < n; ++e) {
+            int fd = events[e].data.fd;
+            if (fd == listener) {
+                int cfd;
+                while ((cfd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0) {
+                    setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    epoll_event cev = {};
+                    cev.events = EPOLLIN | EPOLLRDHUP;
+                    cev.data.fd = cfd;
+                    epoll_ctl(ep, EPOLL_CTL_ADD, cfd, &cev);
+                    conns[cfd];
+                }
+                continue;
+            }
+            Connection& c = conns[fd];
+            bool alive = true;
+            if (events[e].events & EPOLLIN) {
+                ssize_t r;
+                while ((r = recv(fd, buf, sizeof(buf), 0)) > 0) c.in.append(buf, size_t(r));
+                if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) c.closing = true;
+                HttpMessage req;
+                int parsed;
+                while (!c.closing || !c.in.empty()) {
+                    parsed = httpParse(c.in, req);
+                    if (parsed == 0) break;
+                    if (parsed < 0) {
+                        respond(c.out, 400, errorJson(3, "malformed request"));
+                        c.in.clear();
+                        c.closing = true;
+                        break;
+                    }
+                    handleRequest(req, c.out);
+                    ++served;
+                    if (!req.keepAlive) {
+                        c.closing = true;
+                        break;
+                    }
+                }
+            }
+            if (events[e].events & (EPOLLHUP | EPOLLERR)) alive = false;
+            alive = alive && flush(fd, c);
+            if (!alive || (c.closing && c.out.empty())) {
+                closeConn(fd);
+                continue;
+            }
+            bool wantOut = !c.out.empty();
+            if (wantOut != c.watchingOut) {
+                epoll_event cev = {};
+                cev.events = EPOLLIN | EPOLLRDHUP | (wantOut ? EPOLLOUT : 0u);
+                cev.data.fd = fd;
+                epoll_ctl(ep, EPOLL_CTL_MOD, fd, &cev);
+                c.watchingOut = wantOut;
+            }
+        }
+    }
+    for (auto& c : conns) close(c.first);
+    close(listener);
+    close(ep);
+    printf("served %llu requests, last tick %llu\n", (unsigned long long)served, (unsigned long long)currentTick);
+    return 0;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,246 @@
+/*
+ * qSchedule – Piecewise vesting schedules and a hierarchical timer wheel
+ * O(log k) amount-at-time over breakpoints; O(1) amortized unlock timers per tick
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include "qfixed.hpp"
+
+// Cumulative amount vested at `time`
+struct ScheduleBreakpoint {
+    uint64_t time;
+    uint64_t amount;
+};
+
+// ====== Vesting Schedule ======
+// Cumulative vested amount as a piecewise-linear function of time: zero before
+// the first breakpoint, the last amount from the final one on, linear in between.
+// Two breakpoints at the same time make a step; a cliff is a step from zero.
+class VestingSchedule {
+private:
+    std::vector<ScheduleBreakpoint> points; // time and amount non-decreasing
+
+    // Index of the last breakpoint at or before t, or -1
+    long lastAtOrBefore(uint64_t t) const {
+        auto it = std::upper_bound(points.begin(), points.end(), t,
+            [](uint64_t v, const ScheduleBreakpoint& p) { return v < p.time; });
+        return long(it - points.begin()) - 1;
+    }
+
+public:
+    VestingSchedule() = default;
+
+    // Breakpoints must be sorted by time with non-decreasing amounts (see valid())
+    explicit VestingSchedule(std::vector<ScheduleBreakpoint> p) : points(std::move(p)) {}
+
+    static bool valid(const std::vector<ScheduleBreakpoint>& p) {
+        if (p.empty()) return false;
+        for (size_t i = 1; i < p.size(); ++i)
+            if (p[i].time < p[i - 1].time || p[i].amount < p[i - 1].amount) return false;
+        return p.back().amount > 0;
+    }
+
+    // Linear from start over duration
+    static VestingSchedule linear(uint64_t total, uint64_t start, uint64_t duration) {
+        return VestingSchedule({{start, 0}, {start + duration, total}});
+    }
+
+    // Nothing until start + cliff, then what linear vesting would have reached, then linear
+    static VestingSchedule cliff(uint64_t total, uint64_t start, uint64_t cliff, uint64_t duration) {
+        if (cliff >= duration) return VestingSchedule({{start + duration, 0}, {start + duration, total}});
+        uint64_t atCliff = 0;
+        mulDiv(total, cliff, duration, atCliff); // cliff < duration: below total
+        return VestingSchedule({{start + cliff, 0}, {start + cliff, atCliff}, {start + duration, total}});
+    }
+
+    // `count` equal steps every `interval` from start; rounding goes to the last step
+    static VestingSchedule steps(uint64_t total, uint64_t start, uint64_t interval, uint32_t count) {
+        std::vector<ScheduleBreakpoint> p{{start, 0}};
+        uint64_t prev = 0;
+        for (uint32_t i = 1; i <= count; ++i) {
+            uint64_t at = start + interval * i;
+            uint64_t amount = total;
+            if (i < count) mulDiv(total, i, count, amount);
+            p.push_back({at, prev});
+            p.push_back({at, amount});
+            prev = amount;
+        }
+        return VestingSchedule(std::move(p));
+    }
+
+    bool empty() const { return points.empty(); }
+    const std::vector<ScheduleBreakpoint>& breakpoints() const { return points; }
+    uint64_t total() const { return points.empty() ? 0 : points.back().amount; }
+    uint64_t start() const { return points.empty() ? 0 : points.front().time; }
+    uint64_t end() const { return points.empty() ? 0 : points.back().time; }
+
+    // Vested at time t: binary search, then a 128-bit interpolation
+    uint64_t amountAt(uint64_t t) const {
+        long i = lastAtOrBefore(t);
+        if (i < 0) return 0;
+        const ScheduleBreakpoint& a = points[size_t(i)];
+        if (size_t(i) + 1 == points.size()) return a.amount;
+        const ScheduleBreakpoint& b = points[size_t(i) + 1];
+        uint64_t grown = 0;
+        mulDiv(b.amount - a.amount, t - a.time, b.time - a.time, grown); // t < b.time: below the step
+        return a.amount + grown;
+    }
+
+    // First breakpoint time after t at which the vested amount has grown since the
+    // previous breakpoint time (the unlock moments), or UINT64_MAX
+    uint64_t nextUnlockAfter(uint64_t t) const {
+        for (size_t i = size_t(lastAtOrBefore(t) + 1); i < points.size(); ++i) {
+            uint64_t before = i == 0 ? 0 : amountAt(points[i].time - 1);
+            if (amountAt(points[i].time) > before) return points[i].time;
+        }
+        return UINT64_MAX;
+    }
+};
+
+// ====== Hierarchical Timer Wheel ======
+// Six levels of 64 slots; level L holds timers whose deadline first differs from
+// `now` in 6-bit digit L, so each timer moves down at most five times before it
+// fires. Occupancy bitmaps let advance() jump straight to the next non-empty slot:
+// the cost is O(levels) per visited slot plus O(1) amortized per timer, however
+// far time moves. Deadlines beyond 2^36 units are parked in an ordered overflow.
+template <typename Payload>
+class TimerWheel {
+private:
+    static constexpr unsigned BITS = 6, SLOTS = 1u << BITS, LEVELS = 6;
+    struct Timer {
+        uint64_t deadline;
+        Payload payload;
+    };
+
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS] = {};
+    std::multimap<uint64_t, Payload> far;  // beyond the top level
+    std::vector<Timer> due;                // deadline <= now, fired on the next advance
+    uint64_t now = 0;
+    size_t count = 0;
+
+    static unsigned digit(uint64_t t, unsigned level) { return unsigned(t >> (BITS * level)) & (SLOTS - 1); }
+
+    void place(Timer&& timer) {
+        if (timer.deadline <= now) {
+            due.push_back(std::move(timer));
+            return;
+        }
+        uint64_t diff = timer.deadline ^ now;
+        unsigned level = unsigned(63 - __builtin_clzll(diff)) / BITS;
+        if (level >= LEVELS) {
+            far.emplace(timer.deadline, std::move(timer.payload));
+            return;
+        }
+        unsigned slot = digit(timer.deadline, level);
+        slots[level][slot].push_back(std::move(timer));
+        occupied[level] |= uint64_t(1) << slot;
+    }
+
+    // Earliest time after now at which an occupied slot (or the overflow) becomes current
+    uint64_t nextBoundary() const {
+        uint64_t best = UINT64_MAX;
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            unsigned d = digit(now, level);
+            uint64_t ahead = d + 1 < SLOTS ? occupied[level] & (~uint64_t(0) << (d + 1)) : 0;
+            if (!ahead) continue;
+            unsigned shift = BITS * (level + 1);
+            uint64_t prefix = shift >= 64 ? 0 : (now >> shift) << shift;
+            best = std::min(best, prefix | (uint64_t(__builtin_ctzll(ahead)) << (BITS * level)));
+        }
+        if (!far.empty()) {
+            unsigned shift = BITS * LEVELS;
+            best = std::min(best, (far.begin()->first >> shift) << shift);
+        }
+        return best;
+    }
+
+    template <typename Fire>
+    void fireDue(Fire& fire) {
+        while (!due.empty()) {
+            std::vector<Timer> batch;
+            batch.swap(due);
+            count -= batch.size();
+            for (auto& t : batch) fire(t.deadline, t.payload); // may schedule more
+        }
+    }
+
+public:
+    explicit TimerWheel(uint64_t start = 0) : now(start) {}
+
+    uint64_t current() const { return now; }
+    size_t size() const { return count; }
+
+    // Fire at the first advance() reaching deadline (past deadlines fire on the next one)
+    void schedule(uint64_t deadline, Payload payload) {
+        ++count;
+        place(Timer{deadline, std::move(payload)});
+    }
+
+    // Move time to target, calling fire(deadline, payload) for every timer due by
+    // then, in deadline order (insertion order within a deadline)
+    template <typename Fire>
+    void advance(uint64_t target, Fire fire) {
+        fireDue(fire);
+        while (now < target) {
+            uint64_t next = nextBoundary();
+            if (next > target) {
+                now = target;
+                break;
+            }
+            now = next;
+            if (!far.empty() && (far.begin()->first >> (BITS * LEVELS)) == (now >> (BITS * LEVELS))) {
+                auto last = far.upper_bound(now | ((uint64_t(1) << (BITS * LEVELS)) - 1));
+                for (auto it = far.begin(); it != last; ++it) place(Timer{it->first, std::move(it->second)});
+                far.erase(far.begin(), last);
+            }
+            for (unsigned level = LEVELS; level-- > 0;) {
+                unsigned d = digit(now, level);
+                if (!(occupied[level] & (uint64_t(1) << d))) continue;
+                std::vector<Timer> moving;
+                moving.swap(slots[level][d]);
+                occupied[level] &= ~(uint64_t(1) << d);
+                for (auto& t : moving) place(std::move(t));
+            }
+            fireDue(fire);
+        }
+    }
+
+    // Visit (deadline, payload) of every pending timer, in no particular order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& t : due) visit(t.deadline, t.payload);
+        for (unsigned level = 0; level < LEVELS; ++level)
+            for (unsigned slot = 0; slot < SLOTS; ++slot)
+                for (const auto& t : slots[level][slot]) visit(t.deadline, t.payload);
+        for (const auto& e : far) visit(e.first, e.second);
+    }
+
+    void clear(uint64_t start) {
+        for (auto& level : slots)
+            for (auto& slot : level) slot.clear();
+        std::fill(std::begin(occupied), std::end(occupied), 0);
+        far.clear();
+        due.clear();
+        now = start;
+        count = 0;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,140 @@
+/*
+ * qSignerSet – Fixed index table of multisig signers/owners
+ * O(1) allocation-free membership, approvals as 64-bit bitmaps, thresholds by popcount
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <bitset>
+#include <string>
+#include <vector>
+#include <functional>
+
+// One bit per signer slot
+using SignerMask = uint64_t;
+constexpr uint32_t SIGNER_SET_CAPACITY = 64;
+
+inline uint32_t popcount64(uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+    return uint32_t(__builtin_popcountll(m));
+#else
+    return uint32_t(std::bitset<64>(m).count());
+#endif
+}
+
+inline SignerMask signerBit(uint32_t slot) { return SignerMask(1) << slot; }
+
+// ====== Signer Set ======
+// Signers occupy stable slots [0, 64); a key's slot is its bit in every approval
+// mask. Lookup is a linear-probe table of 128 one-byte entries over the slots, so
+// membership costs one string hash and usually one compare. Removal rebuilds the
+// probe table (at most 64 entries). Freed slots are reused by later adds: callers
+// holding approval masks must clear the freed bit (see remove()).
+class SignerSet {
+private:
+    static constexpr uint32_t TABLE_SIZE = 2 * SIGNER_SET_CAPACITY;
+
+    std::array<std::string, SIGNER_SET_CAPACITY> keys; // slot -> key, empty when free
+    std::array<uint8_t, TABLE_SIZE> table{};           // slot + 1, 0 when empty
+    SignerMask active = 0;
+
+    static uint32_t home(const std::string& key) {
+        return uint32_t(std::hash<std::string>()(key)) & (TABLE_SIZE - 1);
+    }
+
+    void link(uint32_t slot) {
+        uint32_t i = home(keys[slot]);
+        while (table[i]) i = (i + 1) & (TABLE_SIZE - 1);
+        table[i] = uint8_t(slot + 1);
+    }
+
+public:
+    // Slot of key, or -1
+    int indexOf(const std::string& key) const {
+        for (uint32_t i = home(key); table[i]; i = (i + 1) & (TABLE_SIZE - 1))
+            if (keys[table[i] - 1] == key) return table[i] - 1;
+        return -1;
+    }
+
+    bool contains(const std::string& key) const { return indexOf(key) >= 0; }
+
+    // Add to the lowest free slot; -1 if present, empty or full
+    int add(const std::string& key) {
+        if (key.empty() || active == ~SignerMask(0) || contains(key)) return -1;
+        uint32_t slot = 0;
+        while (active & signerBit(slot)) ++slot;
+        return assign(slot, key) ? int(slot) : -1;
+    }
+
+    // Place key at a given slot (snapshot restore); false if taken or invalid
+    bool assign(uint32_t slot, const std::string& key) {
+        if (slot >= SIGNER_SET_CAPACITY || key.empty() || (active & signerBit(slot)) || contains(key)) return false;
+        keys[slot] = key;
+        active |= signerBit(slot);
+        link(slot);
+        return true;
+    }
+
+    // Free key's slot and return it, or -1. The slot's bit must be cleared from any
+    // live approval mask before the slot is reused.
+    int remove(const std::string& key) {
+        int slot = indexOf(key);
+        if (slot < 0) return -1;
+        keys[slot].clear();
+        active &= ~signerBit(uint32_t(slot));
+        table.fill(0);
+        for (uint32_t s = 0; s < SIGNER_SET_CAPACITY; ++s)
+            if (active & signerBit(s)) link(s);
+        return slot;
+    }
+
+    void clear() {
+        for (auto& k : keys) k.clear();
+        table.fill(0);
+        active = 0;
+    }
+
+    SignerMask mask() const { return active; }
+    uint32_t size() const { return popcount64(active); }
+    const std::string& at(uint32_t slot) const { return keys[slot]; }
+
+    // Mask of the distinct signers named in `proof`; unknown entries are ignored
+    SignerMask maskOf(const std::vector<std::string>& proof) const {
+        SignerMask m = 0;
+        for (const auto& key : proof) {
+            int slot = indexOf(key);
+            if (slot >= 0) m |= signerBit(uint32_t(slot));
+        }
+        return m;
+    }
+
+    // Visit (slot, key) for each member in slot order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (SignerMask m = active; m; m &= m - 1) {
+            uint32_t slot = popcount64((m & -m) - 1);
+            visit(slot, keys[slot]);
+        }
+    }
+
+    // Highest used slot + 1 (snapshot tables keep holes so slots survive a restore)
+    uint32_t slotSpan() const {
+        uint32_t n = 0;
+        for (SignerMask m = active; m; m >>= 1) ++n;
+        return n;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,406 @@
+/*
+ * qSnapshot – Memory-mapped contract state snapshots
+ * Flat, offset-addressed tables: mmap the file and query it in place
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// ====== File Layout ======
+// [SnapshotHeader][table 0][table 1]...[string heap][directory]
+// Every table starts 8-byte aligned and is addressed by file offset only, so the
+// mapping address never matters. Rows are raw structs in native (little endian)
+// layout: a snapshot restores on the architecture that wrote it.
+constexpr char SNAPSHOT_MAGIC[4] = {'Q', 'S', 'N', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// Reserved table ids; contracts number their own tables from 0
+constexpr uint32_t SNAPSHOT_TABLE_STRINGS = 0xFFFF0000u; // byte heap for SnapshotStringRef
+constexpr uint32_t SNAPSHOT_TABLE_SCALARS = 0xFFFF0001u; // uint64_t contract scalars
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t tick;              // tick boundary the snapshot was taken at
+    uint64_t fileSize;
+    uint64_t directoryOffset;
+    uint32_t tableCount;
+    uint32_t reserved;
+    uint64_t directoryChecksum; // covers the directory, which holds per-table checksums
+};
+
+struct SnapshotTableEntry {
+    uint32_t id;
+    uint32_t rowSize;
+    uint64_t rowCount;
+    uint64_t offset;
+    uint64_t checksum;
+};
+
+// Variable-length bytes in the string heap
+struct SnapshotStringRef {
+    uint64_t offset; // relative to the string heap
+    uint64_t length;
+};
+
+// ====== Checksum ======
+// 64-bit word-wise multiply/rotate mix. Integrity only, not a commitment.
+class SnapshotChecksum {
+private:
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    uint8_t tail[8];
+    size_t tailLen = 0;
+    uint64_t total = 0;
+
+    void mixWord(uint64_t w) {
+        h ^= w * 0xC2B2AE3D27D4EB4FULL;
+        h = (h << 31) | (h >> 33);
+        h *= 0x9E3779B97F4A7C15ULL;
+    }
+
+public:
+    void update(const void* data, size_t len) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        total += len;
+        while (tailLen && len) {
+            tail[tailLen++] = *p++;
+            --len;
+            if (tailLen == 8) {
+                uint64_t w;
+                memcpy(&w, tail, 8);
+                mixWord(w);
+                tailLen = 0;
+            }
+        }
+        for (; len >= 8; p += 8, len -= 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            mixWord(w);
+        }
+        memcpy(tail, p, len);
+        tailLen = len;
+    }
+
+    uint64_t final() const {
+        SnapshotChecksum c = *this;
+        uint64_t w = 0;
+        memcpy(&w, c.tail, c.tailLen);
+        c.mixWord(w);
+        c.mixWord(total);
+        return c.h;
+    }
+};
+
+// ====== Writer ======
+// Streams tables straight to "<path>.tmp", then fsyncs and renames over <path>,
+// so a crash mid-write never leaves a torn snapshot behind.
+class SnapshotWriter {
+private:
+    FILE* f = nullptr;
+    std::string path;
+    uint64_t offset = 0;
+    std::vector<SnapshotTableEntry> directory;
+    std::vector<uint8_t> strings;
+    std::vector<uint64_t> scalars;
+    SnapshotChecksum tableSum;
+    bool inTable = false;
+    bool failed = false;
+
+    void put(const void* data, size_t len) {
+        if (fwrite(data, 1, len, f) != len) failed = true;
+        offset += len;
+    }
+    void align8() {
+        static const uint8_t zeros[8] = {};
+        if (offset % 8) put(zeros, 8 - offset % 8);
+    }
+
+public:
+    explicit SnapshotWriter(const std::string& target) : path(target) {
+        f = fopen((path + ".tmp").c_str(), "wb");
+        if (!f) { failed = true; return; }
+        setvbuf(f, nullptr, _IOFBF, 1 << 20);
+        SnapshotHeader placeholder = {};
+        put(&placeholder, sizeof(placeholder));
+    }
+    ~SnapshotWriter() {
+        if (f) { fclose(f); remove((path + ".tmp").c_str()); }
+    }
+
+    void beginTable(uint32_t id, uint32_t rowSize) {
+        align8();
+        directory.push_back({id, rowSize, 0, offset, 0});
+        tableSum = SnapshotChecksum();
+        inTable = true;
+    }
+
+    template <typename Row>
+    void appendRow(const Row& row) {
+        static_assert(std::is_trivially_copyable<Row>::value, "snapshot rows must be flat");
+        put(&row, sizeof(Row));
+        tableSum.update(&row, sizeof(Row));
+        directory.back().rowCount++;
+    }
+
+    void endTable() {
+        directory.back().checksum = tableSum.final();
+        inTable = false;
+    }
+
+    SnapshotStringRef addString(const std::string& s) {
+        SnapshotStringRef ref = {strings.size(), s.size()};
+        strings.insert(strings.end(), s.begin(), s.end());
+        return ref;
+    }
+
+    void setScalar(size_t index, uint64_t value) {
+        if (scalars.size() <= index) scalars.resize(index + 1, 0);
+        scalars[index] = value;
+    }
+
+    // Write heap, scalars, directory and header; durable once this returns true
+    bool finish(uint64_t tick) {
+        if (!f || inTable) return false;
+        beginTable(SNAPSHOT_TABLE_STRINGS, 1);
+        put(strings.data(), strings.size());
+        tableSum.update(strings.data(), strings.size());
+        directory.back().rowCount = strings.size();
+        endTable();
+        beginTable(SNAPSHOT_TABLE_SCALARS, sizeof(uint64_t));
+        for (uint64_t v : scalars) appendRow(v);
+        endTable();
+
+        align8();
+        SnapshotHeader h = {};
+        memcpy(h.magic, SNAPSHOT_MAGIC, 4);
+        h.version = SNAPSHOT_VERSION;
+        h.tick = tick;
+        h.directoryOffset = offset;
+        h.tableCount = uint32_t(directory.size());
+        SnapshotChecksum dirSum;
+        dirSum.update(directory.data(), directory.size() * sizeof(SnapshotTableEntry));
+        h.directoryChecksum = dirSum.final();
+        put(directory.data(), directory.size() * sizeof(SnapshotTableEntry));
+        h.fileSize = offset;
+
+        if (fseek(f, 0, SEEK_SET) != 0) failed = true;
+        if (fwrite(&h, 1, sizeof(h), f) != sizeof(h)) failed = true;
+        if (fflush(f) != 0 || fsync(fileno(f)) != 0) failed = true;
+        fclose(f);
+        f = nullptr;
+        if (failed) { remove((path + ".tmp").c_str()); return false; }
+        if (rename((path + ".tmp").c_str(), path.c_str()) != 0) return false;
+        return syncParentDirectory(path);
+    }
+
+    // The rename itself is only durable once the directory entry is on disk
+    static bool syncParentDirectory(const std::string& file) {
+        size_t slash = file.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : file.substr(0, slash);
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) return false;
+        bool ok = fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+};
+
+// ====== Reader ======
+// Maps a snapshot read-only. open() checks header and directory only (O(tables));
+// verify() rehashes every table. open(path, true) rehashes before it replaces the
+// current mapping, for holders whose live state points into that mapping.
+class SnapshotView {
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    const SnapshotHeader* header = nullptr;
+    const SnapshotTableEntry* directory = nullptr;
+
+    const SnapshotTableEntry* entry(uint32_t id) const {
+        for (uint32_t i = 0; header && i < header->tableCount; ++i)
+            if (directory[i].id == id) return &directory[i];
+        return nullptr;
+    }
+
+    static bool tablesIntact(const uint8_t* b, const SnapshotHeader* h, const SnapshotTableEntry* dir) {
+        for (uint32_t i = 0; i < h->tableCount; ++i) {
+            SnapshotChecksum sum;
+            sum.update(b + dir[i].offset, dir[i].rowCount * dir[i].rowSize);
+            if (sum.final() != dir[i].checksum) return false;
+        }
+        return true;
+    }
+
+public:
+    SnapshotView() = default;
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+    ~SnapshotView() { close(); }
+
+    // On failure the current mapping, if any, is left untouched
+    bool open(const std::string& path, bool verifyTables = false) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SnapshotHeader)) { ::close(fd); return false; }
+        size_t len = size_t(st.st_size);
+        void* m = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED) return false;
+        const uint8_t* b = static_cast<const uint8_t*>(m);
+        const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(b);
+        const SnapshotTableEntry* dir = nullptr;
+
+        bool ok = memcmp(h->magic, SNAPSHOT_MAGIC, 4) == 0
+            && h->version == SNAPSHOT_VERSION
+            && h->fileSize == len
+            && h->directoryOffset % 8 == 0
+            && h->directoryOffset + uint64_t(h->tableCount) * sizeof(SnapshotTableEntry) <= len;
+        if (ok) {
+            dir = reinterpret_cast<const SnapshotTableEntry*>(b + h->directoryOffset);
+            SnapshotChecksum dirSum;
+            dirSum.update(dir, h->tableCount * sizeof(SnapshotTableEntry));
+            ok = dirSum.final() == h->directoryChecksum;
+            for (uint32_t i = 0; ok && i < h->tableCount; ++i)
+                ok = dir[i].offset % 8 == 0 && dir[i].offset <= h->directoryOffset
+                    && (dir[i].rowSize == 0 || dir[i].rowCount <= (h->directoryOffset - dir[i].offset) / dir[i].rowSize);
+            ok = ok && (!verifyTables || tablesIntact(b, h, dir));
+        }
+        if (!ok) {
+            munmap(m, len);
+            return false;
+        }
+        close();
+        base = b;
+        size = len;
+        header = h;
+        directory = dir;
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(const_cast<uint8_t*>(base), size);
+        base = nullptr;
+        size = 0;
+        header = nullptr;
+        directory = nullptr;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    uint64_t tick() const { return header ? header->tick : 0; }
+
+    // Full integrity pass over every table
+    bool verify() const {
+        return header && tablesIntact(base, header, directory);
+    }
+
+    // Typed in-place view of a table; nullptr (count 0) if absent or the row layout changed
+    template <typename Row>
+    const Row* table(uint32_t id, size_t& count) const {
+        const SnapshotTableEntry* e = entry(id);
+        count = 0;
+        if (!e || e->rowSize != sizeof(Row)) return nullptr;
+        count = size_t(e->rowCount);
+        return reinterpret_cast<const Row*>(base + e->offset);
+    }
+
+    uint64_t scalar(size_t index) const {
+        size_t n;
+        const uint64_t* s = table<uint64_t>(SNAPSHOT_TABLE_SCALARS, n);
+        return index < n ? s[index] : 0;
+    }
+
+    const char* stringData(const SnapshotStringRef& ref) const {
+        const SnapshotTableEntry* e = entry(SNAPSHOT_TABLE_STRINGS);
+        if (!e || ref.offset + ref.length > e->rowCount) return nullptr;
+        return reinterpret_cast<const char*>(base + e->offset + ref.offset);
+    }
+
+    std::string string(const SnapshotStringRef& ref) const {
+        const char* p = stringData(ref);
+        return p ? std::string(p, size_t(ref.length)) : std::string();
+    }
+
+    // Three-way compare of a heap string against s, without copying
+    int compare(const SnapshotStringRef& ref, const std::string& s) const {
+        const char* p = stringData(ref);
+        size_t n = std::min(size_t(ref.length), s.size());
+        int c = p ? memcmp(p, s.data(), n) : -1;
+        if (c != 0) return c;
+        return ref.length < s.size() ? -1 : (ref.length > s.size() ? 1 : 0);
+    }
+
+    // Binary search rows sorted by a leading `SnapshotStringRef key`
+    template <typename Row>
+    const Row* findByKey(const Row* rows, size_t count, const std::string& key) const {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            int c = compare(rows[mid].key, key);
+            if (c == 0) return &rows[mid];
+            if (c < 0) lo = mid + 1; else hi = mid;
+        }
+        return nullptr;
+    }
+
+    // [first, last) of the rows whose leading `key` equals key (rows sorted by key)
+    template <typename Row>
+    void rangeByKey(const Row* rows, size_t count, const std::string& key, size_t& first, size_t& last) const {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (compare(rows[mid].key, key) < 0) lo = mid + 1; else hi = mid;
+        }
+        first = lo;
+        for (hi = count; lo < hi;) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (compare(rows[mid].key, key) <= 0) lo = mid + 1; else hi = mid;
+        }
+        last = lo;
+    }
+};
+
+// ====== Background Copy-on-Write Snapshot ======
+// Call at a tick boundary with no worker threads running. The forked child
+// serializes its frozen copy-on-write image of the state while the parent keeps
+// executing ticks; pages are only copied as the parent dirties them.
+template <typename WriteFn>
+pid_t snapshotInBackground(WriteFn writeSnapshot) {
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) _exit(writeSnapshot() ? 0 : 1);
+    return pid;
+}
+
+// Poll a background snapshot: -1 still running, 0 written, 1 failed
+inline int reapBackgroundSnapshot(pid_t pid) {
+    int status = 0;
+    pid_t r = waitpid(pid, &status, WNOHANG);
+    if (r == 0) return -1;
+    if (r != pid) return 1;
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
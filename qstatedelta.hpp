@@ -0,0 +1,223 @@
+/*
+ * qStateDelta – Dirty-key tracking and binary state deltas for node catch-up
+ * A lagging node pulls only the keys changed since its last synced tick
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <deque>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <istream>
+#include <ostream>
+#include "qstatetree.hpp"
+
+// Ticks of change history kept; older catch-up requests need a full snapshot
+constexpr uint64_t DELTA_RETAINED_TICKS = 4096;
+
+constexpr char DELTA_MAGIC[4] = {'Q', 'D', 'L', 'T'};
+constexpr uint16_t DELTA_VERSION = 1;
+
+// ====== Wire Format (little endian) ======
+// Section header, then `count` records of (key, value). A contract stream is one
+// or more sections, identified by `table`, optionally followed by contract scalars.
+struct DeltaHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t table;
+    uint64_t fromTick;
+    uint64_t toTick;
+    uint64_t count;
+};
+
+inline void writeU64(std::ostream& out, uint64_t v) {
+    uint8_t b[8];
+    for (int i = 0; i < 8; ++i) b[i] = uint8_t(v >> (8 * i));
+    out.write(reinterpret_cast<const char*>(b), 8);
+}
+inline bool readU64(std::istream& in, uint64_t& v) {
+    uint8_t b[8];
+    if (!in.read(reinterpret_cast<char*>(b), 8)) return false;
+    v = 0;
+    for (int i = 0; i < 8; ++i) v |= uint64_t(b[i]) << (8 * i);
+    return true;
+}
+
+inline void writeField(std::ostream& out, uint64_t v) { writeU64(out, v); }
+inline bool readField(std::istream& in, uint64_t& v) { return readU64(in, v); }
+
+inline void writeField(std::ostream& out, bool v) { out.put(v ? 1 : 0); }
+inline bool readField(std::istream& in, bool& v) {
+    char c;
+    if (!in.get(c)) return false;
+    v = c != 0;
+    return true;
+}
+
+inline void writeField(std::ostream& out, const std::string& v) {
+    writeU64(out, v.size());
+    out.write(v.data(), v.size());
+}
+inline bool readField(std::istream& in, std::string& v) {
+    uint64_t n;
+    if (!readU64(in, n) || n > (1u << 20)) return false;
+    v.resize(n);
+    return bool(in.read(&v[0], n));
+}
+
+inline void writeField(std::ostream& out, const std::vector<uint8_t>& v) {
+    writeU64(out, v.size());
+    out.write(reinterpret_cast<const char*>(v.data()), v.size());
+}
+inline bool readField(std::istream& in, std::vector<uint8_t>& v) {
+    uint64_t n;
+    if (!readU64(in, n) || n > (1u << 20)) return false;
+    v.resize(n);
+    return bool(in.read(reinterpret_cast<char*>(v.data()), n));
+}
+
+inline void writeField(std::ostream& out, const std::array<uint8_t, 32>& v) {
+    out.write(reinterpret_cast<const char*>(v.data()), 32);
+}
+inline bool readField(std::istream& in, std::array<uint8_t, 32>& v) {
+    return bool(in.read(reinterpret_cast<char*>(v.data()), 32));
+}
+
+inline void writeDeltaHeader(std::ostream& out, const DeltaHeader& h) {
+    out.write(h.magic, 4);
+    uint8_t b[4] = {uint8_t(h.version), uint8_t(h.version >> 8), uint8_t(h.table), uint8_t(h.table >> 8)};
+    out.write(reinterpret_cast<const char*>(b), 4);
+    writeU64(out, h.fromTick);
+    writeU64(out, h.toTick);
+    writeU64(out, h.count);
+}
+inline bool readDeltaHeader(std::istream& in, DeltaHeader& h) {
+    uint8_t b[4];
+    if (!in.read(h.magic, 4) || memcmp(h.magic, DELTA_MAGIC, 4) != 0) return false;
+    if (!in.read(reinterpret_cast<char*>(b), 4)) return false;
+    h.version = uint16_t(b[0] | (b[1] << 8));
+    h.table = uint16_t(b[2] | (b[3] << 8));
+    if (h.version != DELTA_VERSION) return false;
+    return readU64(in, h.fromTick) && readU64(in, h.toTick) && readU64(in, h.count);
+}
+
+// ====== Dirty Set ======
+// Per-tick lists of changed keys, each key listed at most once per tick.
+// Export cost scales with keys changed since fromTick, not with state size.
+template <typename Key, typename KeyHash = TableHash>
+class DirtyLog {
+private:
+    struct TickKeys {
+        uint64_t tick;
+        std::vector<Key> keys;
+    };
+    std::deque<TickKeys> ticks;                  // oldest first, back() is the open tick
+    std::unordered_set<Key, KeyHash> openTickSet; // dedupe within the open tick
+
+public:
+    DirtyLog() { ticks.push_back({0, {}}); }
+
+    void markDirty(const Key& key) {
+        if (openTickSet.insert(key).second) ticks.back().keys.push_back(key);
+    }
+
+    // Close the open tick and drop history beyond the retention window
+    void endTick() {
+        uint64_t next = ticks.back().tick + 1;
+        // clear() wipes every bucket: after a burst, drop the table rather than pay that each tick
+        if (openTickSet.bucket_count() > 8 * openTickSet.size() + 64) std::unordered_set<Key, KeyHash>().swap(openTickSet);
+        else openTickSet.clear();
+        ticks.push_back({next, {}});
+        while (ticks.size() > DELTA_RETAINED_TICKS) ticks.pop_front();
+    }
+
+    // Start a fresh history at `tick`, e.g. after restoring a snapshot taken there
+    void restart(uint64_t tick) {
+        ticks.clear();
+        openTickSet.clear();
+        ticks.push_back({tick, {}});
+    }
+
+    uint64_t currentTick() const { return ticks.back().tick; }
+    uint64_t oldestTick() const { return ticks.front().tick; }
+
+    // Stream every key changed in [fromTick, currentTick] with its current value.
+    // lookup(key, value) fills the live value. False if fromTick is out of the window.
+    template <typename Value, typename Lookup>
+    bool exportDelta(uint64_t fromTick, uint16_t table, std::ostream& out, Lookup lookup) const {
+        if (fromTick < oldestTick() || fromTick > currentTick()) return false;
+        // Oldest first, so a receiver meets new accounts in the order the sender did
+        std::vector<const Key*> changed;
+        std::unordered_set<Key, KeyHash> seen;
+        for (size_t i = size_t(fromTick - oldestTick()); i < ticks.size(); ++i)
+            for (const auto& k : ticks[i].keys)
+                if (seen.insert(k).second) changed.push_back(&k);
+
+        DeltaHeader h = {};
+        memcpy(h.magic, DELTA_MAGIC, 4);
+        h.version = DELTA_VERSION;
+        h.table = table;
+        h.fromTick = fromTick;
+        h.toTick = currentTick();
+        h.count = changed.size();
+        writeDeltaHeader(out, h);
+
+        Value v{};
+        for (const Key* k : changed) {
+            lookup(*k, v);
+            writeField(out, *k);
+            writeField(out, v);
+        }
+        return bool(out);
+    }
+};
+
+// Read one whole section into `records`. False on malformed input or a table
+// mismatch. Nothing is applied here, so a contract reads every section of its
+// stream before it touches state and a bad stream leaves no partial delta behind.
+template <typename Key, typename Value>
+bool readDelta(std::istream& in, uint16_t table, DeltaHeader& header, std::vector<std::pair<Key, Value>>& records) {
+    records.clear();
+    if (!readDeltaHeader(in, header) || header.table != table || header.toTick < header.fromTick) return false;
+    records.reserve(size_t(std::min<uint64_t>(header.count, 1u << 16))); // count is untrusted until read
+    Key k{};
+    Value v{};
+    for (uint64_t i = 0; i < header.count; ++i) {
+        if (!readField(in, k) || !readField(in, v)) return false;
+        records.emplace_back(std::move(k), std::move(v));
+    }
+    return true;
+}
+
+// Sections of one contract stream cover the same ticks
+inline bool sameDeltaRange(const DeltaHeader& a, const DeltaHeader& b) {
+    return a.fromTick == b.fromTick && a.toTick == b.toTick;
+}
+
+// Read one section and hand each (key, value) to apply(). False on malformed input
+// or a table mismatch, in which case nothing was applied.
+template <typename Key, typename Value, typename Apply>
+bool applyDelta(std::istream& in, uint16_t table, DeltaHeader& header, Apply apply) {
+    std::vector<std::pair<Key, Value>> records;
+    if (!readDelta(in, table, header, records)) return false;
+    for (const auto& r : records) apply(r.first, r.second);
+    return true;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,284 @@
+/*
+ * qStateTree – Incremental Merkle commitment over token balances
+ * One root per tick, rehashed only along the paths of touched accounts
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include "qworkers.hpp"
+
+// Qubic KangarooTwelve hash (platform provided)
+extern void KangarooTwelve(const uint8_t* input, unsigned int inputByteLen, uint8_t* output, unsigned int outputByteLen);
+
+using Hash256 = std::array<uint8_t, 32>;
+
+// Domain separation: a leaf can never be passed off as an inner node
+constexpr uint8_t MERKLE_LEAF_PREFIX = 0x00;
+constexpr uint8_t MERKLE_NODE_PREFIX = 0x01;
+
+// Below this many dirty leaves a tick is rehashed on the calling thread
+constexpr size_t MERKLE_PARALLEL_MIN_DIRTY = 4096;
+
+// Max tree depth served in fixed-size proof outputs (2^32 accounts)
+constexpr size_t MERKLE_MAX_DEPTH = 32;
+
+// ====== Hashing ======
+inline Hash256 merkleLeafHash(const uint8_t* key, size_t keyLen, uint64_t balance) {
+    Hash256 out;
+    uint8_t small[1 + 64 + 8];
+    std::vector<uint8_t> large;
+    uint8_t* buf = small;
+    if (keyLen > 64) {
+        large.resize(1 + keyLen + 8);
+        buf = large.data();
+    }
+    buf[0] = MERKLE_LEAF_PREFIX;
+    memcpy(buf + 1, key, keyLen);
+    for (int i = 0; i < 8; ++i) buf[1 + keyLen + i] = uint8_t(balance >> (8 * i)); // little endian
+    KangarooTwelve(buf, unsigned(1 + keyLen + 8), out.data(), 32);
+    return out;
+}
+
+inline Hash256 merkleLeafHash(uint64_t key, uint64_t balance) {
+    uint8_t k[8];
+    for (int i = 0; i < 8; ++i) k[i] = uint8_t(key >> (8 * i));
+    return merkleLeafHash(k, sizeof(k), balance);
+}
+inline Hash256 merkleLeafHash(const std::string& key, uint64_t balance) {
+    return merkleLeafHash(reinterpret_cast<const uint8_t*>(key.data()), key.size(), balance);
+}
+inline Hash256 merkleLeafHash(const std::vector<uint8_t>& key, uint64_t balance) {
+    return merkleLeafHash(key.data(), key.size(), balance);
+}
+
+inline Hash256 merkleNodeHash(const Hash256& left, const Hash256& right) {
+    uint8_t buf[1 + 64];
+    buf[0] = MERKLE_NODE_PREFIX;
+    memcpy(buf + 1, left.data(), 32);
+    memcpy(buf + 33, right.data(), 32);
+    Hash256 out;
+    KangarooTwelve(buf, sizeof(buf), out.data(), 32);
+    return out;
+}
+
+// ====== Table Hashing ======
+// Account ids, recipients and bridge ids are picked by callers, so hash tables keyed
+// by them hash the whole key with SipHash-2-4 under a per-process random seed: keys
+// cannot be crafted to share a bucket. The seed only decides bucket placement;
+// nothing that reaches state or events iterates these tables in bucket order.
+inline const std::array<uint64_t, 2>& tableHashSeed() {
+    static const std::array<uint64_t, 2> seed = [] {
+        std::random_device rd;
+        return std::array<uint64_t, 2>{(uint64_t(rd()) << 32) | rd(), (uint64_t(rd()) << 32) | rd()};
+    }();
+    return seed;
+}
+
+inline uint64_t tableHash(const void* data, size_t n) {
+    auto rotl = [](uint64_t x, int b) { return (x << b) | (x >> (64 - b)); };
+    const std::array<uint64_t, 2>& k = tableHashSeed();
+    uint64_t v0 = k[0] ^ 0x736f6d6570736575ULL, v1 = k[1] ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k[0] ^ 0x6c7967656e657261ULL, v3 = k[1] ^ 0x7465646279746573ULL;
+    auto round = [&] {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    };
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    size_t full = n & ~size_t(7);
+    for (size_t i = 0; i < full; i += 8) {
+        uint64_t m;
+        memcpy(&m, p + i, 8);
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+    uint64_t last = uint64_t(n) << 56;
+    for (size_t i = 0; i < (n & 7); ++i) last |= uint64_t(p[full + i]) << (8 * i);
+    v3 ^= last;
+    round();
+    round();
+    v0 ^= last;
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) round();
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// Default hash for state tables (BalanceMerkleTree, DirtyLog, HolderIndex, balances)
+struct TableHash {
+    size_t operator()(uint64_t key) const { return size_t(tableHash(&key, sizeof(key))); }
+    size_t operator()(const std::string& key) const { return size_t(tableHash(key.data(), key.size())); }
+    size_t operator()(const std::vector<uint8_t>& key) const { return size_t(tableHash(key.data(), key.size())); }
+    size_t operator()(const Hash256& key) const { return size_t(tableHash(key.data(), key.size())); }
+};
+
+// 32-byte public keys held as std::vector<uint8_t>
+using ByteVectorHash = TableHash;
+
+// ====== Inclusion Proof ======
+struct BalanceProof {
+    uint64_t balance = 0;
+    uint32_t leafIndex = 0;
+    std::vector<Hash256> siblings; // leaf level first, root level last
+};
+
+// Recompute the root from a leaf hash and its sibling path
+inline bool verifyBalanceProof(const Hash256& leaf, const BalanceProof& proof, const Hash256& root) {
+    Hash256 h = leaf;
+    uint64_t idx = proof.leafIndex;
+    for (const auto& sib : proof.siblings) {
+        h = (idx & 1) ? merkleNodeHash(sib, h) : merkleNodeHash(h, sib);
+        idx >>= 1;
+    }
+    return idx == 0 && h == root;
+}
+
+// ====== Balance Merkle Tree ======
+// Accounts get an append-only leaf slot on first touch, so the layout is fixed by
+// execution order and identical on every node. Nodes are a 1-based binary heap:
+// root at 1, leaves at [capacity, 2*capacity). Empty leaves hash to zero.
+template <typename Key, typename KeyHash = TableHash>
+class BalanceMerkleTree {
+private:
+    std::unordered_map<Key, uint32_t, KeyHash> slotOf;
+    std::vector<Key> keys;                             // slot -> account
+    std::vector<uint64_t> balances;                    // slot -> committed balance
+    std::vector<std::pair<uint32_t, uint64_t>> pending; // touched this tick (slot, new balance)
+    std::vector<Hash256> nodes;
+    size_t capacity = 0;
+    size_t committedSlots = 0;
+
+    void hashLeaf(size_t slot) {
+        nodes[capacity + slot] = merkleLeafHash(keys[slot], balances[slot]);
+    }
+
+    // Rehash ancestors of a sorted, unique, single-level frontier until it reaches
+    // the level whose nodes are [bound, 2*bound). bound == 1 stops at the root.
+    void hashUp(std::vector<size_t>& frontier, size_t bound) {
+        while (!frontier.empty() && frontier.front() >= 2 * bound) {
+            size_t out = 0;
+            for (size_t i = 0; i < frontier.size(); ++i) {
+                size_t parent = frontier[i] >> 1;
+                if (out == 0 || frontier[out - 1] != parent) frontier[out++] = parent;
+            }
+            frontier.resize(out);
+            for (size_t p : frontier) nodes[p] = merkleNodeHash(nodes[2 * p], nodes[2 * p + 1]);
+        }
+    }
+
+    // Grow to the next power of two and rehash everything (amortized O(1) per account)
+    void rebuild(unsigned workers) {
+        capacity = 1;
+        while (capacity < keys.size()) capacity <<= 1;
+        nodes.assign(2 * capacity, Hash256{});
+        size_t n = keys.size();
+        size_t chunk = (n + workers - 1) / workers;
+        sharedWorkers().parallelFor((n + chunk - 1) / chunk, [this, chunk, n](size_t w) {
+            for (size_t s = w * chunk; s < std::min(n, (w + 1) * chunk); ++s) hashLeaf(s);
+        });
+        for (size_t p = capacity - 1; p >= 1; --p) nodes[p] = merkleNodeHash(nodes[2 * p], nodes[2 * p + 1]);
+    }
+
+public:
+    // Record a new balance; takes effect in the root at the next commit()
+    void update(const Key& key, uint64_t balance) {
+        auto it = slotOf.find(key);
+        uint32_t slot;
+        if (it == slotOf.end()) {
+            slot = uint32_t(keys.size());
+            slotOf.emplace(key, slot);
+            keys.push_back(key);
+            balances.push_back(0);
+        } else {
+            slot = it->second;
+        }
+        pending.emplace_back(slot, balance);
+    }
+
+    // Fold this tick's touched accounts into the root: O(k log n) hashes,
+    // split into independent subtrees across the shared workers for large ticks
+    const Hash256& commit(unsigned workers = sharedWorkers().concurrency()) {
+        workers = std::max(1u, workers);
+        for (const auto& p : pending) balances[p.first] = p.second; // last write wins
+        if (keys.empty()) return root();
+        if (keys.size() > capacity) {
+            rebuild(workers);
+        } else if (!pending.empty()) {
+            std::vector<size_t> frontier;
+            frontier.reserve(pending.size());
+            for (const auto& p : pending) frontier.push_back(capacity + p.first);
+            std::sort(frontier.begin(), frontier.end());
+            frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+
+            size_t bound = 1;
+            if (workers > 1 && frontier.size() >= MERKLE_PARALLEL_MIN_DIRTY)
+                while (bound * 2 <= workers && bound * 2 <= capacity) bound <<= 1;
+
+            if (bound == 1) {
+                for (size_t leaf : frontier) hashLeaf(leaf - capacity);
+                hashUp(frontier, 1);
+            } else {
+                // Each subtree under [bound, 2*bound) owns a contiguous run of sorted leaves
+                size_t shift = 0;
+                while ((bound << shift) < capacity) ++shift;
+                std::vector<std::vector<size_t>> groups(bound);
+                for (size_t leaf : frontier) groups[(leaf >> shift) - bound].push_back(leaf);
+                sharedWorkers().parallelFor(bound, [this, &groups, bound](size_t g) {
+                    for (size_t leaf : groups[g]) hashLeaf(leaf - capacity);
+                    hashUp(groups[g], bound);
+                });
+                std::vector<size_t> tops;
+                for (size_t g = 0; g < bound; ++g)
+                    if (!groups[g].empty()) tops.push_back(bound + g);
+                hashUp(tops, 1);
+            }
+        }
+        pending.clear();
+        committedSlots = keys.size();
+        return root();
+    }
+
+    // Root as of the last commit (all zero while empty)
+    const Hash256& root() const {
+        static const Hash256 empty{};
+        return nodes.empty() ? empty : nodes[1];
+    }
+
+    // Inclusion proof against root(); false if the account was not committed yet
+    bool prove(const Key& key, BalanceProof& proof) const {
+        auto it = slotOf.find(key);
+        if (it == slotOf.end() || it->second >= committedSlots) return false;
+        proof.balance = balances[it->second];
+        proof.leafIndex = it->second;
+        proof.siblings.clear();
+        for (size_t idx = capacity + it->second; idx > 1; idx >>= 1) proof.siblings.push_back(nodes[idx ^ 1]);
+        return true;
+    }
+
+    size_t accounts() const { return committedSlots; }
+
+    // Accounts in slot order; snapshots persist it so a restore reproduces the root
+    const std::vector<Key>& slotKeys() const { return keys; }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -0,0 +1,198 @@
+/*
+ * qTick – Deterministic tick executor and the tick's cached block time
+ * Contracts that do not call each other run in parallel; state and event log match a serial run
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "qevents.hpp"
+#include "qworkers.hpp"
+
+// ====== Tick Clock ======
+// Block time of the tick being executed, in Unix seconds. The host sets it once
+// before the tick's first transaction; contracts read it instead of a clock, so
+// every call in a tick (and every replay of the tick) sees the same second.
+inline std::atomic<uint64_t>& tickClock() {
+    static std::atomic<uint64_t> timestamp{0};
+    return timestamp;
+}
+
+inline uint64_t tickTimestamp() { return tickClock().load(std::memory_order_relaxed); }
+inline void setTickTimestamp(uint64_t timestamp) { tickClock().store(timestamp, std::memory_order_relaxed); }
+
+// ====== Tick Executor ======
+// Each contract is a lane with its own globals. Transactions are queued per lane
+// in arrival order and executed at runTick(). Lanes joined by link() (one calls
+// into the other, e.g. the pool reading the oracle) form a group that runs on one
+// thread in arrival order; separate groups run concurrently on the executor's pool,
+// largest first. End-of-tick hooks run after a group's transactions, in lane order.
+//
+// The result is the serial one: every transaction in arrival order, then every
+// lane's hooks in lane order. Groups share no state, so only the event log could
+// tell the difference; events are captured per group with the transaction's
+// arrival index (hooks: after all transactions, by lane) and published in that
+// order. A transaction that throws is dropped the same way in both modes.
+//
+// Groups must really be independent: a lane that touches another lane's state
+// without a link() is a data race and breaks determinism.
+class TickExecutor {
+private:
+    struct Lane {
+        std::string name;
+        uint16_t group; // union-find parent; the root is the group's lowest lane
+        std::vector<std::function<void()>> endTick;
+    };
+
+    struct Transaction {
+        uint16_t lane;
+        std::function<void()> apply;
+    };
+
+    struct Group {
+        std::vector<uint16_t> lanes;
+        std::vector<uint32_t> transactions;
+    };
+
+    std::vector<Lane> lanes;
+    std::vector<Transaction> pending;
+    WorkerPool pool; // own pool: contracts may use sharedWorkers() inside a transaction
+
+    uint16_t root(uint16_t lane) const {
+        while (lanes[lane].group != lane) lane = lanes[lane].group;
+        return lane;
+    }
+
+    static bool apply(const Transaction& t) {
+        try {
+            t.apply();
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    std::vector<Group> plan() const {
+        std::vector<int> groupOf(lanes.size(), -1);
+        std::vector<Group> groups;
+        for (uint16_t l = 0; l < lanes.size(); ++l) {
+            uint16_t r = root(l);
+            if (groupOf[r] < 0) {
+                groupOf[r] = int(groups.size());
+                groups.emplace_back();
+            }
+            groups[size_t(groupOf[r])].lanes.push_back(l);
+        }
+        for (uint32_t i = 0; i < pending.size(); ++i)
+            groups[size_t(groupOf[root(pending[i].lane)])].transactions.push_back(i);
+        // Claimed in this order: the biggest group starts first and bounds the tick
+        std::stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+            return a.transactions.size() > b.transactions.size();
+        });
+        return groups;
+    }
+
+    static void publishMerged(std::vector<EventCapture>& captures) {
+        std::vector<size_t> at(captures.size(), 0);
+        for (;;) {
+            size_t best = captures.size();
+            for (size_t c = 0; c < captures.size(); ++c)
+                if (at[c] < captures[c].keys.size()
+                    && (best == captures.size() || captures[c].keys[at[c]] < captures[best].keys[at[best]]))
+                    best = c;
+            if (best == captures.size()) return;
+            eventLog().publish(captures[best].records[at[best]++]);
+        }
+    }
+
+public:
+    explicit TickExecutor(unsigned workers = std::max(1u, std::thread::hardware_concurrency()) - 1)
+        : pool(workers) {}
+
+    TickExecutor(const TickExecutor&) = delete;
+    TickExecutor& operator=(const TickExecutor&) = delete;
+
+    uint16_t addLane(const std::string& name) {
+        uint16_t id = uint16_t(lanes.size());
+        lanes.push_back({name, id, {}});
+        return id;
+    }
+
+    // `caller` calls into `callee` (or either reads the other's state) during a tick
+    void link(uint16_t caller, uint16_t callee) {
+        uint16_t a = root(caller), b = root(callee);
+        if (a == b) return;
+        if (a < b) lanes[b].group = a;
+        else lanes[a].group = b;
+    }
+
+    void onEndTick(uint16_t lane, std::function<void()> fn) { lanes[lane].endTick.push_back(std::move(fn)); }
+
+    void submit(uint16_t lane, std::function<void()> apply) { pending.push_back({lane, std::move(apply)}); }
+
+    size_t pendingTransactions() const { return pending.size(); }
+    unsigned concurrency() const { return pool.concurrency(); }
+    const std::string& laneName(uint16_t lane) const { return lanes[lane].name; }
+
+    // Reference order, on the calling thread. Returns the transactions that threw.
+    uint64_t runTickSerial(uint64_t tick, uint64_t timestamp) {
+        setTickTimestamp(timestamp);
+        eventLog().setTick(tick);
+        uint64_t failed = 0;
+        for (const Transaction& t : pending) failed += !apply(t);
+        for (const Lane& l : lanes)
+            for (const auto& fn : l.endTick) fn();
+        pending.clear();
+        return failed;
+    }
+
+    // Same result as runTickSerial(), with independent groups in parallel
+    uint64_t runTick(uint64_t tick, uint64_t timestamp) {
+        std::vector<Group> groups = plan();
+        size_t busy = std::count_if(groups.begin(), groups.end(), [](const Group& g) {
+            return !g.transactions.empty();
+        });
+        if (pool.concurrency() == 1 || busy < 2) return runTickSerial(tick, timestamp);
+
+        setTickTimestamp(timestamp);
+        eventLog().setTick(tick);
+        std::vector<EventCapture> captures(groups.size());
+        std::atomic<uint64_t> failed{0};
+        pool.parallelFor(groups.size(), [&](size_t g) {
+            EventCapture& capture = captures[g];
+            eventCapture = &capture;
+            uint64_t dropped = 0;
+            for (uint32_t i : groups[g].transactions) {
+                capture.key = i;
+                dropped += !apply(pending[i]);
+            }
+            for (uint16_t l : groups[g].lanes) {
+                capture.key = pending.size() + l;
+                for (const auto& fn : lanes[l].endTick) fn();
+            }
+            eventCapture = nullptr;
+            failed.fetch_add(dropped, std::memory_order_relaxed);
+        });
+        publishMerged(captures);
+        pending.clear();
+        return failed.load();
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
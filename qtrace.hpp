@@ -0,0 +1,274 @@
+/*
+ * qTrace – Seeded synthetic workloads for the contracts, as a compact binary trace
+ * Zipfian accounts, oracle feeds, vesting bursts and multisig proposal lifecycles
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// ====== Trace Records (24 bytes, little endian) ======
+// A trace is a header and a flat run of records; EndTick closes each tick. The
+// generator only decides what happens; contract state comes from replaying it.
+enum class TraceOp : uint8_t {
+    EndTick = 0,         // a: tick
+    QusdMint = 1,        // a: account, amount
+    QusdTransfer = 2,    // a: from, b: to, amount
+    QbtcTransfer = 3,    // a: from, b: to, amount (sats)
+    BkpyTransfer = 4,    // a: from, b: to, amount
+    OraclePrice = 5,     // arg: TraceOracle, amount: price (15 decimals), b: price timestamp
+    VestingCreate = 6,   // a: beneficiary, b: grant id, amount: total, arg: duration in ticks
+    VestingClaim = 7,    // a: beneficiary (claimAll)
+    ProposalCreate = 8,  // a: proposing owner, b: nonce, amount: value
+    ProposalSign = 9,    // a: owner, b: nonce
+    ProposalExecute = 10, // b: nonce
+};
+constexpr unsigned TRACE_OP_COUNT = 11;
+
+enum class TraceOracle : uint8_t {
+    Validator = 0,  // qoracle1.cpp
+    Committee = 1,  // qoraclecommittee1.cpp
+    CodeIsLaw = 2,  // codeislaw_committee.cpp
+    Btcq = 3,       // BTCqoraclecommittee.cpp
+};
+constexpr unsigned TRACE_ORACLES = 4;
+
+struct TraceRecord {
+    uint8_t op;       // TraceOp
+    uint8_t arg;
+    uint16_t reserved;
+    uint32_t a;
+    uint64_t b;
+    uint64_t amount;
+};
+static_assert(sizeof(TraceRecord) == 24, "trace record layout is part of the file format");
+
+constexpr char TRACE_MAGIC[4] = {'Q', 'T', 'R', 'C'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+// Everything a replayer needs to set contracts up the way the generator assumed
+struct TraceHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    uint64_t records;
+    uint32_t ticks;
+    uint32_t accounts;       // account 0 is the deployer of qBTC and BKPY
+    uint64_t baseTimestamp;  // block time of tick 0
+    uint32_t tickSeconds;
+    uint16_t owners;         // Qgnosis owners, at most 32
+    uint16_t threshold;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(TraceHeader) == 64, "trace header layout is part of the file format");
+
+struct Trace {
+    TraceHeader header = {};
+    std::vector<TraceRecord> records;
+};
+
+inline bool writeTrace(const std::string& path, const Trace& t) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    TraceHeader h = t.header;
+    memcpy(h.magic, TRACE_MAGIC, 4);
+    h.version = TRACE_VERSION;
+    h.records = t.records.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              (t.records.empty() || fwrite(t.records.data(), sizeof(TraceRecord), t.records.size(), f) == t.records.size());
+    return fclose(f) == 0 && ok;
+}
+
+inline bool readTrace(const std::string& path, Trace& t) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    bool ok = fread(&t.header, sizeof(t.header), 1, f) == 1 && memcmp(t.header.magic, TRACE_MAGIC, 4) == 0 &&
+              t.header.version == TRACE_VERSION && t.header.records <= (uint64_t(1) << 32);
+    if (ok) {
+        t.records.resize(size_t(t.header.records));
+        ok = t.records.empty() || fread(t.records.data(), sizeof(TraceRecord), t.records.size(), f) == t.records.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+// ====== Deterministic Randomness ======
+// Own generator and integer-only draws: std:: distributions differ between
+// standard libraries, which would make a seed mean different traces.
+class TraceRandom {
+private:
+    uint64_t state;
+
+public:
+    explicit TraceRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() { // splitmix64
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t below(uint64_t n) { return n ? uint64_t((unsigned __int128)next() * n >> 64) : 0; }
+    bool chance(uint32_t perMillion) { return below(1000000) < perMillion; }
+};
+
+// Zipf(s) over ranks [0, n): the popularity table is built once in 2^32 fixed
+// point, so sampling is a binary search over integers
+class ZipfTable {
+private:
+    std::vector<uint32_t> cdf;
+
+public:
+    ZipfTable(uint32_t n, double s) : cdf(n) {
+        double total = 0;
+        for (uint32_t r = 0; r < n; ++r) total += 1.0 / std::pow(double(r + 1), s);
+        double run = 0;
+        for (uint32_t r = 0; r < n; ++r) {
+            run += 1.0 / std::pow(double(r + 1), s);
+            cdf[r] = uint32_t(std::min(4294967295.0, run / total * 4294967296.0));
+        }
+        if (n) cdf[n - 1] = UINT32_MAX;
+    }
+
+    uint32_t sample(TraceRandom& rnd) const {
+        uint32_t u = uint32_t(rnd.next() >> 32);
+        return uint32_t(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+};
+
+// ====== Workload ======
+struct TraceConfig {
+    uint64_t seed = 1;
+    uint32_t ticks = 100;
+    uint32_t accounts = 100000;
+    uint32_t transfersPerTick = 3000;   // split evenly over qUSD, qBTC and BKPY
+    double zipf = 1.1;                  // account popularity exponent
+    uint32_t oracleRate = 1000000;      // chance per tick and committee of a price update, per million
+    uint32_t vestingEvery = 10;         // ticks between grant bursts
+    uint32_t vestingBurst = 200;
+    uint32_t vestingTicks = 50;         // grant duration
+    uint32_t claimEvery = 5;            // ticks between claim bursts
+    uint32_t claimBurst = 500;
+    uint32_t proposalsPerTick = 4;
+    uint16_t owners = 7;
+    uint16_t threshold = 4;
+    uint64_t baseTimestamp = 1700000000;
+    uint32_t tickSeconds = 1;
+};
+
+// Starting balances; transfers are sized well below them, so most succeed
+constexpr uint64_t TRACE_QUSD_GENESIS = 50000000000000ULL;  // 0.05 qUSD (supply is 64-bit at 15 decimals)
+constexpr uint64_t TRACE_QBTC_GENESIS = 1000000;            // 0.01 BTC
+constexpr uint64_t TRACE_BKPY_GENESIS = 100000000000ULL;    // 0.1 BKPY
+
+// Tick 0 is genesis: every account is funded on the three tokens. Each later
+// tick draws Zipfian transfers, oracle updates, grant and claim bursts, and
+// moves multisig proposals along create -> owner signatures -> execute.
+inline Trace generateTrace(const TraceConfig& c) {
+    Trace t;
+    t.header.seed = c.seed;
+    t.header.ticks = c.ticks;
+    t.header.accounts = std::max<uint32_t>(c.accounts, 2);
+    t.header.baseTimestamp = c.baseTimestamp;
+    t.header.tickSeconds = c.tickSeconds;
+    t.header.owners = c.owners;
+    t.header.threshold = std::min(c.threshold, c.owners);
+    uint32_t accounts = t.header.accounts;
+    auto add = [&t](TraceOp op, uint32_t a, uint64_t b, uint64_t amount, uint8_t arg = 0) {
+        t.records.push_back({uint8_t(op), arg, 0, a, b, amount});
+    };
+
+    for (uint32_t i = 1; i < accounts; ++i) {
+        add(TraceOp::QusdMint, i, 0, TRACE_QUSD_GENESIS);
+        add(TraceOp::QbtcTransfer, 0, i, TRACE_QBTC_GENESIS);
+        add(TraceOp::BkpyTransfer, 0, i, TRACE_BKPY_GENESIS);
+    }
+    add(TraceOp::EndTick, 0, 0, 0);
+
+    TraceRandom rnd(c.seed);
+    ZipfTable popular(accounts - 1, c.zipf);
+    auto account = [&] { return popular.sample(rnd) + 1; };
+    uint64_t prices[TRACE_ORACLES] = {2000000, 2000000, 2000000, 2000000}; // micro-dollars, STX/USD-like
+    std::vector<uint32_t> beneficiaries;
+    uint64_t grants = 0, nonces = 1; // Qnosis numbers proposals from 1
+    struct Open {
+        uint64_t nonce;
+        uint32_t signedBy; // owner bitmap
+    };
+    std::vector<Open> open;
+
+    for (uint32_t tick = 1; tick < c.ticks; ++tick) {
+        uint64_t now = c.baseTimestamp + uint64_t(tick) * c.tickSeconds;
+        for (uint32_t i = 0; i < c.transfersPerTick; ++i) {
+            uint32_t from = account(), to = account();
+            switch (i % 3) {
+            case 0: add(TraceOp::QusdTransfer, from, to, 1 + rnd.below(TRACE_QUSD_GENESIS / 100)); break;
+            case 1: add(TraceOp::QbtcTransfer, from, to, 1 + rnd.below(TRACE_QBTC_GENESIS / 100)); break;
+            default: add(TraceOp::BkpyTransfer, from, to, 1 + rnd.below(TRACE_BKPY_GENESIS / 100)); break;
+            }
+        }
+        for (unsigned o = 0; o < TRACE_ORACLES; ++o) {
+            if (!rnd.chance(c.oracleRate)) continue;
+            prices[o] = std::max<uint64_t>(1, prices[o] + rnd.below(2001) - 1000); // random walk
+            add(TraceOp::OraclePrice, 0, now, prices[o] * 1000000000ULL, uint8_t(o));
+        }
+        if (c.vestingEvery && tick % c.vestingEvery == 0) {
+            for (uint32_t i = 0; i < c.vestingBurst; ++i) {
+                uint32_t who = account();
+                beneficiaries.push_back(who);
+                add(TraceOp::VestingCreate, who, grants++, 1000 + rnd.below(1000000),
+                    uint8_t(std::min<uint32_t>(c.vestingTicks, 255)));
+            }
+        }
+        if (c.claimEvery && tick % c.claimEvery == 0 && !beneficiaries.empty()) {
+            for (uint32_t i = 0; i < c.claimBurst; ++i)
+                add(TraceOp::VestingClaim, beneficiaries[rnd.below(beneficiaries.size())], 0, 0);
+        }
+        // Proposals that reached the threshold last tick execute first, then each
+        // open one may gain a signature, then new ones are created
+        for (size_t i = 0; i < open.size();) {
+            if (uint32_t(__builtin_popcount(open[i].signedBy)) >= t.header.threshold) {
+                add(TraceOp::ProposalExecute, 0, open[i].nonce, 0);
+                open[i] = open.back();
+                open.pop_back();
+                continue;
+            }
+            if (rnd.chance(500000)) {
+                uint32_t owner;
+                do owner = uint32_t(rnd.below(c.owners)); while (open[i].signedBy & (1u << owner));
+                open[i].signedBy |= 1u << owner;
+                add(TraceOp::ProposalSign, owner, open[i].nonce, 0);
+            }
+            ++i;
+        }
+        for (uint32_t i = 0; i < c.proposalsPerTick && c.owners; ++i) {
+            uint32_t proposer = uint32_t(rnd.below(c.owners));
+            add(TraceOp::ProposalCreate, proposer, nonces, 1 + rnd.below(1000000));
+            add(TraceOp::ProposalSign, proposer, nonces, 0);
+            open.push_back({nonces, 1u << proposer});
+            ++nonces;
+        }
+        add(TraceOp::EndTick, tick, 0, 0);
+    }
+    t.header.records = t.records.size();
+    return t;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -33,12 +33,32 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 // USDq - Qubic Smart Contract - 1:1 Synthetic USDC Peg, No Fees
 
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
 #include <map>
+#include <utility>
 #include <vector>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include "qstatetree.hpp"
+#include "qstatedelta.hpp"
+#include "qsnapshot.hpp"
+#include "qevents.hpp"
+#include "qjournal.hpp"
+#include "qcall.hpp"
+#include "qholders.hpp"
+#include "qprocessedids.hpp"
+#include "qcollateral.hpp"
+#include "qfixed.hpp"
+#include "qprobe.hpp"
 
 // 15 decimals of precision (fixed point math)
-const uint8_t DECIMALS = 15;
-const uint64_t DECIMAL_MULTIPLIER = 1000000000000000ULL;
+const uint8_t DECIMALS = QusdAmount::decimals;
+const uint64_t DECIMAL_MULTIPLIER = QusdAmount::unit;
 
 // No max supply: mirrors bridged/minted USDC
 const uint64_t MAX_SUPPLY = UINT64_MAX;
@@ -46,10 +66,118 @@ const uint64_t MAX_SUPPLY = UINT64_MAX;
 // Set this to your bridge/custodian public key
 const uint8_t AUTHORIZED_MINT_BURN_PUBKEY[32] = { /* Fill in custodian key */ };
 
+// Bridge batches: entries per call, how far ahead a batch may set its expiry,
+// and the cap on remembered ids (bounded by throughput x expiry window anyway)
+const uint32_t MAX_BRIDGE_BATCH = 16384;
+const uint64_t BRIDGE_MAX_EXPIRY_TICKS = 1024;
+const size_t BRIDGE_MAX_LIVE_IDS = 1 << 22;
+
 // Storage for balances
 std::map<std::vector<uint8_t>, uint64_t> balances;
 uint64_t totalSupply = 0;
 
+// Merkle commitment over balances, rehashed once per tick from touched accounts
+BalanceMerkleTree<std::vector<uint8_t>, ByteVectorHash> balanceTree;
+
+// Accounts changed per tick, for delta catch-up of lagging nodes
+DirtyLog<std::vector<uint8_t>, ByteVectorHash> dirtyBalances;
+constexpr uint16_t DELTA_TABLE_BALANCES = 0;
+
+// Holder ranking and per-tick balance versions (airdrops, governance weight)
+HolderIndex<std::vector<uint8_t>, ByteVectorHash> holders;
+constexpr uint32_t MAX_TOP_HOLDERS = 64;
+
+// Deposit/withdrawal ids already applied, kept until their batch expiry passes
+ProcessedIdSet processedBridgeIds;
+DirtyLog<Hash256, Hash256Hash> dirtyBridgeIds;
+constexpr uint16_t DELTA_TABLE_BRIDGE_IDS = 1;
+
+// qUSD minted against qBTC locked with the custodian, liquidated at tick end
+CollateralEngine<std::vector<uint8_t>> collateral;
+uint64_t seizedCollateral = 0; // sats taken by liquidations, held by the custodian
+uint64_t writtenOffDebt = 0;   // debt of liquidated positions
+DirtyLog<uint64_t> dirtyPositions;
+constexpr uint16_t DELTA_TABLE_POSITIONS = 2;
+
+// A position as carried by deltas; live == 0 means closed or liquidated
+struct PositionRecord {
+    uint8_t live;
+    std::array<uint8_t, 32> owner;
+    uint64_t collateral;
+    uint64_t debt;
+};
+
+void writeField(std::ostream& out, const PositionRecord& r) {
+    writeField(out, r.live != 0);
+    writeField(out, r.owner);
+    writeField(out, r.collateral);
+    writeField(out, r.debt);
+}
+
+bool readField(std::istream& in, PositionRecord& r) {
+    bool live;
+    if (!readField(in, live) || !readField(in, r.owner) || !readField(in, r.collateral) || !readField(in, r.debt))
+        return false;
+    r.live = live;
+    return true;
+}
+
+// Snapshot tables (see qsnapshot.hpp)
+constexpr uint32_t SNAPSHOT_TABLE_BALANCES = 0;   // BalanceRow, sorted by account
+constexpr uint32_t SNAPSHOT_TABLE_TREE_SLOTS = 1; // AccountRow, state tree slot order
+constexpr uint32_t SNAPSHOT_TABLE_BRIDGE_IDS = 2; // BridgeIdRow, live processed ids
+constexpr uint32_t SNAPSHOT_TABLE_STATE_ROOT = 3; // one Hash256, the committed root
+constexpr uint32_t SNAPSHOT_TABLE_POSITIONS = 4;  // PositionRow, sorted by id
+constexpr size_t SNAPSHOT_SCALAR_TOTAL_SUPPLY = 0;
+constexpr size_t SNAPSHOT_SCALAR_SEIZED_COLLATERAL = 1;
+constexpr size_t SNAPSHOT_SCALAR_WRITTEN_OFF_DEBT = 2;
+constexpr size_t SNAPSHOT_SCALAR_COLLATERAL_PRICE = 3;
+constexpr size_t SNAPSHOT_SCALAR_NEXT_POSITION_ID = 4;
+
+struct BalanceRow {
+    uint8_t account[32];
+    uint64_t balance;
+};
+struct AccountRow {
+    uint8_t account[32];
+};
+struct BridgeIdRow {
+    uint8_t id[32];
+    uint64_t expiryTick;
+};
+struct PositionRow {
+    uint64_t id;
+    uint8_t owner[32];
+    uint64_t collateral;
+    uint64_t debt;
+};
+
+// Restored snapshot, queried in place; `balances` then only holds accounts written since
+SnapshotView snapshot;
+const BalanceRow* snapshotBalances = nullptr;
+size_t snapshotBalanceCount = 0;
+
+// State tree and holder index for the restored snapshot, built off the calling thread.
+// Balance writes made meanwhile are queued and replayed onto them on adoption.
+struct IndexReseed {
+    struct Write {
+        std::vector<uint8_t> account;
+        uint64_t balance;
+        uint64_t tick;
+    };
+    std::thread builder;
+    BalanceMerkleTree<std::vector<uint8_t>, ByteVectorHash> tree;
+    HolderIndex<std::vector<uint8_t>, ByteVectorHash> holders;
+    std::vector<Write> writes;
+
+    void wait() {
+        if (builder.joinable()) builder.join();
+    }
+    ~IndexReseed() { wait(); }
+};
+IndexReseed indexReseed;
+bool indexReseedPending = false;
+
 // Input/output structs
 struct TransferInput {
     uint8_t to[32];
@@ -72,6 +200,120 @@ struct MintBurnInput {
     uint64_t amount;
 };
 
+// One bridge deposit (mint) or withdrawal (burn), keyed by its bridge-side id
+struct BridgeEntry {
+    uint8_t id[32];
+    uint8_t account[32];
+    uint64_t amount;
+};
+
+// Re-submitting a batch (e.g. after a timeout) is safe: processed ids are skipped.
+// The batch must execute by expiryTick, which lets ids be forgotten afterwards.
+struct BridgeBatchInput {
+    uint64_t expiryTick; // currentTick <= expiryTick <= currentTick + BRIDGE_MAX_EXPIRY_TICKS
+    uint32_t count;
+    BridgeEntry entries[MAX_BRIDGE_BATCH];
+};
+struct BridgeBatchOutput {
+    bool accepted;       // false: unauthorized, oversized, bad expiry or id set full
+    uint32_t applied;
+    uint32_t duplicates; // id already processed, skipped
+    uint32_t rejected;   // zero amount, overflow or insufficient balance; id not recorded
+};
+
+struct BalanceOfAtInput {
+    uint8_t account[32];
+    uint64_t tick;
+};
+struct BalanceOfAtOutput {
+    uint64_t balance;
+    bool exact; // false: tick older than the history kept, balance is as of the oldest answerable tick
+};
+
+struct HolderRankOutput {
+    bool found;
+    uint64_t rank; // 0 = largest holder
+    uint64_t holders;
+};
+
+struct TopHoldersInput {
+    uint32_t count; // capped at MAX_TOP_HOLDERS
+};
+struct TopHoldersOutput {
+    uint32_t count;
+    struct {
+        uint8_t account[32];
+        uint64_t balance;
+    } holders[MAX_TOP_HOLDERS];
+};
+
+struct TopHoldersAtInput {
+    uint64_t tick;
+    uint32_t count; // capped at MAX_TOP_HOLDERS
+};
+struct TopHoldersAtOutput {
+    bool exact; // false: tick older than the history kept, holders are as of the oldest answerable tick
+    uint32_t count;
+    struct {
+        uint8_t account[32];
+        uint64_t balance;
+    } holders[MAX_TOP_HOLDERS];
+};
+
+struct StateRootOutput {
+    uint8_t root[32];
+    uint64_t accounts;
+};
+
+// Collateralized minting (see qcollateral.hpp for units)
+struct CollateralPriceInput {
+    uint64_t price;      // BTC/USD, 8 decimals, as accepted by the oracle committee
+};
+struct CollateralInput {
+    uint64_t positionId; // 0 opens a new position (depositCollateral only)
+    uint8_t owner[32];   // depositCollateral only
+    uint64_t amount;     // sats for collateral calls, qUSD units for mint/repay
+};
+struct CollateralOutput {
+    bool ok;
+    uint64_t positionId;
+    uint64_t amount;
+};
+struct RedeemInput {
+    uint64_t amount;     // qUSD to redeem
+};
+struct RedeemOutput {
+    uint64_t redeemed;   // qUSD burned
+    uint64_t sats;       // qBTC the custodian releases to the redeemer
+};
+struct PositionInput {
+    uint64_t positionId;
+};
+struct PositionOutput {
+    bool found;
+    uint8_t owner[32];
+    uint64_t collateral;
+    uint64_t debt;
+    uint64_t liquidationPrice;
+};
+struct CollateralStatsOutput {
+    uint64_t price;
+    uint64_t positions;
+    uint64_t collateral;
+    uint64_t debt;
+    uint64_t unsafe;     // liquidated at the next endTick unless the price recovers
+    uint64_t seizedCollateral;
+    uint64_t writtenOffDebt;
+};
+
+struct BalanceProofOutput {
+    bool found;
+    uint64_t balance;
+    uint32_t leafIndex;
+    uint8_t depth;                          // number of valid siblings
+    uint8_t siblings[MERKLE_MAX_DEPTH][32]; // leaf level first
+};
+
 // Permission check
 bool isAuthorized(const uint8_t pubkey[32]) {
     for (int i = 0; i < 32; ++i)
@@ -80,78 +322,729 @@ bool isAuthorized(const uint8_t pubkey[32]) {
     return true;
 }
 
-// Safe Math
-bool safeAdd(uint64_t a, uint64_t b, uint64_t &result) {
-    result = a + b;
-    return result >= a;
+// Balance in the mapped snapshot, or 0
+uint64_t snapshotBalance(const uint8_t account[32]) {
+    const BalanceRow* end = snapshotBalances + snapshotBalanceCount;
+    const BalanceRow* row = std::lower_bound(snapshotBalances, end, account,
+        [](const BalanceRow& r, const uint8_t* a) { return memcmp(r.account, a, 32) < 0; });
+    return (row != end && memcmp(row->account, account, 32) == 0) ? row->balance : 0;
 }
-bool safeSub(uint64_t a, uint64_t b, uint64_t &result) {
-    if (b > a) return false;
-    result = a - b;
-    return true;
+
+// Current balance: written since restore, else the mapped snapshot, else 0
+uint64_t getBalance(const std::vector<uint8_t>& account) {
+    auto it = balances.find(account);
+    if (it != balances.end()) return it->second;
+    return snapshotBalance(account.data());
+}
+
+// After a restore: replay the snapshot's slot order into a fresh tree so the root
+// matches, and rebuild the holder index (history restarts at the snapshot tick).
+// Runs on indexReseed.builder and reads only the mapped snapshot, so restore
+// returns at once and live writes do not wait for it.
+void startIndexReseed(uint64_t tick) {
+    indexReseed.wait();
+    indexReseed.tree = BalanceMerkleTree<std::vector<uint8_t>, ByteVectorHash>();
+    indexReseed.holders = HolderIndex<std::vector<uint8_t>, ByteVectorHash>();
+    indexReseed.writes.clear();
+    indexReseedPending = true;
+    indexReseed.builder = std::thread([tick] {
+        size_t n;
+        const AccountRow* slots = snapshot.table<AccountRow>(SNAPSHOT_TABLE_TREE_SLOTS, n);
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<uint8_t> account(slots[i].account, slots[i].account + 32);
+            uint64_t balance = snapshotBalance(slots[i].account);
+            indexReseed.tree.update(account, balance);
+            indexReseed.holders.update(account, balance, tick);
+        }
+        indexReseed.tree.commit();
+    });
+}
+
+// Adopt the reseeded indexes, waiting for the builder if it is still running,
+// then replay the writes queued since the restore
+void reseedIndexes() {
+    indexReseed.wait();
+    indexReseedPending = false;
+    balanceTree = std::move(indexReseed.tree);
+    holders = std::move(indexReseed.holders);
+    for (const auto& w : indexReseed.writes) {
+        balanceTree.update(w.account, w.balance);
+        holders.update(w.account, w.balance, w.tick);
+    }
+    std::vector<IndexReseed::Write>().swap(indexReseed.writes);
+}
+
+// Single write path for balances: keeps state root and dirty set in step
+void setBalance(const std::vector<uint8_t>& account, uint64_t newBalance) {
+    balances[account] = newBalance;
+    if (indexReseedPending) {
+        indexReseed.writes.push_back({account, newBalance, dirtyBalances.currentTick()});
+    } else {
+        balanceTree.update(account, newBalance);
+        holders.update(account, newBalance, dirtyBalances.currentTick());
+    }
+    dirtyBalances.markDirty(account);
+}
+
+// Batch-level checks, done once per batch rather than per entry
+bool bridgeBatchAdmissible(const BridgeBatchInput& input, const uint8_t caller[32]) {
+    if (!isAuthorized(caller)) return false;
+    if (input.count > MAX_BRIDGE_BATCH) return false;
+    uint64_t tick = dirtyBalances.currentTick();
+    if (input.expiryTick < tick || input.expiryTick - tick > BRIDGE_MAX_EXPIRY_TICKS) return false;
+    return processedBridgeIds.size() + input.count <= BRIDGE_MAX_LIVE_IDS;
+}
+
+void recordBridgeId(const Hash256& id, uint64_t expiryTick) {
+    processedBridgeIds.insert(id, expiryTick);
+    dirtyBridgeIds.markDirty(id);
 }
 
 // Mint: only authorized bridge/custodian may mint
 extern "C" void mint(const MintBurnInput& input, const uint8_t caller[32]) {
-    if (!isAuthorized(caller)) return;
-    if (input.amount == 0) return;
+    QPROBE(probe, "qusd.mint");
+    if (!isAuthorized(caller)) return QPROBE_REJECT_VOID(probe);
+    if (input.amount == 0) return QPROBE_REJECT_VOID(probe);
 
     uint64_t newBalance, newSupply;
     std::vector<uint8_t> to(input.to_or_from, input.to_or_from + 32);
 
-    if (!safeAdd(balances[to], input.amount, newBalance)) return;
-    if (!safeAdd(totalSupply, input.amount, newSupply)) return;
+    if (!checkedAdd(getBalance(to), input.amount, newBalance)) return QPROBE_REJECT_VOID(probe);
+    if (!checkedAdd(totalSupply, input.amount, newSupply)) return QPROBE_REJECT_VOID(probe);
 
-    balances[to] = newBalance;
+    setBalance(to, newBalance);
     totalSupply = newSupply;
+    emitEvent(EventContract::QUSD, EventType::Mint, to, EventKeyRef(), input.amount);
 }
 
 // Burn: only authorized bridge/custodian may burn
 extern "C" void burn(const MintBurnInput& input, const uint8_t caller[32]) {
-    if (!isAuthorized(caller)) return;
-    if (input.amount == 0) return;
+    QPROBE(probe, "qusd.burn");
+    if (!isAuthorized(caller)) return QPROBE_REJECT_VOID(probe);
+    if (input.amount == 0) return QPROBE_REJECT_VOID(probe);
 
     std::vector<uint8_t> from(input.to_or_from, input.to_or_from + 32);
-    uint64_t userBalance = balances[from];
+    uint64_t userBalance = getBalance(from);
 
-    if (userBalance < input.amount) return;
+    if (userBalance < input.amount) return QPROBE_REJECT_VOID(probe);
 
     uint64_t newBalance, newSupply;
-    if (!safeSub(userBalance, input.amount, newBalance)) return;
-    if (!safeSub(totalSupply, input.amount, newSupply)) return;
+    if (!checkedSub(userBalance, input.amount, newBalance)) return QPROBE_REJECT_VOID(probe);
+    if (!checkedSub(totalSupply, input.amount, newSupply)) return QPROBE_REJECT_VOID(probe);
 
-    balances[from] = newBalance;
+    setBalance(from, newBalance);
     totalSupply = newSupply;
+    emitEvent(EventContract::QUSD, EventType::Burn, from, EventKeyRef(), input.amount);
 }
 
-// Transfer: no fees, standard move
-extern "C" void transfer(const TransferInput& input, const uint8_t sender[32]) {
-    if (input.amount == 0) return;
+// Batched mint: one authorization, one supply update, each deposit id applied at most once
+extern "C" BridgeBatchOutput mintBatch(const BridgeBatchInput& input, const uint8_t caller[32]) {
+    QPROBE(probe, "qusd.mintBatch");
+    BridgeBatchOutput output = {};
+    if (!bridgeBatchAdmissible(input, caller)) return QPROBE_REJECT(probe, output);
+    output.accepted = true;
+
+    uint64_t supply = totalSupply;
+    std::vector<uint8_t> to(32);
+    Hash256 id;
+    for (uint32_t i = 0; i < input.count; ++i) {
+        const BridgeEntry& entry = input.entries[i];
+        memcpy(id.data(), entry.id, 32);
+        if (processedBridgeIds.contains(id)) { output.duplicates++; continue; }
+
+        memcpy(to.data(), entry.account, 32);
+        uint64_t newBalance, newSupply;
+        if (entry.amount == 0 || !checkedAdd(getBalance(to), entry.amount, newBalance) ||
+            !checkedAdd(supply, entry.amount, newSupply)) {
+            output.rejected++;
+            continue;
+        }
+        recordBridgeId(id, input.expiryTick);
+        setBalance(to, newBalance);
+        supply = newSupply;
+        emitEvent(EventContract::QUSD, EventType::Mint, to, EventKeyRef(entry.id), entry.amount);
+        output.applied++;
+    }
+    totalSupply = supply;
+    return output;
+}
+
+// Batched burn: one authorization, one supply update, each withdrawal id applied at most once
+extern "C" BridgeBatchOutput burnBatch(const BridgeBatchInput& input, const uint8_t caller[32]) {
+    QPROBE(probe, "qusd.burnBatch");
+    BridgeBatchOutput output = {};
+    if (!bridgeBatchAdmissible(input, caller)) return QPROBE_REJECT(probe, output);
+    output.accepted = true;
+
+    uint64_t supply = totalSupply;
+    std::vector<uint8_t> from(32);
+    Hash256 id;
+    for (uint32_t i = 0; i < input.count; ++i) {
+        const BridgeEntry& entry = input.entries[i];
+        memcpy(id.data(), entry.id, 32);
+        if (processedBridgeIds.contains(id)) { output.duplicates++; continue; }
+
+        memcpy(from.data(), entry.account, 32);
+        uint64_t newBalance, newSupply;
+        if (entry.amount == 0 || !checkedSub(getBalance(from), entry.amount, newBalance) ||
+            !checkedSub(supply, entry.amount, newSupply)) {
+            output.rejected++;
+            continue;
+        }
+        recordBridgeId(id, input.expiryTick);
+        setBalance(from, newBalance);
+        supply = newSupply;
+        emitEvent(EventContract::QUSD, EventType::Burn, from, EventKeyRef(entry.id), entry.amount);
+        output.applied++;
+    }
+    totalSupply = supply;
+    return output;
+}
+
+// Move `amount` between two accounts; false (nothing changed) if refused
+bool moveBalance(const uint8_t sender[32], const uint8_t recipient[32], uint64_t amount) {
+    if (amount == 0) return false;
     std::vector<uint8_t> from(sender, sender + 32);
-    std::vector<uint8_t> to(input.to, input.to + 32);
+    std::vector<uint8_t> to(recipient, recipient + 32);
 
-    if (from == to) return;
+    if (from == to) return false;
 
-    uint64_t fromBalance = balances[from];
-    if (fromBalance < input.amount) return;
+    uint64_t fromBalance = getBalance(from);
+    if (fromBalance < amount) return false;
 
     uint64_t newFrom, newTo;
-    if (!safeSub(fromBalance, input.amount, newFrom)) return;
-    if (!safeAdd(balances[to], input.amount, newTo)) return;
+    if (!checkedSub(fromBalance, amount, newFrom)) return false;
+    if (!checkedAdd(getBalance(to), amount, newTo)) return false;
 
-    balances[from] = newFrom;
-    balances[to] = newTo;
+    setBalance(from, newFrom);
+    setBalance(to, newTo);
+    emitEvent(EventContract::QUSD, EventType::Transfer, from, to, amount);
+    return true;
+}
+
+// Transfer: no fees, standard move
+extern "C" void transfer(const TransferInput& input, const uint8_t sender[32]) {
+    QPROBE(probe, "qusd.transfer");
+    if (!moveBalance(sender, input.to, input.amount)) return QPROBE_REJECT_VOID(probe);
 }
 
 // balanceOf
 extern "C" BalanceOfOutput balanceOf(const BalanceOfInput& input) {
+    QPROBE(probe, "qusd.balanceOf");
+    std::vector<uint8_t> account(input.account, input.account + 32);
+    BalanceOfOutput output = { getBalance(account) };
+    return output;
+}
+
+// balanceOf as of the end of a past tick
+extern "C" BalanceOfAtOutput balanceOfAt(const BalanceOfAtInput& input) {
+    QPROBE(probe, "qusd.balanceOfAt");
+    if (indexReseedPending) reseedIndexes();
     std::vector<uint8_t> account(input.account, input.account + 32);
-    BalanceOfOutput output = { balances[account] };
+    BalanceOfAtOutput output = {};
+    output.exact = holders.balanceAt(account, input.tick, output.balance);
+    return output;
+}
+
+// Rank of an account by balance
+extern "C" HolderRankOutput holderRank(const BalanceOfInput& input) {
+    QPROBE(probe, "qusd.holderRank");
+    if (indexReseedPending) reseedIndexes();
+    HolderRankOutput output = {};
+    std::vector<uint8_t> account(input.account, input.account + 32);
+    output.found = holders.rankOf(account, output.rank);
+    output.holders = holders.holders();
+    return output;
+}
+
+// Largest holders, in rank order
+extern "C" TopHoldersOutput topHolders(const TopHoldersInput& input) {
+    QPROBE(probe, "qusd.topHolders");
+    if (indexReseedPending) reseedIndexes();
+    TopHoldersOutput output = {};
+    holders.topHolders(std::min(input.count, MAX_TOP_HOLDERS),
+        [&output](const std::vector<uint8_t>& account, uint64_t balance) {
+            memcpy(output.holders[output.count].account, account.data(), 32);
+            output.holders[output.count].balance = balance;
+            output.count++;
+        });
+    return output;
+}
+
+// Largest holders as of the end of a past tick, in rank order. Scans every
+// account's history: meant for airdrop snapshots, not per-tick use.
+extern "C" TopHoldersAtOutput topHoldersAt(const TopHoldersAtInput& input) {
+    QPROBE(probe, "qusd.topHoldersAt");
+    if (indexReseedPending) reseedIndexes();
+    TopHoldersAtOutput output = {};
+    output.exact = holders.topHoldersAt(input.tick, std::min(input.count, MAX_TOP_HOLDERS),
+        [&output](const std::vector<uint8_t>& account, uint64_t balance) {
+            memcpy(output.holders[output.count].account, account.data(), 32);
+            output.holders[output.count].balance = balance;
+            output.count++;
+        });
     return output;
 }
 
 // totalSupply
 extern "C" TotalSupplyOutput getTotalSupply() {
+    QPROBE(probe, "qusd.getTotalSupply");
     TotalSupplyOutput output = { totalSupply };
     return output;
 }
+
+// ====== Collateralized Minting ======
+
+// Relay of the oracle committee's accepted BTC/USD price (custodian only)
+extern "C" void updateCollateralPrice(const CollateralPriceInput& input, const uint8_t caller[32]) {
+    QPROBE(probe, "qusd.updateCollateralPrice");
+    if (!isAuthorized(caller) || input.price == 0) return QPROBE_REJECT_VOID(probe);
+    collateral.updatePrice(input.price, [](uint64_t id, const CollateralPosition<std::vector<uint8_t>>& pos) {
+        emitEvent(EventContract::QUSD, EventType::PositionUnsafe, id, pos.owner, 0, pos.liqPrice);
+    });
+}
+
+// Credit qBTC the custodian has locked to a position (custodian only)
+extern "C" CollateralOutput depositCollateral(const CollateralInput& input, const uint8_t caller[32]) {
+    QPROBE(probe, "qusd.depositCollateral");
+    CollateralOutput output = {};
+    if (!isAuthorized(caller) || input.amount == 0) return QPROBE_REJECT(probe, output);
+    std::vector<uint8_t> owner(input.owner, input.owner + 32);
+    uint64_t id = input.positionId;
+    bool opened = id == 0;
+    if (opened) id = collateral.open(owner);
+    if (!collateral.deposit(id, input.amount)) {
+        if (opened) collateral.discard(id);
+        return QPROBE_REJECT(probe, output);
+    }
+    dirtyPositions.markDirty(id);
+    emitEvent(EventContract::QUSD, EventType::CollateralLocked, id, collateral.find(id)->owner, input.amount);
+    output = { true, id, input.amount };
+    return output;
+}
+
+// Mint qUSD to the position owner, keeping the position above the minimum ratio
+extern "C" CollateralOutput mintAgainstCollateral(const CollateralInput& input, const uint8_t sender[32]) {
+    QPROBE(probe, "qusd.mintAgainstCollateral");
+    CollateralOutput output = {};
+    std::vector<uint8_t> owner(sender, sender + 32);
+    uint64_t newBalance, newSupply;
+    if (!checkedAdd(getBalance(owner), input.amount, newBalance)) return QPROBE_REJECT(probe, output);
+    if (!checkedAdd(totalSupply, input.amount, newSupply)) return QPROBE_REJECT(probe, output);
+    if (!collateral.mint(input.positionId, owner, input.amount)) return QPROBE_REJECT(probe, output);
+    dirtyPositions.markDirty(input.positionId);
+
+    setBalance(owner, newBalance);
+    totalSupply = newSupply;
+    emitEvent(EventContract::QUSD, EventType::Mint, owner, EventKeyRef(), input.amount);
+    output = { true, input.positionId, input.amount };
+    return output;
+}
+
+// Burn the sender's qUSD against a position's debt
+extern "C" CollateralOutput repayDebt(const CollateralInput& input, const uint8_t sender[32]) {
+    QPROBE(probe, "qusd.repayDebt");
+    CollateralOutput output = {};
+    std::vector<uint8_t> from(sender, sender + 32);
+    uint64_t newBalance, newSupply;
+    if (!checkedSub(getBalance(from), input.amount, newBalance)) return QPROBE_REJECT(probe, output);
+    if (!checkedSub(totalSupply, input.amount, newSupply)) return QPROBE_REJECT(probe, output);
+    if (!collateral.repay(input.positionId, input.amount)) return QPROBE_REJECT(probe, output);
+    dirtyPositions.markDirty(input.positionId);
+
+    setBalance(from, newBalance);
+    totalSupply = newSupply;
+    emitEvent(EventContract::QUSD, EventType::Burn, from, EventKeyRef(), input.amount);
+    output = { true, input.positionId, input.amount };
+    return output;
+}
+
+// Release collateral to the owner (the custodian unlocks the qBTC on this event).
+// Withdrawing everything from a debt-free position closes it.
+extern "C" CollateralOutput withdrawCollateral(const CollateralInput& input, const uint8_t sender[32]) {
+    QPROBE(probe, "qusd.withdrawCollateral");
+    CollateralOutput output = {};
+    std::vector<uint8_t> owner(sender, sender + 32);
+    const auto* pos = collateral.find(input.positionId);
+    if (!pos) return QPROBE_REJECT(probe, output);
+    uint64_t released = input.amount;
+    if (pos->debt == 0 && released == pos->collateral) {
+        if (!collateral.close(input.positionId, owner, released)) return QPROBE_REJECT(probe, output);
+    } else if (!collateral.withdraw(input.positionId, owner, released)) {
+        return QPROBE_REJECT(probe, output);
+    }
+    dirtyPositions.markDirty(input.positionId);
+    emitEvent(EventContract::QUSD, EventType::CollateralReleased, input.positionId, owner, released);
+    output = { true, input.positionId, released };
+    return output;
+}
+
+// Burn qUSD for qBTC at the oracle price, repaying the safe positions nearest liquidation
+extern "C" RedeemOutput redeem(const RedeemInput& input, const uint8_t sender[32]) {
+    QPROBE(probe, "qusd.redeem");
+    RedeemOutput output = {};
+    std::vector<uint8_t> from(sender, sender + 32);
+    uint64_t balance = getBalance(from);
+    if (input.amount == 0 || balance < input.amount) return QPROBE_REJECT(probe, output);
+    output.redeemed = collateral.redeem(input.amount, output.sats,
+        [](uint64_t id, const CollateralPosition<std::vector<uint8_t>>& pos, uint64_t, uint64_t sats) {
+            dirtyPositions.markDirty(id);
+            if (sats) emitEvent(EventContract::QUSD, EventType::CollateralReleased, id, pos.owner, sats);
+        });
+    if (output.redeemed == 0) return QPROBE_REJECT(probe, output);
+
+    setBalance(from, balance - output.redeemed);
+    totalSupply -= output.redeemed;
+    emitEvent(EventContract::QUSD, EventType::Redemption, from, EventKeyRef(), output.redeemed, output.sats);
+    return output;
+}
+
+extern "C" PositionOutput getPosition(const PositionInput& input) {
+    QPROBE(probe, "qusd.getPosition");
+    PositionOutput output = {};
+    const auto* pos = collateral.find(input.positionId);
+    if (!pos) return QPROBE_REJECT(probe, output);
+    output.found = true;
+    memcpy(output.owner, pos->owner.data(), 32);
+    output.collateral = pos->collateral;
+    output.debt = pos->debt;
+    output.liquidationPrice = pos->liqPrice;
+    return output;
+}
+
+extern "C" CollateralStatsOutput getCollateralStats() {
+    QPROBE(probe, "qusd.getCollateralStats");
+    CollateralStatsOutput output = { collateral.currentPrice(), collateral.size(), collateral.collateralLocked(),
+                                     collateral.debtOutstanding(), collateral.unsafeCount(), seizedCollateral,
+                                     writtenOffDebt };
+    return output;
+}
+
+// Close every position still unsafe at the tick's last price, in one pass
+void liquidateUnsafePositions() {
+    collateral.liquidate([](const CollateralLiquidation<std::vector<uint8_t>>& l) {
+        seizedCollateral += l.collateral;
+        writtenOffDebt += l.debt;
+        dirtyPositions.markDirty(l.id);
+        emitEvent(EventContract::QUSD, EventType::Liquidation, l.id, l.owner, l.collateral, l.debt);
+    });
+}
+
+bool exportDelta(uint64_t fromTick, std::ostream& out);
+
+// Cross-contract calls (qcall.hpp): transfer from and balance of the calling contract's account
+void bindCalls(CallBus& bus) {
+    static_assert(sizeof(CallTransferInput) == sizeof(TransferInput), "same layout as TransferInput");
+    bus.bind<CallTransferInput, CallTransferOutput>(EventContract::QUSD, CallProcedure::Transfer, nullptr,
+        [](void*, const uint8_t caller[32], const CallTransferInput& input, CallTransferOutput& output) {
+            QPROBE(probe, "qusd.call.transfer");
+            output.ok = moveBalance(caller, input.to, input.amount);
+            if (!output.ok) QPROBE_REJECT_VOID(probe);
+        });
+    bus.bind<CallBalanceInput, CallBalanceOutput>(EventContract::QUSD, CallProcedure::BalanceOf, nullptr,
+        [](void*, const uint8_t*, const CallBalanceInput& input, CallBalanceOutput& output) {
+            output.balance = getBalance(std::vector<uint8_t>(input.account, input.account + 32));
+            output.addressable = 1;
+        });
+}
+
+// End of tick: liquidate unsafe positions, journal the tick's changes, then commit
+// touched balances into the state root
+extern "C" StateRootOutput endTick() {
+    QPROBE(probe, "qusd.endTick");
+    StateRootOutput output = {};
+    liquidateUnsafePositions();
+    uint64_t tick = dirtyBalances.currentTick();
+    journal().record(EventContract::QUSD, JournalRecord::Delta, tick,
+                     [tick](std::ostream& out) { exportDelta(tick, out); });
+    if (indexReseedPending) reseedIndexes();
+    const Hash256& root = balanceTree.commit();
+    dirtyBalances.endTick();
+    dirtyBridgeIds.endTick();
+    dirtyPositions.endTick();
+    holders.endTick(dirtyBalances.currentTick());
+    processedBridgeIds.prune(dirtyBalances.currentTick());
+    memcpy(output.root, root.data(), 32);
+    output.accounts = balanceTree.accounts();
+    return output;
+}
+
+// State root as of the last committed tick
+extern "C" StateRootOutput getStateRoot() {
+    QPROBE(probe, "qusd.getStateRoot");
+    StateRootOutput output = {};
+    size_t n;
+    const Hash256* saved = snapshot.table<Hash256>(SNAPSHOT_TABLE_STATE_ROOT, n);
+    if (indexReseedPending && n == 1) { // nothing committed since the restore
+        memcpy(output.root, saved->data(), 32);
+        snapshot.table<AccountRow>(SNAPSHOT_TABLE_TREE_SLOTS, n);
+        output.accounts = n;
+        return output;
+    }
+    if (indexReseedPending) reseedIndexes();
+    memcpy(output.root, balanceTree.root().data(), 32);
+    output.accounts = balanceTree.accounts();
+    return output;
+}
+
+// balanceOf with a Merkle inclusion proof against getStateRoot()
+extern "C" BalanceProofOutput balanceOfWithProof(const BalanceOfInput& input) {
+    QPROBE(probe, "qusd.balanceOfWithProof");
+    BalanceProofOutput output = {};
+    std::vector<uint8_t> account(input.account, input.account + 32);
+    BalanceProof proof;
+    if (indexReseedPending) reseedIndexes();
+    if (!balanceTree.prove(account, proof)) return QPROBE_REJECT(probe, output);
+    output.found = true;
+    output.balance = proof.balance;
+    output.leafIndex = proof.leafIndex;
+    output.depth = uint8_t(proof.siblings.size());
+    for (size_t i = 0; i < proof.siblings.size(); ++i)
+        memcpy(output.siblings[i], proof.siblings[i].data(), 32);
+    return output;
+}
+
+// Delta of balances, bridge ids and collateral positions changed since fromTick,
+// followed by totalSupply and the collateral engine's scalars.
+// False if fromTick is older than the retained window: fall back to a full snapshot.
+bool exportDelta(uint64_t fromTick, std::ostream& out) {
+    bool ok = dirtyBalances.exportDelta<uint64_t>(fromTick, DELTA_TABLE_BALANCES, out,
+        [](const std::vector<uint8_t>& account, uint64_t& balance) { balance = getBalance(account); });
+    if (!ok) return false;
+    ok = dirtyBridgeIds.exportDelta<uint64_t>(fromTick, DELTA_TABLE_BRIDGE_IDS, out,
+        [](const Hash256& id, uint64_t& expiryTick) {
+            if (!processedBridgeIds.expiryOf(id, expiryTick)) expiryTick = 0; // already pruned
+        });
+    if (!ok) return false;
+    ok = dirtyPositions.exportDelta<PositionRecord>(fromTick, DELTA_TABLE_POSITIONS, out,
+        [](uint64_t id, PositionRecord& r) {
+            const auto* pos = collateral.find(id);
+            r = PositionRecord{};
+            if (!pos) return; // closed or liquidated
+            r.live = 1;
+            memcpy(r.owner.data(), pos->owner.data(), 32);
+            r.collateral = pos->collateral;
+            r.debt = pos->debt;
+        });
+    if (!ok) return false;
+    writeU64(out, totalSupply);
+    writeU64(out, seizedCollateral);
+    writeU64(out, writtenOffDebt);
+    writeU64(out, collateral.currentPrice());
+    writeU64(out, collateral.nextPositionId());
+    return bool(out);
+}
+
+// Apply a delta produced by exportDelta() on a peer. It must start at the open tick;
+// every section is read before any state changes, and the dirty logs then continue
+// after the delta's last tick, so tick-keyed checks (bridge expiry, holder versions,
+// processed-id pruning) see the tick the state is now at.
+bool applyDelta(std::istream& in) {
+    DeltaHeader balancesHeader, idsHeader, positionsHeader;
+    std::vector<std::pair<std::vector<uint8_t>, uint64_t>> balanceRecords;
+    std::vector<std::pair<Hash256, uint64_t>> idRecords;
+    std::vector<std::pair<uint64_t, PositionRecord>> positionRecords;
+    uint64_t supply, seized, writtenOff, price, nextPositionId;
+    if (!readDelta(in, DELTA_TABLE_BALANCES, balancesHeader, balanceRecords) ||
+        !readDelta(in, DELTA_TABLE_BRIDGE_IDS, idsHeader, idRecords) ||
+        !readDelta(in, DELTA_TABLE_POSITIONS, positionsHeader, positionRecords) || !readU64(in, supply) ||
+        !readU64(in, seized) || !readU64(in, writtenOff) || !readU64(in, price) || !readU64(in, nextPositionId))
+        return false;
+    if (balancesHeader.fromTick != dirtyBalances.currentTick() || !sameDeltaRange(balancesHeader, idsHeader) ||
+        !sameDeltaRange(balancesHeader, positionsHeader))
+        return false;
+    for (const auto& r : balanceRecords)
+        if (r.first.size() != 32) return false;
+    // Positions are restored whole: check the engine totals cannot overflow first
+    uint64_t locked = collateral.collateralLocked(), outstanding = collateral.debtOutstanding();
+    std::unordered_set<uint64_t> seen;
+    for (const auto& r : positionRecords) {
+        if (r.first == 0 || !seen.insert(r.first).second) return false;
+        if (const auto* pos = collateral.find(r.first)) {
+            locked -= pos->collateral;
+            outstanding -= pos->debt;
+        }
+        if (r.second.live && (!checkedAdd(locked, r.second.collateral, locked) ||
+                              !checkedAdd(outstanding, r.second.debt, outstanding)))
+            return false;
+    }
+
+    uint64_t toTick = balancesHeader.toTick;
+    dirtyBalances.restart(toTick); // holder versions land on the delta's last tick
+    for (const auto& r : balanceRecords) setBalance(r.first, r.second);
+    for (const auto& r : idRecords) recordBridgeId(r.first, r.second);
+    for (const auto& r : positionRecords) {
+        if (r.second.live)
+            collateral.restore(r.first, std::vector<uint8_t>(r.second.owner.begin(), r.second.owner.end()),
+                               r.second.collateral, r.second.debt);
+        else
+            collateral.remove(r.first);
+    }
+    collateral.restoreCounters(price, nextPositionId);
+    totalSupply = supply;
+    seizedCollateral = seized;
+    writtenOffDebt = writtenOff;
+    dirtyBalances.restart(toTick + 1);
+    dirtyBridgeIds.restart(toTick + 1);
+    dirtyPositions.restart(toTick + 1);
+    holders.endTick(toTick + 1);
+    processedBridgeIds.prune(toTick + 1);
+    return true;
+}
+
+// Re-apply a tick journaled by endTick() on top of the restored snapshot (qjournal.hpp).
+// Ticks the snapshot already holds are skipped. The state root is folded once, by
+// endJournalReplay(), instead of once per replayed tick.
+bool replayJournal(uint64_t tick, std::istream& in) {
+    if (tick < dirtyBalances.currentTick()) return true;
+    return applyDelta(in);
+}
+
+extern "C" StateRootOutput endJournalReplay() {
+    StateRootOutput output = {};
+    if (indexReseedPending) reseedIndexes();
+    memcpy(output.root, balanceTree.commit().data(), 32);
+    output.accounts = balanceTree.accounts();
+    return output;
+}
+
+// Whether the mapped snapshot holds a row for the account. Every account in the
+// state tree has a balance row (setBalance writes both), so this also says whether
+// the snapshot's slot order already has it.
+bool snapshotHasAccount(const uint8_t account[32]) {
+    const BalanceRow* end = snapshotBalances + snapshotBalanceCount;
+    const BalanceRow* row = std::lower_bound(snapshotBalances, end, account,
+        [](const BalanceRow& r, const uint8_t* a) { return memcmp(r.account, a, 32) < 0; });
+    return row != end && memcmp(row->account, account, 32) == 0;
+}
+
+// State tree slot order and root without the tree: while the reseed is pending,
+// the order is the mapped snapshot's, then accounts first written since the restore
+// in write order (as the reseed would replay them), and nothing has been committed
+// since, so the root is the snapshot's
+void writeTreeTables(SnapshotWriter& w) {
+    size_t n;
+    w.beginTable(SNAPSHOT_TABLE_TREE_SLOTS, sizeof(AccountRow));
+    if (indexReseedPending) {
+        const AccountRow* slots = snapshot.table<AccountRow>(SNAPSHOT_TABLE_TREE_SLOTS, n);
+        for (size_t i = 0; i < n; ++i) w.appendRow(slots[i]);
+        std::unordered_set<std::vector<uint8_t>, ByteVectorHash> added;
+        for (const auto& write : indexReseed.writes) {
+            if (snapshotHasAccount(write.account.data()) || !added.insert(write.account).second) continue;
+            AccountRow row;
+            memcpy(row.account, write.account.data(), 32);
+            w.appendRow(row);
+        }
+    } else {
+        for (const auto& account : balanceTree.slotKeys()) {
+            AccountRow row;
+            memcpy(row.account, account.data(), 32);
+            w.appendRow(row);
+        }
+    }
+    w.endTable();
+    w.beginTable(SNAPSHOT_TABLE_STATE_ROOT, sizeof(Hash256));
+    if (indexReseedPending) w.appendRow(*snapshot.table<Hash256>(SNAPSHOT_TABLE_STATE_ROOT, n));
+    else w.appendRow(balanceTree.root());
+    w.endTable();
+}
+
+// Snapshot at the current tick boundary: balances merged with the mapped base,
+// the state tree slot order and root, live bridge ids, collateral positions, and
+// totalSupply with the collateral engine's scalars. Needs neither index, so a
+// pending reseed is left running.
+bool saveSnapshot(const std::string& path) {
+    SnapshotWriter w(path);
+    w.beginTable(SNAPSHOT_TABLE_BALANCES, sizeof(BalanceRow));
+    auto it = balances.begin();
+    size_t i = 0;
+    while (it != balances.end() || i < snapshotBalanceCount) {
+        int c = it == balances.end() ? 1
+              : i == snapshotBalanceCount ? -1
+              : memcmp(it->first.data(), snapshotBalances[i].account, 32);
+        BalanceRow row;
+        if (c <= 0) {
+            memcpy(row.account, it->first.data(), 32);
+            row.balance = it->second;
+            if (c == 0) ++i; // written since restore: shadows the base row
+            ++it;
+        } else {
+            row = snapshotBalances[i++];
+        }
+        w.appendRow(row);
+    }
+    w.endTable();
+    writeTreeTables(w);
+    w.beginTable(SNAPSHOT_TABLE_BRIDGE_IDS, sizeof(BridgeIdRow));
+    processedBridgeIds.forEach([&w](const Hash256& id, uint64_t expiryTick) {
+        BridgeIdRow row;
+        memcpy(row.id, id.data(), 32);
+        row.expiryTick = expiryTick;
+        w.appendRow(row);
+    });
+    w.endTable();
+    std::vector<PositionRow> positions;
+    positions.reserve(collateral.size());
+    collateral.forEach([&positions](uint64_t id, const CollateralPosition<std::vector<uint8_t>>& pos) {
+        PositionRow row;
+        row.id = id;
+        memcpy(row.owner, pos.owner.data(), 32);
+        row.collateral = pos.collateral;
+        row.debt = pos.debt;
+        positions.push_back(row);
+    });
+    std::sort(positions.begin(), positions.end(), [](const PositionRow& a, const PositionRow& b) { return a.id < b.id; });
+    w.beginTable(SNAPSHOT_TABLE_POSITIONS, sizeof(PositionRow));
+    for (const auto& row : positions) w.appendRow(row);
+    w.endTable();
+    w.setScalar(SNAPSHOT_SCALAR_TOTAL_SUPPLY, totalSupply);
+    w.setScalar(SNAPSHOT_SCALAR_SEIZED_COLLATERAL, seizedCollateral);
+    w.setScalar(SNAPSHOT_SCALAR_WRITTEN_OFF_DEBT, writtenOffDebt);
+    w.setScalar(SNAPSHOT_SCALAR_COLLATERAL_PRICE, collateral.currentPrice());
+    w.setScalar(SNAPSHOT_SCALAR_NEXT_POSITION_ID, collateral.nextPositionId());
+    return w.finish(dirtyBalances.currentTick());
+}
+
+// Same, from a forked copy-on-write child; poll with reapBackgroundSnapshot(). The
+// child reads only the mapping and the main thread's state, never the reseed
+// builder's half-built indexes, so a pending reseed neither blocks nor breaks it.
+pid_t saveSnapshotInBackground(const std::string& path) {
+    return snapshotInBackground([&path] { return saveSnapshot(path); });
+}
+
+// Map a snapshot, checksummed before it replaces the current one, and serve balances
+// from it in place; the state tree and holder index are rebuilt off-thread
+bool loadSnapshot(const std::string& path) {
+    indexReseed.wait(); // the builder reads the current mapping
+    if (!snapshot.open(path, true)) return false;
+    snapshotBalances = snapshot.table<BalanceRow>(SNAPSHOT_TABLE_BALANCES, snapshotBalanceCount);
+    balances.clear();
+    totalSupply = snapshot.scalar(SNAPSHOT_SCALAR_TOTAL_SUPPLY);
+    balanceTree = BalanceMerkleTree<std::vector<uint8_t>, ByteVectorHash>();
+    holders = HolderIndex<std::vector<uint8_t>, ByteVectorHash>();
+    dirtyBalances.restart(snapshot.tick());
+    dirtyBridgeIds.restart(snapshot.tick());
+    dirtyPositions.restart(snapshot.tick());
+    // Positions are copied out too: the liquidation index lives in memory
+    size_t positionCount;
+    const PositionRow* positions = snapshot.table<PositionRow>(SNAPSHOT_TABLE_POSITIONS, positionCount);
+    collateral = CollateralEngine<std::vector<uint8_t>>();
+    for (size_t i = 0; i < positionCount; ++i)
+        collateral.restore(positions[i].id, std::vector<uint8_t>(positions[i].owner, positions[i].owner + 32),
+                           positions[i].collateral, positions[i].debt);
+    collateral.restoreCounters(snapshot.scalar(SNAPSHOT_SCALAR_COLLATERAL_PRICE),
+                               snapshot.scalar(SNAPSHOT_SCALAR_NEXT_POSITION_ID));
+    seizedCollateral = snapshot.scalar(SNAPSHOT_SCALAR_SEIZED_COLLATERAL);
+    writtenOffDebt = snapshot.scalar(SNAPSHOT_SCALAR_WRITTEN_OFF_DEBT);
+    // Live ids are few (bounded by the expiry window), so they are copied out
+    size_t idCount;
+    const BridgeIdRow* ids = snapshot.table<BridgeIdRow>(SNAPSHOT_TABLE_BRIDGE_IDS, idCount);
+    processedBridgeIds.clear();
+    for (size_t i = 0; i < idCount; ++i) {
+        Hash256 id;
+        memcpy(id.data(), ids[i].id, 32);
+        processedBridgeIds.insert(id, ids[i].expiryTick);
+    }
+    startIndexReseed(snapshot.tick());
+    return true;
+}
@@ -0,0 +1,199 @@
+/*
+ * qVestingStore – Column (structure-of-arrays) store of vesting grants
+ * Bulk vestedAt(t) in AVX2 with exact 128-bit results, parallel totals for reports
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "qworkers.hpp"
+#include "qschedule.hpp"
+#include "qfixed.hpp"
+
+// ====== Scalar Reference ======
+// floor(total * elapsed / duration), capped at total. The product is taken in
+// 128 bits and the quotient is below total, so mulDiv cannot fail; every other
+// path must agree with this exactly.
+inline uint64_t linearVested(uint64_t total, uint64_t start, uint64_t duration, uint64_t t) {
+    uint64_t elapsed = t > start ? t - start : 0;
+    if (elapsed >= duration) return total;
+    uint64_t vested = 0;
+    mulDiv(total, elapsed, duration, vested);
+    return vested;
+}
+
+constexpr uint8_t VESTING_PAUSED = 1;
+constexpr uint8_t VESTING_CANCELLED = 2;
+
+// Report over a store: claimable excludes paused and cancelled grants
+struct VestingTotals {
+    uint64_t vested = 0;
+    uint64_t claimed = 0;
+    uint64_t claimable = 0;
+};
+
+// Grants per parallel work item
+constexpr size_t VESTING_REDUCE_CHUNK = 1 << 16;
+
+// ====== Vesting Store ======
+// One column per field, indexed by row. Rows are appended and updated in place,
+// never removed (cancelled grants keep their row with the flag set). Rows with a
+// non-linear schedule keep it on the side and are evaluated after the kernel pass.
+class VestingStore {
+private:
+    std::vector<uint64_t> start, duration, total, claimed;
+    std::vector<uint8_t> flags;
+    std::map<uint32_t, VestingSchedule> schedules; // row -> schedule, non-linear rows only
+
+    void setSchedule(uint32_t row, const VestingSchedule* schedule) {
+        if (schedule && !schedule->empty()) schedules[row] = *schedule;
+        else schedules.erase(row);
+    }
+
+    void applySchedules(uint64_t t, size_t begin, size_t end, uint64_t* out) const {
+        for (auto it = schedules.lower_bound(uint32_t(begin)); it != schedules.end() && it->first < end; ++it)
+            out[it->first - begin] = it->second.amountAt(t);
+    }
+
+#if defined(__AVX2__)
+    // Lanes the vector path handles exactly: total < 2^51 and duration < 2^32.
+    // Other running lanes are recomputed in scalar; saturated lanes are blended.
+    static constexpr uint64_t FAST_TOTAL_LIMIT = uint64_t(1) << 51;
+    static constexpr uint64_t FAST_DURATION_LIMIT = uint64_t(1) << 32;
+    using V = Avx2U64;
+
+    // Four lanes from row i. A double estimate of total * elapsed / duration is
+    // within 1 of the answer; the exact remainder (mod 2^64, small in magnitude)
+    // then fixes it with one more division, exact in doubles at that size.
+    void vested4(size_t i, __m256i t, uint64_t tScalar, uint64_t* out) const {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&start[i]));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&duration[i]));
+        __m256i T = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&total[i]));
+        __m256i e = _mm256_and_si256(V::lessThan(s, t), _mm256_sub_epi64(t, s));
+        __m256i running = V::lessThan(e, d);
+        __m256i fast = _mm256_and_si256(V::lessThan(T, _mm256_set1_epi64x(int64_t(FAST_TOTAL_LIMIT))),
+                                        V::lessThan(d, _mm256_set1_epi64x(int64_t(FAST_DURATION_LIMIT))));
+        __m256d dd = V::toDouble(d);
+        __m256i q = V::toUint(_mm256_floor_pd(_mm256_div_pd(_mm256_mul_pd(V::toDouble(T), V::toDouble(e)), dd)));
+        __m256i r = _mm256_sub_epi64(V::mulLow(T, e), V::mulLow(q, d));
+        q = _mm256_add_epi64(q, V::toSigned(_mm256_floor_pd(_mm256_div_pd(V::signedToDouble(r), dd))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_blendv_epi8(T, q, running));
+        int slow = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(fast, running)));
+        for (int lane = 0; slow; ++lane, slow >>= 1)
+            if (slow & 1) out[lane] = linearVested(total[i + lane], start[i + lane], duration[i + lane], tScalar);
+    }
+#endif
+
+public:
+    size_t size() const { return total.size(); }
+
+    void reserve(size_t n) {
+        start.reserve(n);
+        duration.reserve(n);
+        total.reserve(n);
+        claimed.reserve(n);
+        flags.reserve(n);
+    }
+
+    void clear() {
+        start.clear();
+        duration.clear();
+        total.clear();
+        claimed.clear();
+        flags.clear();
+        schedules.clear();
+    }
+
+    uint32_t append(uint64_t startTime, uint64_t dur, uint64_t totalAmount, uint64_t claimedAmount, uint8_t flag,
+                    const VestingSchedule* schedule = nullptr) {
+        start.push_back(startTime);
+        duration.push_back(dur);
+        total.push_back(totalAmount);
+        claimed.push_back(claimedAmount);
+        flags.push_back(flag);
+        setSchedule(uint32_t(total.size() - 1), schedule);
+        return uint32_t(total.size() - 1);
+    }
+
+    void set(uint32_t row, uint64_t startTime, uint64_t dur, uint64_t totalAmount, uint64_t claimedAmount, uint8_t flag,
+             const VestingSchedule* schedule = nullptr) {
+        start[row] = startTime;
+        duration[row] = dur;
+        total[row] = totalAmount;
+        claimed[row] = claimedAmount;
+        flags[row] = flag;
+        setSchedule(row, schedule);
+    }
+
+    uint64_t vestedAt(uint32_t row, uint64_t t) const {
+        auto it = schedules.find(row);
+        if (it != schedules.end()) return it->second.amountAt(t);
+        return linearVested(total[row], start[row], duration[row], t);
+    }
+
+    // Vested amount of rows [begin, end) at time t into out[0, end - begin)
+    void vestedAt(uint64_t t, size_t begin, size_t end, uint64_t* out) const {
+        const size_t n = end - begin;
+        size_t k = 0;
+#if defined(__AVX2__)
+        __m256i tv = _mm256_set1_epi64x(int64_t(t));
+        for (; k + 4 <= n; k += 4) vested4(begin + k, tv, t, out + k);
+#endif
+        for (; k < n; ++k) out[k] = linearVested(total[begin + k], start[begin + k], duration[begin + k], t);
+        if (!schedules.empty()) applySchedules(t, begin, end, out);
+    }
+
+    std::vector<uint64_t> vestedAt(uint64_t t) const {
+        std::vector<uint64_t> out(size());
+        sharedWorkers().parallelFor((size() + VESTING_REDUCE_CHUNK - 1) / VESTING_REDUCE_CHUNK, [&](size_t c) {
+            size_t b = c * VESTING_REDUCE_CHUNK, e = std::min(size(), b + VESTING_REDUCE_CHUNK);
+            vestedAt(t, b, e, out.data() + b);
+        });
+        return out;
+    }
+
+    // Totals over every row at time t, chunked across the worker pool. Each chunk
+    // sums into its own slot and slots are added in order, so the result does not
+    // depend on scheduling.
+    VestingTotals totalsAt(uint64_t t) const {
+        size_t chunks = (size() + VESTING_REDUCE_CHUNK - 1) / VESTING_REDUCE_CHUNK;
+        std::vector<VestingTotals> partial(chunks);
+        sharedWorkers().parallelFor(chunks, [&](size_t c) {
+            size_t b = c * VESTING_REDUCE_CHUNK, e = std::min(size(), b + VESTING_REDUCE_CHUNK);
+            uint64_t buf[256];
+            VestingTotals sum;
+            for (size_t i = b; i < e; i += 256) {
+                size_t n = std::min<size_t>(256, e - i);
+                vestedAt(t, i, i + n, buf);
+                for (size_t k = 0; k < n; ++k) {
+                    sum.vested += buf[k];
+                    sum.claimed += claimed[i + k];
+                    if (!flags[i + k]) sum.claimable += buf[k] - std::min(buf[k], claimed[i + k]);
+                }
+            }
+            partial[c] = sum;
+        });
+        VestingTotals out;
+        for (const auto& p : partial) {
+            out.vested += p.vested;
+            out.claimed += p.claimed;
+            out.claimable += p.claimable;
+        }
+        return out;
+    }
+};
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
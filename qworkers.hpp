@@ -0,0 +1,113 @@
+/*
+ * qWorkers – Persistent worker pool for parallel-for over independent items
+ * Threads are started once and parked between jobs; the caller works too
+ * Code is Law – Security First
+ * License: Qubic Anti-Military, see end of file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// ====== Worker Pool ======
+// parallelFor(n, fn) runs fn(i) for every i in [0, n) on the pool and the calling
+// thread, returning once all calls finished. Items are claimed one at a time, so
+// fn can skip cheaply once a shared goal is met. Calls from different threads are
+// serialized; fn must not call parallelFor on the same pool.
+class WorkerPool {
+private:
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake, idle;
+    std::mutex runLock;                       // one job at a time
+    std::function<void(size_t)> job;
+    std::atomic<size_t> next{0};
+    size_t count = 0;
+    uint64_t generation = 0;
+    unsigned active = 0;                      // workers inside the current job
+    bool stopping = false;
+
+    void drain() {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) job(i);
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> g(lock);
+        for (;;) {
+            wake.wait(g, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            ++active;
+            g.unlock();
+            drain();
+            g.lock();
+            if (--active == 0) idle.notify_all();
+        }
+    }
+
+public:
+    explicit WorkerPool(unsigned workers = std::max(1u, std::thread::hardware_concurrency()) - 1) {
+        for (unsigned i = 0; i < workers; ++i) threads.emplace_back([this] { workerLoop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads taking part in a job, including the caller
+    unsigned concurrency() const { return unsigned(threads.size()) + 1; }
+
+    template <typename Fn>
+    void parallelFor(size_t n, Fn fn) {
+        if (n == 0) return;
+        if (n == 1 || threads.empty()) {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+        std::lock_guard<std::mutex> run(runLock);
+        {
+            std::unique_lock<std::mutex> g(lock);
+            idle.wait(g, [&] { return active == 0; }); // stragglers from the last job
+            job = std::ref(fn);
+            count = n;
+            next.store(0, std::memory_order_relaxed);
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> g(lock);
+        idle.wait(g, [&] { return active == 0; });
+    }
+};
+
+// Process-wide pool shared by contracts in this process
+inline WorkerPool& sharedWorkers() {
+    static WorkerPool pool;
+    return pool;
+}
+
+/*
+Qubic Anti-Military License – Code is Law Edition
+Permission is hereby granted, perpetual, worldwide, non-exclusive, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+- The Software cannot be used in any form or in any substantial portions for development, maintenance and for any other purposes, in the military sphere and in relation to military products or activities as defined in the original license.
+- All modifications, alterations, or merges must maintain these restrictions.
+- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+(c) BANKON All Rights Reserved. See LICENSE file for full text.
+*/
@@ -5,7 +5,7 @@ echo "=================================="
 
 # Configuration
 CONTRACT_INDEX=13
-RPC_URL="https://rpc.qubic.org/v1"
+RPC_URL="${RPC_URL:-https://rpc.qubic.org/v1}" # override to test against a local qrpcnode
 
 # Colors for output
 GREEN='\033[0;32m'
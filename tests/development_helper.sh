@@ -3,10 +3,13 @@
 echo "BANKON PYTHAI Development Helper"
 echo "================================"
 
+# RPC endpoint (override with RPC_URL, e.g. a local qrpcnode at http://127.0.0.1:8000/v1)
+RPC_URL="${RPC_URL:-https://rpc.qubic.org/v1}"
+
 case "$1" in
     "status")
         echo "Current Network Status:"
-        curl -s -X GET "https://rpc.qubic.org/v1/tick-info" | jq .
+        curl -s -X GET "$RPC_URL/tick-info" | jq .
         ;;
     "test")
         ./scripts/test_connection.sh
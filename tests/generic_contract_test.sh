@@ -3,9 +3,12 @@
 echo "Testing BANKON PYTHAI Contract Functions..."
 echo "=========================================="
 
+# RPC endpoint (override with RPC_URL, e.g. a local qrpcnode at http://127.0.0.1:8000/v1)
+RPC_URL="${RPC_URL:-https://rpc.qubic.org/v1}"
+
 # Test QX contract (contract index 1) to verify RPC works
 echo "Testing QX contract query..."
-QX_RESPONSE=$(curl -s -X POST "https://rpc.qubic.org/v1/querySmartContract" \
+QX_RESPONSE=$(curl -s -X POST "$RPC_URL/querySmartContract" \
     -H "Content-Type: application/json" \
     -d '{"contractIndex": 1, "inputType": 1, "inputSize": 0, "requestData": ""}')
 
@@ -18,7 +21,7 @@ fi
 
 # Test HM25 contract (contract index 12) if available
 echo "Testing HM25 contract query..."
-HM25_RESPONSE=$(curl -s -X POST "https://rpc.qubic.org/v1/querySmartContract" \
+HM25_RESPONSE=$(curl -s -X POST "$RPC_URL/querySmartContract" \
     -H "Content-Type: application/json" \
     -d '{"contractIndex": 12, "inputType": 1, "inputSize": 0, "requestData": ""}')
 
@@ -3,9 +3,13 @@
 echo "Testing Qubic Network Connection..."
 echo "=================================="
 
+# RPC endpoint (override with RPC_URL, e.g. a local qrpcnode at http://127.0.0.1:8000/v1)
+RPC_URL="${RPC_URL:-https://rpc.qubic.org/v1}"
+TESTNET_RPC_URL="${TESTNET_RPC_URL:-https://testnet-rpc.qubic.org/v1}"
+
 # Test mainnet RPC
 echo "Testing mainnet RPC..."
-TICK_INFO=$(curl -s -X GET "https://rpc.qubic.org/v1/tick-info")
+TICK_INFO=$(curl -s -X GET "$RPC_URL/tick-info")
 if [ $? -eq 0 ]; then
     echo "✅ Mainnet RPC is accessible"
     echo "Current tick info: $TICK_INFO"
@@ -15,7 +19,7 @@ fi
 
 # Test testnet RPC
 echo "Testing testnet RPC..."
-TESTNET_INFO=$(curl -s -X GET "https://testnet-rpc.qubic.org/v1/tick-info")
+TESTNET_INFO=$(curl -s -X GET "$TESTNET_RPC_URL/tick-info")
 if [ $? -eq 0 ]; then
     echo "✅ Testnet RPC is accessible"
     echo "Testnet tick info: $TESTNET_INFO"
@@ -2,11 +2,14 @@
 
 echo "BANKON PYTHAI Project Status Summary"
 echo "===================================="
+
+# RPC endpoint (override with RPC_URL, e.g. a local qrpcnode at http://127.0.0.1:8000/v1)
+RPC_URL="${RPC_URL:-https://rpc.qubic.org/v1}"
 echo ""
 
 # Get current network status
 echo "📊 Network Status:"
-TICK_INFO=$(curl -s -X GET "https://rpc.qubic.org/v1/tick-info")
+TICK_INFO=$(curl -s -X GET "$RPC_URL/tick-info")
 TICK=$(echo $TICK_INFO | grep -o '"tick":[0-9]*' | cut -d':' -f2)
 EPOCH=$(echo $TICK_INFO | grep -o '"epoch":[0-9]*' | cut -d':' -f2)
 echo "   Current Tick: $TICK"
@@ -16,7 +19,7 @@ echo ""
 
 # Check contract deployment status
 echo "📋 Contract Status:"
-CONTRACT_RESPONSE=$(curl -s -X POST "https://rpc.qubic.org/v1/querySmartContract" \
+CONTRACT_RESPONSE=$(curl -s -X POST "$RPC_URL/querySmartContract" \
     -H "Content-Type: application/json" \
     -d '{"contractIndex": 13, "inputType": 1, "inputSize": 0, "requestData": ""}')
 